@@ -22,14 +22,49 @@ StatusCode ChronoAuditor::initialize() {
       error() << "Cannot get ChronoStatSvc" << endmsg;
       return StatusCode::FAILURE;
     }
+    // the handles of a previous initialization may be of another ChronoStatSvc
+    m_handles.clear();
+    m_handleCache.clear();
     return StatusCode::SUCCESS;
   } );
 }
 
+IChronoSvc::ChronoHandle ChronoAuditor::i_handle( CustomEventTypeRef evt, std::string_view caller ) {
+  // reuse the buffer to avoid an allocation per call
+  thread_local std::string id;
+  id.assign( caller ).append( ":" ).append( evt );
+  {
+    std::shared_lock lock{ m_handlesMutex };
+    if ( auto it = m_handles.find( id ); it != m_handles.end() ) return it->second;
+  }
+  auto             handle = chronoSvc()->chronoHandle( id );
+  std::unique_lock lock{ m_handlesMutex };
+  m_handles.emplace( id, handle );
+  return handle;
+}
+
+IChronoSvc::ChronoHandle ChronoAuditor::i_handle( StandardEventType evt, INamedInterface* caller ) {
+  auto [it, added] = m_handleCache.local().try_emplace( CacheKey{ caller, evt } );
+  auto& cached     = it->second;
+  if ( added || cached.name != caller->name() ) {
+    cached.name   = caller->name();
+    cached.handle = i_handle( toStr( evt ), cached.name );
+  }
+  return cached.handle;
+}
+
+void ChronoAuditor::before( StandardEventType evt, INamedInterface* caller ) {
+  if ( caller && i_auditEventType( toStr( evt ) ) ) chronoSvc()->chronoStart( i_handle( evt, caller ) );
+}
+
+void ChronoAuditor::after( StandardEventType evt, INamedInterface* caller, const StatusCode& ) {
+  if ( caller && i_auditEventType( toStr( evt ) ) ) chronoSvc()->chronoStop( i_handle( evt, caller ) );
+}
+
 void ChronoAuditor::i_before( CustomEventTypeRef evt, std::string_view caller ) {
-  chronoSvc()->chronoStart( i_id( evt, caller ) );
+  chronoSvc()->chronoStart( i_handle( evt, caller ) );
 }
 
 void ChronoAuditor::i_after( CustomEventTypeRef evt, std::string_view caller, const StatusCode& ) {
-  chronoSvc()->chronoStop( i_id( evt, caller ) );
+  chronoSvc()->chronoStop( i_handle( evt, caller ) );
 }
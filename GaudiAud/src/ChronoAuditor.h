@@ -13,8 +13,16 @@
 
 #include "CommonAuditor.h"
 
+#include "Gaudi/Concurrency/PerThread.h"
 #include "GaudiKernel/IChronoStatSvc.h"
 
+#include <functional>
+#include <map>
+#include <shared_mutex>
+#include <string>
+#include <unordered_map>
+#include <utility>
+
 /** @class ChronoAuditor
     Monitors the cpu time usage of each algorithm
 
@@ -27,6 +35,13 @@ public:
 
   StatusCode initialize() override;
 
+  using CommonAuditor::after;
+  using CommonAuditor::before;
+
+  /// Standard events of a component (e.g. Execute), with the handle of the chrono cached per thread
+  void before( StandardEventType evt, INamedInterface* caller ) override;
+  void after( StandardEventType evt, INamedInterface* caller, const StatusCode& sc ) override;
+
 private:
   /// Default (catch-all) "before" Auditor hook
   void i_before( CustomEventTypeRef evt, std::string_view caller ) override;
@@ -34,11 +49,33 @@ private:
   /// Default (catch-all) "after" Auditor hook
   void i_after( CustomEventTypeRef evt, std::string_view caller, const StatusCode& sc ) override;
 
-  /// Compute the id string to be used for the chrono entity.
-  std::string i_id( CustomEventTypeRef evt, std::string_view caller ) { return std::string{ caller } + ":" + evt; }
+  /// Handle of the chrono entity ("<caller>:<evt>"), resolved only the first time it is needed.
+  IChronoSvc::ChronoHandle i_handle( CustomEventTypeRef evt, std::string_view caller );
+
+  /// Handle of the chrono entity of a standard event of a component, from a cache of the current
+  /// thread (no lock and no string to build once the thread has seen the component).
+  IChronoSvc::ChronoHandle i_handle( StandardEventType evt, INamedInterface* caller );
 
   SmartIF<IChronoStatSvc>& chronoSvc() { return m_chronoSvc; }
   SmartIF<IChronoStatSvc>  m_chronoSvc;
+
+  std::map<std::string, IChronoSvc::ChronoHandle, std::less<>> m_handles;
+  std::shared_mutex                                            m_handlesMutex;
+
+  /// Cached handle, with the name of the component it was resolved for (a component created at
+  /// the address of a deleted one gets its own handle)
+  struct CachedHandle {
+    std::string              name;
+    IChronoSvc::ChronoHandle handle{};
+  };
+  using CacheKey = std::pair<const INamedInterface*, StandardEventType>;
+  struct CacheKeyHash {
+    std::size_t operator()( const CacheKey& k ) const {
+      return std::hash<const void*>{}( k.first ) ^ static_cast<std::size_t>( k.second );
+    }
+  };
+  /// handles of the standard events of the components seen by each thread, cleared at initialize
+  Gaudi::Concurrency::PerThread<std::unordered_map<CacheKey, CachedHandle, CacheKeyHash>> m_handleCache;
 };
 
 #endif
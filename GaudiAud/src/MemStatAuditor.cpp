@@ -64,7 +64,7 @@ void MemStatAuditor::i_printinfo( std::string_view msg, CustomEventTypeRef evt,
   // cannot be exactly 0
   double deltaVSize = 0.00001;
 
-  if ( procInfo pInfo; ProcStats::instance()->fetch( pInfo ) ) {
+  if ( procInfo pInfo; ProcStats::instance()->sample( pInfo ) ) {
 
     if ( pInfo.vsize > 0 ) {
       if ( m_vSize > 0 ) { deltaVSize = pInfo.vsize - m_vSize; }
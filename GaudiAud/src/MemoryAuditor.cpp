@@ -47,7 +47,7 @@ void MemoryAuditor::i_after( CustomEventTypeRef evt, std::string_view caller, co
 void MemoryAuditor::i_printinfo( std::string_view msg, CustomEventTypeRef evt, std::string_view caller ) {
   /// Get the process informations.
   /// fetch true if it was possible to retrieve the informations.
-  if ( procInfo pInfo; ProcStats::instance()->fetch( pInfo ) ) {
+  if ( procInfo pInfo; ProcStats::instance()->sample( pInfo ) ) {
     info() << msg << " " << caller << " " << evt << " virtual size = " << pInfo.vsize << " MB"
            << " resident set size = " << pInfo.rss << " MB" << endmsg;
   }
@@ -0,0 +1,97 @@
+/***********************************************************************************\
+* (c) Copyright 2022 CERN for the benefit of the LHCb and ATLAS collaborations      *
+*                                                                                   *
+* This software is distributed under the terms of the Apache version 2 licence,     *
+* copied verbatim in the file "LICENSE".                                            *
+*                                                                                   *
+* In applying this licence, CERN does not waive the privileges and immunities       *
+* granted to it by virtue of its status as an Intergovernmental Organization        *
+* or submit itself to any jurisdiction.                                             *
+\***********************************************************************************/
+#include "ProcStats.h"
+
+#include <Gaudi/Accumulators.h>
+#include <GaudiKernel/Service.h>
+
+#include <atomic>
+#include <nlohmann/json.hpp>
+#include <optional>
+
+/** Samples the memory usage of the process (/proc/self/statm and getrusage) in a background thread.
+ *
+ *  The latest values are published through the monitoring hub as a "gauge:Memory" entity (so that
+ *  the periodic snapshots of the hub give their time series) and accumulated in counters.  While the
+ *  service runs, MemoryAuditor and MemStatAuditor use the latest sample instead of reading /proc
+ *  around each algorithm.
+ */
+class MemorySamplerSvc : public Service {
+public:
+  using Service::Service;
+
+  StatusCode initialize() override {
+    return Service::initialize().andThen( [&]() -> StatusCode {
+      if ( m_period <= 0 ) {
+        error() << "invalid sampling Period " << m_period.value() << endmsg;
+        return StatusCode::FAILURE;
+      }
+      m_previous.reset();
+      serviceLocator()->monitoringHub().registerEntity( name(), "Memory", "gauge:Memory", m_gauge );
+      ProcStats::instance()->startSampling( std::chrono::duration<double>( m_period.value() ),
+                                            [this]( const ProcStats::Sample& s ) { onSample( s ); } );
+      return StatusCode::SUCCESS;
+    } );
+  }
+
+  StatusCode finalize() override {
+    ProcStats::instance()->stopSampling();
+    serviceLocator()->monitoringHub().removeEntity( m_gauge );
+    return Service::finalize();
+  }
+
+private:
+  /// Latest values, as a monitoring hub entity.
+  struct Gauge {
+    std::atomic<double> vsize{ 0 }, rss{ 0 }, minorFaultsRate{ 0 }, majorFaultsRate{ 0 };
+    static constexpr bool concurrentReads = true;
+
+    nlohmann::json toJSON() const {
+      return { { "type", "gauge:Memory" },
+               { "vsize", vsize.load() },
+               { "rss", rss.load() },
+               { "minorFaultsRate", minorFaultsRate.load() },
+               { "majorFaultsRate", majorFaultsRate.load() } };
+    }
+    void reset() {}
+  };
+
+  /// Called from the sampler thread.
+  void onSample( const ProcStats::Sample& s ) {
+    m_gauge.vsize = s.info.vsize;
+    m_gauge.rss   = s.info.rss;
+    m_vsize += s.info.vsize;
+    m_rss += s.info.rss;
+    if ( m_previous ) {
+      const double dt = std::chrono::duration<double>( s.time - m_previous->time ).count();
+      if ( dt > 0 ) {
+        m_gauge.minorFaultsRate = ( s.minorFaults - m_previous->minorFaults ) / dt;
+        m_gauge.majorFaultsRate = ( s.majorFaults - m_previous->majorFaults ) / dt;
+        m_minorFaultsRate += m_gauge.minorFaultsRate.load();
+        m_majorFaultsRate += m_gauge.majorFaultsRate.load();
+      }
+    }
+    m_previous = s;
+  }
+
+  Gaudi::Property<double> m_period{ this, "Period", 1., "sampling period in seconds" };
+
+  std::optional<ProcStats::Sample> m_previous;
+
+  Gauge m_gauge;
+
+  Gaudi::Accumulators::StatCounter<double> m_vsize{ this, "VSize [MB]" };
+  Gaudi::Accumulators::StatCounter<double> m_rss{ this, "RSS [MB]" };
+  Gaudi::Accumulators::StatCounter<double> m_minorFaultsRate{ this, "Minor page faults [1/s]" };
+  Gaudi::Accumulators::StatCounter<double> m_majorFaultsRate{ this, "Major page faults [1/s]" };
+};
+
+DECLARE_COMPONENT( MemorySamplerSvc )
@@ -19,225 +19,23 @@
 
 #include "ProcStats.h"
 
+#include <charconv>
+#include <iostream>
 #if defined( __linux__ ) or defined( __APPLE__ )
-#  include <iostream>
-#  include <sstream>
-#  include <sys/signal.h>
-#  include <sys/syscall.h>
-#  ifdef __linux__
-#    include <sys/procfs.h>
-#  endif // __linux__
-#  include <cstdio>
-
-using std::cerr;
-using std::cout;
-using std::endl;
-
-/* Format of the Linux proc/stat (man 5 proc, kernel 2.6.35):
- pid %d      The process ID.
-
- comm %s     The  filename  of the executable, in parentheses.  This is visible
-             whether or not the executable is swapped out.
-
- state %c    One character from the string "RSDZTW" where R is  running,  S  is
-             sleeping in an interruptible wait, D is waiting in uninterruptible
-             disk sleep, Z is zombie, T is traced or stopped (on a signal), and
-             W is paging.
-
- ppid %d     The PID of the parent.
-
- pgrp %d     The process group ID of the process.
-
- session %d  The session ID of the process.
-
- tty_nr %d   The controlling terminal of the process.  (The minor device number
-             is contained in the combination of bits 31 to 20 and 7 to  0;  the
-             major device number is in bits 15 t0 8.)
-
- tpgid %d    The ID of the foreground process group of the controlling terminal
-             of the process.
-
- flags %u (%lu before Linux 2.6.22)
-             The kernel flags word of the process.  For bit meanings,  see  the
-             PF_*  defines  in  <linux/sched.h>.   Details depend on the kernel
-             version.
-
- minflt %lu  The number of minor faults the process has  made  which  have  not
-             required loading a memory page from disk.
-
- cminflt %lu The  number of minor faults that the process's waited-for children
-             have made.
-
- majflt %lu  The number of  major  faults  the  process  has  made  which  have
-             required loading a memory page from disk.
-
- cmajflt %lu The  number of major faults that the process's waited-for children
-             have made.
-
- utime %lu   Amount of time that this process has been scheduled in user  mode,
-             measured  in  clock  ticks  (divide by sysconf(_SC_CLK_TCK).  This
-             includes guest time, guest_time (time spent running a virtual CPU,
-             see  below),  so that applications that are not aware of the guest
-             time field do not lose that time from their calculations.
-
- stime %lu   Amount of time that this process  has  been  scheduled  in  kernel
-             mode, measured in clock ticks (divide by sysconf(_SC_CLK_TCK).
-
- cutime %ld  Amount  of  time that this process's waited-for children have been
-             scheduled in  user  mode,  measured  in  clock  ticks  (divide  by
-             sysconf(_SC_CLK_TCK).   (See  also times(2).)  This includes guest
-             time, cguest_time (time spent running a virtual CPU, see below).
-
- cstime %ld  Amount of time that this process's waited-for children  have  been
-             scheduled  in  kernel  mode,  measured  in  clock ticks (divide by
-             sysconf(_SC_CLK_TCK).
-
- priority %ld
-             (Explanation for Linux 2.6)  For  processes  running  a  real-time
-             scheduling  policy (policy below; see sched_setscheduler(2)), this
-             is the negated scheduling priority, minus one; that is,  a  number
-             in  the  range -2 to -100, corresponding to real-time priorities 1
-             to 99.  For processes running  under  a  non-real-time  scheduling
-             policy, this is the raw nice value (setpriority(2)) as represented
-             in the kernel.  The kernel stores nice values as  numbers  in  the
-             range 0 (high) to 39 (low), corresponding to the user-visible nice
-             range of -20 to 19.
-
-             Before Linux 2.6, this was a scaled value based on  the  scheduler
-             weighting given to this process.
-
- nice %ld    The  nice value (see setpriority(2)), a value in the range 19 (low
-             priority) to -20 (high priority).
-
- num_threads %ld
-             Number of threads in this process (since Linux 2.6).  Before  ker‐
-             nel  2.6,  this  field was hard coded to 0 as a placeholder for an
-             earlier removed field.
-
- itrealvalue %ld
-             The time in jiffies before the next SIGALRM is sent to the process
-             due  to  an interval timer.  Since kernel 2.6.17, this field is no
-             longer maintained, and is hard coded as 0.
-
- starttime %llu (was %lu before Linux 2.6)
-             The time in jiffies the process started after system boot.
-
- vsize %lu   Virtual memory size in bytes.
-
- rss %ld     Resident Set Size: number of pages the process has in real memory.
-             This  is  just  the pages which count towards text, data, or stack
-             space.  This does not include pages which have  not  been  demand-
-             loaded in, or which are swapped out.
-
- rsslim %lu  Current  soft  limit  in  bytes on the rss of the process; see the
-             description of RLIMIT_RSS in getpriority(2).
-
- startcode %lu
-             The address above which program text can run.
-
- endcode %lu The address below which program text can run.
-
- startstack %lu
-             The address of the start (i.e., bottom) of the stack.
-
- kstkesp %lu The current value of ESP (stack pointer), as found in  the  kernel
-             stack page for the process.
-
- kstkeip %lu The current EIP (instruction pointer).
-
- signal %lu  The  bitmap  of  pending  signals,  displayed as a decimal number.
-             Obsolete, because it does not  provide  information  on  real-time
-             signals; use /proc/[pid]/status instead.
-
- blocked %lu The  bitmap  of  blocked  signals,  displayed as a decimal number.
-             Obsolete, because it does not  provide  information  on  real-time
-             signals; use /proc/[pid]/status instead.
-
- sigignore %lu
-             The  bitmap  of  ignored  signals,  displayed as a decimal number.
-             Obsolete, because it does not  provide  information  on  real-time
-             signals; use /proc/[pid]/status instead.
-
- sigcatch %lu
-             The  bitmap  of  caught  signals,  displayed  as a decimal number.
-             Obsolete, because it does not  provide  information  on  real-time
-             signals; use /proc/[pid]/status instead.
-
- wchan %lu   This  is the "channel" in which the process is waiting.  It is the
-             address of a system call, and can be looked up in  a  namelist  if
-             you   need   a   textual   name.    (If  you  have  an  up-to-date
-             /etc/psdatabase, then try ps -l to see the WCHAN field in action.)
-
- nswap %lu   Number of pages swapped (not maintained).
-
- cnswap %lu  Cumulative nswap for child processes (not maintained).
-
- exit_signal %d (since Linux 2.1.22)
-             Signal to be sent to parent when we die.
-
- processor %d (since Linux 2.2.8)
-             CPU number last executed on.
-
- rt_priority %u (since Linux 2.5.19; was %lu before Linux 2.6.22)
-             Real-time scheduling priority, a number in the range 1 to  99  for
-             processes  scheduled under a real-time policy, or 0, for non-real-
-             time processes (see sched_setscheduler(2)).
-
- policy %u (since Linux 2.5.19; was %lu before Linux 2.6.22)
-             Scheduling policy (see sched_setscheduler(2)).  Decode  using  the
-             SCHED_* constants in linux/sched.h.
-
- delayacct_blkio_ticks %llu (since Linux 2.6.18)
-             Aggregated  block  I/O  delays, measured in clock ticks (centisec‐
-             onds).
+#  include <sys/resource.h>
+#endif // __linux__ or __APPLE__
 
- guest_time %lu (since Linux 2.6.24)
-             Guest time of the process (time spent running a virtual CPU for  a
-             guest  operating  system),  measured  in  clock  ticks  (divide by
-             sysconf(_SC_CLK_TCK).
+/* Format of /proc/self/statm (man 5 proc), all values in pages:
+ size       total program size (same as VmSize in /proc/[pid]/status)
+ resident   resident set size (same as VmRSS in /proc/[pid]/status)
+ shared     number of resident shared pages (i.e., backed by a file)
+ text       text (code)
+ lib        library (unused since Linux 2.6; always 0)
+ data       data + stack
+ dt         dirty pages (unused since Linux 2.6; always 0)
 
- cguest_time %ld (since Linux 2.6.24)
-             Guest time of the process's  children,  measured  in  clock  ticks
-             (divide by sysconf(_SC_CLK_TCK).
+ It is much cheaper to produce and parse than /proc/self/stat.
 */
-struct linux_proc {
-  int                pid;
-  char               comm[400];
-  char               state;
-  int                ppid;
-  int                pgrp;
-  int                session;
-  int                tty;
-  int                tpgid;
-  unsigned long      flags;
-  unsigned long      minflt;
-  unsigned long      cminflt;
-  unsigned long      majflt;
-  unsigned long      cmajflt;
-  unsigned long      utime;
-  unsigned long      stime;
-  long               cutime;
-  long               cstime;
-  long               priority;
-  long               nice;
-  long               num_threads;
-  long               itrealvalue;
-  unsigned long long starttime;
-  unsigned long      vsize;
-  long               rss;
-  unsigned long      rlim;
-  unsigned long      startcode;
-  unsigned long      endcode;
-  unsigned long      startstack;
-  unsigned long      kstkesp;
-  unsigned long      kstkeip;
-  unsigned long      signal;
-  unsigned long      blocked;
-  unsigned long      sigignore;
-  unsigned long      sigcatch;
-  unsigned long      wchan;
-};
-#endif // __linux__ or __APPLE__
 
 ProcStats::cleanup::~cleanup() {
   if ( ProcStats::inst != 0 ) {
@@ -258,64 +56,110 @@ ProcStats::ProcStats() : valid( false ) {
 #if defined( __linux__ ) or defined( __APPLE__ )
   pg_size = sysconf( _SC_PAGESIZE ); // getpagesize();
 
-  fname = "/proc/" + std::to_string( getpid() ) + "/stat";
-
-  fd.open( fname.c_str(), O_RDONLY );
+  fd.open( "/proc/self/statm", O_RDONLY );
   if ( !fd ) {
-    cerr << "Failed to open " << fname << endl;
+    std::cerr << "Failed to open /proc/self/statm" << std::endl;
     return;
   }
 #endif // __linux__ or __APPLE__
   valid = true;
 }
 
-bool ProcStats::fetch( procInfo& f ) {
-  if ( valid == false ) return false;
-
-#if defined( __linux__ ) or defined( __APPLE__ )
-  double     pr_size, pr_rssize;
-  linux_proc pinfo;
-  int        cnt;
-
-  fd.lseek( 0, SEEK_SET );
-
-  if ( ( cnt = fd.read( buf, sizeof( buf ) ) ) < 0 ) {
-    cout << "LINUX Read of Proc file failed:" << endl;
-    return false;
+ProcStats::~ProcStats() { stopSampling(); }
+
+bool ProcStats::parseStatm( std::string_view statm, double pageSize, procInfo& f ) {
+  unsigned long pages[2] = { 0, 0 }; // size, resident
+  const char*   p        = statm.data();
+  const char*   end      = p + statm.size();
+  for ( auto& value : pages ) {
+    while ( p != end && *p == ' ' ) ++p;
+    auto [next, ec] = std::from_chars( p, end, value );
+    if ( ec != std::errc{} ) return false;
+    p = next;
   }
 
-  if ( cnt > 0 ) {
-    buf[std::min( static_cast<std::size_t>( cnt ), sizeof( buf ) - 1 )] = '\0';
-
-    sscanf( buf,
-            // 1  2  3  4  5  6  7  8  9  10  1   2   3   4   5   6   7   8   9   20  1   2   3   4   5   6   7   8   9
-            // 30  1   2   3   4   5
-            "%d %s %c %d %d %d %d %d %lu %lu %lu %lu %lu %lu %lu %ld %ld %ld %ld %ld %ld %llu %lu %ld %lu %lu %lu %lu "
-            "%lu %lu %lu %lu %lu %lu %lu",
-            &pinfo.pid, pinfo.comm, &pinfo.state, &pinfo.ppid, &pinfo.pgrp, &pinfo.session, &pinfo.tty, &pinfo.tpgid,
-            &pinfo.flags, &pinfo.minflt, &pinfo.cminflt, &pinfo.majflt, &pinfo.cmajflt, &pinfo.utime, &pinfo.stime,
-            &pinfo.cutime, &pinfo.cstime, &pinfo.priority, &pinfo.nice, &pinfo.num_threads, &pinfo.itrealvalue,
-            &pinfo.starttime, &pinfo.vsize, &pinfo.rss, &pinfo.rlim, &pinfo.startcode, &pinfo.endcode,
-            &pinfo.startstack, &pinfo.kstkesp, &pinfo.kstkeip, &pinfo.signal, &pinfo.blocked, &pinfo.sigignore,
-            &pinfo.sigcatch, &pinfo.wchan );
+  f.vsize = pages[0] * pageSize / ( 1024 * 1024 );
+  f.rss   = pages[1] * pageSize / ( 1024 * 1024 );
+  return true;
+}
 
-    // resident set size in pages
-    pr_size   = (double)pinfo.vsize;
-    pr_rssize = (double)pinfo.rss;
+bool ProcStats::read( procInfo& f ) const {
+  if ( valid == false ) return false;
 
-    f.vsize = pr_size / ( 1024 * 1024 );
-    f.rss   = pr_rssize * pg_size / ( 1024 * 1024 );
-  }
+#if defined( __linux__ ) or defined( __APPLE__ )
+  // no allocation and no shared buffer: can be called from any thread
+  char buf[128];
+  auto cnt = fd.pread( buf, sizeof( buf ), 0 );
+  if ( cnt <= 0 ) return false;
 
+  return parseStatm( { buf, static_cast<std::size_t>( cnt ) }, pg_size, f );
 #else
   f.vsize = 0;
   f.rss   = 0;
 #endif // __linux__ or __APPLE__
 
-  bool rc = ( curr == f ) ? false : true;
+  return true;
+}
+
+bool ProcStats::update( const procInfo& f ) {
+  // both exchanges must be done
+  const bool vsizeChanged = curr_vsize.exchange( f.vsize ) != f.vsize;
+  const bool rssChanged   = curr_rss.exchange( f.rss ) != f.rss;
+  return vsizeChanged || rssChanged;
+}
 
-  curr.rss   = f.rss;
-  curr.vsize = f.vsize;
+bool ProcStats::fetch( procInfo& f ) { return read( f ) && update( f ); }
 
-  return rc;
+bool ProcStats::sample( procInfo& f ) {
+  if ( !sampling.load( std::memory_order_acquire ) ) return fetch( f );
+  f.vsize = last_vsize.load( std::memory_order_relaxed );
+  f.rss   = last_rss.load( std::memory_order_relaxed );
+  return update( f );
+}
+
+void ProcStats::startSampling( std::chrono::duration<double> period, std::function<void( const Sample& )> callback ) {
+  stopSampling();
+  if ( !valid ) return;
+
+  auto takeSample = [this]( Sample& s ) {
+    s.time = std::chrono::steady_clock::now();
+    if ( !read( s.info ) ) return false;
+#if defined( __linux__ ) or defined( __APPLE__ )
+    rusage usage;
+    getrusage( RUSAGE_SELF, &usage );
+    s.minorFaults = usage.ru_minflt;
+    s.majorFaults = usage.ru_majflt;
+#endif // __linux__ or __APPLE__
+    last_vsize.store( s.info.vsize, std::memory_order_relaxed );
+    last_rss.store( s.info.rss, std::memory_order_relaxed );
+    return true;
+  };
+
+  // first sample before returning, so that sample() is immediately meaningful
+  Sample first{};
+  if ( !takeSample( first ) ) return;
+  sampling.store( true, std::memory_order_release );
+  sampler_stop = false;
+
+  sampler = std::thread{ [this, period, takeSample, callback = std::move( callback ), first]() {
+    if ( callback ) callback( first );
+    std::unique_lock lock{ sampler_mutex };
+    while ( !sampler_wakeup.wait_for( lock, period, [this] { return sampler_stop; } ) ) {
+      lock.unlock();
+      Sample s{};
+      if ( takeSample( s ) && callback ) callback( s );
+      lock.lock();
+    }
+  } };
+}
+
+void ProcStats::stopSampling() {
+  if ( !sampler.joinable() ) return;
+  {
+    std::scoped_lock lock{ sampler_mutex };
+    sampler_stop = true;
+  }
+  sampler_wakeup.notify_one();
+  sampler.join();
+  sampling.store( false, std::memory_order_release );
 }
@@ -15,7 +15,14 @@
 // Description:  Keeps statistics on memory usage
 // Author: Jim Kowalkowski (FNAL), modified by M. Shapiro (LBNL)
 
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <functional>
+#include <mutex>
 #include <string>
+#include <string_view>
+#include <thread>
 #include <vector>
 #if defined( __linux__ ) or defined( __APPLE__ )
 #  include <fcntl.h>
@@ -52,11 +59,37 @@ class ProcStats {
 public:
   static ProcStats* instance();
 
-  bool   fetch( procInfo& fill_me );
+  /// Read the current memory usage, returning false if it could not be read or did not change since the previous
+  /// call (of fetch or sample).
+  bool fetch( procInfo& fill_me );
+  /// Same as fetch, but using the latest sample of the background sampler, if running, instead of reading /proc.
+  bool   sample( procInfo& fill_me );
   double pageSize() const { return pg_size; }
 
+  /// Parse the content of /proc/self/statm (sizes in pages of pageSize bytes) into fill_me (sizes in MB),
+  /// returning false if it is malformed.
+  static bool parseStatm( std::string_view statm, double pageSize, procInfo& fill_me );
+
+  /// Sample taken by the background sampler.
+  struct Sample {
+    std::chrono::steady_clock::time_point time;
+    procInfo                              info;
+    long                                  minorFaults; ///< since the start of the process
+    long                                  majorFaults; ///< since the start of the process
+  };
+  /// Start sampling the memory usage in a background thread, passing each sample to the callback (in that thread).
+  void startSampling( std::chrono::duration<double> period, std::function<void( const Sample& )> callback );
+  /// Stop the background sampler, if running.
+  void stopSampling();
+
 private:
   ProcStats();
+  ~ProcStats();
+
+  /// Read the memory usage, without side effects.
+  bool read( procInfo& fill_me ) const;
+  /// Record f as the current value, returning true if it changed.
+  bool update( const procInfo& f );
 
   struct cleanup {
     cleanup() {}
@@ -92,7 +125,7 @@ private:
     return ::fun( m_fd, std::forward<Args>( args )... );                                                               \
   }
     unique_fd_forward( lseek ) unique_fd_forward( read ) unique_fd_forward( write ) unique_fd_forward( fcntl )
-        unique_fd_forward( fsync ) unique_fd_forward( fchown ) unique_fd_forward( stat )
+        unique_fd_forward( fsync ) unique_fd_forward( pread ) unique_fd_forward( fchown ) unique_fd_forward( stat )
 #undef unique_fd_forward
             int close() {
       auto r = ::close( m_fd );
@@ -101,12 +134,21 @@ private:
     }
   };
 
-  unique_fd   fd;
-  double      pg_size;
-  procInfo    curr;
-  std::string fname;
-  char        buf[500];
-  bool        valid;
+  unique_fd fd;
+  double    pg_size;
+  bool      valid;
+
+  /// value of the previous call of fetch or sample
+  std::atomic<double> curr_vsize{ 0 }, curr_rss{ 0 };
+
+  /// latest sample of the background sampler
+  std::atomic<double> last_vsize{ 0 }, last_rss{ 0 };
+  std::atomic<bool>   sampling{ false };
+
+  std::thread             sampler;
+  std::mutex              sampler_mutex;
+  std::condition_variable sampler_wakeup;
+  bool                    sampler_stop = false;
 
   static ProcStats* inst;
 };
@@ -0,0 +1,76 @@
+/***********************************************************************************\
+* (c) Copyright 2022 CERN for the benefit of the LHCb and ATLAS collaborations      *
+*                                                                                   *
+* This software is distributed under the terms of the Apache version 2 licence,     *
+* copied verbatim in the file "LICENSE".                                            *
+*                                                                                   *
+* In applying this licence, CERN does not waive the privileges and immunities       *
+* granted to it by virtue of its status as an Intergovernmental Organization        *
+* or submit itself to any jurisdiction.                                             *
+\***********************************************************************************/
+#define BOOST_TEST_DYN_LINK
+#define BOOST_TEST_MODULE test_ProcStats
+#include <boost/test/unit_test.hpp>
+
+#include "../../src/ProcStats.h"
+
+#include <atomic>
+#include <chrono>
+#include <thread>
+
+BOOST_AUTO_TEST_CASE( parse_statm ) {
+  procInfo info;
+  // 1 GB of virtual memory, 512 MB resident, with 4 kB pages
+  BOOST_REQUIRE( ProcStats::parseStatm( "262144 131072 2000 300 0 50000 0\n", 4096, info ) );
+  BOOST_CHECK_EQUAL( info.vsize, 1024. );
+  BOOST_CHECK_EQUAL( info.rss, 512. );
+
+  // fractions of MB, with 64 kB pages
+  BOOST_REQUIRE( ProcStats::parseStatm( "40 8 1 1 0 1 0\n", 65536, info ) );
+  BOOST_CHECK_EQUAL( info.vsize, 2.5 );
+  BOOST_CHECK_EQUAL( info.rss, 0.5 );
+
+  // only the first two values are needed, the rest may be truncated
+  BOOST_REQUIRE( ProcStats::parseStatm( "256 128", 4096, info ) );
+  BOOST_CHECK_EQUAL( info.vsize, 1. );
+  BOOST_CHECK_EQUAL( info.rss, 0.5 );
+}
+
+BOOST_AUTO_TEST_CASE( parse_malformed_statm ) {
+  procInfo info{ 1, 2 };
+  BOOST_CHECK( !ProcStats::parseStatm( "", 4096, info ) );
+  BOOST_CHECK( !ProcStats::parseStatm( "256", 4096, info ) );
+  BOOST_CHECK( !ProcStats::parseStatm( "256 x", 4096, info ) );
+  BOOST_CHECK( !ProcStats::parseStatm( "-256 128", 4096, info ) );
+  // not modified
+  BOOST_CHECK( info == procInfo( 1, 2 ) );
+}
+
+#if defined( __linux__ )
+BOOST_AUTO_TEST_CASE( read_own_process ) {
+  auto     stats = ProcStats::instance();
+  procInfo info;
+  // the first call always reports a change
+  BOOST_REQUIRE( stats->fetch( info ) );
+  BOOST_CHECK_GT( info.rss, 0 );
+  BOOST_CHECK_GE( info.vsize, info.rss );
+  BOOST_CHECK_EQUAL( stats->pageSize(), sysconf( _SC_PAGESIZE ) );
+
+  // samples of the background thread, with the same units
+  std::atomic<int>  samples{ 0 };
+  std::atomic<bool> consistent{ true };
+  stats->startSampling( std::chrono::milliseconds( 1 ), [&]( const ProcStats::Sample& s ) {
+    if ( !( s.info.rss > 0 && s.info.vsize >= s.info.rss && s.info.vsize < 2 * info.vsize + 1024 ) ) {
+      consistent = false;
+    }
+    ++samples;
+  } );
+  while ( samples < 3 ) std::this_thread::sleep_for( std::chrono::milliseconds( 1 ) );
+  stats->stopSampling();
+  BOOST_CHECK( consistent );
+
+  procInfo sampled;
+  stats->sample( sampled );
+  BOOST_CHECK_GT( sampled.rss, 0 );
+}
+#endif
@@ -17,6 +17,8 @@
 
 #include <TDirectory.h>
 #include <TFile.h>
+#include <TH1.h>
+#include <TROOT.h>
 
 #include <range/v3/numeric/accumulate.hpp>
 #include <range/v3/range/conversion.hpp>
@@ -32,10 +34,17 @@ namespace ranges::views {
 #include <nlohmann/json.hpp>
 
 #include <algorithm>
+#include <atomic>
+#include <condition_variable>
 #include <deque>
+#include <exception>
 #include <functional>
 #include <map>
+#include <memory>
+#include <mutex>
 #include <string>
+#include <thread>
+#include <typeindex>
 #include <vector>
 
 namespace {
@@ -55,12 +64,56 @@ namespace Gaudi::Histograming::Sink {
       std::string  title;
     };
 
-    Axis toAxis( nlohmann::json& jAxis ) {
+    Axis toAxis( nlohmann::json const& jAxis ) {
       return { jAxis.at( "nBins" ).get<unsigned int>(), jAxis.at( "minValue" ).get<double>(),
                jAxis.at( "maxValue" ).get<double>(),
                ";" + jAxis.at( "title" ).get<std::string>() }; // ";" to prepare concatenations of titles
     }
 
+    /**
+     * directory and name under which to save an entity, given its component and name
+     *
+     * names starting with '/' are absolute, and the part preceding the last '/' is moved to the directory
+     */
+    inline std::pair<std::string, std::string> splitPath( std::string dir, std::string name ) {
+      if ( name[0] == '/' ) {
+        dir  = "";
+        name = name.substr( 1 );
+      }
+
+      // take into account the case where name contains '/'s (e.g. "Group/Name") by
+      // moving the prefix into dir
+      if ( auto pos = name.rfind( '/' ); pos != std::string::npos ) {
+        dir += '/' + name.substr( 0, pos );
+        name = name.substr( pos + 1 );
+      }
+      return { std::move( dir ), std::move( name ) };
+    }
+
+    /// find or create (recursively) the given directory in a file
+    inline TDirectory* getOrCreateDirectory( TFile& file, std::string const& dir ) {
+      using namespace ranges;
+      auto is_delimiter        = []( auto c ) { return c == '/' || c == '.'; };
+      auto transform_to_string = views::transform( []( auto&& rng ) { return rng | to<std::string>; } );
+
+      auto currentDir = accumulate( dir | views::split_when( is_delimiter ) | transform_to_string,
+                                    file.GetDirectory( "" ), []( auto current, auto&& dir_level ) {
+                                      if ( current ) {
+                                        // try to get next level
+                                        auto nextDir = current->GetDirectory( dir_level.c_str() );
+                                        // if it does not exist, create it
+                                        if ( !nextDir ) nextDir = current->mkdir( dir_level.c_str() );
+                                        // move to next level
+                                        current = nextDir;
+                                      }
+                                      return current;
+                                    } );
+
+      if ( !currentDir )
+        throw GaudiException( "Could not create directory " + dir, "Histogram::Sink::Root", StatusCode::FAILURE );
+      return currentDir;
+    }
+
     /**
      * generic function to handle histograms - internal implemenatation
      */
@@ -79,45 +132,13 @@ namespace Gaudi::Histograming::Sink {
       auto totNBins = ( ( axis[index].nBins + 2 ) * ... );
       assert( weights.size() == totNBins );
 
-      if ( name[0] == '/' ) {
-        dir  = "";
-        name = name.substr( 1 );
-      }
-
-      // take into account the case where name contains '/'s (e.g. "Group/Name") by
-      // moving the prefix into dir
-      if ( auto pos = name.rfind( '/' ); pos != std::string::npos ) {
-        dir += '/' + name.substr( 0, pos );
-        name = name.substr( pos + 1 );
-      }
+      std::tie( dir, name ) = splitPath( std::move( dir ), std::move( name ) );
 
       // remember the current directory
       auto previousDir = gDirectory;
 
-      // find or create the directory for the histogram
-      {
-        using namespace ranges;
-        auto is_delimiter        = []( auto c ) { return c == '/' || c == '.'; };
-        auto transform_to_string = views::transform( []( auto&& rng ) { return rng | to<std::string>; } );
-
-        auto currentDir = accumulate( dir | views::split_when( is_delimiter ) | transform_to_string,
-                                      file.GetDirectory( "" ), []( auto current, auto&& dir_level ) {
-                                        if ( current ) {
-                                          // try to get next level
-                                          auto nextDir = current->GetDirectory( dir_level.c_str() );
-                                          // if it does not exist, create it
-                                          if ( !nextDir ) nextDir = current->mkdir( dir_level.c_str() );
-                                          // move to next level
-                                          current = nextDir;
-                                        }
-                                        return current;
-                                      } );
-
-        if ( !currentDir )
-          throw GaudiException( "Could not create directory " + dir, "Histogram::Sink::Root", StatusCode::FAILURE );
-        // switch to the directory
-        currentDir->cd();
-      }
+      // find or create the directory for the histogram and switch to it
+      getOrCreateDirectory( file, dir )->cd();
 
       // Create Root histogram calling constructors with the args tuple
       auto histo = Traits::create( name, title, axis[index]... );
@@ -159,6 +180,14 @@ namespace Gaudi::Histograming::Sink {
    * a Base class for Root related Sinks dealing with Histograms.
    *
    * provides the common method plus a generic way of registering handler for different types
+   *
+   * Entities can be handled in two ways :
+   *   - by a converter, building a ROOT histogram from the entity, either from its JSON representation
+   *     (registered per type and dimension) or directly from its internal data (registered per internal type,
+   *     used when the DirectConversion property is set). Converters run in parallel, in NumberOfThreads threads,
+   *     and only the writing of the resulting histograms to the file is sequential
+   *   - by a handler, writing the entity to the file from its JSON representation. Handlers are always
+   *     called sequentially, as they access the file
    */
   class Base : public Service, public Gaudi::Monitoring::Hub::Sink {
   public:
@@ -166,6 +195,14 @@ namespace Gaudi::Histograming::Sink {
     using HistoHandler        = std::function<void( TFile& file, std::string, std::string, nlohmann::json& )>;
     using HistoRegistry       = std::map<HistoIdentification, HistoHandler>;
 
+    /// builds a ROOT histogram, not attached to any directory, from the JSON representation of an entity
+    using HistoConverter = std::function<std::unique_ptr<TH1>( std::string const& name, nlohmann::json const& )>;
+    using HistoConverterRegistry = std::map<HistoIdentification, HistoConverter>;
+    /// builds a ROOT histogram, not attached to any directory, directly from the internal data of an entity
+    using HistoDirectConverter =
+        std::function<std::unique_ptr<TH1>( std::string const& name, Monitoring::Hub::Entity const& )>;
+    using HistoDirectConverterRegistry = std::map<std::type_index, HistoDirectConverter>;
+
     Base( std::string name, ISvcLocator* svcloc,
           std::function<bool( Monitoring::Hub::Entity const& )> const isRelevant = isHistogram )
         : Service( name, svcloc ), m_isRelevant( std::move( isRelevant ) ) {}
@@ -182,16 +219,63 @@ namespace Gaudi::Histograming::Sink {
         return std::tie( a.name, a.component ) > std::tie( b.name, b.component );
       } );
       TFile histoFile( m_fileName.value().c_str(), "RECREATE" );
-      std::for_each( begin( m_monitoringEntities ), end( m_monitoringEntities ), [&histoFile, this]( auto& ent ) {
-        auto j    = ent.toJSON();
-        auto dim  = j.at( "dimension" ).template get<unsigned int>();
-        auto type = j.at( "type" ).template get<std::string>();
-        // cut type after last ':' if there is one. The rest is precision parameter that we do not need here
-        // as ROOT anyway treats everything as doubles in histograms
-        type       = type.substr( 0, type.find_last_of( ':' ) );
-        auto saver = m_registry.find( { type, dim } );
-        if ( saver != m_registry.end() ) ( saver->second )( histoFile, ent.component, ent.name, j );
-      } );
+
+      // histograms are built in parallel, detached from any directory, and written in order by this thread
+      ROOT::EnableThreadSafety();
+      const bool addDirectory = TH1::AddDirectoryStatus();
+      TH1::AddDirectory( false );
+
+      const auto               nEntities = m_monitoringEntities.size();
+      std::vector<Converted>   converted( nEntities );
+      std::vector<char>        ready( nEntities, false );
+      std::mutex               readyMutex;
+      std::condition_variable  readyCond;
+      std::atomic<std::size_t> next{ 0 };
+
+      auto work = [&] {
+        for ( auto i = next++; i < nEntities; i = next++ ) {
+          try {
+            convert( m_monitoringEntities[i], converted[i] );
+          } catch ( ... ) { converted[i].error = std::current_exception(); }
+          {
+            std::scoped_lock lock{ readyMutex };
+            ready[i] = true;
+          }
+          readyCond.notify_one();
+        }
+      };
+      std::vector<std::thread> workers;
+      const unsigned int       nThreads =
+          m_nThreads > 0 ? m_nThreads.value() : std::max( 1u, std::thread::hardware_concurrency() );
+      for ( unsigned int t = 0; t < std::min<std::size_t>( nThreads, nEntities ); ++t ) workers.emplace_back( work );
+
+      std::exception_ptr error;
+      for ( std::size_t i = 0; i < nEntities && !error; ++i ) {
+        {
+          std::unique_lock lock{ readyMutex };
+          readyCond.wait( lock, [&] { return ready[i]; } );
+        }
+        auto& ent = m_monitoringEntities[i];
+        auto& c   = converted[i];
+        try {
+          if ( c.error ) std::rethrow_exception( c.error );
+          if ( c.histo ) {
+            auto [dir, name] = details::splitPath( ent.component, ent.name );
+            details::getOrCreateDirectory( histoFile, dir )->WriteTObject( c.histo.get() );
+          } else if ( c.handler ) {
+            ( *c.handler )( histoFile, ent.component, ent.name, c.json );
+          }
+        } catch ( ... ) {
+          error = std::current_exception();
+          // no need to convert the remaining entities
+          next = nEntities;
+        }
+        // release the memory as soon as possible
+        c = {};
+      }
+      for ( auto& w : workers ) w.join();
+      TH1::AddDirectory( addDirectory );
+      if ( error ) std::rethrow_exception( error );
       return ok;
     }
 
@@ -208,9 +292,51 @@ namespace Gaudi::Histograming::Sink {
       m_registry.emplace( std::piecewise_construct, std::make_tuple( id ), std::make_tuple( func ) );
     }
 
+    void registerConverter( HistoIdentification const& id, HistoConverter const& func ) {
+      m_converters.emplace( id, func );
+    }
+
+    void registerDirectConverter( std::type_index const& id, HistoDirectConverter const& func ) {
+      m_directConverters.emplace( id, func );
+    }
+
   private:
+    /// result of the conversion of one entity
+    struct Converted {
+      std::unique_ptr<TH1> histo;
+      /// JSON representation, kept when the entity has to be written by a handler
+      nlohmann::json      json;
+      HistoHandler const* handler{ nullptr };
+      std::exception_ptr  error;
+    };
+
+    /// converts an entity, using the first possible method among direct conversion, converter and handler
+    void convert( Monitoring::Hub::Entity const& ent, Converted& out ) const {
+      auto name = details::splitPath( ent.component, ent.name ).second;
+      if ( m_directConversion ) {
+        if ( auto conv = m_directConverters.find( ent.typeIndex() ); conv != m_directConverters.end() ) {
+          out.histo = ( conv->second )( name, ent );
+          return;
+        }
+      }
+      auto j    = ent.toJSON();
+      auto dim  = j.at( "dimension" ).template get<unsigned int>();
+      auto type = j.at( "type" ).template get<std::string>();
+      // cut type after last ':' if there is one. The rest is precision parameter that we do not need here
+      // as ROOT anyway treats everything as doubles in histograms
+      type = type.substr( 0, type.find_last_of( ':' ) );
+      if ( auto conv = m_converters.find( { type, dim } ); conv != m_converters.end() ) {
+        out.histo = ( conv->second )( name, j );
+      } else if ( auto saver = m_registry.find( { type, dim } ); saver != m_registry.end() ) {
+        out.json    = std::move( j );
+        out.handler = &saver->second;
+      }
+    }
+
     /// map of supported type and the way to handle them
-    HistoRegistry m_registry{};
+    HistoRegistry                m_registry{};
+    HistoConverterRegistry       m_converters{};
+    HistoDirectConverterRegistry m_directConverters{};
 
     /// function saying whether a given entity is relevant for this Sink
     std::function<bool( Monitoring::Hub::Entity const& )> const m_isRelevant;
@@ -218,8 +344,13 @@ namespace Gaudi::Histograming::Sink {
     /// list of entities handled by this Sink
     std::deque<Gaudi::Monitoring::Hub::Entity> m_monitoringEntities;
 
-    Gaudi::Property<std::string> m_fileName{ this, "FileName", "testHisto.root",
+    Gaudi::Property<std::string>  m_fileName{ this, "FileName", "testHisto.root",
                                              "Name of file where to save histograms" };
+    Gaudi::Property<unsigned int> m_nThreads{
+        this, "NumberOfThreads", 0, "Number of threads converting the histograms, 0 meaning one per core" };
+    Gaudi::Property<bool> m_directConversion{
+        this, "DirectConversion", false,
+        "Convert the histograms of known types directly from their bins, instead of going through JSON" };
   };
 
 } // namespace Gaudi::Histograming::Sink
@@ -24,6 +24,7 @@
 // GaudiKernel
 // ============================================================================
 #include "GaudiKernel/ChronoEntity.h"
+#include "GaudiKernel/ConcurrencyFlags.h"
 #include "GaudiKernel/IChronoStatSvc.h"
 #include "GaudiKernel/IHiveWhiteBoard.h"
 #include "GaudiKernel/IIncidentSvc.h"
@@ -131,8 +132,15 @@ StatusCode ChronoStatSvc::finalize() {
   /// stop its own chrono
   chronoStop( name() );
 
+  /// collect the chronos accessed by handle
+  mergeThreadChronos();
+
   if ( m_ofd.is_open() ) {
     debug() << "writing per-event timing data to '" << m_perEventFile << "'" << endmsg;
+    if ( Gaudi::Concurrency::ConcurrencyFlags::concurrent() ) {
+      info() << "per-event timing data of the chronos accessed by handle are written only in sequential jobs"
+             << endmsg;
+    }
     for ( const auto& itr : m_perEvtTime ) {
       m_ofd << itr.first.substr( 0, itr.first.length() - 8 ) << " ";
       for ( const auto& itt : itr.second ) { m_ofd << " " << (long int)( itt ); }
@@ -291,6 +299,60 @@ const ChronoEntity* ChronoStatSvc::chronoStop( const IChronoStatSvc::ChronoTag&
   return &entity;
 }
 // ============================================================================
+// Implementation of IChronoStatSvc::chronoHandle
+// ============================================================================
+IChronoStatSvc::ChronoHandle ChronoStatSvc::chronoHandle( const IChronoStatSvc::ChronoTag& chronoTag ) {
+  auto lock = std::scoped_lock{ m_handleMutex };
+  auto it   = m_handles.find( chronoTag );
+  if ( it == m_handles.end() ) {
+    it = m_handles.emplace( chronoTag, static_cast<ChronoHandle>( m_handleTags.size() ) ).first;
+    m_handleTags.push_back( chronoTag );
+  }
+  return it->second;
+}
+// ============================================================================
+// Implementation of IChronoStatSvc::chronoStart
+// ============================================================================
+ChronoEntity* ChronoStatSvc::chronoStart( ChronoHandle handle ) {
+  ChronoEntity& entity = getEntity( handle );
+  entity.start();
+  return &entity;
+}
+// ============================================================================
+// Implementation of IChronoStatSvc::chronoStop
+// ============================================================================
+const ChronoEntity* ChronoStatSvc::chronoStop( ChronoHandle handle ) {
+  ChronoEntity& entity = getEntity( handle );
+  entity.stop();
+  return &entity;
+}
+// ============================================================================
+// chrono of the current thread for a handle
+// ============================================================================
+ChronoEntity& ChronoStatSvc::getEntity( ChronoHandle handle ) {
+  auto&      entities = m_threadChronos.local().entities;
+  const auto index    = static_cast<std::size_t>( handle );
+  if ( index >= entities.size() ) {
+    // only the current thread modifies its chronos, the lock is there for mergeThreadChronos
+    auto lock = std::scoped_lock{ m_handleMutex };
+    entities.resize( m_handleTags.size() );
+  }
+  return entities[index];
+}
+// ============================================================================
+// add the chronos of all threads to m_chronoEntities, resetting them
+// ============================================================================
+void ChronoStatSvc::mergeThreadChronos() {
+  auto lock = std::scoped_lock{ m_mutex, m_handleMutex };
+  m_threadChronos.forEach( [&]( ThreadChronos& chronos ) {
+    for ( std::size_t i = 0; i < chronos.entities.size(); ++i ) {
+      const auto& entity = chronos.entities[i];
+      if ( entity.nOfMeasurements() > 0 ) m_chronoEntities[m_handleTags[i]] += entity;
+    }
+    chronos.entities.clear();
+  } );
+}
+// ============================================================================
 // Implementation of IChronoStatSvc::chronoDelta
 // ============================================================================
 IChronoStatSvc::ChronoTime ChronoStatSvc::chronoDelta( const IChronoStatSvc::ChronoTag& chronoTag,
@@ -524,6 +586,19 @@ void ChronoStatSvc::handle( const Incident& /* inc */ ) {
       itm->second.push_back( itr.second.delta( IChronoSvc::ELAPSED ) );
     }
   }
+
+  // chronos accessed by handle, as measured by the current thread: they are the ones of the event
+  // only in sequential jobs (in MT the event was processed by other threads)
+  if ( Gaudi::Concurrency::ConcurrencyFlags::concurrent() ) return;
+  std::vector<ChronoTag> handleTags;
+  {
+    auto hlock = std::scoped_lock{ m_handleMutex };
+    handleTags = m_handleTags;
+  }
+  for ( std::size_t i = 0; i < handleTags.size(); ++i ) {
+    if ( handleTags[i].find( ":Execute" ) == std::string::npos ) continue;
+    m_perEvtTime[handleTags[i]].push_back( getEntity( static_cast<ChronoHandle>( i ) ).delta( IChronoSvc::ELAPSED ) );
+  }
 }
 
 // ============================================================================
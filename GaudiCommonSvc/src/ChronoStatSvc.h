@@ -15,14 +15,18 @@
 // STD & STL
 // ============================================================================
 #include <atomic>
+#include <deque>
 #include <fstream>
 #include <functional>
 #include <map>
+#include <memory>
 #include <mutex>
 #include <string>
+#include <vector>
 // ============================================================================
 // GaudiKernel
 // ============================================================================
+#include "Gaudi/Concurrency/PerThread.h"
 #include "GaudiKernel/IChronoStatSvc.h"
 #include "GaudiKernel/IIncidentListener.h"
 #include "GaudiKernel/Kernel.h"
@@ -104,6 +108,21 @@ public:
    */
   const ChronoEntity* chrono( const IChronoStatSvc::ChronoTag& t ) const override;
   // ============================================================================
+  /** Implementation of IChronoStatSvc::chronoHandle
+   *  @see IChronoStatSvc
+   */
+  ChronoHandle chronoHandle( const IChronoStatSvc::ChronoTag& chronoTag ) override;
+  // ============================================================================
+  /** Implementation of IChronoStatSvc::chronoStart
+   *  @see IChronoStatSvc
+   */
+  ChronoEntity* chronoStart( ChronoHandle handle ) override;
+  // ============================================================================
+  /** Implementation of IChronoStatSvc::chronoStop
+   *  @see IChronoStatSvc
+   */
+  const ChronoEntity* chronoStop( ChronoHandle handle ) override;
+  // ============================================================================
   /** extract the stat   entity for the given tag (name)
    *  @see IChronoStatSvc
    *  @param t stat   tag(name)
@@ -152,6 +171,12 @@ private:
     return m_chronoEntities[chronoTag];
   }
 
+  /// chrono of the current thread for a handle
+  ChronoEntity& getEntity( ChronoHandle handle );
+
+  /// add the chronos of all threads to m_chronoEntities, resetting them
+  void mergeThreadChronos();
+
   // basically limit the integer to MSG::Level range
   static MSG::Level int2level( int l ) {
     return static_cast<MSG::Level>(
@@ -163,6 +188,17 @@ private:
   /// Mutex protecting m_chronoEntities.
   mutable std::mutex m_mutex;
 
+  /// chronos of one thread, indexed by handle
+  struct ThreadChronos {
+    std::deque<ChronoEntity> entities;
+  };
+  /// tags of the chronos accessed by handle, indexed by handle
+  std::vector<ChronoTag>                       m_handleTags;
+  std::map<ChronoTag, ChronoHandle>            m_handles;
+  Gaudi::Concurrency::PerThread<ThreadChronos> m_threadChronos;
+  /// Mutex protecting the handles and the growth of the per-thread chronos.
+  mutable std::mutex m_handleMutex;
+
   /// level of info printing
   MSG::Level m_chronoPrintLevel = MSG::INFO;
 
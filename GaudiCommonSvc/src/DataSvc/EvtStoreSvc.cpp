@@ -10,15 +10,21 @@
 \***********************************************************************************/
 #include "Gaudi/Accumulators.h"
 #include "Gaudi/Arena/Monotonic.h"
+#include "Gaudi/Interfaces/IDataObjectRecycler.h"
+#include "Gaudi/Interfaces/ISharedDataStore.h"
+#include "Gaudi/Monitoring/StoreMemoryMonitor.h"
 #include "GaudiKernel/ConcurrencyFlags.h"
+#include "GaudiKernel/EventContext.h"
 #include "GaudiKernel/IConversionSvc.h"
 #include "GaudiKernel/IDataManagerSvc.h"
 #include "GaudiKernel/IDataProviderSvc.h"
 #include "GaudiKernel/IHiveWhiteBoard.h"
 #include "GaudiKernel/IOpaqueAddress.h"
 #include "GaudiKernel/IRegistry.h"
+#include "GaudiKernel/LinkManager.h"
 #include "GaudiKernel/Service.h"
 #include "GaudiKernel/System.h"
+#include "GaudiKernel/ThreadLocalContext.h"
 #include "tbb/concurrent_queue.h"
 
 #include "ThreadLocalStorage.h"
@@ -26,12 +32,16 @@
 #include "boost/algorithm/string/predicate.hpp"
 
 #include <algorithm>
+#include <atomic>
 #include <iomanip>
 #include <iterator>
 #include <map>
 #include <mutex>
+#include <optional>
+#include <shared_mutex>
 #include <stdexcept>
 #include <type_traits>
+#include <typeindex>
 #include <unordered_map>
 #include <utility>
 #include <vector>
@@ -53,7 +63,8 @@ namespace {
 
   public:
     using allocator_type = LocalAlloc<char>;
-    static void setDataProviderSvc( IDataProviderSvc* p ) { s_svc = p; }
+    static void              setDataProviderSvc( IDataProviderSvc* p ) { s_svc = p; }
+    static IDataProviderSvc* dataProviderSvc() { return s_svc; }
 
     Entry( std::string_view id, std::unique_ptr<DataObject> data, std::unique_ptr<IOpaqueAddress> addr,
            allocator_type alloc ) noexcept
@@ -79,6 +90,8 @@ namespace {
       return *m_identifier;
     }
     std::string_view  identifierView() const { return m_identifierStorage; }
+    /// Take the ownership of the object away from the entry
+    std::unique_ptr<DataObject> extractObject() { return std::move( m_data ); }
     IDataProviderSvc* dataSvc() const override { return s_svc; }
     DataObject*       object() const override { return const_cast<DataObject*>( m_data.get() ); }
     IOpaqueAddress*   address() const override { return m_addr.get(); }
@@ -89,6 +102,37 @@ namespace {
   };
   IDataProviderSvc* Entry::s_svc = nullptr;
 
+  /// Registry of an object shared by all the event slots (possibly only within an IOV).
+  class SharedEntry final : public IRegistry {
+    std::shared_ptr<DataObject> m_data;
+    std::string                 m_identifier;
+    std::optional<EventIDRange> m_iov;
+
+  public:
+    SharedEntry( std::string_view id, std::shared_ptr<DataObject> data, std::optional<EventIDRange> iov )
+        : m_data{ std::move( data ) }, m_identifier{ id }, m_iov{ std::move( iov ) } {
+      m_data->setRegistry( this );
+    }
+    ~SharedEntry() override {
+      if ( m_data->registry() == this ) m_data->setRegistry( nullptr );
+    }
+    SharedEntry( const SharedEntry& ) = delete;
+    SharedEntry& operator=( const SharedEntry& ) = delete;
+
+    bool hasIOV() const { return m_iov.has_value(); }
+    bool isValidFor( const EventIDBase& id ) const { return !m_iov || m_iov->isInRange( id ); }
+
+    // required by IRegistry...
+    unsigned long     addRef() override { return -1; }
+    unsigned long     release() override { return -1; }
+    const name_type&  name() const override { return m_identifier; }
+    const id_type&    identifier() const override { return m_identifier; }
+    IDataProviderSvc* dataSvc() const override { return Entry::dataProviderSvc(); }
+    DataObject*       object() const override { return m_data.get(); }
+    IOpaqueAddress*   address() const override { return nullptr; }
+    void              setAddress( IOpaqueAddress* ) override {}
+  };
+
   using UnorderedMap =
       std::unordered_map<std::string_view, Entry, std::hash<std::string_view>, std::equal_to<std::string_view>,
                          LocalAlloc<std::pair<const std::string_view, Entry>>>;
@@ -142,6 +186,14 @@ namespace {
       return i != m_store->end() ? &( i->second ) : nullptr;
     }
 
+    /// Pass the ownership of all the objects in the store to f (e.g. before a reset)
+    template <typename Fun>
+    void extract_objects( Fun&& f ) {
+      for ( auto& [k, entry] : *m_store ) {
+        if ( auto obj = entry.extractObject() ) f( std::move( obj ) );
+      }
+    }
+
     [[nodiscard]] auto begin() const noexcept { return m_store->begin(); }
     [[nodiscard]] auto end() const noexcept { return m_store->end(); }
     void               clear() noexcept { m_store->clear(); }
@@ -181,6 +233,48 @@ namespace {
     return object;
   }
 
+  /// Per-slot pool of DataObject instances kept for reuse in later events.
+  class RecyclingPool {
+  public:
+    using Resetter = Gaudi::Interfaces::IDataObjectRecycler::Resetter;
+    struct Bin {
+      Resetter                                 reset = nullptr;
+      std::vector<std::unique_ptr<DataObject>> free;
+      std::size_t                              hits   = 0;
+      std::size_t                              misses = 0;
+    };
+
+    /// Get an instance of the given type (if any), enabling recycling for the type.
+    std::unique_ptr<DataObject> acquire( const std::type_info& type, Resetter reset ) {
+      auto& bin = m_bins[type];
+      if ( !bin.reset ) bin.reset = reset;
+      if ( bin.free.empty() ) {
+        ++bin.misses;
+        return {};
+      }
+      ++bin.hits;
+      auto obj = std::move( bin.free.back() );
+      bin.free.pop_back();
+      return obj;
+    }
+    /// Keep the object for later use if its type is recycled and the pool is not full,
+    /// otherwise leave it to the caller (which will delete it).
+    void recycle( std::unique_ptr<DataObject>& obj, std::size_t maxPerType ) {
+      auto i = m_bins.find( typeid( *obj ) );
+      if ( i == m_bins.end() || i->second.free.size() >= maxPerType ) return;
+      obj->setRegistry( nullptr );
+      if ( auto links = obj->linkMgr() ) links->clearLinks();
+      i->second.reset( *obj );
+      i->second.free.push_back( std::move( obj ) );
+    }
+    void clear() { m_bins.clear(); }
+
+    const auto& bins() const { return m_bins; }
+
+  private:
+    std::unordered_map<std::type_index, Bin> m_bins;
+  };
+
   // HiveWhiteBoard helpers
   struct Partition final {
     // Use optional to allow re-constructing in-place without an ugly
@@ -188,6 +282,9 @@ namespace {
     // to pass constructor arguments to Store<>.
     std::optional<Store<>> store;
     int                    eventNumber = -1;
+    RecyclingPool          pool;
+    /// shared objects used by the current event, kept alive until the slot is cleared
+    std::unordered_map<std::string_view, std::shared_ptr<const SharedEntry>> shared;
   };
 
   template <typename T, typename Mutex = std::recursive_mutex, typename ReadLock = std::scoped_lock<Mutex>,
@@ -234,7 +331,9 @@ namespace {
  * @author Gerhard Raven
  * @version 1.0
  */
-class GAUDI_API EvtStoreSvc : public extends<Service, IDataProviderSvc, IDataManagerSvc, IHiveWhiteBoard> {
+class GAUDI_API EvtStoreSvc : public extends<Service, IDataProviderSvc, IDataManagerSvc, IHiveWhiteBoard,
+                                              Gaudi::Interfaces::IDataObjectRecycler,
+                                              Gaudi::Interfaces::ISharedDataStore> {
   Gaudi::Property<CLID>        m_rootCLID{ this, "RootCLID", 110 /*CLID_Event*/, "CLID of root entry" };
   Gaudi::Property<std::string> m_rootName{ this, "RootName", "/Event", "name of root entry" };
   Gaudi::Property<bool>        m_forceLeaves{ this, "ForceLeaves", false,
@@ -245,8 +344,19 @@ class GAUDI_API EvtStoreSvc : public extends<Service, IDataProviderSvc, IDataMan
   Gaudi::Property<std::size_t> m_poolSize{ this, "PoolSize", 1024, "Initial per-event memory pool size [KiB]" };
   Gaudi::Property<std::size_t> m_estStoreBuckets{ this, "StoreBuckets", 100,
                                                   "Estimated number of buckets in the store" };
+  Gaudi::Property<bool>        m_enableRecycling{ this, "EnableRecycling", false,
+                                           "Reuse the DataObject instances of recyclable types across events" };
+  Gaudi::Property<std::size_t> m_maxRecycled{ this, "MaxRecycledPerType", 64,
+                                              "Maximum number of instances of a type kept for reuse in each slot" };
+  Gaudi::Property<unsigned int> m_memAccountingPeriod{
+      this, "MemoryAccountingPeriod", 0,
+      "Account for the memory of one registered object out of N (on average), by location and producer; "
+      "0 to disable" };
+  Gaudi::Property<double> m_memHistoMax{ this, "MemoryHistogramMax", 1024.,
+                                         "Upper edge of the memory accounting histograms [KiB]" };
   mutable Gaudi::Accumulators::AveragingCounter<std::size_t> m_usedPoolSize, m_servedPoolAllocations,
       m_usedPoolAllocations, m_storeEntries, m_storeBuckets;
+  std::optional<Gaudi::Monitoring::StoreMemoryMonitor<EvtStoreSvc>> m_memMonitor;
 
   // Convert to bytes
   std::size_t poolSize() const { return m_poolSize * 1024; }
@@ -264,7 +374,12 @@ class GAUDI_API EvtStoreSvc : public extends<Service, IDataProviderSvc, IDataMan
   }
 
   void initStore( Partition& p ) const {
+    p.shared.clear();
     if ( p.store ) {
+      if ( m_enableRecycling ) {
+        // hand back the objects of recycled types to the pool of the slot
+        p.store->extract_objects( [&]( std::unique_ptr<DataObject> obj ) { p.pool.recycle( obj, m_maxRecycled ); } );
+      }
       // re-use the existing memory pool
       p.store->reset();
     } else {
@@ -272,6 +387,23 @@ class GAUDI_API EvtStoreSvc : public extends<Service, IDataProviderSvc, IDataMan
     }
   }
 
+  void printRecyclingStats() {
+    std::map<std::string, std::pair<std::size_t, std::size_t>> stats; // type -> (hits, misses)
+    for ( auto& synced_p : m_partitions ) {
+      synced_p.with_lock( [&stats]( Partition& p ) {
+        for ( const auto& [type, bin] : p.pool.bins() ) {
+          auto& s = stats[System::typeinfoName( type.name() )];
+          s.first += bin.hits;
+          s.second += bin.misses;
+        }
+        p.pool.clear();
+      } );
+    }
+    for ( const auto& [type, s] : stats ) {
+      info() << "Recycling of " << type << ": " << s.first << " hits, " << s.second << " misses" << endmsg;
+    }
+  }
+
   SmartIF<IConversionSvc> m_dataLoader;
 
   /// Items to be pre-loaded
@@ -282,6 +414,28 @@ class GAUDI_API EvtStoreSvc : public extends<Service, IDataProviderSvc, IDataMan
 
   tbb::concurrent_queue<size_t> m_freeSlots;
 
+  /// Objects shared by all the slots, by location (most recently registered first)
+  std::map<std::string, std::vector<std::shared_ptr<const SharedEntry>>, std::less<>> m_shared;
+  mutable std::shared_mutex                                                         m_sharedMutex;
+  std::atomic<bool>                                                                 m_hasShared{ false };
+
+  /// Find the shared object at the given location valid for the current event, keeping it alive
+  /// for the lifetime of the event.
+  const DataObject* findShared( Partition& p, std::string_view path ) const {
+    if ( auto i = p.shared.find( path ); i != p.shared.end() ) return i->second->object();
+    std::shared_lock lock{ m_sharedMutex };
+    auto             i = m_shared.find( path );
+    if ( i == m_shared.end() ) return nullptr;
+    const auto& evtId = Gaudi::Hive::currentContext().eventID();
+    auto        j     = std::find_if( i->second.begin(), i->second.end(),
+                                      [&]( const auto& e ) { return e->isValidFor( evtId ); } );
+    if ( j == i->second.end() ) return nullptr;
+    p.shared.emplace( ( *j )->identifier(), *j );
+    return ( *j )->object();
+  }
+  StatusCode i_registerShared( std::string_view path, std::shared_ptr<DataObject> obj,
+                               std::optional<EventIDRange> iov );
+
   Gaudi::Property<std::vector<std::string>> m_inhibitPrefixes{
       this,
       "InhibitedPathPrefixes",
@@ -366,6 +520,17 @@ public:
   }
   StatusCode preLoad() override;
 
+  std::unique_ptr<DataObject> acquire( const std::type_info& type, Resetter reset ) override;
+
+  StatusCode registerShared( std::string_view path, std::shared_ptr<DataObject> obj ) override {
+    return i_registerShared( path, std::move( obj ), std::nullopt );
+  }
+  StatusCode registerShared( std::string_view path, std::shared_ptr<DataObject> obj,
+                             const EventIDRange& iov ) override {
+    return i_registerShared( path, std::move( obj ), iov );
+  }
+  StatusCode unregisterShared( std::string_view path ) override;
+
   StatusCode linkObject( IRegistry*, std::string_view, DataObject* ) override { return dummy( __FUNCTION__ ); }
   StatusCode linkObject( std::string_view, DataObject* ) override { return dummy( __FUNCTION__ ); }
   StatusCode unlinkObject( IRegistry*, std::string_view ) override { return dummy( __FUNCTION__ ); }
@@ -386,6 +551,10 @@ public:
     }
     for ( size_t i = 0; i < m_slots; i++ ) { m_freeSlots.push( i ); }
     selectStore( 0 ).ignore();
+    if ( m_memAccountingPeriod > 0 ) {
+      m_memMonitor.emplace( this, m_memAccountingPeriod,
+                            Gaudi::Monitoring::StoreMemoryMonitor<EvtStoreSvc>::Axis{ 100, 0., m_memHistoMax, "KiB" } );
+    }
 
     auto loader = serviceLocator()->service( m_loader ).as<IConversionSvc>().get();
     if ( !loader ) {
@@ -401,6 +570,15 @@ public:
              << " to produce " << float( m_storeEntries.mean() ) << " entries in " << float( m_storeBuckets.mean() )
              << " buckets" << endmsg;
     }
+    if ( m_enableRecycling ) printRecyclingStats();
+    for ( auto& synced_p : m_partitions ) {
+      synced_p.with_lock( []( Partition& p ) { p.shared.clear(); } );
+    }
+    {
+      std::scoped_lock lock{ m_sharedMutex };
+      m_shared.clear();
+      m_hasShared = false;
+    }
     setDataLoader( nullptr, nullptr ).ignore(); // release
     return extends::finalize();
   }
@@ -612,6 +790,8 @@ StatusCode EvtStoreSvc::registerObject( DataObject* parentObj, std::string_view
   if ( parentObj ) return StatusCode::FAILURE;
   return fwd( [&, object = std::unique_ptr<DataObject>( pObject ),
                path = normalize_path( path, rootName() )]( Partition& p ) mutable {
+    // memory accounting: size reported by the object
+    const std::size_t objBytes = ( object && m_memMonitor && m_memMonitor->sample() ) ? object->memoryFootprint() : 0;
     if ( m_forceLeaves ) {
       auto dir = path;
       for ( auto i = dir.rfind( '/' ); i != std::string_view::npos; i = dir.rfind( '/' ) ) {
@@ -630,6 +810,7 @@ StatusCode EvtStoreSvc::registerObject( DataObject* parentObj, std::string_view
               << ( ptr ? " -> " + System::typeinfoName( typeid( *ptr ) ) : std::string{} ) << endmsg;
     }
     p.store->put( path, std::move( object ) );
+    if ( objBytes ) m_memMonitor->record( path, objBytes );
     return StatusCode::SUCCESS;
   } );
 }
@@ -638,6 +819,7 @@ StatusCode EvtStoreSvc::retrieveObject( IRegistry* pDirectory, std::string_view
   return fwd( [&]( Partition& p ) {
     path    = normalize_path( path, rootName() );
     pObject = const_cast<DataObject*>( p.store->get( path ) );
+    if ( !pObject && m_hasShared ) pObject = const_cast<DataObject*>( findShared( p, path ) );
     if ( msgLevel( MSG::DEBUG ) ) {
       debug() << "retrieveObject: " << std::quoted( path ) << " (DataObject*)" << (void*)pObject
               << ( pObject ? " -> " + System::typeinfoName( typeid( *pObject ) ) : std::string{} ) << endmsg;
@@ -654,6 +836,47 @@ StatusCode EvtStoreSvc::findObject( std::string_view fullPath, DataObject*& pObj
 StatusCode EvtStoreSvc::unregisterObject( std::string_view sr ) {
   return fwd( [&]( Partition& p ) { return p.store->erase( sr ) != 0 ? StatusCode::SUCCESS : StatusCode::FAILURE; } );
 }
+StatusCode EvtStoreSvc::i_registerShared( std::string_view path, std::shared_ptr<DataObject> obj,
+                                          std::optional<EventIDRange> iov ) {
+  if ( !obj ) return Status::INVALID_OBJECT;
+  path = normalize_path( path, rootName() );
+  if ( msgLevel( MSG::DEBUG ) ) {
+    debug() << "registerShared: " << std::quoted( path ) << " (DataObject*)" << static_cast<void*>( obj.get() )
+            << " -> " << System::typeinfoName( typeid( *obj ) );
+    if ( iov ) debug() << " for " << std::string{ *iov };
+    debug() << endmsg;
+  }
+  std::scoped_lock lock{ m_sharedMutex };
+  auto&            entries = m_shared[std::string{ path }];
+  auto             entry   = std::make_shared<const SharedEntry>( path, std::move( obj ), std::move( iov ) );
+  if ( entry->hasIOV() ) {
+    // objects with an IOV take precedence over the one valid for all the events
+    entries.insert( entries.begin(), std::move( entry ) );
+  } else {
+    if ( !entries.empty() && !entries.back()->hasIOV() ) return Status::DOUBL_OBJ_PATH;
+    entries.push_back( std::move( entry ) );
+  }
+  m_hasShared = true;
+  return StatusCode::SUCCESS;
+}
+StatusCode EvtStoreSvc::unregisterShared( std::string_view path ) {
+  path = normalize_path( path, rootName() );
+  std::scoped_lock lock{ m_sharedMutex };
+  auto             i = m_shared.find( path );
+  if ( i == m_shared.end() ) return StatusCode::FAILURE;
+  m_shared.erase( i );
+  m_hasShared = !m_shared.empty();
+  return StatusCode::SUCCESS;
+}
+std::unique_ptr<DataObject> EvtStoreSvc::acquire( const std::type_info& type, Resetter reset ) {
+  if ( !m_enableRecycling ) return {};
+  std::unique_ptr<DataObject> obj;
+  fwd( [&]( Partition& p ) {
+    obj = p.pool.acquire( type, reset );
+    return StatusCode::SUCCESS;
+  } ).ignore();
+  return obj;
+}
 StatusCode EvtStoreSvc::addPreLoadItem( const DataStoreItem& item ) {
   auto i = std::find( m_preLoads.begin(), m_preLoads.begin(), item );
   if ( i == m_preLoads.end() ) m_preLoads.push_back( item );
@@ -11,6 +11,8 @@
 
 #include "GaudiKernel/Service.h"
 
+#include <Gaudi/Accumulators/Histogram.h>
+#include <Gaudi/Accumulators/SparseHistogram.h>
 #include <HistogramPersistencySvc/RootHistogramSinkBase.h>
 
 #include <TH1D.h>
@@ -36,6 +38,13 @@ namespace {
     static RootHisto create( std::string& name, std::string& title, Axis&... axis ) {
       return create( name, title, std::make_tuple( axis... ), std::make_index_sequence<sizeof...( Axis )>() );
     }
+    /// same as create, but allocating the histogram on the heap
+    template <typename... Axis>
+    static std::unique_ptr<RootHisto> make( std::string const& name, std::string const& title, Axis const&... axis ) {
+      return std::apply( []( auto... args ) { return std::make_unique<RootHisto>( args... ); },
+                         std::tuple_cat( std::tuple{ name.c_str(), title.c_str() },
+                                         std::tuple{ axis.nBins, axis.minValue, axis.maxValue }... ) );
+    }
     static void fillMetaData( RootHisto& histo, nlohmann::json const& jsonAxis, unsigned int nentries ) {
       auto try_set_bin_labels = [&histo, &jsonAxis]( auto idx ) {
         if ( jsonAxis[idx].contains( "labels" ) ) {
@@ -109,31 +118,107 @@ namespace Gaudi::Histograming::Sink {
 
   using namespace std::string_literals;
 
+  /// builds a ROOT histogram from its title, its axis in JSON form, its number of entries and its bin contents
+  template <typename Traits, typename BinContent, std::size_t... index>
+  std::unique_ptr<TH1> makeRootHisto( std::string const& name, std::string title, nlohmann::json const& jsonAxis,
+                                      unsigned int nEntries, BinContent binContent, std::index_sequence<index...> ) {
+    auto axis = std::array{ details::toAxis( jsonAxis[index] )... };
+    // weird way ROOT has to give titles to axis
+    title += ( axis[index].title + ... );
+    // compute total number of bins, multiplying bins per axis
+    auto totNBins = ( ( axis[index].nBins + 2 ) * ... );
+    auto histo    = Traits::make( name, title, axis[index]... );
+    for ( unsigned int i = 0; i < totNBins; i++ ) Traits::fill( *histo, i, binContent( i ) );
+    Traits::fillMetaData( *histo, jsonAxis, nEntries );
+    return histo;
+  }
+
+  /// HistoConverter building a ROOT histogram from the JSON representation of a Gaudi histogram
   template <unsigned int N, bool isProfile, typename ROOTHisto>
-  void saveRootHisto( TFile& file, std::string dir, std::string name, nlohmann::json& j ) {
-    details::saveRootHisto<Traits<isProfile, ROOTHisto, N>>( file, std::move( dir ), std::move( name ), j );
+  std::unique_ptr<TH1> jsonToRootHisto( std::string const& name, nlohmann::json const& j ) {
+    using TraitsType = Traits<isProfile, ROOTHisto, N>;
+    auto weights     = j.at( "bins" ).get<std::vector<typename TraitsType::WeightType>>();
+    return makeRootHisto<TraitsType>(
+        name, j.at( "title" ).get<std::string>(), j.at( "axis" ), j.at( "nEntries" ).get<unsigned int>(),
+        [&weights]( unsigned int i ) {
+          assert( i < weights.size() );
+          return weights[i];
+        },
+        std::make_index_sequence<N>() );
+  }
+
+  /// HistoDirectConverter building a ROOT histogram from the bins of a Gaudi histogram of type Histo
+  template <typename Histo, bool isProfile, typename ROOTHisto>
+  std::unique_ptr<TH1> directToRootHisto( std::string const& name, Monitoring::Hub::Entity const& ent ) {
+    constexpr unsigned int N = Histo::NumberDimensions::value;
+    using TraitsType         = Traits<isProfile, ROOTHisto, N>;
+    auto&        h           = *ent.dataAs<Histo>();
+    unsigned int nEntries{ 0 };
+    for ( unsigned int i = 0; i < h.totNBins(); i++ ) nEntries += h.nEntries( i );
+    return makeRootHisto<TraitsType>(
+        name, h.title(), nlohmann::json( h.axis() ), nEntries,
+        [&h]( unsigned int i ) { return typename TraitsType::WeightType( h.binValue( i ) ); },
+        std::make_index_sequence<N>() );
+  }
+
+  template <typename Histo, bool isProfile, typename ROOTHisto>
+  void registerDirectFor( Base::HistoDirectConverterRegistry& registry ) {
+    registry.emplace( typeid( Histo ), &directToRootHisto<Histo, isProfile, ROOTHisto> );
+  }
+
+  /// registers the direct conversion of all precisions and atomicities of a given Gaudi histogram type
+  template <template <unsigned int, Accumulators::atomicity, typename> typename Histo, unsigned int N, bool isProfile,
+            typename ROOTHisto>
+  void registerDirect( Base::HistoDirectConverterRegistry& registry ) {
+    using Accumulators::atomicity;
+    registerDirectFor<Histo<N, atomicity::none, double>, isProfile, ROOTHisto>( registry );
+    registerDirectFor<Histo<N, atomicity::full, double>, isProfile, ROOTHisto>( registry );
+    registerDirectFor<Histo<N, atomicity::sharded, double>, isProfile, ROOTHisto>( registry );
+    registerDirectFor<Histo<N, atomicity::none, float>, isProfile, ROOTHisto>( registry );
+    registerDirectFor<Histo<N, atomicity::full, float>, isProfile, ROOTHisto>( registry );
+    registerDirectFor<Histo<N, atomicity::sharded, float>, isProfile, ROOTHisto>( registry );
+  }
+
+  /// registers the direct conversion of the dense and sparse versions of the histograms of dimension N
+  template <unsigned int N, typename ROOTHisto, typename ROOTProfile>
+  void registerDirect( Base::HistoDirectConverterRegistry& registry ) {
+    using namespace Accumulators;
+    registerDirect<Histogram, N, false, ROOTHisto>( registry );
+    registerDirect<WeightedHistogram, N, false, ROOTHisto>( registry );
+    registerDirect<ProfileHistogram, N, true, ROOTProfile>( registry );
+    registerDirect<WeightedProfileHistogram, N, true, ROOTProfile>( registry );
+    registerDirect<SparseHistogram, N, false, ROOTHisto>( registry );
+    registerDirect<SparseWeightedHistogram, N, false, ROOTHisto>( registry );
+    registerDirect<SparseProfileHistogram, N, true, ROOTProfile>( registry );
+    registerDirect<SparseWeightedProfileHistogram, N, true, ROOTProfile>( registry );
   }
 
   struct Root : Base {
 
     using Base::Base;
 
-    HistoRegistry registry = { { { "histogram:Histogram"s, 1 }, &saveRootHisto<1, false, TH1D> },
-                               { { "histogram:WeightedHistogram"s, 1 }, &saveRootHisto<1, false, TH1D> },
-                               { { "histogram:Histogram"s, 2 }, &saveRootHisto<2, false, TH2D> },
-                               { { "histogram:WeightedHistogram"s, 2 }, &saveRootHisto<2, false, TH2D> },
-                               { { "histogram:Histogram"s, 3 }, &saveRootHisto<3, false, TH3D> },
-                               { { "histogram:WeightedHistogram"s, 3 }, &saveRootHisto<3, false, TH3D> },
-                               { { "histogram:ProfileHistogram"s, 1 }, &saveRootHisto<1, true, TProfile> },
-                               { { "histogram:WeightedProfileHistogram"s, 1 }, &saveRootHisto<1, true, TProfile> },
-                               { { "histogram:ProfileHistogram"s, 2 }, &saveRootHisto<2, true, TProfile2D> },
-                               { { "histogram:WeightedProfileHistogram"s, 2 }, &saveRootHisto<2, true, TProfile2D> },
-                               { { "histogram:ProfileHistogram"s, 3 }, &saveRootHisto<3, true, TProfile3D> },
-                               { { "histogram:WeightedProfileHistogram"s, 3 }, &saveRootHisto<3, true, TProfile3D> } };
+    HistoConverterRegistry registry = {
+        { { "histogram:Histogram"s, 1 }, &jsonToRootHisto<1, false, TH1D> },
+        { { "histogram:WeightedHistogram"s, 1 }, &jsonToRootHisto<1, false, TH1D> },
+        { { "histogram:Histogram"s, 2 }, &jsonToRootHisto<2, false, TH2D> },
+        { { "histogram:WeightedHistogram"s, 2 }, &jsonToRootHisto<2, false, TH2D> },
+        { { "histogram:Histogram"s, 3 }, &jsonToRootHisto<3, false, TH3D> },
+        { { "histogram:WeightedHistogram"s, 3 }, &jsonToRootHisto<3, false, TH3D> },
+        { { "histogram:ProfileHistogram"s, 1 }, &jsonToRootHisto<1, true, TProfile> },
+        { { "histogram:WeightedProfileHistogram"s, 1 }, &jsonToRootHisto<1, true, TProfile> },
+        { { "histogram:ProfileHistogram"s, 2 }, &jsonToRootHisto<2, true, TProfile2D> },
+        { { "histogram:WeightedProfileHistogram"s, 2 }, &jsonToRootHisto<2, true, TProfile2D> },
+        { { "histogram:ProfileHistogram"s, 3 }, &jsonToRootHisto<3, true, TProfile3D> },
+        { { "histogram:WeightedProfileHistogram"s, 3 }, &jsonToRootHisto<3, true, TProfile3D> } };
 
     StatusCode initialize() override {
       return Base::initialize().andThen( [&] {
-        for ( auto& [id, func] : registry ) { registerHandler( id, func ); }
+        for ( auto& [id, func] : registry ) { registerConverter( id, func ); }
+        HistoDirectConverterRegistry direct;
+        registerDirect<1, TH1D, TProfile>( direct );
+        registerDirect<2, TH2D, TProfile2D>( direct );
+        registerDirect<3, TH3D, TProfile3D>( direct );
+        for ( auto& [id, func] : direct ) { registerDirectConverter( id, func ); }
       } );
     }
   };
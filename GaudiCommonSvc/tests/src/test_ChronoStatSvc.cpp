@@ -0,0 +1,114 @@
+/***********************************************************************************\
+* (c) Copyright 2022 CERN for the benefit of the LHCb and ATLAS collaborations      *
+*                                                                                   *
+* This software is distributed under the terms of the Apache version 2 licence,     *
+* copied verbatim in the file "LICENSE".                                            *
+*                                                                                   *
+* In applying this licence, CERN does not waive the privileges and immunities       *
+* granted to it by virtue of its status as an Intergovernmental Organization        *
+* or submit itself to any jurisdiction.                                             *
+\***********************************************************************************/
+#define BOOST_TEST_DYN_LINK
+#define BOOST_TEST_MODULE test_ChronoStatSvc
+#include <boost/test/unit_test.hpp>
+
+#include "ApplicationFixture.h"
+
+#include <GaudiKernel/Bootstrap.h>
+#include <GaudiKernel/ChronoEntity.h>
+#include <GaudiKernel/IChronoStatSvc.h>
+#include <GaudiKernel/IService.h>
+#include <GaudiKernel/ISvcLocator.h>
+#include <GaudiKernel/SmartIF.h>
+
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace {
+  constexpr int s_threads = 4;
+  constexpr int s_calls   = 100;
+
+  /// A new, initialized, ChronoStatSvc instance, so that the tests do not depend on each other.
+  SmartIF<IChronoStatSvc> chronoSvc( const std::string& name ) {
+    return Gaudi::svcLocator()->service<IChronoStatSvc>( "ChronoStatSvc/" + name );
+  }
+
+  /// Start and stop a handle based chrono s_calls times in each of s_threads threads, returns the
+  /// number of measurements seen by each thread.
+  std::vector<unsigned long> runThreads( IChronoStatSvc& svc, IChronoStatSvc::ChronoHandle handle ) {
+    std::vector<unsigned long> measurements( s_threads );
+    std::vector<std::thread>   threads;
+    for ( int t = 0; t != s_threads; ++t ) {
+      threads.emplace_back( [&, t] {
+        const ChronoEntity* entity = nullptr;
+        for ( int i = 0; i != s_calls; ++i ) {
+          svc.chronoStart( handle );
+          entity = svc.chronoStop( handle );
+        }
+        measurements[t] = entity->nOfMeasurements();
+      } );
+    }
+    for ( auto& t : threads ) t.join();
+    return measurements;
+  }
+} // namespace
+
+BOOST_GLOBAL_FIXTURE( ApplicationFixture );
+
+BOOST_AUTO_TEST_CASE( handles ) {
+  auto svc = chronoSvc( "ChronoHandles" );
+  BOOST_REQUIRE( svc );
+
+  const auto first = svc->chronoHandle( "first" );
+  BOOST_CHECK( svc->chronoHandle( "first" ) == first );
+  BOOST_CHECK( svc->chronoHandle( "second" ) != first );
+
+  const ChronoEntity* started = svc->chronoStart( first );
+  const ChronoEntity* stopped = svc->chronoStop( first );
+  BOOST_CHECK_EQUAL( started, stopped );
+  BOOST_CHECK_EQUAL( stopped->nOfMeasurements(), 1u );
+  svc->chronoStart( first );
+  BOOST_CHECK_EQUAL( svc->chronoStop( first )->nOfMeasurements(), 2u );
+
+  // the handle based chronos are not visible by tag before the merge at finalize
+  BOOST_CHECK( !svc->chrono( "first" ) );
+}
+
+BOOST_AUTO_TEST_CASE( threads ) {
+  auto svc = chronoSvc( "ChronoThreads" );
+  BOOST_REQUIRE( svc );
+
+  // each thread has its own chrono for the handle
+  for ( auto m : runThreads( *svc, svc->chronoHandle( "threads" ) ) ) {
+    BOOST_CHECK_EQUAL( m, static_cast<unsigned long>( s_calls ) );
+  }
+}
+
+BOOST_AUTO_TEST_CASE( merge_at_finalize ) {
+  auto svc = chronoSvc( "ChronoMerge" );
+  BOOST_REQUIRE( svc );
+
+  const auto first = svc->chronoHandle( "first" );
+  svc->chronoStart( first );
+  svc->chronoStop( first );
+  svc->chronoStart( first );
+  svc->chronoStop( first );
+  // the same tag can also be used by name
+  svc->chronoStart( "first" );
+  svc->chronoStop( "first" );
+  runThreads( *svc, svc->chronoHandle( "threads" ) );
+  svc->chronoHandle( "second" );
+
+  BOOST_REQUIRE( svc.as<IService>()->sysFinalize() );
+
+  // the chronos of all the threads are added to the ones by tag
+  const ChronoEntity* merged = svc->chrono( "first" );
+  BOOST_REQUIRE( merged );
+  BOOST_CHECK_EQUAL( merged->nOfMeasurements(), 3u );
+  const ChronoEntity* threads = svc->chrono( "threads" );
+  BOOST_REQUIRE( threads );
+  BOOST_CHECK_EQUAL( threads->nOfMeasurements(), static_cast<unsigned long>( s_threads * s_calls ) );
+  // a handle that was never started does not appear in the table
+  BOOST_CHECK( !svc->chrono( "second" ) );
+}
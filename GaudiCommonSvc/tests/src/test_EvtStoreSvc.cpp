@@ -0,0 +1,257 @@
+/***********************************************************************************\
+* (c) Copyright 2022 CERN for the benefit of the LHCb and ATLAS collaborations      *
+*                                                                                   *
+* This software is distributed under the terms of the Apache version 2 licence,     *
+* copied verbatim in the file "LICENSE".                                            *
+*                                                                                   *
+* In applying this licence, CERN does not waive the privileges and immunities       *
+* granted to it by virtue of its status as an Intergovernmental Organization        *
+* or submit itself to any jurisdiction.                                             *
+\***********************************************************************************/
+#define BOOST_TEST_DYN_LINK
+#define BOOST_TEST_MODULE test_EvtStoreSvc
+#include <boost/test/unit_test.hpp>
+
+#include "ApplicationFixture.h"
+
+#include <Gaudi/Interfaces/IDataObjectRecycler.h>
+#include <Gaudi/Interfaces/IOptionsSvc.h>
+#include <Gaudi/Interfaces/ISharedDataStore.h>
+#include <GaudiKernel/AnyDataWrapper.h>
+#include <GaudiKernel/Bootstrap.h>
+#include <GaudiKernel/DataObject.h>
+#include <GaudiKernel/EventContext.h>
+#include <GaudiKernel/EventIDBase.h>
+#include <GaudiKernel/EventIDRange.h>
+#include <GaudiKernel/IDataProviderSvc.h>
+#include <GaudiKernel/IHiveWhiteBoard.h>
+#include <GaudiKernel/IRegistry.h>
+#include <GaudiKernel/ISvcLocator.h>
+#include <GaudiKernel/SmartIF.h>
+#include <GaudiKernel/ThreadLocalContext.h>
+
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <memory>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace {
+  /// Application with an EvtStoreSvc instance ("TestStore", 2 slots) recycling the objects.
+  struct Application : ApplicationFixture {
+    Application() : ApplicationFixture{ { "libGaudiCoreSvc.so", "libGaudiCommonSvc.so" } } {
+      auto& opts = Gaudi::svcLocator()->getOptsSvc();
+      opts.set( "TestStore.EventSlots", "2" );
+      opts.set( "TestStore.EnableRecycling", "True" );
+      opts.set( "TestStore.MaxRecycledPerType", "1" );
+    }
+  };
+
+  SmartIF<IDataProviderSvc> store() {
+    return Gaudi::svcLocator()->service<IDataProviderSvc>( "EvtStoreSvc/TestStore" );
+  }
+
+  using Wrapper = AnyDataWrapper<std::vector<int>>;
+
+  /// Recyclable type keeping track of its live instances.
+  struct Counted : DataObject {
+    Counted() { ++s_alive; }
+    ~Counted() override { --s_alive; }
+    void              clear() {}
+    static inline int s_alive = 0;
+  };
+
+  /// Process, in the current thread, an event of the given run in the given slot.
+  void startEvent( IHiveWhiteBoard& wb, std::size_t slot, unsigned int run ) {
+    EventContext ctx{ 0, slot };
+    ctx.setEventID( EventIDBase{ run, 1 } );
+    Gaudi::Hive::setCurrentContext( ctx );
+    wb.selectStore( slot ).ignore();
+  }
+
+  const DataObject* find( IDataProviderSvc& svc, std::string_view path ) {
+    DataObject* obj = nullptr;
+    return svc.retrieveObject( path, obj ).isSuccess() ? obj : nullptr;
+  }
+
+  EventIDRange runs( unsigned int first, unsigned int last ) {
+    return { EventIDBase{ first, 0 }, EventIDBase{ last + 1, 0 } };
+  }
+} // namespace
+
+BOOST_GLOBAL_FIXTURE( Application );
+
+BOOST_AUTO_TEST_CASE( recycling ) {
+  auto                                            svc = store();
+  SmartIF<IHiveWhiteBoard>                        wb{ svc };
+  SmartIF<Gaudi::Interfaces::IDataObjectRecycler> recycler{ svc };
+  BOOST_REQUIRE( wb && recycler );
+
+  BOOST_REQUIRE( wb->selectStore( 0 ) );
+  std::vector<const Wrapper*> used;
+  for ( const auto path : { "/Event/A", "/Event/B" } ) {
+    auto obj = Gaudi::Recycling::acquire<Wrapper>( recycler.get() );
+    BOOST_CHECK_EQUAL( obj->getData().capacity(), 0u ); // nothing to recycle in the first event
+    obj->getData().assign( 1000, 42 );
+    used.push_back( obj.get() );
+    BOOST_REQUIRE( svc->registerObject( path, obj.release() ) );
+  }
+  BOOST_REQUIRE( wb->clearStore( 0 ) );
+
+  // the other slot has its own pool
+  BOOST_REQUIRE( wb->selectStore( 1 ) );
+  BOOST_CHECK_EQUAL( Gaudi::Recycling::acquire<Wrapper>( recycler.get() )->getData().capacity(), 0u );
+
+  // next event in the first slot: one object kept (MaxRecycledPerType), emptied but with its buffer
+  BOOST_REQUIRE( wb->selectStore( 0 ) );
+  auto again = Gaudi::Recycling::acquire<Wrapper>( recycler.get() );
+  BOOST_CHECK( std::find( used.begin(), used.end(), again.get() ) != used.end() );
+  BOOST_CHECK( again->getData().empty() );
+  BOOST_CHECK( again->getData().capacity() >= 1000u );
+  BOOST_CHECK_EQUAL( Gaudi::Recycling::acquire<Wrapper>( recycler.get() )->getData().capacity(), 0u );
+}
+
+BOOST_AUTO_TEST_CASE( only_requested_types ) {
+  auto                                            svc = store();
+  SmartIF<IHiveWhiteBoard>                        wb{ svc };
+  SmartIF<Gaudi::Interfaces::IDataObjectRecycler> recycler{ svc };
+  BOOST_REQUIRE( wb->selectStore( 1 ) );
+
+  // objects of types never requested to the store are deleted when the slot is cleared
+  BOOST_REQUIRE( svc->registerObject( "/Event/C", new Counted ) );
+  BOOST_REQUIRE( wb->clearStore( 1 ) );
+  BOOST_CHECK_EQUAL( Counted::s_alive, 0 );
+
+  auto obj = Gaudi::Recycling::acquire<Counted>( recycler.get() );
+  auto ptr = obj.get();
+  BOOST_REQUIRE( svc->registerObject( "/Event/C", obj.release() ) );
+  BOOST_REQUIRE( wb->clearStore( 1 ) );
+  BOOST_CHECK_EQUAL( Counted::s_alive, 1 );
+  obj = Gaudi::Recycling::acquire<Counted>( recycler.get() );
+  BOOST_CHECK( obj.get() == ptr );
+  BOOST_CHECK( !obj->registry() );
+}
+
+BOOST_AUTO_TEST_CASE( shared_in_all_slots ) {
+  auto                                         svc = store();
+  SmartIF<IHiveWhiteBoard>                     wb{ svc };
+  SmartIF<Gaudi::Interfaces::ISharedDataStore> shared{ svc };
+  BOOST_REQUIRE( shared );
+
+  auto any    = std::make_shared<DataObject>();
+  auto first  = std::make_shared<DataObject>();
+  auto second = std::make_shared<DataObject>();
+  BOOST_REQUIRE( shared->registerShared( "/Event/Geometry", any ) );
+  BOOST_CHECK( shared->registerShared( "/Event/Geometry", std::make_shared<DataObject>() ).isFailure() );
+  BOOST_REQUIRE( shared->registerShared( "/Event/Geometry", first, runs( 1, 1 ) ) );
+  BOOST_REQUIRE( shared->registerShared( "/Event/Geometry", second, runs( 2, 3 ) ) );
+
+  // the same instance in all the slots, chosen by the IOV of the event
+  startEvent( *wb, 0, 1 );
+  BOOST_CHECK( find( *svc, "/Event/Geometry" ) == first.get() );
+  BOOST_CHECK( find( *svc, "Geometry" ) == first.get() );
+  startEvent( *wb, 1, 3 );
+  BOOST_CHECK( find( *svc, "/Event/Geometry" ) == second.get() );
+  BOOST_REQUIRE( wb->clearStore( 1 ) );
+  startEvent( *wb, 1, 1 );
+  BOOST_CHECK( find( *svc, "/Event/Geometry" ) == first.get() );
+  BOOST_REQUIRE( wb->clearStore( 1 ) );
+  startEvent( *wb, 1, 7 );
+  BOOST_CHECK( find( *svc, "/Event/Geometry" ) == any.get() );
+
+  // an object registered in a slot hides the shared one
+  auto local = new DataObject;
+  BOOST_REQUIRE( svc->registerObject( "/Event/Geometry", local ) );
+  BOOST_CHECK( find( *svc, "/Event/Geometry" ) == local );
+  startEvent( *wb, 0, 1 );
+  BOOST_CHECK( find( *svc, "/Event/Geometry" ) == first.get() );
+
+  BOOST_REQUIRE( shared->unregisterShared( "/Event/Geometry" ) );
+  BOOST_CHECK( shared->unregisterShared( "/Event/Geometry" ).isFailure() );
+  BOOST_REQUIRE( wb->clearStore( 0 ) );
+  BOOST_REQUIRE( wb->clearStore( 1 ) );
+  BOOST_CHECK( !find( *svc, "/Event/Geometry" ) );
+}
+
+BOOST_AUTO_TEST_CASE( shared_lifetime ) {
+  auto                                         svc = store();
+  SmartIF<IHiveWhiteBoard>                     wb{ svc };
+  SmartIF<Gaudi::Interfaces::ISharedDataStore> shared{ svc };
+
+  std::weak_ptr<DataObject> observer;
+  {
+    auto obj = std::make_shared<DataObject>();
+    observer = obj;
+    BOOST_REQUIRE( shared->registerShared( "/Event/Conditions", std::move( obj ) ) );
+  }
+  // the store keeps the object alive across the slot resets
+  startEvent( *wb, 0, 1 );
+  const DataObject* obj = find( *svc, "/Event/Conditions" );
+  BOOST_REQUIRE( obj );
+  BOOST_CHECK( obj->registry() && obj->registry()->identifier() == "Conditions" );
+  BOOST_REQUIRE( wb->clearStore( 0 ) );
+  BOOST_CHECK( !observer.expired() );
+  BOOST_CHECK( find( *svc, "/Event/Conditions" ) == obj );
+
+  // once unregistered, it stays valid in the slots that used it, until they are cleared
+  BOOST_REQUIRE( shared->unregisterShared( "/Event/Conditions" ) );
+  BOOST_CHECK( !observer.expired() );
+  BOOST_CHECK( find( *svc, "/Event/Conditions" ) == obj );
+  startEvent( *wb, 1, 1 );
+  BOOST_CHECK( !find( *svc, "/Event/Conditions" ) );
+  BOOST_REQUIRE( wb->clearStore( 0 ) );
+  BOOST_CHECK( observer.expired() );
+}
+
+BOOST_AUTO_TEST_CASE( shared_concurrent_registration ) {
+  auto                                         svc = store();
+  SmartIF<IHiveWhiteBoard>                     wb{ svc };
+  SmartIF<Gaudi::Interfaces::ISharedDataStore> shared{ svc };
+  BOOST_REQUIRE( wb->clearStore( 0 ) );
+  BOOST_REQUIRE( wb->clearStore( 1 ) );
+
+  constexpr int                         writers = 4, objects = 50;
+  std::array<std::atomic<int>, writers> registered{}; // objects registered by each writer
+  std::atomic<int>                      unique{ 0 };  // successful registrations of the same location
+  std::atomic<bool>                     done{ false };
+  std::atomic<int>                      missing{ 0 };
+
+  auto path = []( int w, int i ) { return "/Event/Shared/" + std::to_string( w ) + "/" + std::to_string( i ); };
+
+  // readers process events in both slots while the objects are being registered
+  std::vector<std::thread> readers;
+  for ( std::size_t slot = 0; slot != 2; ++slot ) {
+    readers.emplace_back( [&, slot] {
+      startEvent( *wb, slot, 1 );
+      while ( !done ) {
+        for ( int w = 0; w != writers; ++w ) {
+          if ( int n = registered[w]; n && !find( *svc, path( w, n - 1 ) ) ) ++missing;
+        }
+      }
+    } );
+  }
+  std::vector<std::thread> threads;
+  for ( int w = 0; w != writers; ++w ) {
+    threads.emplace_back( [&, w] {
+      if ( shared->registerShared( "/Event/Shared/Unique", std::make_shared<DataObject>() ) ) ++unique;
+      for ( int i = 0; i != objects; ++i ) {
+        if ( shared->registerShared( path( w, i ), std::make_shared<DataObject>() ) ) ++registered[w];
+      }
+    } );
+  }
+  for ( auto& t : threads ) t.join();
+  done = true;
+  for ( auto& t : readers ) t.join();
+
+  BOOST_CHECK_EQUAL( unique, 1 );
+  BOOST_CHECK_EQUAL( missing, 0 );
+  startEvent( *wb, 0, 1 );
+  for ( int w = 0; w != writers; ++w ) {
+    BOOST_CHECK_EQUAL( registered[w], objects );
+    for ( int i = 0; i != objects; ++i ) BOOST_CHECK( find( *svc, path( w, i ) ) );
+  }
+  BOOST_REQUIRE( wb->clearStore( 0 ) );
+  BOOST_REQUIRE( wb->clearStore( 1 ) );
+}
@@ -17,6 +17,11 @@
 
 DECLARE_COMPONENT( AlgExecStateSvc )
 
+namespace {
+  /// State of the algorithms that did not run in the current event
+  const AlgExecState s_noState{};
+} // namespace
+
 //=============================================================================
 
 void AlgExecStateSvc::init() {
@@ -25,21 +30,25 @@ void AlgExecStateSvc::init() {
                                 ? std::max( (size_t)1, Gaudi::Concurrency::ConcurrencyFlags::numConcurrentEvents() )
                                 : 1;
 
-  m_algStates.resize( slots );
-  m_eventStatus.resize( slots );
-
-  if ( msgLevel( MSG::DEBUG ) ) debug() << "resizing state containers to : " << slots << endmsg;
-
   SmartIF<IAlgManager> algMan( serviceLocator() );
   if ( !algMan.isValid() ) {
     fatal() << "could not get the AlgManager" << endmsg;
     throw GaudiException( "In AlgExecStateSvc, unable to get the AlgManager!", "AlgExecStateSvc", StatusCode::FAILURE );
   }
 
-  m_isInit = true;
-
   for ( const auto& alg : algMan->getAlgorithms() ) addAlg( alg );
-  for ( const auto& alg : m_preInitAlgs ) addAlg( alg );
+
+  {
+    std::scoped_lock lock( m_mut );
+    m_slots = std::vector<SlotStates>( slots ); // SlotStates cannot be copied
+    for ( auto& slot : m_slots ) slot.algs.resize( m_algNames.size() );
+    m_algStateMaps.resize( slots );
+    m_eventStatus.resize( slots );
+  }
+
+  if ( msgLevel( MSG::DEBUG ) ) debug() << "resizing state containers to : " << slots << endmsg;
+
+  m_isInit = true;
 
   if ( msgLevel( MSG::VERBOSE ) ) {
     std::ostringstream ost;
@@ -64,39 +73,62 @@ void AlgExecStateSvc::dump( std::ostringstream& ost, const EventContext& ctx ) c
 
   ost << "  [slot: " << slotID << ", incident: " << m_eventStatus.at( slotID ) << "]:\n\n";
 
-  auto& algState = m_algStates.at( slotID );
-  auto  ml       = std::accumulate( begin( algState ), end( algState ), size_t{ 0 },
-                                    []( size_t m, const auto& as ) { return std::max( m, as.first.str().length() ); } );
+  const auto& slot = m_slots.at( slotID );
+  auto        ml   = std::accumulate( begin( m_algNames ), end( m_algNames ), size_t{ 0 },
+                                      []( size_t m, const auto& n ) { return std::max( m, n.str().length() ); } );
 
-  for ( const auto& e : algState ) ost << "  + " << std::setw( ml ) << e.first.str() << "  " << e.second << '\n';
+  for ( std::size_t i = 0; i != slot.algs.size(); ++i ) {
+    const auto& s = slot.algs[i];
+    ost << "  + " << std::setw( ml ) << m_algNames[i].str() << "  "
+        << ( s.generation == slot.generation ? s.state : s_noState ) << '\n';
+  }
 }
 
 //-----------------------------------------------------------------------------
 
 void AlgExecStateSvc::addAlg( const Gaudi::StringKey& alg ) {
-  if ( !m_isInit ) {
-    if ( msgLevel( MSG::DEBUG ) ) debug() << "preInit: will add Alg " << alg.str() << " later" << endmsg;
-    m_preInitAlgs.push_back( alg );
-    return;
-  }
-
-  if ( !m_algStates.empty() && m_algStates.front().find( alg ) != m_algStates.front().end() ) {
-    // already added
-    return;
-  }
-
   {
     // in theory, this should only get called during initialization (serial)
     // so shouldn't have to protect with a mutex...
     std::scoped_lock lock( m_mut );
 
-    AlgExecState s;
-    for ( auto& a : m_algStates ) a[alg] = s;
-    m_errorCount[alg] = 0;
+    if ( m_algIndex.find( alg ) != m_algIndex.end() ) {
+      // already added
+      return;
+    }
+
+    m_algIndex.emplace( alg, m_algNames.size() );
+    m_algNames.push_back( alg );
+    m_errorCount.emplace_back( 0 );
+    for ( auto& slot : m_slots ) slot.algs.resize( m_algNames.size() );
   }
 
   if ( msgLevel( MSG::DEBUG ) )
-    debug() << "adding alg " << alg.str() << " to " << m_algStates.size() << " slots" << endmsg;
+    debug() << "adding alg " << alg.str() << " to " << m_slots.size() << " slots" << endmsg;
+}
+
+//-----------------------------------------------------------------------------
+
+std::size_t AlgExecStateSvc::algIndex( const Gaudi::StringKey& algName ) const {
+  auto itr = m_algIndex.find( algName );
+  if ( itr == m_algIndex.end() ) {
+    throw GaudiException{ "cannot find Alg " + algName.str() + " in AlgStateMap", name(), StatusCode::FAILURE };
+  }
+  return itr->second;
+}
+
+//-----------------------------------------------------------------------------
+
+AlgExecStateSvc::AlgStates_t* AlgExecStateSvc::subSlotStates( const EventContext& ctx, bool create ) const {
+  auto& subSlots = m_slots.at( ctx.slot() ).subSlots;
+  if ( ctx.subSlot() >= subSlots.size() ) {
+    if ( !create ) return nullptr;
+    subSlots.resize( ctx.subSlot() + 1 );
+  }
+  auto& states = subSlots[ctx.subSlot()];
+  if ( !states && create ) states = std::make_unique<AlgStates_t>();
+  if ( states && states->size() < m_algNames.size() ) states->resize( m_algNames.size() );
+  return states.get();
 }
 
 //-----------------------------------------------------------------------------
@@ -104,73 +136,61 @@ void AlgExecStateSvc::addAlg( const Gaudi::StringKey& alg ) {
 const AlgExecState& AlgExecStateSvc::algExecState( const Gaudi::StringKey& algName, const EventContext& ctx ) const {
   checkInit();
 
-  auto& algState = m_algStates.at( ctx.slot() );
-  auto  itr      = algState.find( algName );
-  if ( itr == algState.end() ) {
-    throw GaudiException{ "cannot find Alg " + algName.str() + " in AlgStateMap", name(), StatusCode::FAILURE };
-  }
+  const auto  index = algIndex( algName );
+  const auto& slot  = m_slots.at( ctx.slot() );
 
   // Assuming the alg is known, look for its state in the sub-slot
+  const AlgState* state = &slot.algs[index];
   if ( ctx.usesSubSlot() ) {
-    auto& subSlots    = m_algSubSlotStates[ctx.slot()];
-    auto& thisSubSlot = subSlots[ctx.subSlot()];
-    auto  subitr      = thisSubSlot.find( algName );
-    if ( subitr == thisSubSlot.end() ) {
-      throw GaudiException{ "cannot find Alg " + algName.str() + " in AlgStateMap", name(), StatusCode::FAILURE };
-    } else {
-      return subitr->second;
-    }
+    std::scoped_lock lock( m_mut );
+    auto*            states = subSlotStates( ctx, false );
+    if ( !states ) return s_noState;
+    state = &( *states )[index];
   }
 
-  return itr->second;
+  return state->generation == slot.generation ? state->state : s_noState;
 }
 
 //-----------------------------------------------------------------------------
 
 AlgExecState& AlgExecStateSvc::algExecState( IAlgorithm* iAlg, const EventContext& ctx ) {
   std::call_once( m_initFlag, &AlgExecStateSvc::init, this );
+  return algExecState( algIndex( iAlg->nameKey() ), ctx );
+}
+
+//-----------------------------------------------------------------------------
+
+AlgExecState& AlgExecStateSvc::algExecState( std::size_t index, const EventContext& ctx ) {
+  std::call_once( m_initFlag, &AlgExecStateSvc::init, this );
 
-  auto& algState = m_algStates.at( ctx.slot() );
-  auto  itr      = algState.find( iAlg->nameKey() );
-  if ( itr == algState.end() ) {
-    throw GaudiException{ std::string{ "cannot find Alg " } + iAlg->name() + " in AlgStateMap", name(),
-                          StatusCode::FAILURE };
+  auto& slot = m_slots.at( ctx.slot() );
+  if ( index >= slot.algs.size() ) {
+    throw GaudiException{ "invalid Alg index " + std::to_string( index ), name(), StatusCode::FAILURE };
   }
 
   // Sub-slots are dynamic
-  // Assuming the alg is known, look for a subslot
   // Return the existing state, or create a new one
   if ( ctx.usesSubSlot() ) {
-
     // Use mutex since dynamic
     std::scoped_lock lock( m_mut );
-
-    // Check that there is any sub-slot information for this slot
-    if ( ctx.slot() >= m_algSubSlotStates.size() ) m_algSubSlotStates.resize( ctx.slot() + 1 );
-
-    // Check that there is information for this sub-slot
-    auto& subSlots = m_algSubSlotStates[ctx.slot()];
-    if ( ctx.subSlot() >= subSlots.size() ) subSlots.resize( ctx.subSlot() + 1 );
-
-    // Find (or create) the state of the algorithm in this sub-slot
-    auto& thisSubSlot = subSlots[ctx.subSlot()];
-    auto  subitr      = thisSubSlot.find( iAlg->name() );
-    if ( subitr == thisSubSlot.end() ) {
-      thisSubSlot[iAlg->name()] = AlgExecState();
-      return thisSubSlot[iAlg->name()];
-    } else {
-      return subitr->second;
-    }
+    return current( ( *subSlotStates( ctx, true ) )[index], slot.generation );
   }
 
-  return itr->second;
+  return current( slot.algs[index], slot.generation );
 }
 
 //-----------------------------------------------------------------------------
 
 const IAlgExecStateSvc::AlgStateMap_t& AlgExecStateSvc::algExecStates( const EventContext& ctx ) const {
   checkInit();
-  return m_algStates.at( ctx.slot() );
+  const auto& slot = m_slots.at( ctx.slot() );
+  auto&       map  = m_algStateMaps.at( ctx.slot() );
+  map.clear();
+  for ( std::size_t i = 0; i != slot.algs.size(); ++i ) {
+    const auto& s = slot.algs[i];
+    map.emplace( m_algNames[i], s.generation == slot.generation ? s.state : s_noState );
+  }
+  return map;
 }
 
 //-----------------------------------------------------------------------------
@@ -205,14 +225,8 @@ void AlgExecStateSvc::reset( const EventContext& ctx ) {
   if ( msgLevel( MSG::VERBOSE ) ) verbose() << "reset(" << ctx.slot() << ")" << endmsg;
 
   std::call_once( m_initFlag, &AlgExecStateSvc::init, this );
-  for ( auto& e : m_algStates.at( ctx.slot() ) ) e.second.reset();
-
-  // Also clear sub slots
-  if ( ctx.slot() < m_algSubSlotStates.size() ) {
-    for ( auto& subSlot : m_algSubSlotStates[ctx.slot()] ) {
-      for ( auto& e : subSlot ) e.second.reset();
-    }
-  }
+  // the states of the slot, and of its sub slots, are reset when they are accessed
+  ++m_slots.at( ctx.slot() ).generation;
 
   m_eventStatus.at( ctx.slot() ) = EventStatus::Invalid;
 }
@@ -220,22 +234,22 @@ void AlgExecStateSvc::reset( const EventContext& ctx ) {
 //-----------------------------------------------------------------------------
 
 unsigned int AlgExecStateSvc::algErrorCount( const IAlgorithm* iAlg ) const {
-  auto itr = m_errorCount.find( iAlg->nameKey() );
-  if ( itr == m_errorCount.end() ) {
+  auto itr = m_algIndex.find( iAlg->nameKey() );
+  if ( itr == m_algIndex.end() ) {
     error() << "Unable to find Algorithm \"" << iAlg->name() << "\" in map"
             << " of ErrorCounts" << endmsg;
     return 0;
   }
 
-  return itr->second;
+  return m_errorCount[itr->second];
 }
 
 //-----------------------------------------------------------------------------
 
 void AlgExecStateSvc::resetErrorCount( const IAlgorithm* iAlg ) {
-  auto itr = m_errorCount.find( iAlg->nameKey() );
-  if ( itr != m_errorCount.end() ) {
-    itr->second = 0;
+  auto itr = m_algIndex.find( iAlg->nameKey() );
+  if ( itr != m_algIndex.end() ) {
+    m_errorCount[itr->second] = 0;
   } else {
     error() << "Unable to find Algorithm \"" << iAlg->name() << "\" in map"
             << " of ErrorCounts" << endmsg;
@@ -245,11 +259,11 @@ void AlgExecStateSvc::resetErrorCount( const IAlgorithm* iAlg ) {
 //-----------------------------------------------------------------------------
 
 unsigned int AlgExecStateSvc::incrementErrorCount( const IAlgorithm* iAlg ) {
-  auto itr = m_errorCount.find( iAlg->nameKey() );
-  if ( itr == m_errorCount.end() ) {
+  auto itr = m_algIndex.find( iAlg->nameKey() );
+  if ( itr == m_algIndex.end() ) {
     error() << "Unable to find Algorithm \"" << iAlg->name() << "\" in map"
             << " of ErrorCounts" << endmsg;
     return 0;
   }
-  return ++( itr->second );
+  return ++m_errorCount[itr->second];
 }
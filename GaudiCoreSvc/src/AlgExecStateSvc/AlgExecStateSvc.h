@@ -15,6 +15,10 @@
 #include "GaudiKernel/IAlgorithm.h"
 #include "GaudiKernel/Service.h"
 
+#include <atomic>
+#include <cstdint>
+#include <deque>
+#include <memory>
 #include <mutex>
 #include <unordered_map>
 #include <vector>
@@ -22,6 +26,10 @@
 /** @class AlgExecStateSvc
  * @brief A service that keeps track of the execution state of Algorithm
  *
+ * The algorithms get an index when they are added, and the states of each event slot (and
+ * sub-slot) are arrays indexed by it. A state is only valid if it was accessed since the last
+ * reset of the slot (it has the generation of the slot), so that a reset does not have to go
+ * through the states. The arrays of the sub-slots are kept for the next events.
  */
 class AlgExecStateSvc : public extends<Service, IAlgExecStateSvc> {
 public:
@@ -32,6 +40,9 @@ public:
   using IAlgExecStateSvc::algExecState;
   const AlgExecState&  algExecState( const Gaudi::StringKey& algName, const EventContext& ctx ) const override;
   AlgExecState&        algExecState( IAlgorithm* iAlg, const EventContext& ctx ) override;
+  std::size_t          algIndex( const Gaudi::StringKey& algName ) const override;
+  AlgExecState&        algExecState( std::size_t algIndex, const EventContext& ctx ) override;
+  /// Copy of the states of an event slot, for diagnostics (valid until the next call for the slot).
   const AlgStateMap_t& algExecStates( const EventContext& ctx ) const override;
 
   void reset( const EventContext& ctx ) override;
@@ -52,21 +63,52 @@ public:
   void dump( std::ostringstream& ost, const EventContext& ctx ) const override;
 
 private:
+  /// State of an algorithm, valid if it has the generation of its slot
+  struct AlgState {
+    AlgExecState  state;
+    std::uint64_t generation = 0;
+  };
+  /// States indexed by algorithm index (a deque, so that adding algorithms does not move them)
+  typedef std::deque<AlgState> AlgStates_t;
+
+  struct SlotStates {
+    AlgStates_t algs;
+    /// Incremented by reset(), invalidating all the states of the slot and of its sub-slots
+    std::uint64_t generation = 1;
+    /// States of the sub-slots, reused by the next events
+    std::vector<std::unique_ptr<AlgStates_t>> subSlots;
+  };
+
+  /// State of an algorithm of a slot, reset if it was not accessed since the reset of the slot.
+  static AlgExecState& current( AlgState& s, std::uint64_t generation ) {
+    if ( s.generation != generation ) {
+      s.state.reset();
+      s.generation = generation;
+    }
+    return s.state;
+  }
+
+  /// States of the sub-slot of the context, nullptr if it was never used (m_mut must be held).
+  AlgStates_t* subSlotStates( const EventContext& ctx, bool create ) const;
+
   // one vector entry per event slot
-  std::vector<AlgStateMap_t>              m_algStates;
-  std::vector<std::vector<AlgStateMap_t>> m_algSubSlotStates;
+  mutable std::vector<SlotStates>    m_slots;
+  mutable std::vector<AlgStateMap_t> m_algStateMaps;
 
   std::vector<EventStatus::Status> m_eventStatus;
-  std::vector<Gaudi::StringKey>    m_preInitAlgs;
 
-  std::unordered_map<Gaudi::StringKey, std::atomic<unsigned int>> m_errorCount;
+  /// Names of the algorithms by index, and indices by name
+  std::vector<Gaudi::StringKey>                     m_algNames;
+  std::unordered_map<Gaudi::StringKey, std::size_t> m_algIndex;
+
+  std::deque<std::atomic<unsigned int>> m_errorCount;
 
   void           init();
   void           checkInit() const;
   std::once_flag m_initFlag;
   bool           m_isInit{ false };
 
-  std::mutex m_mut;
+  mutable std::mutex m_mut;
 };
 
 #endif
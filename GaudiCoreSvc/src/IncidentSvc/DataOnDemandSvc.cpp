@@ -24,6 +24,7 @@
 #include "GaudiKernel/ThreadLocalContext.h"
 #include "GaudiKernel/ToStream.h"
 #include "GaudiKernel/TypeNameString.h"
+#include <chrono>
 #include <fmt/format.h>
 #include <map>
 #include <math.h>
@@ -120,6 +121,47 @@ StatusCode DataOnDemandSvc::i_setAlgHandler( const std::string& name, const Gaud
   return StatusCode::SUCCESS;
 }
 
+void DataOnDemandSvc::compileHandlers() {
+  m_handlers.clear();
+  m_handlers.reserve( m_nodes.size() + m_algs.size() );
+  auto statFor = [this]( const std::string& path ) -> PathStat* {
+    if ( !m_pathCounters ) return nullptr;
+    auto i = m_pathStats.find( path );
+    if ( i == m_pathStats.end() ) i = m_pathStats.try_emplace( path, this, "Time [ms] " + path ).first;
+    return &i->second;
+  };
+  // nodes have precedence over algorithms
+  for ( auto& [path, node] : m_nodes ) {
+    m_handlers.emplace( path.str(), Handler{ &node, nullptr, statFor( path.str() ) } );
+  }
+  for ( auto& [path, leaf] : m_algs ) {
+    m_handlers.emplace( path.str(), Handler{ nullptr, &leaf, statFor( path.str() ) } );
+  }
+}
+
+void DataOnDemandSvc::i_connect() {
+  if ( m_directFaults ) {
+    m_faultSource = m_dataSvc;
+    if ( m_faultSource && m_faultSource->setDataFaultHandler( this ).isSuccess() ) {
+      if ( msgLevel( MSG::DEBUG ) ) {
+        debug() << "Handling data faults of " << m_dataSvcName.value() << " directly" << endmsg;
+      }
+      return;
+    }
+    m_faultSource.reset();
+  }
+  m_incSvc->addListener( this, m_trapType );
+}
+
+void DataOnDemandSvc::i_disconnect() {
+  if ( m_faultSource ) {
+    m_faultSource->setDataFaultHandler( nullptr ).ignore();
+    m_faultSource.reset();
+  } else if ( m_incSvc ) {
+    m_incSvc->removeListener( this, m_trapType );
+  }
+}
+
 // ============================================================================
 // update the content of Data-On-Demand actions
 // ============================================================================
@@ -164,6 +206,8 @@ StatusCode DataOnDemandSvc::update() {
   }
   /// setup nodes
   for ( const auto& node : m_nodeMap ) { i_setNodeHandler( node.first, node.second ); }
+  /// build the lookup table
+  compileHandlers();
   ///
   m_updateRequired = false;
   //
@@ -217,10 +261,9 @@ StatusCode DataOnDemandSvc::finalize() {
     dump( MSG::DEBUG, false );
   }
   //
-  if ( m_incSvc ) {
-    m_incSvc->removeListener( this, m_trapType );
-    m_incSvc.reset();
-  }
+  i_disconnect();
+  m_incSvc.reset();
+  m_handlers.clear();
   m_algMgr.reset();
   m_dataSvc.reset();
   if ( m_toolSvc ) { // we may not have retrieved the ToolSvc
@@ -242,10 +285,8 @@ StatusCode DataOnDemandSvc::finalize() {
 // ============================================================================
 StatusCode DataOnDemandSvc::reinitialize() {
   // reinitialize the Service Base class
-  if ( m_incSvc ) {
-    m_incSvc->removeListener( this, m_trapType );
-    m_incSvc.reset();
-  }
+  i_disconnect();
+  m_incSvc.reset();
   m_algMgr.reset();
   m_dataSvc.reset();
   for ( const auto& i : m_nodeMappers ) m_toolSvc->releaseTool( i ).ignore();
@@ -283,13 +324,13 @@ StatusCode DataOnDemandSvc::setup() {
     error() << "Failed to retrieve Incident service." << endmsg;
     return StatusCode::FAILURE;
   }
-  m_incSvc->addListener( this, m_trapType );
 
   if ( !( m_dataSvc = serviceLocator()->service( m_dataSvcName ) ) ) // assignment meant
   {
     error() << "Failed to retrieve the data provider interface of " << m_dataSvcName << endmsg;
     return StatusCode::FAILURE;
   }
+  i_connect();
 
   // No need to get the ToolSvc if we are not using tools
   if ( !( m_nodeMapTools.empty() && m_algMapTools.empty() ) ) {
@@ -459,67 +500,84 @@ namespace {
 // IIncidentListener interfaces overrides: incident handling
 // ===========================================================================
 void DataOnDemandSvc::handle( const Incident& incident ) {
+  auto lock = std::scoped_lock{ m_faultMutex };
+  // proper incident type?
+  if ( incident.type() != m_trapType ) {
+    ++m_stat;
+    return;
+  } // RETURN
+  const DataIncident* inc = dynamic_cast<const DataIncident*>( &incident );
+  if ( !inc ) {
+    ++m_stat;
+    return;
+  } // RETURN
+  if ( msgLevel( MSG::VERBOSE ) ) {
+    verbose() << "Incident: [" << incident.type() << "] "
+              << " = " << incident.source() << " Location:" << inc->tag() << endmsg;
+  }
+  handleDataFault( inc->tag() );
+}
+// ===========================================================================
+// IDataFaultHandler interfaces overrides: data fault handling
+// ===========================================================================
+void DataOnDemandSvc::handleDataFault( const std::string& path ) {
+  auto lock = std::scoped_lock{ m_faultMutex };
 
   Gaudi::Utils::LockedChrono timer( m_timer_all, m_locked_all );
 
   ++m_stat;
-  // proper incident type?
-  if ( incident.type() != m_trapType ) { return; } // RETURN
-  const DataIncident* inc = dynamic_cast<const DataIncident*>( &incident );
-  if ( !inc ) { return; } // RETURN
   // update if needed!
   if ( m_updateRequired ) {
     if ( !update() ) throw GaudiException( "Failed to update", name(), StatusCode::FAILURE );
   }
-
-  if ( msgLevel( MSG::VERBOSE ) ) {
-    verbose() << "Incident: [" << incident.type() << "] "
-              << " = " << incident.source() << " Location:" << inc->tag() << endmsg;
-  }
-  // ==========================================================================
-  Gaudi::StringKey tag( inc->tag() );
+  if ( msgLevel( MSG::VERBOSE ) ) verbose() << "Data fault for location: " << path << endmsg;
   // ==========================================================================
-  auto icl = m_nodes.find( tag );
-  if ( icl != m_nodes.end() ) {
-    StatusCode sc = execHandler( tag, icl->second );
-    if ( sc.isSuccess() ) { ++m_statNode; }
-    return; // RETURN
+  auto h = m_handlers.find( path );
+  if ( h == m_handlers.end() ) {
+    // Fall back on the tools
+    if ( !m_toolSvc || !i_resolveWithTools( path ) ) return; // RETURN
+    h = m_handlers.find( path );
+    if ( h == m_handlers.end() ) return; // RETURN
   }
   // ==========================================================================
-  auto ialg = m_algs.find( tag );
-  if ( ialg != m_algs.end() ) {
-    StatusCode sc = execHandler( tag, ialg->second );
-    if ( sc.isSuccess() ) { ++m_statAlg; }
-    return; // RETURN
+  const auto& handler = h->second;
+  const auto  start   = handler.stat ? std::chrono::steady_clock::now() : std::chrono::steady_clock::time_point{};
+  if ( handler.node ) {
+    if ( execHandler( path, *handler.node ).isSuccess() ) { ++m_statNode; }
+  } else {
+    if ( execHandler( path, *handler.leaf ).isSuccess() ) { ++m_statAlg; }
   }
-  // ==========================================================================
-  // Fall back on the tools
-  if ( m_toolSvc ) {
-    if ( msgLevel( MSG::VERBOSE ) ) verbose() << "Try to find mapping with mapping tools" << endmsg;
-    Finder finder( no_prefix( inc->tag(), m_prefix ), m_nodeMappers, m_algMappers );
-    //  - try the node mappers
-    std::string node = finder.node();
-    if ( isGood( node ) ) {
-      // if one is found update the internal node mapping and try again.
-      if ( msgLevel( MSG::VERBOSE ) ) verbose() << "Found Node handler: " << node << endmsg;
-      i_setNodeHandler( inc->tag(), node );
-      handle( incident );
-      --m_stat; // avoid double counting because of recursion
-      return;
-    }
-    //  - try alg mappings
-    Gaudi::Utils::TypeNameString alg = finder.alg();
-    if ( isGood( alg ) ) {
-      // we got an algorithm, update alg map and try to handle again
-      if ( msgLevel( MSG::VERBOSE ) ) verbose() << "Found Algorithm handler: " << alg << endmsg;
-      i_setAlgHandler( inc->tag(), alg ).ignore();
-      handle( incident );
-      --m_stat; // avoid double counting because of recursion
-      return;
-    }
+  if ( handler.stat ) {
+    *handler.stat += std::chrono::duration<double, std::milli>( std::chrono::steady_clock::now() - start ).count();
   }
 }
 // ===========================================================================
+// look for a handler with the mapping tools
+// ===========================================================================
+bool DataOnDemandSvc::i_resolveWithTools( const std::string& path ) {
+  if ( msgLevel( MSG::VERBOSE ) ) verbose() << "Try to find mapping with mapping tools" << endmsg;
+  Finder finder( no_prefix( path, m_prefix ), m_nodeMappers, m_algMappers );
+  //  - try the node mappers
+  std::string node = finder.node();
+  if ( isGood( node ) ) {
+    // if one is found update the internal node mapping
+    if ( msgLevel( MSG::VERBOSE ) ) verbose() << "Found Node handler: " << node << endmsg;
+    i_setNodeHandler( path, node );
+    compileHandlers();
+    return true;
+  }
+  //  - try alg mappings
+  Gaudi::Utils::TypeNameString alg = finder.alg();
+  if ( isGood( alg ) ) {
+    // we got an algorithm, update alg map
+    if ( msgLevel( MSG::VERBOSE ) ) verbose() << "Found Algorithm handler: " << alg << endmsg;
+    if ( i_setAlgHandler( path, alg ).isFailure() ) return false;
+    compileHandlers();
+    return true;
+  }
+  return false;
+}
+// ===========================================================================
 // execute the handler
 // ===========================================================================
 StatusCode DataOnDemandSvc::execHandler( const std::string& tag, Node& n ) {
@@ -16,10 +16,15 @@
 // STD & STL
 // ============================================================================
 #include <map>
+#include <mutex>
+#include <string_view>
+#include <unordered_map>
 #include <vector>
 // ============================================================================
 // GaudiKernel
 // ============================================================================
+#include "Gaudi/Accumulators.h"
+#include "Gaudi/Interfaces/IDataFaultHandler.h"
 #include "GaudiKernel/ChronoEntity.h"
 #include "GaudiKernel/IDODAlgMapper.h"
 #include "GaudiKernel/IDODNodeMapper.h"
@@ -94,10 +99,22 @@ class IToolSvc;
  *    From now the default prefix ( "/Event/" ) could be omitted from
  *    any data-item. It will be added automatically.
  *
+ *  If the data service supports it (Gaudi::Interfaces::IDataFaultSource) the
+ *  service registers itself as direct data fault handler, instead of listening
+ *  to the "DataFault" incidents (see the property "DirectFaultHandling").
+ *  The handlers are looked up in a single hash table compiled from the maps
+ *  when they are updated. If "PathCounters" is set, the number of calls and the
+ *  time spent for each path are recorded in counters named "Time [ms] <path>".
+ *
+ *  The data faults are handled one at a time (whether they come directly from the
+ *  data service or through the incident service), so the handlers and the statistics
+ *  need no further protection in multithreaded jobs. The lock is recursive, as the
+ *  algorithms run by a handler may cause data faults themselves.
+ *
  * @author  M.Frank
  * @version 1.0
  */
-class DataOnDemandSvc : public extends<Service, IIncidentListener> {
+class DataOnDemandSvc : public extends<Service, IIncidentListener, Gaudi::Interfaces::IDataFaultHandler> {
 public:
   // ==========================================================================
   // Typedefs
@@ -160,6 +177,8 @@ public:
   StatusCode reinitialize() override;
   /// IIncidentListener interfaces overrides: incident handling
   void handle( const Incident& incident ) override;
+  /// IDataFaultHandler interfaces overrides: create the object missing at the given path
+  void handleDataFault( const std::string& path ) override;
   /// Standard initializing service constructor.
   using extends::extends;
   // ==========================================================================
@@ -197,6 +216,14 @@ protected:
   void i_setNodeHandler( const std::string& name, const std::string& type );
   /// Internal method to initialize an algorithm handler.
   StatusCode i_setAlgHandler( const std::string& name, const Gaudi::Utils::TypeNameString& alg );
+  /// (Re)build the table of handlers from the node and algorithm maps
+  void compileHandlers();
+  /// Look for a handler with the mapping tools, adding it to the maps if found
+  bool i_resolveWithTools( const std::string& path );
+  /// Connect to the data faults of the data service (directly or via incidents)
+  void i_connect();
+  /// Disconnect from the data faults of the data service
+  void i_disconnect();
   // ==========================================================================
 protected:
   // ==========================================================================
@@ -232,8 +259,24 @@ private:
   AlgMap m_algs;
   /// Map of "empty" objects to be placed as intermediate nodes
   NodeMap m_nodes;
+  // ==========================================================================
+  using PathStat = Gaudi::Accumulators::StatCounter<double>;
+  /// Handler of a path: either a node or an algorithm, with its statistics
+  struct Handler {
+    Node*     node = nullptr;
+    Leaf*     leaf = nullptr;
+    PathStat* stat = nullptr;
+  };
+  /// Handlers by path (the keys point to the keys of m_algs and m_nodes)
+  std::unordered_map<std::string_view, Handler> m_handlers;
+  /// Number of calls and time spent (in ms) per path
+  std::map<std::string, PathStat, std::less<>> m_pathStats;
+  /// Data service calling us directly on data faults, if any
+  SmartIF<Gaudi::Interfaces::IDataFaultSource> m_faultSource;
 
   bool m_updateRequired = true;
+  /// Serializes the handling of the data faults (see the class documentation)
+  std::recursive_mutex m_faultMutex;
   // ==========================================================================
   ChronoEntity       m_total;
   unsigned long long m_statAlg  = 0;
@@ -253,6 +296,11 @@ private:
   // Properties
   Gaudi::Property<std::string> m_trapType{ this, "IncidentName", "DataFault", "the type of handled Incident" };
   Gaudi::Property<std::string> m_dataSvcName{ this, "DataSvc", "EventDataSvc", "DataSvc name" };
+  Gaudi::Property<bool>        m_directFaults{
+      this, "DirectFaultHandling", true,
+      "be called directly by the data service on data faults (if supported) instead of via incidents" };
+  Gaudi::Property<bool> m_pathCounters{ this, "PathCounters", false,
+                                        "record the number of calls and the time spent for each path" };
 
   Gaudi::Property<bool> m_partialPath{ this, "UsePreceedingPath", true, "allow creation of partial leaves" };
   Gaudi::Property<bool> m_dump{
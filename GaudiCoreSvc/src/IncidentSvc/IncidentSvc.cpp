@@ -27,6 +27,8 @@
 #include "GaudiKernel/MsgStream.h"
 #include "GaudiKernel/SmartIF.h"
 #include <functional>
+#include <iterator>
+#include <optional>
 // ============================================================================
 // Local
 // ============================================================================
@@ -45,6 +47,15 @@ namespace {
     return iNamed ? iNamed->name() : s_unknown;
   }
   // ==========================================================================
+  /// Number of incident handlers being called by the current thread
+  thread_local int s_handlerDepth = 0;
+  /// Whether the current thread delivers incidents to asynchronous listeners
+  thread_local bool s_deliveryThread = false;
+  struct HandlerScope {
+    HandlerScope() { ++s_handlerDepth; }
+    ~HandlerScope() { --s_handlerDepth; }
+  };
+  // ==========================================================================
 } // namespace
 
 #define ON_DEBUG if ( msgLevel( MSG::DEBUG ) )
@@ -56,11 +67,32 @@ namespace {
 // ============================================================================
 // Constructors and Destructors
 // ============================================================================
-IncidentSvc::IncidentSvc( const std::string& name, ISvcLocator* svc ) : base_class( name, svc ) {}
+IncidentSvc::IncidentSvc( const std::string& name, ISvcLocator* svc ) : base_class( name, svc ) {
+  m_allType                = incidentTypeHandle( "ALL" );
+  m_failInputFileType      = incidentTypeHandle( IncidentType::FailInputFile );
+  m_corruptedInputFileType = incidentTypeHandle( IncidentType::CorruptedInputFile );
+}
 // ============================================================================
 IncidentSvc::~IncidentSvc() { auto lock = std::scoped_lock{ m_listenerMapMutex }; }
 // ============================================================================
+StatusCode IncidentSvc::initialize() {
+  return Service::initialize().andThen( [&]() -> StatusCode {
+    auto lock      = std::scoped_lock{ m_asyncMutex };
+    m_asyncRunning = true;
+    m_asyncThread  = std::thread( &IncidentSvc::asyncLoop, this );
+    return StatusCode::SUCCESS;
+  } );
+}
+// ============================================================================
 StatusCode IncidentSvc::finalize() {
+  // deliver the queued incidents and stop the delivery thread
+  {
+    auto lock      = std::scoped_lock{ m_asyncMutex };
+    m_asyncRunning = false;
+  }
+  m_asyncQueued.notify_one();
+  if ( m_asyncThread.joinable() ) m_asyncThread.join();
+
   DEBMSG << m_timer.outputUserTime( "Incident  timing: Mean(+-rms)/Min/Max:%3%(+-%4%)/%6%/%7%[ms] ", System::milliSec )
          << m_timer.outputUserTime( "Total:%2%[s]", System::Sec ) << endmsg;
 
@@ -72,155 +104,284 @@ StatusCode IncidentSvc::finalize() {
 // ============================================================================
 // Inherited IIncidentSvc overrides:
 // ============================================================================
+IIncidentSvc::IncidentTypeHandle IncidentSvc::incidentTypeHandle( const std::string& type ) {
+  if ( auto i = m_typeHandles.find( type ); i != m_typeHandles.end() ) return i->second;
+
+  auto lock = std::scoped_lock{ m_listenerMapMutex };
+  if ( auto i = m_typeHandles.find( type ); i != m_typeHandles.end() ) return i->second;
+
+  const auto handle = m_nTypes;
+  if ( handle >= s_maxChunks * s_chunkSize ) {
+    throw GaudiException( "too many incident types, cannot register " + type, name(), StatusCode::FAILURE );
+  }
+  if ( handle % s_chunkSize == 0 ) {
+    m_chunks.push_back( std::make_unique<TypeEntry[]>( s_chunkSize ) );
+    m_entries[handle >> s_chunkBits].store( m_chunks.back().get(), std::memory_order_release );
+  }
+  entry( handle ).type = type;
+  ++m_nTypes;
+  // published last, so that the entry is complete when the handle is found without lock
+  m_typeHandles.emplace( type, handle );
+  return handle;
+}
+// ============================================================================
+std::shared_ptr<const IncidentSvc::Listeners> IncidentSvc::setListeners( TypeEntry& entry, ListenerList listeners ) {
+  // the old list is kept alive by the loops that are calling its listeners
+  std::shared_ptr<Listeners> current;
+  if ( !listeners.empty() ) {
+    ListenerList async;
+    std::copy_if( listeners.begin(), listeners.end(), std::back_inserter( async ),
+                  []( const Listener& l ) { return l.async; } );
+    current = std::make_shared<Listeners>();
+    if ( !async.empty() ) current->async = std::make_shared<const ListenerList>( std::move( async ) );
+    current->all = std::move( listeners );
+  }
+  return entry.exchange( std::move( current ) );
+}
+// ============================================================================
 void IncidentSvc::addListener( IIncidentListener* lis, const std::string& type, long prio, bool rethrow,
-                               bool singleShot ) {
+                               bool singleShot, bool async ) {
   static const std::string all{ "ALL" };
   auto                     lock = std::scoped_lock{ m_listenerMapMutex };
 
   const std::string& ltype = ( !type.empty() ? type : all );
 
-  // find if the type already exists
-  auto itMap = m_listenerMap.find( ltype );
-  if ( itMap == m_listenerMap.end() ) {
-    // if not found, create and insert now a list of listeners
-    auto p = m_listenerMap.insert( { ltype, std::make_unique<ListenerList>() } );
-    if ( !p.second ) { /* OOPS */
-    }
-    itMap = p.first;
-  }
-  auto& llist = *itMap->second;
+  auto&        e = entry( incidentTypeHandle( ltype ) );
+  ListenerList llist;
+  if ( const auto current = e.listeners() ) llist = current->all;
   // add Listener ordered by priority -- higher priority first,
   // and then add behind listeneres with the same priority
   // -- so we skip over all items with higher or same priority
   auto i = std::partition_point( std::begin( llist ), std::end( llist ),
                                  [&]( const Listener& j ) { return j.priority >= prio; } );
   // We insert before the current position
-  DEBMSG << "Adding [" << type << "] listener '" << getListenerName( lis ) << "' with priority " << prio << endmsg;
-  llist.emplace( i, IIncidentSvc::Listener{ lis, prio, rethrow, singleShot } );
+  DEBMSG << "Adding [" << type << "] " << ( async ? "asynchronous " : "" ) << "listener '" << getListenerName( lis )
+         << "' with priority " << prio << endmsg;
+  llist.insert( i, IIncidentSvc::Listener{ lis, prio, rethrow, singleShot, async } );
+  setListeners( e, std::move( llist ) );
 }
 // ============================================================================
-IncidentSvc::ListenerMap::iterator
-IncidentSvc::removeListenerFromList( ListenerMap::iterator i, IIncidentListener* item, bool scheduleRemoval ) {
+std::shared_ptr<const IncidentSvc::Listeners> IncidentSvc::removeListenerFromList( TypeEntry&         e,
+                                                                                    IIncidentListener* item ) {
+  const auto current = e.listeners();
+  if ( !current ) return nullptr;
   auto match = [&]( ListenerList::const_reference j ) { return !item || item == j.iListener; };
 
-  auto& c = *( i->second );
-  if ( !scheduleRemoval ) {
-    ON_DEBUG std::for_each( std::begin( c ), std::end( c ), [&]( ListenerList::const_reference j ) {
-      if ( match( j ) )
-        debug() << "Removing [" << i->first << "] listener '" << getListenerName( j.iListener ) << "'" << endmsg;
-    } );
-    c.erase( std::remove_if( std::begin( c ), std::end( c ), match ), std::end( c ) );
-  } else {
-    std::for_each( std::begin( c ), std::end( c ), [&]( Listener& i ) {
-      if ( match( i ) ) i.singleShot = true; // will trigger removal as soon as it is safe
-    } );
+  const auto&  all = current->all;
+  ListenerList c;
+  c.reserve( all.size() );
+  for ( const auto& j : all ) {
+    if ( match( j ) ) {
+      DEBMSG << "Removing [" << e.type << "] listener '" << getListenerName( j.iListener ) << "'" << endmsg;
+    } else {
+      c.push_back( j );
+    }
   }
-  return c.empty() ? m_listenerMap.erase( i ) : std::next( i );
+  // if the incident is being fired, the loops over the listeners continue with the old list
+  return c.size() != all.size() ? setListeners( e, std::move( c ) ) : nullptr;
 }
 // ============================================================================
 void IncidentSvc::removeListener( IIncidentListener* lis, const std::string& type ) {
+  std::vector<TypeEntry*> changed;
+  bool                    async = false;
+  {
+    auto lock   = std::scoped_lock{ m_listenerMapMutex };
+    auto remove = [&]( TypeEntry& e ) {
+      if ( auto old = removeListenerFromList( e, lis ) ) {
+        changed.push_back( &e );
+        async |= old->async != nullptr;
+      }
+    };
+    if ( type.empty() ) {
+      for ( IncidentTypeHandle i = 0; i != m_nTypes; ++i ) remove( entry( i ) );
+    } else {
+      auto i = m_typeHandles.find( type );
+      if ( i != m_typeHandles.end() ) remove( entry( i->second ) );
+    }
+  }
+  // the listener may be deleted after this call, but not from a handler, which could wait for itself
+  if ( s_handlerDepth ) return;
+  // the threads still calling the removed listener hold a reference to one of the replaced lists
+  for ( const auto e : changed ) {
+    while ( e->retired.load( std::memory_order_acquire ) ) std::this_thread::yield();
+  }
+  if ( async ) waitAsync();
+}
+// ============================================================================
+bool IncidentSvc::takeSingleShot( TypeEntry& e, IIncidentListener* item ) {
   auto lock = std::scoped_lock{ m_listenerMapMutex };
-
-  bool scheduleForRemoval = ( m_currentIncidentType && type == *m_currentIncidentType );
-  if ( type.empty() ) {
-    auto i = std::begin( m_listenerMap );
-    while ( i != std::end( m_listenerMap ) ) { i = removeListenerFromList( i, lis, scheduleForRemoval ); }
-  } else {
-    auto i = m_listenerMap.find( type );
-    if ( i != m_listenerMap.end() ) removeListenerFromList( i, lis, scheduleForRemoval );
+  const auto current = e.listeners();
+  if ( !current ) return false;
+  const auto& all = current->all;
+  auto        i   = std::find_if( all.begin(), all.end(),
+                                  [&]( const Listener& l ) { return l.singleShot && l.iListener == item; } );
+  if ( i == all.end() ) return false;
+  ListenerList remaining;
+  remaining.reserve( all.size() - 1 );
+  std::copy_if( all.begin(), all.end(), std::back_inserter( remaining ),
+                [&]( const Listener& l ) { return !( l.singleShot && l.iListener == item ); } );
+  setListeners( e, std::move( remaining ) );
+  return true;
+}
+// ============================================================================
+std::uint64_t IncidentSvc::queueAsync( std::shared_ptr<const Incident>     incident,
+                                       std::shared_ptr<const ListenerList> listeners ) {
+  std::uint64_t delivery = 0;
+  {
+    auto lock = std::scoped_lock{ m_asyncMutex };
+    if ( !m_asyncRunning ) return 0;
+    m_asyncQueue.push_back( { std::move( incident ), std::move( listeners ) } );
+    delivery = ++m_asyncCount;
   }
+  m_asyncQueued.notify_one();
+  return delivery;
 }
 // ============================================================================
-namespace {
-  /// Helper class to identify a singleShot Listener
-  constexpr struct isSingleShot_t {
-    bool operator()( const IncidentSvc::Listener& l ) const { return l.singleShot; }
-  } isSingleShot{};
-} // namespace
+void IncidentSvc::waitAsync() {
+  auto       lock   = std::unique_lock{ m_asyncMutex };
+  const auto target = m_asyncCount;
+  m_asyncDone.wait( lock, [&] { return m_asyncDelivered >= target; } );
+}
+// ============================================================================
+void IncidentSvc::waitAsync( std::uint64_t delivery ) {
+  auto lock = std::unique_lock{ m_asyncMutex };
+  m_asyncDone.wait( lock, [&] { return m_asyncDelivered >= delivery; } );
+}
 // ============================================================================
-void IncidentSvc::i_fireIncident( const Incident& incident, const std::string& listenerType ) {
+void IncidentSvc::asyncLoop() {
+  HandlerScope scope;
+  s_deliveryThread = true;
+  auto         lock = std::unique_lock{ m_asyncMutex };
+  while ( true ) {
+    m_asyncQueued.wait( lock, [&] { return !m_asyncQueue.empty() || !m_asyncRunning; } );
+    if ( m_asyncQueue.empty() ) break; // stopped, and everything delivered
+    auto delivery = std::move( m_asyncQueue.front() );
+    m_asyncQueue.pop_front();
+    lock.unlock();
+    for ( const auto& listener : *delivery.listeners ) {
+      try {
+        callListener( listener, *delivery.incident );
+      } catch ( ... ) {} // already reported, and there is nobody to rethrow to
+    }
+    delivery = {};
+    lock.lock();
+    ++m_asyncDelivered;
+    m_asyncDone.notify_all();
+  }
+}
+// ============================================================================
+void IncidentSvc::reportException( const Listener& listener, const Incident& incident ) {
+  const std::string& curIncTyp = incident.type();
+  try {
+    throw;
+  } catch ( const GaudiException& exc ) {
+    error() << "Exception with tag=" << exc.tag()
+            << " is caught"
+               " handling incident "
+            << curIncTyp << " in listener " << getListenerName( listener.iListener ) << endmsg;
+    error() << exc << endmsg;
+    if ( listener.rethrow ) { throw exc; }
+  } catch ( const std::exception& exc ) {
+    error() << "Standard std::exception is caught"
+               " handling incident "
+            << curIncTyp << " in listener " << getListenerName( listener.iListener ) << endmsg;
+    error() << exc.what() << endmsg;
+    if ( listener.rethrow ) { throw exc; }
+  } catch ( ... ) {
+    error() << "UNKNOWN Exception is caught"
+               " handling incident "
+            << curIncTyp << " in listener " << getListenerName( listener.iListener ) << endmsg;
+    if ( listener.rethrow ) { throw; }
+  }
+}
+// ============================================================================
+inline void IncidentSvc::callListener( const Listener& listener, const Incident& incident ) {
+  VERMSG << "Calling '" << getListenerName( listener.iListener ) << "' for incident [" << incident.type() << "]"
+         << endmsg;
+  // handle exceptions if they occur (out of line, not to slow down the loops over the listeners)
+  try {
+    listener.iListener->handle( incident );
+  } catch ( ... ) { reportException( listener, incident ); }
+}
+// ============================================================================
+void IncidentSvc::i_fireIncident( const Incident& incident, IncidentTypeHandle type,
+                                  std::shared_ptr<const Incident>& copy ) {
+
+  auto& e = entry( type );
+  if ( !e.active.load( std::memory_order_acquire ) ) return;
+
+  // keep a reference to the list, so that the handlers can add or remove listeners, and so that
+  // removeListener() knows that the listeners are being called
+  const auto listeners = e.listeners();
+  if ( !listeners ) return;
+
+  // the asynchronous listeners get a copy of the incident, or the incident itself if it cannot be
+  // copied, in which case we wait for its delivery (unless we are the delivery thread)
+  std::uint64_t borrowed = 0;
+  bool          queued   = false;
+  if ( listeners->async ) {
+    if ( !copy ) copy = incident.clone();
+    if ( copy ) {
+      queued = queueAsync( copy, listeners->async ) != 0;
+    } else if ( !s_deliveryThread ) {
+      // non-owning pointer: the incident outlives the delivery
+      borrowed = queueAsync( std::shared_ptr<const Incident>( std::shared_ptr<const Incident>{}, &incident ),
+                             listeners->async );
+      queued   = borrowed != 0;
+    }
+  }
 
-  auto lock = std::scoped_lock{ m_listenerMapMutex };
+  try {
+    HandlerScope scope;
+    for ( auto& listener : listeners->all ) {
+      // a single-shot listener is removed (and called) only by the first thread that gets to it
+      if ( listener.singleShot && !takeSingleShot( e, listener.iListener ) ) continue;
+      if ( !( queued && listener.async ) ) callListener( listener, incident );
+    }
+  } catch ( ... ) {
+    // the incident must outlive its delivery, even if a listener rethrows an exception
+    if ( borrowed ) waitAsync( borrowed );
+    throw;
+  }
+  if ( borrowed ) waitAsync( borrowed );
+}
+// ============================================================================
+void IncidentSvc::fireIncident( const Incident& incident, IncidentTypeHandle type ) {
+
+  // the timing is only reported in debug mode, and it is not free
+  std::optional<Gaudi::Utils::LockedChrono> timer;
+  if ( msgLevel( MSG::DEBUG ) ) timer.emplace( m_timer, m_timerLock );
 
   // Wouldn't it be better to write a small 'ReturnCode' service which
   // looks for these 'special' incidents and does whatever needs to
   // be done instead of making a special case here?
 
   // Special case: FailInputFile incident must set the application return code
-  if ( incident.type() == IncidentType::FailInputFile || incident.type() == IncidentType::CorruptedInputFile ) {
+  if ( type == m_failInputFileType || type == m_corruptedInputFileType ) {
     auto appmgr = serviceLocator()->as<IProperty>();
-    Gaudi::setAppReturnCode( appmgr, incident.type() == IncidentType::FailInputFile
-                                         ? Gaudi::ReturnCode::FailInput
-                                         : Gaudi::ReturnCode::CorruptedInput )
+    Gaudi::setAppReturnCode( appmgr, type == m_failInputFileType ? Gaudi::ReturnCode::FailInput
+                                                                 : Gaudi::ReturnCode::CorruptedInput )
         .ignore();
   }
 
-  auto ilisteners = m_listenerMap.find( listenerType );
-  if ( m_listenerMap.end() == ilisteners ) return;
-
-  // setting this pointer will avoid that a call to removeListener() during
-  // the loop triggers a segfault
-  m_currentIncidentType = &incident.type();
-  std::string curIncTyp;
-  if ( m_currentIncidentType != nullptr ) {
-    curIncTyp = *m_currentIncidentType;
-  } else {
-    curIncTyp = "UNKNOWN";
-  }
-
-  bool firedSingleShot = false;
-
-  auto& listeners = *ilisteners->second;
-
-  for ( auto& listener : listeners ) {
-
-    VERMSG << "Calling '" << getListenerName( listener.iListener ) << "' for incident [" << incident.type() << "]"
-           << endmsg;
-
-    // handle exceptions if they occur
-    try {
-      listener.iListener->handle( incident );
-    } catch ( const GaudiException& exc ) {
-      error() << "Exception with tag=" << exc.tag()
-              << " is caught"
-                 " handling incident "
-              << curIncTyp << " in listener " << getListenerName( listener.iListener ) << endmsg;
-      error() << exc << endmsg;
-      if ( listener.rethrow ) { throw exc; }
-    } catch ( const std::exception& exc ) {
-      error() << "Standard std::exception is caught"
-                 " handling incident "
-              << curIncTyp << " in listener " << getListenerName( listener.iListener ) << endmsg;
-      error() << exc.what() << endmsg;
-      if ( listener.rethrow ) { throw exc; }
-    } catch ( ... ) {
-      error() << "UNKNOWN Exception is caught"
-                 " handling incident "
-              << curIncTyp << " in listener " << getListenerName( listener.iListener ) << endmsg;
-      if ( listener.rethrow ) { throw; }
-    }
-    // check wheter one of the listeners is singleShot
-    firedSingleShot |= listener.singleShot;
-  }
-  if ( firedSingleShot ) {
-    // remove all the singleshot listeners that got their shot...
-    listeners.erase( std::remove_if( std::begin( listeners ), std::end( listeners ), isSingleShot ),
-                     std::end( listeners ) );
-    if ( listeners.empty() ) m_listenerMap.erase( ilisteners );
+  std::shared_ptr<const Incident> copy;
+  // Call specific listeners
+  i_fireIncident( incident, type, copy );
+  // Try listeners registered for ALL incidents
+  if ( type != m_allType ) { // avoid double calls if somebody fires the incident "ALL"
+    i_fireIncident( incident, m_allType, copy );
   }
-
-  m_currentIncidentType = nullptr;
 }
 // ============================================================================
 void IncidentSvc::fireIncident( const Incident& incident ) {
-
-  Gaudi::Utils::LockedChrono timer( m_timer, m_timerLock );
-
-  // Call specific listeners
-  i_fireIncident( incident, incident.type() );
-  // Try listeners registered for ALL incidents
-  if ( incident.type() != "ALL" ) { // avoid double calls if somebody fires the incident "ALL"
-    i_fireIncident( incident, "ALL" );
+  auto i = m_typeHandles.find( incident.type() );
+  if ( i != m_typeHandles.end() ) {
+    fireIncident( incident, i->second );
+  } else { // nobody ever listened to this type
+    std::optional<Gaudi::Utils::LockedChrono> timer;
+    if ( msgLevel( MSG::DEBUG ) ) timer.emplace( m_timer, m_timerLock );
+    std::shared_ptr<const Incident> copy;
+    i_fireIncident( incident, m_allType, copy );
   }
 }
 // ============================================================================
@@ -257,11 +418,13 @@ void IncidentSvc::getListeners( std::vector<IIncidentListener*>& l, const std::s
   const std::string& ltype = ( !type.empty() ? type : ALL );
 
   l.clear();
-  auto i = m_listenerMap.find( ltype );
-  if ( i != m_listenerMap.end() ) {
-    l.reserve( i->second->size() );
-    std::transform( std::begin( *i->second ), std::end( *i->second ), std::back_inserter( l ),
-                    []( const Listener& j ) { return j.iListener; } );
+  auto i = m_typeHandles.find( ltype );
+  if ( i != m_typeHandles.end() ) {
+    if ( const auto listeners = entry( i->second ).listeners() ) {
+      l.reserve( listeners->all.size() );
+      std::transform( std::begin( listeners->all ), std::end( listeners->all ), std::back_inserter( l ),
+                      []( const Listener& j ) { return j.iListener; } );
+    }
   }
 }
 
@@ -278,10 +441,20 @@ IIncidentSvc::IncidentPack IncidentSvc::getIncidents( const EventContext* ctx )
       while ( incs->second.try_pop( inc ) ) {
         // ensure incident is for this event (should not be necessary)
         if ( inc->context().evt() == ctx->evt() ) {
-          std::scoped_lock lock( m_listenerMapMutex );
-          auto             i = m_listenerMap.find( inc->type() );
-          if ( i != m_listenerMap.end() ) {
-            p.emplace_back( std::move( inc ), std::vector<Listener>{ i->second->begin(), i->second->end() } );
+          auto i = m_typeHandles.find( inc->type() );
+          if ( i == m_typeHandles.end() ) continue;
+          const auto listeners = entry( i->second ).listeners();
+          if ( !listeners ) continue;
+          // the asynchronous listeners get a copy of the incident from the delivery thread, if possible
+          std::shared_ptr<const Incident> copy;
+          if ( listeners->async ) copy = inc->clone();
+          if ( copy && queueAsync( std::move( copy ), listeners->async ) ) {
+            ListenerList sync;
+            std::copy_if( listeners->all.begin(), listeners->all.end(), std::back_inserter( sync ),
+                          []( const Listener& l ) { return !l.async; } );
+            if ( !sync.empty() ) p.emplace_back( std::move( inc ), std::move( sync ) );
+          } else {
+            p.emplace_back( std::move( inc ), listeners->all );
           }
         }
       }
@@ -16,16 +16,22 @@
 // STD & STL
 // ============================================================================
 #include <algorithm>
-#include <list>
+#include <array>
+#include <atomic>
+#include <condition_variable>
+#include <deque>
 #include <map>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
 // ============================================================================
 // GaudiKernel
 // ============================================================================
 #include "GaudiKernel/ChronoEntity.h"
-#include "GaudiKernel/HashMap.h"
 #include "GaudiKernel/IIncidentSvc.h"
 #include "GaudiKernel/Service.h"
-#include "GaudiKernel/StringKey.h"
 // ============================================================================
 // TBB
 // ============================================================================
@@ -37,34 +43,55 @@
  * @brief Default implementation of the IIncidentSvc interface.
  *
  * This implementation is thread-safe with the following features:
- *  - Calls to fireIncident(), addListener() and removeListener() are
- *    synchronized across threads.
- *  - Calls to IIncidentListener::handle() are serialized, i.e. at any time
- *    there is at most one incident handler being executed across all threads.
+ *  - Calls to addListener() and removeListener() are synchronized across
+ *    threads.
+ *  - Calls to fireIncident() do not lock anything: incidents fired by
+ *    different threads are delivered concurrently, so listeners that can get
+ *    incidents from several threads must protect their own state.
+ *  - removeListener() returns when the listener is no longer being called by
+ *    other threads, so that it can then be deleted (unless it is called from
+ *    an incident handler, that could wait for itself).
+ *  - A single-shot listener is called once, even if its incident is fired by
+ *    several threads at the same time (only removing it takes the lock).
+ *
+ * Incident types are registered as integer handles, each with an array of
+ * listeners that is replaced (never modified) when listeners are added or
+ * removed. Firing an incident loads the current array and calls its
+ * listeners, and firing it through its handle (see incidentTypeHandle())
+ * does not look up the type either. Listeners added or removed by a handler
+ * take effect from the next incident of that type.
+ *
+ * Asynchronous listeners (see IIncidentSvc::addListener()) are called by a
+ * background thread of the service, one at a time and in the order the
+ * incidents were fired, on a copy of the incident (see Incident::clone()).
+ * They can run at the same time as the synchronous handlers. Incidents that
+ * cannot be copied are queued too, and the thread that fires them waits until
+ * they are delivered (an incident fired by an asynchronous handler is
+ * delivered directly, though). Incidents fired while the service is not
+ * initialized are delivered synchronously. Removing an asynchronous listener
+ * waits for the delivery of the incidents already queued for it (unless it is
+ * done from an incident handler).
  */
 
-struct isSingleShot_t;
-
 class IncidentSvc : public extends<Service, IIncidentSvc> {
 private:
-  // Typedefs
-  // ListenerList should be a list rather than a vector because handing
-  // a fired incident may result in a call to addListener.
-  typedef std::list<IIncidentSvc::Listener>                                    ListenerList;
-  typedef GaudiUtils::HashMap<Gaudi::StringKey, std::unique_ptr<ListenerList>> ListenerMap;
+  typedef std::vector<IIncidentSvc::Listener> ListenerList;
 
 public:
   // Inherited Service overrides:
+  StatusCode initialize() override;
   StatusCode finalize() override;
 
   // IIncidentSvc interfaces overwrite
   //
   void addListener( IIncidentListener* lis, const std::string& type = "", long priority = 0, bool rethrow = false,
-                    bool singleShot = false ) override;
+                    bool singleShot = false, bool async = false ) override;
 
   void removeListener( IIncidentListener* l, const std::string& type = "" ) override;
   void fireIncident( const Incident& incident ) override;
   void fireIncident( std::unique_ptr<Incident> incident ) override;
+  IncidentTypeHandle incidentTypeHandle( const std::string& type ) override;
+  void               fireIncident( const Incident& incident, IncidentTypeHandle type ) override;
   // TODO: return by value instead...
   void getListeners( std::vector<IIncidentListener*>& lis, const std::string& type = "" ) const override;
 
@@ -75,21 +102,122 @@ public:
   IIncidentSvc::IncidentPack getIncidents( const EventContext* ctx ) override;
 
 private:
-  ListenerMap::iterator removeListenerFromList( ListenerMap::iterator, IIncidentListener* item, bool scheduleRemoval );
+  /// Immutable listeners of an incident type.
+  struct Listeners {
+    /// All the listeners, ordered by priority
+    ListenerList all;
+    /// The asynchronous ones among them
+    std::shared_ptr<const ListenerList> async;
+    /// Count of the replaced lists of the incident type, set when this one is replaced
+    mutable std::atomic<int>* retired = nullptr;
+
+    ~Listeners() {
+      if ( retired ) retired->fetch_sub( 1, std::memory_order_release );
+    }
+  };
+
+  /// Incident type and its listeners.
+  struct TypeEntry {
+    std::string type;
+    /// Whether there are listeners
+    std::atomic<bool> active{ false };
+    /// Number of replaced lists of listeners still used by the threads that loaded them
+    std::atomic<int> retired{ 0 };
+
+    /// Snapshot of the current listeners (no lock needed).
+    std::shared_ptr<const Listeners> listeners() const {
+#if defined( __cpp_lib_atomic_shared_ptr )
+      return current.load( std::memory_order_acquire );
+#else
+      return std::atomic_load_explicit( &current, std::memory_order_acquire );
+#endif
+    }
+    /// Replace the listeners (with m_listenerMapMutex held), returns the previous ones.
+    std::shared_ptr<const Listeners> exchange( std::shared_ptr<const Listeners> l ) {
+      active.store( l != nullptr, std::memory_order_release );
+#if defined( __cpp_lib_atomic_shared_ptr )
+      auto old = current.exchange( std::move( l ), std::memory_order_acq_rel );
+#else
+      auto old = std::atomic_exchange_explicit( &current, std::move( l ), std::memory_order_acq_rel );
+#endif
+      if ( old ) {
+        retired.fetch_add( 1, std::memory_order_relaxed );
+        old->retired = &retired;
+      }
+      return old;
+    }
+
+  private:
+#if defined( __cpp_lib_atomic_shared_ptr )
+    std::atomic<std::shared_ptr<const Listeners>> current;
+#else
+    std::shared_ptr<const Listeners> current;
+#endif
+  };
+
+  /// Entry of a registered incident type (no lock needed).
+  TypeEntry& entry( IncidentTypeHandle type ) const {
+    return m_entries[type >> s_chunkBits].load( std::memory_order_acquire )[type & ( s_chunkSize - 1 )];
+  }
+  /// Replace the listeners of an incident type (m_listenerMapMutex must be held), returns the previous ones.
+  std::shared_ptr<const Listeners> setListeners( TypeEntry& entry, ListenerList listeners );
+  /// Remove the listener (or all listeners) from the list, returns the previous listeners if it changed.
+  std::shared_ptr<const Listeners> removeListenerFromList( TypeEntry& entry, IIncidentListener* item );
+  /// Remove a single-shot listener that is about to be called, returns false if it was already removed.
+  bool takeSingleShot( TypeEntry& entry, IIncidentListener* item );
   // ==========================================================================
   /// Internal function to allow incidents listening to all events
-  void i_fireIncident( const Incident& incident, const std::string& type );
+  /// (copy is the copy of the incident for the asynchronous listeners, made when first needed)
+  void i_fireIncident( const Incident& incident, IncidentTypeHandle type, std::shared_ptr<const Incident>& copy );
+  /// Call a listener, reporting the exceptions
+  void callListener( const Listener& listener, const Incident& incident );
+  /// Report the exception being handled, and rethrow it if requested by the listener.
+  void reportException( const Listener& listener, const Incident& incident );
 
-  /// List of auditor names
-  ListenerMap m_listenerMap;
+  /// Incident to deliver to asynchronous listeners
+  struct AsyncDelivery {
+    std::shared_ptr<const Incident>     incident;
+    std::shared_ptr<const ListenerList> listeners;
+  };
+  /// Queue an asynchronous delivery, returns its number (from 1), or 0 if the delivery thread is not running.
+  std::uint64_t queueAsync( std::shared_ptr<const Incident> incident, std::shared_ptr<const ListenerList> listeners );
+  /// Wait for the delivery of the incidents queued so far (not from the delivery thread).
+  void waitAsync();
+  /// Wait for the delivery of the incidents up to the given number (not from the delivery thread).
+  void waitAsync( std::uint64_t delivery );
+  /// Body of the delivery thread.
+  void asyncLoop();
 
-  /// Incident being fired. It is used to know if we can safely remove a listener or
-  /// we have to schedule its removal for later.
-  const std::string* m_currentIncidentType = nullptr;
+  /// The type entries are allocated in chunks, so that they never move and can be read while
+  /// new types are registered.
+  static constexpr unsigned int s_chunkBits = 8;
+  static constexpr unsigned int s_chunkSize = 1u << s_chunkBits;
+  static constexpr unsigned int s_maxChunks = 256;
 
-  /// Mutex to synchronize access to m_listenerMap
+  std::array<std::atomic<TypeEntry*>, s_maxChunks> m_entries{};
+  std::vector<std::unique_ptr<TypeEntry[]>>        m_chunks;
+  IncidentTypeHandle                               m_nTypes = 0;
+  /// Handles of the registered incident types
+  tbb::concurrent_unordered_map<std::string, IncidentTypeHandle> m_typeHandles;
+
+  /// Handles of the types with special treatment
+  IncidentTypeHandle m_allType;
+  IncidentTypeHandle m_failInputFileType;
+  IncidentTypeHandle m_corruptedInputFileType;
+
+  /// Mutex to synchronize the changes of the listeners
   mutable std::recursive_mutex m_listenerMapMutex;
 
+  /// Asynchronous deliveries and their thread
+  std::mutex                m_asyncMutex;
+  std::condition_variable   m_asyncQueued;
+  std::condition_variable   m_asyncDone;
+  std::deque<AsyncDelivery> m_asyncQueue;
+  std::uint64_t             m_asyncCount     = 0; ///< incidents queued since the start
+  std::uint64_t             m_asyncDelivered = 0; ///< incidents delivered since the start
+  bool                      m_asyncRunning   = false;
+  std::thread               m_asyncThread;
+
   /// timer & it's lock
   mutable ChronoEntity m_timer;
   mutable bool         m_timerLock = false;
@@ -0,0 +1,275 @@
+/***********************************************************************************\
+* (c) Copyright 2022 CERN for the benefit of the LHCb and ATLAS collaborations      *
+*                                                                                   *
+* This software is distributed under the terms of the Apache version 2 licence,     *
+* copied verbatim in the file "LICENSE".                                            *
+*                                                                                   *
+* In applying this licence, CERN does not waive the privileges and immunities       *
+* granted to it by virtue of its status as an Intergovernmental Organization        *
+* or submit itself to any jurisdiction.                                             *
+\***********************************************************************************/
+#include "AsyncMessageSvc.h"
+
+#include <GaudiKernel/ThreadLocalContext.h>
+
+#include <algorithm>
+#include <chrono>
+#include <cstring>
+
+DECLARE_COMPONENT( AsyncMessageSvc )
+
+namespace {
+  std::uint64_t now() {
+    return std::chrono::duration_cast<std::chrono::nanoseconds>(
+               std::chrono::steady_clock::now().time_since_epoch() )
+        .count();
+  }
+} // namespace
+
+StatusCode AsyncMessageSvc::initialize() {
+  return MessageSvc::initialize().andThen( [&]() -> StatusCode {
+    if ( m_bufferSize.value() < 2 || m_latency <= 0 ) {
+      error() << "invalid BufferSize or Latency" << endmsg;
+      return StatusCode::FAILURE;
+    }
+    m_stopping = false;
+    m_running  = true;
+    m_printer  = std::thread( &AsyncMessageSvc::printerLoop, this );
+    return StatusCode::SUCCESS;
+  } );
+}
+
+StatusCode AsyncMessageSvc::finalize() {
+  if ( m_running ) {
+    // new reports are printed directly, wait for those that are still writing to a buffer (the
+    // printer keeps running meanwhile, so that the reports waiting for space can complete)
+    m_running = false;
+    while ( m_writers.load() ) {
+      m_wakeUp.notify_one();
+      std::this_thread::yield();
+    }
+    {
+      auto lock  = std::scoped_lock{ m_wakeUpMutex };
+      m_stopping = true;
+    }
+    m_wakeUp.notify_one();
+    m_printer.join();
+    drain(); // messages published while the printer was stopping
+  }
+  if ( m_droppedTotal ) {
+    warning() << m_droppedTotal << " messages were dropped because the buffers were full "
+              << "(see BufferSize and BlockLevel)" << endmsg;
+  }
+  m_buffers.clear(); // the threads get new buffers after a new initialization
+  m_droppedTotal = 0;
+  return MessageSvc::finalize(); // must be called after all other actions
+}
+
+AsyncMessageSvc::ThreadBuffer& AsyncMessageSvc::localBuffer() {
+  return m_buffers.local( [this] {
+    std::size_t size = 1;
+    while ( size < m_bufferSize ) size <<= 1;
+    return std::make_unique<ThreadBuffer>( size );
+  } );
+}
+
+AsyncMessageSvc::Record* AsyncMessageSvc::acquire( ThreadBuffer& buffer, int type ) {
+  const auto head = buffer.head.load( std::memory_order_relaxed );
+  while ( head - buffer.tail.load( std::memory_order_acquire ) > buffer.mask ) {
+    m_wakeUp.notify_one();
+    if ( type < m_blockLevel ) {
+      buffer.dropped.fetch_add( 1, std::memory_order_relaxed );
+      return nullptr;
+    }
+    std::this_thread::yield();
+  }
+  return &buffer.records[head & buffer.mask];
+}
+
+void AsyncMessageSvc::publish( ThreadBuffer& buffer ) {
+  const auto head = buffer.head.load( std::memory_order_relaxed ) + 1;
+  buffer.head.store( head, std::memory_order_release );
+  // wake up the printer early if the buffer is filling up
+  if ( head - buffer.tail.load( std::memory_order_relaxed ) == ( buffer.mask + 1 ) / 2 ) m_wakeUp.notify_one();
+}
+
+void AsyncMessageSvc::reportMessage( const Message& msg, int outputLevel ) {
+  Writer writer{ m_writers };
+  if ( !m_running ) {
+    writer.release();
+    MessageSvc::reportMessage( msg, outputLevel < 0 ? this->outputLevel( msg.getSource() ) : outputLevel );
+    return;
+  }
+
+  auto&   buffer = localBuffer();
+  Record* record = acquire( buffer, msg.getType() );
+  if ( !record ) return;
+
+  record->time        = now();
+  record->kind        = RecordHeader::Kind::Message;
+  record->type        = msg.getType();
+  record->outputLevel = outputLevel;
+  record->slot        = msg.getEventSlot();
+  record->evt         = msg.getEventNumber();
+  record->eventID     = msg.getEventID();
+  record->thread      = msg.getThread();
+
+  const auto& source = msg.getSource();
+  const auto& text   = msg.getMessage();
+  if ( source.size() + text.size() <= sizeof( Record::data ) ) {
+    record->sourceSize = source.size();
+    record->textSize   = text.size();
+    std::memcpy( record->data, source.data(), source.size() );
+    std::memcpy( record->data + source.size(), text.data(), text.size() );
+  } else {
+    record->overflow = std::make_unique<Message>( msg );
+  }
+  publish( buffer );
+}
+
+void AsyncMessageSvc::reportMessage( const Message& msg ) {
+  // the output level of the source is looked up by the printer thread
+  reportMessage( msg, -1 );
+}
+
+void AsyncMessageSvc::reportMessage( const StatusCode& code, std::string_view source ) {
+  Writer writer{ m_writers };
+  if ( !m_running ) {
+    writer.release();
+    MessageSvc::reportMessage( code, source );
+    return;
+  }
+
+  auto&   buffer = localBuffer();
+  Record* record = acquire( buffer, MSG::ALWAYS );
+  if ( !record ) return;
+  record->time   = now();
+  record->kind   = RecordHeader::Kind::StatusCode;
+  record->code   = code;
+  if ( source.size() <= sizeof( Record::data ) ) {
+    record->sourceSize = source.size();
+    std::memcpy( record->data, source.data(), source.size() );
+  } else {
+    record->overflow = std::make_unique<Message>( std::string{ source }, MSG::NIL, "" );
+  }
+  publish( buffer );
+}
+
+void AsyncMessageSvc::reportDeferred( std::string_view source, int type, Gaudi::DeferredText& text ) {
+  // the text object is stored after the source, if it fits in the record
+  const auto align  = text.alignment();
+  const auto offset = ( source.size() + align - 1 ) / align * align;
+  Writer     writer{ m_writers };
+  if ( m_running && align <= alignof( std::max_align_t ) && offset + text.size() <= sizeof( Record::data ) ) {
+    auto&   buffer = localBuffer();
+    Record* record = acquire( buffer, type );
+    if ( !record ) return;
+
+    const auto& ctx     = Gaudi::Hive::currentContext();
+    record->time        = now();
+    record->kind        = RecordHeader::Kind::Deferred;
+    record->type        = type;
+    record->outputLevel = type; // the level was checked by the caller
+    record->slot        = ctx.slot();
+    record->evt         = ctx.evt();
+    record->eventID     = ctx.eventID();
+    record->thread      = pthread_self();
+    record->sourceSize  = source.size();
+    std::memcpy( record->data, source.data(), source.size() );
+    record->deferred = text.moveTo( record->data + offset );
+    publish( buffer );
+    return;
+  }
+  // not running or too large for a record: format the text now
+  writer.release();
+  std::string str;
+  text.formatTo( str );
+  reportMessage( Message{ std::string{ source }, type, std::move( str ) }, type );
+}
+
+void AsyncMessageSvc::print( Record& record ) {
+  if ( record.kind == RecordHeader::Kind::StatusCode ) {
+    if ( record.overflow ) {
+      i_reportMessage( record.code, record.overflow->getSource() );
+      record.overflow.reset();
+    } else {
+      i_reportMessage( record.code, std::string_view{ record.data, record.sourceSize } );
+    }
+    return;
+  }
+
+  auto report = [&]( const Message& msg ) {
+    i_reportMessage( msg, record.outputLevel < 0 ? outputLevel( msg.getSource() ) : record.outputLevel );
+  };
+  if ( record.deferred ) {
+    std::string text;
+    try {
+      record.deferred->formatTo( text );
+    } catch ( const std::exception& e ) { text = std::string{ "<cannot format message: " } + e.what() + ">"; }
+    record.deferred->~DeferredText();
+    record.deferred = nullptr;
+    Message msg{ std::string{ record.data, record.sourceSize }, record.type, std::move( text ) };
+    msg.setEventInfo( record.slot, record.evt, record.eventID, record.thread );
+    report( msg );
+  } else if ( record.overflow ) {
+    report( *record.overflow );
+    record.overflow.reset();
+  } else {
+    Message msg{ std::string{ record.data, record.sourceSize }, record.type,
+                 std::string{ record.data + record.sourceSize, record.textSize } };
+    msg.setEventInfo( record.slot, record.evt, record.eventID, record.thread );
+    report( msg );
+  }
+}
+
+std::size_t AsyncMessageSvc::drain() {
+  m_drainBuffers.clear();
+  m_buffers.forEach( [this]( ThreadBuffer& buffer ) { m_drainBuffers.push_back( &buffer ); } );
+
+  // collect the published records of all threads and sort them by time (the records of each
+  // thread are already sorted)
+  m_batch.clear();
+  m_heads.clear();
+  std::uint64_t dropped = 0;
+  for ( auto* buffer : m_drainBuffers ) {
+    dropped += buffer->dropped.exchange( 0, std::memory_order_relaxed );
+    const auto head = buffer->head.load( std::memory_order_acquire );
+    for ( auto i = buffer->tail.load( std::memory_order_relaxed ); i != head; ++i ) {
+      auto& record = buffer->records[i & buffer->mask];
+      m_batch.emplace_back( record.time, &record );
+    }
+    m_heads.push_back( head );
+  }
+  std::stable_sort( m_batch.begin(), m_batch.end(),
+                    []( const auto& a, const auto& b ) { return a.first < b.first; } );
+
+  {
+    // the messages reported directly during finalize() may be printed at the same time
+    auto lock = std::scoped_lock{ m_reportMutex };
+    for ( auto& [time, record] : m_batch ) print( *record );
+    if ( dropped ) {
+      m_droppedTotal += dropped;
+      i_reportMessage( Message{ name(), MSG::WARNING,
+                                std::to_string( dropped ) + " messages dropped because the buffers were full" },
+                       MSG::NIL );
+    }
+  }
+
+  // give the printed records back to the threads
+  for ( std::size_t i = 0; i != m_drainBuffers.size(); ++i ) {
+    m_drainBuffers[i]->tail.store( m_heads[i], std::memory_order_release );
+  }
+  return m_batch.size();
+}
+
+void AsyncMessageSvc::printerLoop() {
+  const auto latency =
+      std::chrono::duration_cast<std::chrono::steady_clock::duration>( std::chrono::duration<double>( m_latency ) );
+  while ( true ) {
+    const bool stopping = m_stopping;
+    if ( drain() ) continue; // more records may have arrived meanwhile
+    if ( stopping ) break;   // nothing left after the last reports
+    auto lock = std::unique_lock{ m_wakeUpMutex };
+    if ( !m_stopping ) m_wakeUp.wait_for( lock, latency );
+  }
+}
@@ -0,0 +1,157 @@
+/***********************************************************************************\
+* (c) Copyright 2022 CERN for the benefit of the LHCb and ATLAS collaborations      *
+*                                                                                   *
+* This software is distributed under the terms of the Apache version 2 licence,     *
+* copied verbatim in the file "LICENSE".                                            *
+*                                                                                   *
+* In applying this licence, CERN does not waive the privileges and immunities       *
+* granted to it by virtue of its status as an Intergovernmental Organization        *
+* or submit itself to any jurisdiction.                                             *
+\***********************************************************************************/
+#ifndef MESSAGESVC_ASYNCMESSAGESVC_H
+#define MESSAGESVC_ASYNCMESSAGESVC_H 1
+
+#include "MessageSvc.h"
+
+#include <Gaudi/Concurrency/PerThread.h>
+
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+/** @class AsyncMessageSvc AsyncMessageSvc.h MessageSvc/AsyncMessageSvc.h
+ *
+ * Asynchronous extension of the standard MessageSvc.
+ *
+ * Each thread copies the messages it reports into fixed size records of its own ring buffer,
+ * without locking nor allocating (only messages too long for a record are copied to the heap).
+ * A single background thread collects the records of all threads, orders them by the time they
+ * were reported and prints them with the standard MessageSvc logic.
+ *
+ * Messages reported through MsgStream carry the text formatted by the reporting thread, except
+ * those reported with Gaudi::reportDeferred (IDeferredMessageSvc): their format string and the
+ * copies of the arguments are stored in the record and formatted by the background thread.
+ *
+ * When the buffer of a thread is full, the messages below BlockLevel are dropped (the number of
+ * dropped messages is printed as soon as there is space again), while the others wait for the
+ * background thread to make space.
+ *
+ * At finalization, the reports still being written to a buffer are waited for, then all the
+ * queued messages are printed.
+ */
+class AsyncMessageSvc : public extends<MessageSvc, IDeferredMessageSvc> {
+public:
+  using extends::extends;
+
+  StatusCode initialize() override;
+  StatusCode finalize() override;
+
+  using MessageSvc::reportMessage;
+
+  /// Implementation of IMessageSvc::reportMessage()
+  void reportMessage( const Message& msg ) override;
+
+  /// Implementation of IMessageSvc::reportMessage()
+  void reportMessage( const Message& msg, int outputLevel ) override;
+
+  /// Implementation of IMessageSvc::reportMessage()
+  void reportMessage( const StatusCode& code, std::string_view source = "" ) override;
+
+  /// Implementation of IDeferredMessageSvc::reportDeferred()
+  void reportDeferred( std::string_view source, int type, Gaudi::DeferredText& text ) override;
+
+private:
+  /// Fixed part of a message record.
+  struct alignas( std::max_align_t ) RecordHeader {
+    enum class Kind : std::uint8_t { Message, StatusCode, Deferred };
+
+    std::uint64_t              time        = 0; ///< steady clock time of the report, in ns
+    Kind                       kind        = Kind::Message;
+    int                        type        = 0;
+    int                        outputLevel = -1; ///< -1 means the level of the source
+    EventContext::ContextID_t  slot = EventContext::INVALID_CONTEXT_ID;
+    EventContext::ContextEvt_t evt  = EventContext::INVALID_CONTEXT_EVT;
+    EventIDBase                eventID;
+    pthread_t                  thread{};
+    StatusCode                 code;
+    std::unique_ptr<Message>   overflow;           ///< message too long for the record
+    Gaudi::DeferredText*       deferred = nullptr; ///< text to format, stored in data after the source
+    std::uint16_t              sourceSize = 0;
+    std::uint16_t              textSize   = 0;
+  };
+  static constexpr std::size_t RecordSize = 512;
+  /// Message record: source and text (or deferred text) are stored inline after the header.
+  struct Record : RecordHeader {
+    char data[RecordSize - sizeof( RecordHeader )]; // aligned as std::max_align_t
+  };
+
+  /// Ring buffer of the records of one thread.
+  struct ThreadBuffer {
+    ThreadBuffer( std::size_t size ) : records{ std::make_unique<Record[]>( size ) }, mask{ size - 1 } {}
+
+    std::unique_ptr<Record[]>                records;
+    const std::size_t                        mask;
+    alignas( 64 ) std::atomic<std::uint64_t> head{ 0 };    ///< next record to use (written by the owning thread)
+    alignas( 64 ) std::atomic<std::uint64_t> tail{ 0 };    ///< first record not yet printed (written by the printer)
+    std::atomic<std::uint64_t>               dropped{ 0 }; ///< messages lost because the buffer was full
+  };
+
+  /// Registers a report being written to a buffer, finalize() waits for all of them before the last drain.
+  class Writer {
+  public:
+    Writer( std::atomic<int>& count ) : m_count{ &count } { m_count->fetch_add( 1 ); }
+    ~Writer() { release(); }
+    /// The report does not use the buffers (the service is not running).
+    void release() {
+      if ( m_count ) m_count->fetch_sub( 1, std::memory_order_release );
+      m_count = nullptr;
+    }
+
+  private:
+    std::atomic<int>* m_count;
+  };
+
+  ThreadBuffer& localBuffer();
+
+  /// Get a free record of the buffer of the current thread, or nullptr if the message has to be dropped.
+  Record* acquire( ThreadBuffer& buffer, int type );
+  /// Make the record filled after acquire() visible to the printer.
+  void publish( ThreadBuffer& buffer );
+
+  /// Print the records published by all threads, returns the number of records printed.
+  std::size_t drain();
+  void        print( Record& record );
+  void        printerLoop();
+
+  Gaudi::Property<std::size_t> m_bufferSize{ this, "BufferSize", 4096,
+                                             "number of messages buffered per thread (rounded up to a power of 2)" };
+  Gaudi::Property<int>         m_blockLevel{
+      this, "BlockLevel", MSG::WARNING,
+      "messages of this level or above wait for space in a full buffer, the others are dropped" };
+  Gaudi::Property<double> m_latency{ this, "Latency", 0.05, "maximum delay in seconds before printing a message" };
+
+  Gaudi::Concurrency::PerThread<ThreadBuffer> m_buffers;
+
+  /// reports being written to the buffers
+  std::atomic<int> m_writers{ 0 };
+
+  // state of the printer thread
+  std::thread             m_printer;
+  std::atomic<bool>       m_running{ false };  ///< reports go to the buffers
+  std::atomic<bool>       m_stopping{ false }; ///< the printer exits once the buffers are empty
+  std::mutex              m_wakeUpMutex;
+  std::condition_variable m_wakeUp;
+
+  // used only by the printer thread
+  std::vector<ThreadBuffer*>                     m_drainBuffers;
+  std::vector<std::uint64_t>                     m_heads;
+  std::vector<std::pair<std::uint64_t, Record*>> m_batch;
+  std::uint64_t                                  m_droppedTotal = 0;
+};
+
+#endif // MESSAGESVC_ASYNCMESSAGESVC_H
@@ -0,0 +1,99 @@
+/***********************************************************************************\
+* (c) Copyright 2022 CERN for the benefit of the LHCb and ATLAS collaborations      *
+*                                                                                   *
+* This software is distributed under the terms of the Apache version 2 licence,     *
+* copied verbatim in the file "LICENSE".                                            *
+*                                                                                   *
+* In applying this licence, CERN does not waive the privileges and immunities       *
+* granted to it by virtue of its status as an Intergovernmental Organization        *
+* or submit itself to any jurisdiction.                                             *
+\***********************************************************************************/
+#pragma once
+
+#include <GaudiKernel/IMessageSvc.h>
+#include <GaudiKernel/Message.h>
+
+#include <chrono>
+#include <cstdint>
+#include <fstream>
+#include <map>
+#include <string>
+#include <string_view>
+
+/** Writes messages to a file in a compact binary format, decoded by the gaudi_log_decode script.
+ *
+ * The file starts with the 8 characters "GAUDILOG" and the format version (uint32, little endian),
+ * followed by records made of a one byte tag and:
+ *  - tag 1, definition of a message source: id, size and characters,
+ *  - tag 2, message: time, source id, level (one byte), event slot + 1, event number + 1 (0 for
+ *    invalid slots and event numbers), size and characters of the text.
+ * Numbers are unsigned LEB128 variable length integers, except the time, which is the difference in
+ * ns with the time of the previous message (the Unix epoch for the first one) as a zigzag encoded
+ * signed LEB128 integer.
+ *
+ * Not thread safe: the calls are serialized by the message service.
+ */
+class BinaryLogWriter {
+public:
+  static constexpr std::string_view magic{ "GAUDILOG" };
+  static constexpr std::uint32_t    version{ 1 };
+
+  explicit BinaryLogWriter( const std::string& fileName ) : m_os{ fileName, std::ios::out | std::ios::binary } {
+    m_buffer.append( magic );
+    for ( int i = 0; i != 4; ++i ) m_buffer.push_back( char( ( version >> ( 8 * i ) ) & 0xff ) );
+    flush();
+  }
+
+  bool good() const { return m_os.good(); }
+
+  void write( const Message& msg ) {
+    const auto& source = msg.getSource();
+    auto        id     = m_sources.find( source );
+    if ( id == m_sources.end() ) {
+      id = m_sources.emplace( source, m_sources.size() ).first;
+      m_buffer.push_back( char( 1 ) );
+      put( id->second );
+      put( source.size() );
+      m_buffer.append( source );
+    }
+    const std::int64_t time = std::chrono::duration_cast<std::chrono::nanoseconds>(
+                                  std::chrono::system_clock::now().time_since_epoch() )
+                                  .count();
+    const std::int64_t delta = time - m_lastTime;
+    m_lastTime               = time;
+
+    const auto& text = msg.getMessage();
+    m_buffer.push_back( char( 2 ) );
+    put( ( std::uint64_t( delta ) << 1 ) ^ std::uint64_t( delta >> 63 ) ); // zigzag
+    put( id->second );
+    m_buffer.push_back( char( msg.getType() ) );
+    put( msg.getEventSlot() + 1 );   // the invalid value (all bits set) becomes 0
+    put( msg.getEventNumber() + 1 ); // idem
+    put( text.size() );
+    m_buffer.append( text );
+    // keep the buffer small, and make sure that errors reach the file in case of crash
+    if ( m_buffer.size() > 65536 || msg.getType() >= MSG::ERROR ) flush();
+  }
+
+  void flush() {
+    m_os.write( m_buffer.data(), m_buffer.size() );
+    m_os.flush();
+    m_buffer.clear();
+  }
+
+  ~BinaryLogWriter() { flush(); }
+
+private:
+  void put( std::uint64_t value ) {
+    while ( value >= 0x80 ) {
+      m_buffer.push_back( char( ( value & 0x7f ) | 0x80 ) );
+      value >>= 7;
+    }
+    m_buffer.push_back( char( value ) );
+  }
+
+  std::ofstream                                     m_os;
+  std::string                                       m_buffer;
+  std::map<std::string, std::uint64_t, std::less<>> m_sources;
+  std::int64_t                                      m_lastTime = 0;
+};
@@ -0,0 +1,103 @@
+/***********************************************************************************\
+* (c) Copyright 2022 CERN for the benefit of the LHCb and ATLAS collaborations      *
+*                                                                                   *
+* This software is distributed under the terms of the Apache version 2 licence,     *
+* copied verbatim in the file "LICENSE".                                            *
+*                                                                                   *
+* In applying this licence, CERN does not waive the privileges and immunities       *
+* granted to it by virtue of its status as an Intergovernmental Organization        *
+* or submit itself to any jurisdiction.                                             *
+\***********************************************************************************/
+
+#include "GaudiKernel/Service.h"
+
+#include <Gaudi/MonitoringBinaryFormat.h>
+#include <Gaudi/MonitoringHub.h>
+
+#include <fstream>
+
+#include <algorithm>
+#include <deque>
+#include <regex>
+#include <string>
+
+namespace Gaudi::Monitoring {
+
+  /**
+   * Sink writing the entities in the compact binary format of Gaudi/MonitoringBinaryFormat.h.
+   *
+   * Contrary to JSONSink, entities are serialized and written one by one, so that the whole
+   * document never has to be kept in memory. The files can be converted to the JSON output of
+   * JSONSink or to ROOT histograms with the gaudi_monitoring_convert script.
+   */
+  class BinarySink : public Service, public Hub::Sink {
+
+  public:
+    using Service::Service;
+
+    StatusCode initialize() override {
+      return Service::initialize().andThen( [&] {
+        m_namesRegex      = toRegex( m_namesToSave );
+        m_componentsRegex = toRegex( m_componentsToSave );
+        m_typesRegex      = toRegex( m_typesToSave );
+        serviceLocator()->monitoringHub().addSink( this );
+      } );
+    }
+
+    StatusCode finalize() override {
+      serviceLocator()->monitoringHub().removeSink( this );
+      return Service::finalize();
+    }
+
+    StatusCode stop() override {
+      auto ok = Service::stop();
+      if ( !ok ) return ok;
+      if ( m_fileName.empty() ) { return ok; }
+
+      info() << "Writing binary monitoring file " << m_fileName.value() << endmsg;
+      std::ofstream        os( m_fileName, std::ios::out | std::ios::binary );
+      BinaryFormat::Writer writer( os );
+      for ( auto& ent : m_monitoringEntities ) writer.write( ent );
+      os.close();
+      if ( !os ) {
+        error() << "Failed to write " << m_fileName.value() << endmsg;
+        return StatusCode::FAILURE;
+      }
+      return ok;
+    }
+
+    void registerEntity( Hub::Entity ent ) override {
+      if ( wanted( ent.type, m_typesRegex ) && wanted( ent.name, m_namesRegex ) &&
+           wanted( ent.component, m_componentsRegex ) ) {
+        m_monitoringEntities.emplace_back( std::move( ent ) );
+      }
+    }
+
+    void removeEntity( Hub::Entity const& ent ) override {
+      auto it = std::find( begin( m_monitoringEntities ), end( m_monitoringEntities ), ent );
+      if ( it != m_monitoringEntities.end() ) { m_monitoringEntities.erase( it ); }
+    }
+
+  private:
+    static std::vector<std::regex> toRegex( std::vector<std::string> const& patterns ) {
+      return { begin( patterns ), end( patterns ) };
+    }
+    static bool wanted( std::string const& name, std::vector<std::regex> const& regexes ) {
+      return regexes.empty() || std::any_of( begin( regexes ), end( regexes ),
+                                             [&name]( auto const& r ) { return std::regex_match( name, r ); } );
+    }
+
+    std::deque<Gaudi::Monitoring::Hub::Entity> m_monitoringEntities;
+    std::vector<std::regex>                    m_namesRegex, m_componentsRegex, m_typesRegex;
+
+    Gaudi::Property<std::string> m_fileName{ this, "FileName", "monitoring.gmon", "Name of output binary file" };
+    Gaudi::Property<std::vector<std::string>> m_namesToSave{ this, "NamesToSave", {}, "Names of entities to save" };
+    Gaudi::Property<std::vector<std::string>> m_componentsToSave{
+        this, "ComponentsToSave", {}, "Component names of entities to save" };
+    Gaudi::Property<std::vector<std::string>> m_typesToSave{
+        this, "TypesToSave", {}, "Type names of entities to save" };
+  };
+
+  DECLARE_COMPONENT( BinarySink )
+
+} // namespace Gaudi::Monitoring
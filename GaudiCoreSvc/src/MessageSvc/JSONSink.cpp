@@ -26,7 +26,16 @@ namespace Gaudi::Monitoring {
     using Service::Service;
 
     StatusCode initialize() override {
-      return Service::initialize().andThen( [&] { serviceLocator()->monitoringHub().addSink( this ); } );
+      return Service::initialize().andThen( [&] {
+        if ( !m_snapshotFileName.empty() ) m_snapshotStream.open( m_snapshotFileName, std::ios::out );
+        serviceLocator()->monitoringHub().addSink( this );
+      } );
+    }
+
+    StatusCode finalize() override {
+      serviceLocator()->monitoringHub().removeSink( this );
+      if ( m_snapshotStream.is_open() ) m_snapshotStream.close();
+      return Service::finalize();
     }
 
     StatusCode stop() override {
@@ -50,10 +59,21 @@ namespace Gaudi::Monitoring {
     }
 
     void registerEntity( Hub::Entity ent ) override {
-      if ( wanted( ent.type, m_typesToSave ) && wanted( ent.name, m_namesToSave ) &&
-           wanted( ent.component, m_componentsToSave ) ) {
-        m_monitoringEntities.emplace_back( std::move( ent ) );
-      }
+      if ( wanted( ent ) ) { m_monitoringEntities.emplace_back( std::move( ent ) ); }
+    }
+
+    /// writes one line of JSON per changed entity to the snapshot file, if any
+    void onSnapshot( std::uint64_t snapshot, Hub::Entity const& ent, nlohmann::json const& value ) override {
+      if ( !m_snapshotStream.is_open() || !wanted( ent ) ) return;
+      m_snapshotStream << nlohmann::json{ { "snapshot", snapshot },
+                                          { "name", ent.name },
+                                          { "component", ent.component },
+                                          { "entity", value } }
+                       << '\n';
+    }
+
+    void onSnapshotEnd( std::uint64_t ) override {
+      if ( m_snapshotStream.is_open() ) m_snapshotStream.flush();
     }
 
     void removeEntity( Hub::Entity const& ent ) override {
@@ -62,6 +82,10 @@ namespace Gaudi::Monitoring {
     }
 
   private:
+    bool wanted( Hub::Entity const& ent ) {
+      return wanted( ent.type, m_typesToSave ) && wanted( ent.name, m_namesToSave ) &&
+             wanted( ent.component, m_componentsToSave );
+    }
     bool wanted( std::string name, std::vector<std::string> searchNames ) {
       if ( searchNames.empty() ) { return true; }
       for ( const auto& searchName : searchNames ) {
@@ -78,6 +102,10 @@ namespace Gaudi::Monitoring {
         this, "ComponentsToSave", {}, "Component names of entities to save" };
     Gaudi::Property<std::vector<std::string>> m_typesToSave{
         this, "TypesToSave", {}, "Type names of entities to save" };
+    Gaudi::Property<std::string> m_snapshotFileName{
+        this, "SnapshotFileName", "", "Name of the file receiving the periodic snapshots, one JSON entity per line" };
+
+    std::ofstream m_snapshotStream;
   };
 
   DECLARE_COMPONENT( JSONSink )
@@ -15,6 +15,7 @@
 #endif
 
 #include "MessageSvc.h"
+#include "BinaryLogWriter.h"
 #include "GaudiKernel/IAppMgrUI.h"
 #include "GaudiKernel/Kernel.h"
 #include "GaudiKernel/Message.h"
@@ -100,6 +101,8 @@ MessageSvc::MessageSvc( const std::string& name, ISvcLocator* svcloc ) : base_cl
   std::fill( std::begin( m_msgCount ), std::end( m_msgCount ), 0 );
 }
 
+MessageSvc::~MessageSvc() = default;
+
 //#############################################################################
 
 /// Initialize Service
@@ -114,6 +117,16 @@ StatusCode MessageSvc::initialize() {
   // make sure the map of logged stream names is initialized
   setupLogStreams();
 
+  m_binaryLog.reset();
+  if ( !m_binaryLogFile.empty() ) {
+    auto binaryLog = std::make_unique<BinaryLogWriter>( m_binaryLogFile );
+    if ( !binaryLog->good() ) {
+      error() << "cannot open BinaryLogFile " << m_binaryLogFile.value() << endmsg;
+      return StatusCode::FAILURE;
+    }
+    m_binaryLog = std::move( binaryLog );
+  }
+
   return StatusCode::SUCCESS;
 }
 
@@ -332,6 +345,8 @@ StatusCode MessageSvc::finalize() {
   }
 #endif
 
+  m_binaryLog.reset(); // flush and close the file
+
   return StatusCode::SUCCESS;
 }
 
@@ -363,7 +378,10 @@ void MessageSvc::i_reportMessage( const Message& msg, int outputLevel ) {
 
     // Increase the counter of 'key' type of messages for the source and
     // get the new value.
-    const int nmsg = ++( m_sourceMap[msg.getSource()].msg[key] );
+    const int nmsg = [&] {
+      auto lock = std::scoped_lock{ m_sourceMapMutex };
+      return ++( m_sourceMap[msg.getSource()].msg[key] );
+    }();
 
     if ( m_suppress.value() && m_msgLimit[key] != 0 ) {
       if ( nmsg > m_msgLimit[key] ) return;
@@ -376,6 +394,8 @@ void MessageSvc::i_reportMessage( const Message& msg, int outputLevel ) {
     }
   }
 
+  if ( m_binaryLog && key >= outputLevel ) m_binaryLog->write( *cmsg );
+
   auto range = m_streamMap.equal_range( key );
   if ( range.first != m_streamMap.end() ) {
     std::for_each( range.first, range.second,
@@ -588,6 +608,22 @@ std::string MessageSvc::getLogColor( int logLevel ) const {
 // ---------------------------------------------------------------------------
 int MessageSvc::messageCount( MSG::Level level ) const { return m_msgCount[level]; }
 
+// ---------------------------------------------------------------------------
+bool MessageSvc::suppressMessage( MSG::Level level, std::string_view source ) {
+  // same conditions as in i_reportMessage, where the message limit is applied after formatting
+  if ( !m_suppress.value() || m_msgLimit[level] == 0 ) return false;
+  // the logged streams receive also the suppressed messages
+  if ( !m_loggedStreams.empty() && m_loggedStreams.find( source ) != m_loggedStreams.end() ) return false;
+
+  auto lock  = std::scoped_lock{ m_sourceMapMutex };
+  auto entry = m_sourceMap.find( source );
+  if ( entry == m_sourceMap.end() || entry->second.msg[level] < m_msgLimit[level] ) return false;
+  // count the message as if it was reported
+  ++entry->second.msg[level];
+  ++m_msgCount[level];
+  return true;
+}
+
 // ---------------------------------------------------------------------------
 void MessageSvc::incrInactiveCount( MSG::Level level, std::string_view source ) {
   auto entry = m_inactiveMap.find( source );
@@ -12,6 +12,8 @@
 #define GAUDI_MESSAGESVC_H
 
 // Include files
+#include <array>
+#include <atomic>
 #include <iosfwd>
 #include <map>
 #include <memory>
@@ -28,6 +30,7 @@
 
 // Forward declarations
 class ISvcLocator;
+class BinaryLogWriter;
 
 //
 // ClassName:   MessageSvc
@@ -37,7 +40,7 @@ class ISvcLocator;
 //
 // Author:      Iain Last
 //
-class MessageSvc : public extends<Service, IMessageSvc, IInactiveMessageCounter> {
+class MessageSvc : public extends<Service, IMessageSvc, IInactiveMessageCounter, IMessageLimiter> {
 public:
   typedef std::pair<std::string, std::ostream*>   NamedStream;
   typedef std::multimap<int, NamedStream>         StreamMap;
@@ -47,6 +50,9 @@ public:
   // Default constructor.
   MessageSvc( const std::string& name, ISvcLocator* svcloc );
 
+  // Destructor (BinaryLogWriter is incomplete here).
+  ~MessageSvc() override;
+
   // Implementation of IService::reinitialize()
   StatusCode reinitialize() override;
   // Implementation of IService::initialize()
@@ -126,6 +132,9 @@ public:
   // Implementation of IInactiveMessageCounter::incrInactiveCount()
   void incrInactiveCount( MSG::Level level, std::string_view src ) override;
 
+  // Implementation of IMessageLimiter::suppressMessage()
+  bool suppressMessage( MSG::Level level, std::string_view src ) override;
+
 protected:
   /// Internal implementation of reportMessage(const Message&,int) without lock.
   virtual void i_reportMessage( const Message& msg, int outputLevel );
@@ -133,6 +142,9 @@ protected:
   /// Internal implementation of reportMessage(const StatusCode&,const std::string&) without lock.
   virtual void i_reportMessage( const StatusCode& code, std::string_view source );
 
+  /// Mutex to synchronize multiple threads printing.
+  mutable std::recursive_mutex m_reportMutex;
+
 private:
   Gaudi::Property<std::string>  m_defaultFormat{ this, "Format", Message::getDefaultFormat(), "" };
   Gaudi::Property<std::string>  m_defaultTimeFormat{ this, "timeFormat", Message::getDefaultTimeFormat(), "" };
@@ -180,6 +192,10 @@ private:
   Gaudi::Property<std::map<std::string, std::string, std::less<>>> m_loggedStreamsName{
       this, "loggedStreams", {}, "MessageStream sources we want to dump into a logfile" };
 
+  Gaudi::Property<std::string> m_binaryLogFile{
+      this, "BinaryLogFile", "",
+      "if set, write also the printed messages to this file, in a compact binary format (see gaudi_log_decode)" };
+
   std::ostream* m_defaultStream = &std::cout; ///< Pointer to the output stream.
   Message       m_defaultMessage;             ///< Default Message
   StreamMap     m_streamMap;                  ///< Stream map
@@ -198,10 +214,12 @@ private:
 
   std::map<std::string, MsgAry, std::less<>> m_sourceMap, m_inactiveMap;
 
-  std::array<int, MSG::NUM_LEVELS> m_msgCount;
+  std::array<std::atomic<int>, MSG::NUM_LEVELS> m_msgCount;
 
   std::map<std::string, std::shared_ptr<std::ostream>, std::less<>> m_loggedStreams;
 
+  std::unique_ptr<BinaryLogWriter> m_binaryLog;
+
   void setupColors( Gaudi::Details::PropertyBase& prop );
   void setupLimits( Gaudi::Details::PropertyBase& prop );
   void setupThreshold( Gaudi::Details::PropertyBase& prop );
@@ -209,8 +227,9 @@ private:
 
   void setupLogStreams();
 
-  /// Mutex to synchronize multiple threads printing.
-  mutable std::recursive_mutex m_reportMutex;
+  /// Mutex to synchronize multiple access to m_sourceMap (also used before the messages are reported,
+  /// @see suppressMessage).
+  mutable std::mutex m_sourceMapMutex;
 
   /// Mutex to synchronize multiple access to m_messageMap.
   mutable std::recursive_mutex m_messageMapMutex;
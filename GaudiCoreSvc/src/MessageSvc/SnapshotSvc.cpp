@@ -0,0 +1,88 @@
+/***********************************************************************************\
+* (c) Copyright 2022 CERN for the benefit of the LHCb and ATLAS collaborations      *
+*                                                                                   *
+* This software is distributed under the terms of the Apache version 2 licence,     *
+* copied verbatim in the file "LICENSE".                                            *
+*                                                                                   *
+* In applying this licence, CERN does not waive the privileges and immunities       *
+* granted to it by virtue of its status as an Intergovernmental Organization        *
+* or submit itself to any jurisdiction.                                             *
+\***********************************************************************************/
+#include "GaudiKernel/Service.h"
+
+#include <Gaudi/MonitoringHub.h>
+
+#include <chrono>
+#include <condition_variable>
+#include <mutex>
+#include <thread>
+
+namespace Gaudi::Monitoring {
+
+  /**
+   * Publishes periodic snapshots of the Monitoring::Hub entities, from a dedicated thread, between start and stop.
+   *
+   * Only the entities that changed since the previous snapshot are passed to the sinks, through
+   * Hub::Sink::onSnapshot, so that online jobs can be monitored without pausing the event processing.
+   */
+  class SnapshotSvc : public Service {
+  public:
+    using Service::Service;
+
+    StatusCode start() override {
+      return Service::start().andThen( [&] {
+        if ( m_period <= 0 ) return;
+        m_stopping = false;
+        m_thread   = std::thread{ [this] { run(); } };
+      } );
+    }
+
+    StatusCode stop() override {
+      if ( m_thread.joinable() ) {
+        {
+          std::scoped_lock lock{ m_mutex };
+          m_stopping = true;
+        }
+        m_wakeUp.notify_one();
+        m_thread.join();
+        if ( m_nSnapshots ) {
+          info() << "Published " << m_nSnapshots << " snapshots, on average "
+                 << m_totalTime.count() / m_nSnapshots * 1e3 << " ms and " << double( m_nChanged ) / m_nSnapshots
+                 << " changed entities per snapshot" << endmsg;
+        }
+      }
+      return Service::stop();
+    }
+
+  private:
+    void run() {
+      auto&                               hub = serviceLocator()->monitoringHub();
+      const std::chrono::duration<double> period{ m_period.value() };
+      std::unique_lock                    lock{ m_mutex };
+      while ( !m_wakeUp.wait_for( lock, period, [this] { return m_stopping; } ) ) {
+        lock.unlock();
+        auto start = std::chrono::steady_clock::now();
+        m_nChanged += hub.publishSnapshot();
+        m_totalTime += std::chrono::steady_clock::now() - start;
+        ++m_nSnapshots;
+        lock.lock();
+      }
+    }
+
+    Gaudi::Property<double> m_period{ this, "Period", 10.,
+                                      "Time between two snapshots, in seconds (no snapshot if not positive)" };
+
+    std::thread             m_thread;
+    std::mutex              m_mutex;
+    std::condition_variable m_wakeUp;
+    bool                    m_stopping{ false };
+
+    // statistics, only accessed by the snapshot thread until it is joined
+    std::size_t                   m_nSnapshots{ 0 };
+    std::size_t                   m_nChanged{ 0 };
+    std::chrono::duration<double> m_totalTime{ 0 };
+  };
+
+  DECLARE_COMPONENT( SnapshotSvc )
+
+} // namespace Gaudi::Monitoring
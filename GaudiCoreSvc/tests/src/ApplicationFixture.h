@@ -0,0 +1,60 @@
+/***********************************************************************************\
+* (c) Copyright 2022 CERN for the benefit of the LHCb and ATLAS collaborations      *
+*                                                                                   *
+* This software is distributed under the terms of the Apache version 2 licence,     *
+* copied verbatim in the file "LICENSE".                                            *
+*                                                                                   *
+* In applying this licence, CERN does not waive the privileges and immunities       *
+* granted to it by virtue of its status as an Intergovernmental Organization        *
+* or submit itself to any jurisdiction.                                             *
+\***********************************************************************************/
+#pragma once
+
+#include <GaudiKernel/Bootstrap.h>
+#include <GaudiKernel/IAppMgrUI.h>
+#include <GaudiKernel/IProperty.h>
+#include <GaudiKernel/SmartIF.h>
+#include <GaudiKernel/System.h>
+
+#include <stdexcept>
+#include <string>
+#include <utility>
+#include <vector>
+
+/** Initialized application for the unit tests of services, to be used as (or as the base of) a
+ *  BOOST_GLOBAL_FIXTURE.
+ *
+ *  The libraries are loaded explicitly (bypassing the PluginService) and the properties of the
+ *  ApplicationMgr are set, as Python representations, before the configuration.
+ */
+struct ApplicationFixture {
+  using Properties = std::vector<std::pair<std::string, std::string>>;
+
+  ApplicationFixture( const std::vector<std::string>& libraries = { "libGaudiCoreSvc.so" },
+                      const Properties&               properties = {} ) {
+    for ( const auto& lib : libraries ) {
+      System::ImageHandle handle;
+      System::loadDynamicLib( lib, &handle );
+    }
+    app = Gaudi::createApplicationMgr();
+    SmartIF<IProperty> appProp{ app };
+    appProp->setProperty( "JobOptionsType", "NONE" ).ignore();
+    appProp->setPropertyRepr( "AppName", "''" ).ignore();
+    appProp->setProperty( "OutputLevel", 6 ).ignore();
+    for ( const auto& [name, value] : properties ) {
+      if ( appProp->setPropertyRepr( name, value ).isFailure() ) {
+        throw std::runtime_error( "cannot set ApplicationMgr." + name + " = " + value );
+      }
+    }
+    // (no test assertions in a global fixture)
+    if ( app->configure().isFailure() || app->initialize().isFailure() ) {
+      throw std::runtime_error( "cannot initialize the application" );
+    }
+  }
+  ~ApplicationFixture() {
+    app->finalize().ignore();
+    app->terminate().ignore();
+  }
+
+  SmartIF<IAppMgrUI> app;
+};
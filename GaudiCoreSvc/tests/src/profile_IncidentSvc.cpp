@@ -0,0 +1,122 @@
+/***********************************************************************************\
+* (c) Copyright 2022 CERN for the benefit of the LHCb and ATLAS collaborations      *
+*                                                                                   *
+* This software is distributed under the terms of the Apache version 2 licence,     *
+* copied verbatim in the file "LICENSE".                                            *
+*                                                                                   *
+* In applying this licence, CERN does not waive the privileges and immunities       *
+* granted to it by virtue of its status as an Intergovernmental Organization        *
+* or submit itself to any jurisdiction.                                             *
+\***********************************************************************************/
+// Cost of firing the BeginEvent/EndEvent incidents with many listeners, by incident type and by
+// handle, of firing an incident that nobody listens to, and of a slow listener (10 us per
+// incident) for the thread that fires the incidents, when it is synchronous and asynchronous.
+//
+// usage: profile_IncidentSvc [n_listeners] [n_events]
+#include <GaudiKernel/Bootstrap.h>
+#include <GaudiKernel/IAppMgrUI.h>
+#include <GaudiKernel/IIncidentListener.h>
+#include <GaudiKernel/IIncidentSvc.h>
+#include <GaudiKernel/IProperty.h>
+#include <GaudiKernel/ISvcLocator.h>
+#include <GaudiKernel/Incident.h>
+#include <GaudiKernel/SmartIF.h>
+#include <GaudiKernel/System.h>
+#include <GaudiKernel/implements.h>
+
+#include <algorithm>
+#include <chrono>
+#include <cstdlib>
+#include <iostream>
+#include <memory>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace {
+  struct Listener : implements<IIncidentListener> {
+    void          handle( const Incident& ) override { ++count; }
+    unsigned long count = 0;
+  };
+
+  struct SlowListener : implements<IIncidentListener> {
+    void handle( const Incident& ) override { std::this_thread::sleep_for( std::chrono::microseconds( 10 ) ); }
+  };
+
+  template <typename F>
+  void measure( const std::string& what, int n_events, F&& fire ) {
+    auto start = std::chrono::high_resolution_clock::now();
+    for ( int i = 0; i != n_events; ++i ) fire();
+    std::chrono::duration<double> elapsed = std::chrono::high_resolution_clock::now() - start;
+    std::cout << what << ": " << elapsed.count() / n_events * 1e9 << " ns per event" << std::endl;
+  }
+} // namespace
+
+int main( int argc, char* argv[] ) {
+  const int n_listeners = argc > 1 ? std::atoi( argv[1] ) : 100;
+  const int n_events    = argc > 2 ? std::atoi( argv[2] ) : 1000000;
+
+  // Load required libraries (bypass PluginService)
+  {
+    System::ImageHandle handle;
+    System::loadDynamicLib( "libGaudiCoreSvc.so", &handle );
+  }
+
+  auto               app = Gaudi::createApplicationMgr();
+  SmartIF<IProperty> appProp{ app };
+  appProp->setProperty( "JobOptionsType", "NONE" ).ignore();
+  appProp->setPropertyRepr( "AppName", "''" ).ignore();
+  if ( app->configure().isFailure() ) {
+    std::cerr << "cannot configure the application" << std::endl;
+    return 1;
+  }
+  auto incSvc = Gaudi::svcLocator()->service<IIncidentSvc>( "IncidentSvc" );
+
+  std::vector<std::unique_ptr<Listener>> listeners;
+  for ( int i = 0; i != n_listeners; ++i ) {
+    auto& l = listeners.emplace_back( std::make_unique<Listener>() );
+    l->addRef(); // the service does not own the listeners
+    incSvc->addListener( l.get(), IncidentType::BeginEvent, i % 4 );
+    incSvc->addListener( l.get(), IncidentType::EndEvent, i % 4 );
+  }
+
+  const Incident beginEvent{ "profile", IncidentType::BeginEvent };
+  const Incident endEvent{ "profile", IncidentType::EndEvent };
+  const Incident other{ "profile", "NobodyListensToThis" };
+
+  std::cout << n_listeners << " listeners of BeginEvent and EndEvent" << std::endl;
+  measure( "by type", n_events, [&]() {
+    incSvc->fireIncident( beginEvent );
+    incSvc->fireIncident( endEvent );
+  } );
+
+  const auto beginHandle = incSvc->incidentTypeHandle( IncidentType::BeginEvent );
+  const auto endHandle   = incSvc->incidentTypeHandle( IncidentType::EndEvent );
+  measure( "by handle", n_events, [&]() {
+    incSvc->fireIncident( beginEvent, beginHandle );
+    incSvc->fireIncident( endEvent, endHandle );
+  } );
+
+  measure( "no listeners", n_events, [&]() { incSvc->fireIncident( other ); } );
+
+  for ( auto& l : listeners ) incSvc->removeListener( l.get() );
+
+  // the application has to be initialized for the asynchronous delivery
+  if ( app->initialize().isFailure() ) {
+    std::cerr << "cannot initialize the application" << std::endl;
+    return 1;
+  }
+  SlowListener slow;
+  slow.addRef();
+  const Incident slowIncident{ "profile", "Slow" };
+  const int      n_slow = std::min( n_events, 10000 );
+  for ( bool async : { false, true } ) {
+    incSvc->addListener( &slow, "Slow", 0, false, false, async );
+    measure( async ? "slow asynchronous listener" : "slow synchronous listener", n_slow,
+             [&]() { incSvc->fireIncident( slowIncident ); } );
+    incSvc->removeListener( &slow, "Slow" ); // waits for the queued incidents
+  }
+
+  app->finalize().ignore();
+  app->terminate().ignore();
+}
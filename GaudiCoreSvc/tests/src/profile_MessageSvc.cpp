@@ -0,0 +1,96 @@
+/***********************************************************************************\
+* (c) Copyright 2022 CERN for the benefit of the LHCb and ATLAS collaborations      *
+*                                                                                   *
+* This software is distributed under the terms of the Apache version 2 licence,     *
+* copied verbatim in the file "LICENSE".                                            *
+*                                                                                   *
+* In applying this licence, CERN does not waive the privileges and immunities       *
+* granted to it by virtue of its status as an Intergovernmental Organization        *
+* or submit itself to any jurisdiction.                                             *
+\***********************************************************************************/
+// Throughput of a message service when many threads print at the same time: the time is measured
+// from the first message to the finalization of the service, so that it includes the printing
+// of the messages still buffered by the asynchronous services.
+// The messages are written to /dev/null. By default AsyncMessageSvc does not drop messages, so that
+// all services do the same work (see its BlockLevel property).
+// With "deferred" the messages are reported with Gaudi::reportDeferred, so that AsyncMessageSvc formats
+// them in its printer thread.
+//
+// usage: profile_MessageSvc [MessageSvc|InertMessageSvc|AsyncMessageSvc] [n_threads] [n_messages_per_thread]
+//                           [BlockLevel] [deferred]
+#include <Gaudi/LazyFormat.h>
+#include <GaudiKernel/Bootstrap.h>
+#include <GaudiKernel/IAppMgrUI.h>
+#include <GaudiKernel/IMessageSvc.h>
+#include <GaudiKernel/IProperty.h>
+#include <GaudiKernel/IService.h>
+#include <GaudiKernel/ISvcLocator.h>
+#include <GaudiKernel/MsgStream.h>
+#include <GaudiKernel/SmartIF.h>
+#include <GaudiKernel/System.h>
+
+#include <chrono>
+#include <cstdlib>
+#include <fstream>
+#include <iostream>
+#include <string>
+#include <string_view>
+#include <thread>
+#include <vector>
+
+int main( int argc, char* argv[] ) {
+  const std::string type       = argc > 1 ? argv[1] : "AsyncMessageSvc";
+  const int         n_threads  = argc > 2 ? std::atoi( argv[2] ) : 64;
+  const int         n_messages = argc > 3 ? std::atoi( argv[3] ) : 100000;
+  const int         blockLevel = argc > 4 ? std::atoi( argv[4] ) : MSG::NIL;
+  const bool        deferred   = argc > 5 && std::string_view{ argv[5] } == "deferred";
+
+  // Load required libraries (bypass PluginService)
+  {
+    System::ImageHandle handle;
+    System::loadDynamicLib( "libGaudiCoreSvc.so", &handle );
+  }
+
+  auto               app = Gaudi::createApplicationMgr();
+  SmartIF<IProperty> appProp{ app };
+  appProp->setProperty( "JobOptionsType", "NONE" ).ignore();
+  appProp->setPropertyRepr( "AppName", "''" ).ignore();
+  appProp->setProperty( "MessageSvcType", type ).ignore();
+  if ( app->configure().isFailure() ) {
+    std::cerr << "cannot configure the application with " << type << std::endl;
+    return 1;
+  }
+
+  auto          msgSvc = Gaudi::svcLocator()->service<IMessageSvc>( "MessageSvc" );
+  std::ofstream devNull( "/dev/null" );
+  msgSvc->setDefaultStream( &devNull );
+  if ( type == "AsyncMessageSvc" ) msgSvc.as<IProperty>()->setProperty( "BlockLevel", blockLevel ).ignore();
+
+  auto start = std::chrono::high_resolution_clock::now();
+
+  std::vector<std::thread> threads;
+  for ( int t = 0; t != n_threads; ++t ) {
+    threads.emplace_back( [&msgSvc, t, n_messages, deferred]() {
+      MsgStream log( msgSvc, "Source" + std::to_string( t ) );
+      for ( int i = 0; i != n_messages; ++i ) {
+        if ( deferred ) {
+          Gaudi::reportDeferred( log << MSG::INFO, "message {} value {}", i, 0.5 * i );
+        } else {
+          log << MSG::INFO << "message " << i << " value " << 0.5 * i << endmsg;
+        }
+      }
+    } );
+  }
+  for ( auto& thread : threads ) thread.join();
+  const auto produced = std::chrono::high_resolution_clock::now();
+
+  msgSvc.as<IService>()->finalize().ignore();
+  const auto end = std::chrono::high_resolution_clock::now();
+
+  const double n_total = double( n_threads ) * n_messages;
+
+  std::chrono::duration<double> elapsed = end - start, producing = produced - start;
+  std::cout << type << ( deferred ? " (deferred)" : "" ) << ": " << n_threads << " threads, " << n_total / elapsed.count() << " messages/s ("
+            << producing.count() / n_total * n_threads * 1e9 << " ns per message in the reporting threads)"
+            << std::endl;
+}
@@ -0,0 +1,135 @@
+/***********************************************************************************\
+* (c) Copyright 2022 CERN for the benefit of the LHCb and ATLAS collaborations      *
+*                                                                                   *
+* This software is distributed under the terms of the Apache version 2 licence,     *
+* copied verbatim in the file "LICENSE".                                            *
+*                                                                                   *
+* In applying this licence, CERN does not waive the privileges and immunities       *
+* granted to it by virtue of its status as an Intergovernmental Organization        *
+* or submit itself to any jurisdiction.                                             *
+\***********************************************************************************/
+#define BOOST_TEST_DYN_LINK
+#define BOOST_TEST_MODULE test_AlgExecStateSvc
+#include <boost/test/unit_test.hpp>
+
+#include "ApplicationFixture.h"
+
+#include <GaudiKernel/Bootstrap.h>
+#include <GaudiKernel/EventContext.h>
+#include <GaudiKernel/GaudiException.h>
+#include <GaudiKernel/IAlgExecStateSvc.h>
+#include <GaudiKernel/ISvcLocator.h>
+#include <GaudiKernel/SmartIF.h>
+
+namespace {
+  /// The service, with the algorithms "A" and "B" known and the states of the slot allocated.
+  SmartIF<IAlgExecStateSvc> stateSvc() {
+    auto svc = Gaudi::svcLocator()->service<IAlgExecStateSvc>( "AlgExecStateSvc" );
+    svc->addAlg( "A" );
+    svc->addAlg( "B" );
+    svc->reset( EventContext{ 0, 0 } );
+    return svc;
+  }
+
+  /// Read only access, as done by the monitoring and the schedulers.
+  const AlgExecState& constState( const IAlgExecStateSvc& svc, const char* alg, const EventContext& ctx ) {
+    return svc.algExecState( alg, ctx );
+  }
+} // namespace
+
+// the AlgExecStateSvc is created by the tests (one slot, no algorithms)
+BOOST_GLOBAL_FIXTURE( ApplicationFixture );
+
+BOOST_AUTO_TEST_CASE( const_state_and_reset ) {
+  auto               svc = stateSvc();
+  const EventContext ctx{ 1, 0 };
+  svc->reset( ctx );
+
+  // nothing ran yet in this event
+  BOOST_CHECK_EQUAL( constState( *svc, "A", ctx ).state(), AlgExecState::State::None );
+  BOOST_CHECK( constState( *svc, "A", ctx ).filterPassed() );
+
+  auto& a = svc->algExecState( svc->algIndex( "A" ), ctx );
+  a.setState( AlgExecState::State::Done );
+  a.setFilterPassed( false );
+  BOOST_CHECK_EQUAL( constState( *svc, "A", ctx ).state(), AlgExecState::State::Done );
+  BOOST_CHECK( !constState( *svc, "A", ctx ).filterPassed() );
+  BOOST_CHECK_EQUAL( constState( *svc, "B", ctx ).state(), AlgExecState::State::None );
+
+  // the states of the previous event are not visible after the reset, even before being touched
+  svc->reset( EventContext{ 2, 0 } );
+  BOOST_CHECK_EQUAL( svc->eventStatus( ctx ), EventStatus::Invalid );
+  BOOST_CHECK_EQUAL( constState( *svc, "A", ctx ).state(), AlgExecState::State::None );
+  BOOST_CHECK( constState( *svc, "A", ctx ).filterPassed() );
+
+  // the writable state is the same object, reset on first access
+  auto& again = svc->algExecState( svc->algIndex( "A" ), ctx );
+  BOOST_CHECK_EQUAL( &again, &a );
+  BOOST_CHECK_EQUAL( again.state(), AlgExecState::State::None );
+  BOOST_CHECK( again.filterPassed() );
+
+  BOOST_CHECK_THROW( constState( *svc, "Unknown", ctx ), GaudiException );
+}
+
+BOOST_AUTO_TEST_CASE( sub_slots ) {
+  auto         svc = stateSvc();
+  EventContext ctx{ 3, 0 };
+  svc->reset( ctx );
+  EventContext sub{ ctx };
+  sub.setSubSlot( 1 );
+
+  // a sub-slot that was never used
+  BOOST_CHECK_EQUAL( constState( *svc, "A", sub ).state(), AlgExecState::State::None );
+
+  auto& subState = svc->algExecState( svc->algIndex( "A" ), sub );
+  subState.setState( AlgExecState::State::Executing );
+  BOOST_CHECK_EQUAL( constState( *svc, "A", sub ).state(), AlgExecState::State::Executing );
+  // independent of the slot state
+  BOOST_CHECK_EQUAL( constState( *svc, "A", ctx ).state(), AlgExecState::State::None );
+  BOOST_CHECK( &svc->algExecState( svc->algIndex( "A" ), ctx ) != &subState );
+
+  // the sub-slots are reset with their slot, and reused in the next event
+  ctx.set( 4, 0 );
+  sub.set( 4, 0, 1 );
+  svc->reset( ctx );
+  BOOST_CHECK_EQUAL( constState( *svc, "A", sub ).state(), AlgExecState::State::None );
+  auto& reused = svc->algExecState( svc->algIndex( "A" ), sub );
+  BOOST_CHECK_EQUAL( &reused, &subState );
+  BOOST_CHECK_EQUAL( reused.state(), AlgExecState::State::None );
+  reused.setState( AlgExecState::State::Done );
+  BOOST_CHECK_EQUAL( constState( *svc, "A", sub ).state(), AlgExecState::State::Done );
+
+  // a sub-slot not used in this event is not affected by the others
+  sub.setSubSlot( 5 );
+  BOOST_CHECK_EQUAL( constState( *svc, "A", sub ).state(), AlgExecState::State::None );
+  BOOST_CHECK_EQUAL( svc->algExecState( svc->algIndex( "B" ), sub ).state(), AlgExecState::State::None );
+}
+
+BOOST_AUTO_TEST_CASE( snapshot ) {
+  auto               svc = stateSvc();
+  const EventContext ctx{ 5, 0 };
+  svc->reset( ctx );
+
+  svc->algExecState( svc->algIndex( "A" ), ctx ).setState( AlgExecState::State::Done );
+  {
+    const auto& states = svc->algExecStates( ctx );
+    BOOST_CHECK_EQUAL( states.size(), 2u );
+    BOOST_CHECK_EQUAL( states.at( "A" ).state(), AlgExecState::State::Done );
+    BOOST_CHECK_EQUAL( states.at( "B" ).state(), AlgExecState::State::None );
+  }
+
+  // the snapshot holds copies: it is updated only by the next call
+  auto  states = svc->algExecStates( ctx );
+  auto& b      = svc->algExecState( svc->algIndex( "B" ), ctx );
+  b.setState( AlgExecState::State::Executing );
+  BOOST_CHECK_EQUAL( states.at( "B" ).state(), AlgExecState::State::None );
+  BOOST_CHECK_EQUAL( svc->algExecStates( ctx ).at( "B" ).state(), AlgExecState::State::Executing );
+
+  // the states of the previous event are replaced by the default one
+  svc->reset( EventContext{ 6, 0 } );
+  for ( const auto& [name, state] : svc->algExecStates( ctx ) ) {
+    BOOST_TEST_CONTEXT( name.str() ) { BOOST_CHECK_EQUAL( state.state(), AlgExecState::State::None ); }
+  }
+  // and the stale states are not modified by the snapshot
+  BOOST_CHECK_EQUAL( b.state(), AlgExecState::State::Executing );
+}
@@ -0,0 +1,228 @@
+/***********************************************************************************\
+* (c) Copyright 2022 CERN for the benefit of the LHCb and ATLAS collaborations      *
+*                                                                                   *
+* This software is distributed under the terms of the Apache version 2 licence,     *
+* copied verbatim in the file "LICENSE".                                            *
+*                                                                                   *
+* In applying this licence, CERN does not waive the privileges and immunities       *
+* granted to it by virtue of its status as an Intergovernmental Organization        *
+* or submit itself to any jurisdiction.                                             *
+\***********************************************************************************/
+#define BOOST_TEST_DYN_LINK
+#define BOOST_TEST_MODULE test_AsyncMessageSvc
+#include <boost/test/unit_test.hpp>
+
+#include "ApplicationFixture.h"
+
+#include <Gaudi/Interfaces/IOptionsSvc.h>
+#include <Gaudi/LazyFormat.h>
+#include <GaudiKernel/Bootstrap.h>
+#include <GaudiKernel/IMessageSvc.h>
+#include <GaudiKernel/IService.h>
+#include <GaudiKernel/ISvcLocator.h>
+#include <GaudiKernel/Message.h>
+#include <GaudiKernel/MsgStream.h>
+#include <GaudiKernel/SmartIF.h>
+
+#include <fmt/format.h>
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <mutex>
+#include <sstream>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace {
+  /// A new AsyncMessageSvc instance (not the one of the application), printing "<source> <text>" to @c out
+  /// (which has to outlive the service).
+  SmartIF<IMessageSvc> messageSvc( const std::string& name, std::ostream& out,
+                                   const std::vector<std::pair<std::string, std::string>>& options = {} ) {
+    auto& opts = Gaudi::svcLocator()->getOptsSvc();
+    opts.set( name + ".OutputLevel", "3" );
+    opts.set( name + ".Format", "'%S %M'" );
+    for ( const auto& [prop, value] : options ) opts.set( name + "." + prop, value );
+    auto svc = Gaudi::svcLocator()->service<IMessageSvc>( "AsyncMessageSvc/" + name );
+    if ( svc ) svc->setDefaultStream( &out );
+    return svc;
+  }
+
+  /// Finalize the service, which prints all the queued messages.
+  bool finalize( IMessageSvc& svc ) { return SmartIF<IService>( &svc )->sysFinalize().isSuccess(); }
+
+  std::vector<std::string> lines( const std::string& text ) {
+    std::vector<std::string> result;
+    std::istringstream       in{ text };
+    for ( std::string line; std::getline( in, line ); ) result.push_back( line );
+    return result;
+  }
+
+  /// Stream buffer blocking the printer thread on its first write, until the gate is opened.
+  class GateBuf : public std::stringbuf {
+  public:
+    void waitEntered() {
+      auto lock = std::unique_lock{ m_mutex };
+      m_cond.wait( lock, [&] { return m_entered; } );
+    }
+    void open() {
+      {
+        auto lock = std::scoped_lock{ m_mutex };
+        m_open    = true;
+      }
+      m_cond.notify_all();
+    }
+
+  protected:
+    std::streamsize xsputn( const char* s, std::streamsize n ) override {
+      wait();
+      return std::stringbuf::xsputn( s, n );
+    }
+    int_type overflow( int_type c ) override {
+      wait();
+      return std::stringbuf::overflow( c );
+    }
+
+  private:
+    void wait() {
+      auto lock = std::unique_lock{ m_mutex };
+      m_entered = true;
+      m_cond.notify_all();
+      m_cond.wait( lock, [&] { return m_open; } );
+    }
+    std::mutex              m_mutex;
+    std::condition_variable m_cond;
+    bool                    m_entered = false;
+    bool                    m_open    = false;
+  };
+
+  /// Argument of a deferred message recording the thread that formats it.
+  struct ThreadRecorder {
+    std::thread::id* formattedBy;
+  };
+} // namespace
+
+template <>
+struct fmt::formatter<ThreadRecorder> : fmt::formatter<std::string_view> {
+  template <typename FormatContext>
+  auto format( const ThreadRecorder& r, FormatContext& ctx ) const {
+    *r.formattedBy = std::this_thread::get_id();
+    return fmt::formatter<std::string_view>::format( "formatted", ctx );
+  }
+};
+
+BOOST_GLOBAL_FIXTURE( ApplicationFixture );
+
+BOOST_AUTO_TEST_CASE( time_order ) {
+  static std::ostringstream out;
+  auto                      svc = messageSvc( "Ordered", out );
+  BOOST_REQUIRE( svc );
+
+  // the threads report in turn, so the messages are reported in the order of their numbers
+  constexpr int            nThreads = 4, nMessages = 400;
+  std::atomic<int>         turn{ 0 };
+  std::vector<std::thread> threads;
+  for ( int t = 0; t != nThreads; ++t ) {
+    threads.emplace_back( [&, t] {
+      for ( int i = t; i < nMessages; i += nThreads ) {
+        while ( turn != i ) std::this_thread::yield();
+        svc->reportMessage( Message{ "Ordered", MSG::INFO, std::to_string( i ) } );
+        ++turn;
+      }
+    } );
+  }
+  for ( auto& t : threads ) t.join();
+  BOOST_REQUIRE( finalize( *svc ) );
+
+  std::vector<std::string> expected;
+  for ( int i = 0; i != nMessages; ++i ) expected.push_back( "Ordered " + std::to_string( i ) );
+  const auto printed = lines( out.str() );
+  BOOST_CHECK_EQUAL_COLLECTIONS( printed.begin(), printed.end(), expected.begin(), expected.end() );
+}
+
+BOOST_AUTO_TEST_CASE( block_level ) {
+  static GateBuf      gate;
+  static std::ostream out{ &gate };
+  auto                svc = messageSvc( "Blocking", out, { { "BufferSize", "4" }, { "BlockLevel", "4" } } );
+  BOOST_REQUIRE( svc );
+
+  std::atomic<bool> warningReported{ false };
+  std::thread       reporter( [&] {
+    auto report = [&]( MSG::Level level, const std::string& text ) {
+      svc->reportMessage( Message{ "Blocking", level, text } );
+    };
+    report( MSG::INFO, "info 0" );
+    gate.waitEntered(); // the printer is stuck printing "info 0", the buffer has room for 3 more
+    for ( int i = 1; i != 6; ++i ) report( MSG::INFO, "info " + std::to_string( i ) );
+    report( MSG::WARNING, "warning" );
+    warningReported = true;
+  } );
+
+  // the message at BlockLevel waits for the printer
+  std::this_thread::sleep_for( std::chrono::milliseconds( 200 ) );
+  BOOST_CHECK( !warningReported );
+  gate.open();
+  reporter.join();
+  BOOST_REQUIRE( finalize( *svc ) );
+
+  const auto printed = lines( gate.str() );
+  auto       found   = [&]( const std::string& line ) {
+    return std::find( printed.begin(), printed.end(), line ) != printed.end();
+  };
+  for ( int i = 0; i != 4; ++i ) BOOST_CHECK( found( "Blocking info " + std::to_string( i ) ) );
+  BOOST_CHECK( !found( "Blocking info 4" ) );
+  BOOST_CHECK( !found( "Blocking info 5" ) );
+  BOOST_CHECK( found( "Blocking warning" ) );
+  BOOST_CHECK( found( "Blocking 2 messages dropped because the buffers were full" ) );
+  BOOST_CHECK_EQUAL( printed.size(), 6u );
+}
+
+BOOST_AUTO_TEST_CASE( deferred_formatting ) {
+  static std::ostringstream out;
+  auto                      svc = messageSvc( "Deferred", out );
+  BOOST_REQUIRE( svc );
+
+  std::thread::id formattedBy;
+  {
+    MsgStream log( svc.get(), "Deferred" );
+    Gaudi::reportDeferred( log << MSG::INFO, "text {} by the printer", ThreadRecorder{ &formattedBy } );
+  }
+  BOOST_REQUIRE( finalize( *svc ) );
+
+  BOOST_CHECK_EQUAL( out.str(), "Deferred text formatted by the printer\n" );
+  BOOST_CHECK( formattedBy != std::thread::id{} );
+  BOOST_CHECK( formattedBy != std::this_thread::get_id() );
+}
+
+BOOST_AUTO_TEST_CASE( print_all_at_finalize ) {
+  static std::ostringstream out;
+  // the printer thread would wait for a long time before printing the messages
+  auto svc = messageSvc( "Finalize", out, { { "BufferSize", "8" }, { "Latency", "100" } } );
+  BOOST_REQUIRE( svc );
+
+  // reports at BlockLevel are never dropped, even while the service is being finalized
+  constexpr int            nThreads = 4;
+  std::atomic<bool>        stop{ false };
+  std::atomic<int>         started{ 0 };
+  std::vector<int>         reported( nThreads );
+  std::vector<std::thread> threads;
+  for ( int t = 0; t != nThreads; ++t ) {
+    threads.emplace_back( [&, t] {
+      ++started;
+      for ( int i = 0; !stop || i < 100; ++i ) {
+        svc->reportMessage( Message{ "Finalize", MSG::WARNING, std::to_string( t ) } );
+        ++reported[t];
+      }
+    } );
+  }
+  while ( started != nThreads ) std::this_thread::yield();
+  BOOST_CHECK( finalize( *svc ) );
+  stop = true;
+  for ( auto& t : threads ) t.join();
+
+  std::vector<int> printed( nThreads );
+  for ( const auto& line : lines( out.str() ) ) ++printed.at( std::stoi( line.substr( line.find( ' ' ) + 1 ) ) );
+  BOOST_CHECK_EQUAL_COLLECTIONS( printed.begin(), printed.end(), reported.begin(), reported.end() );
+}
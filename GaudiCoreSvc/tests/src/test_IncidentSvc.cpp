@@ -0,0 +1,142 @@
+/***********************************************************************************\
+* (c) Copyright 2022 CERN for the benefit of the LHCb and ATLAS collaborations      *
+*                                                                                   *
+* This software is distributed under the terms of the Apache version 2 licence,     *
+* copied verbatim in the file "LICENSE".                                            *
+*                                                                                   *
+* In applying this licence, CERN does not waive the privileges and immunities       *
+* granted to it by virtue of its status as an Intergovernmental Organization        *
+* or submit itself to any jurisdiction.                                             *
+\***********************************************************************************/
+#define BOOST_TEST_DYN_LINK
+#define BOOST_TEST_MODULE test_IncidentSvc
+#include <boost/test/unit_test.hpp>
+
+#include "ApplicationFixture.h"
+
+#include <GaudiKernel/Bootstrap.h>
+#include <GaudiKernel/IIncidentListener.h>
+#include <GaudiKernel/IIncidentSvc.h>
+#include <GaudiKernel/ISvcLocator.h>
+#include <GaudiKernel/Incident.h>
+#include <GaudiKernel/SmartIF.h>
+#include <GaudiKernel/implements.h>
+
+#include <algorithm>
+#include <atomic>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace {
+  SmartIF<IIncidentSvc> incidentSvc() { return Gaudi::svcLocator()->service<IIncidentSvc>( "IncidentSvc" ); }
+
+  /// Records the incidents it gets, and the thread that delivers them.
+  struct Recorder : implements<IIncidentListener> {
+    Recorder() { addRef(); } // not owned by the service
+    void handle( const Incident& inc ) override {
+      auto lock = std::scoped_lock{ m_mutex };
+      seen.push_back( inc.source() + ":" + inc.type() );
+      threads.push_back( std::this_thread::get_id() );
+    }
+    std::mutex                   m_mutex;
+    std::vector<std::string>     seen;
+    std::vector<std::thread::id> threads;
+  };
+
+  struct Counter : implements<IIncidentListener> {
+    Counter() { addRef(); }
+    void             handle( const Incident& ) override { ++count; }
+    std::atomic<int> count{ 0 };
+  };
+
+  /// Incident that cannot be copied for the asynchronous listeners (it does not override clone()).
+  struct NotClonable : Incident {
+    using Incident::Incident;
+  };
+} // namespace
+
+// the asynchronous delivery needs an initialized IncidentSvc
+BOOST_GLOBAL_FIXTURE( ApplicationFixture );
+
+BOOST_AUTO_TEST_CASE( async_ordering ) {
+  auto     svc = incidentSvc();
+  Recorder sync, async;
+  svc->addListener( &sync, "A" );
+  svc->addListener( &async, "A", 0, false, false, true );
+  svc->addListener( &async, "B", 0, false, false, true );
+
+  std::vector<std::string> expected;
+  for ( int i = 0; i != 1000; ++i ) {
+    const auto type = i % 3 ? "A" : "B";
+    svc->fireIncident( Incident( std::to_string( i ), type ) );
+    expected.push_back( std::to_string( i ) + ":" + type );
+  }
+  svc->removeListener( &async ); // waits for the delivery of the queued incidents
+  svc->removeListener( &sync );
+
+  BOOST_CHECK_EQUAL_COLLECTIONS( async.seen.begin(), async.seen.end(), expected.begin(), expected.end() );
+  BOOST_CHECK( std::all_of( async.threads.begin(), async.threads.end(),
+                            []( auto id ) { return id != std::this_thread::get_id(); } ) );
+  BOOST_CHECK_EQUAL( sync.seen.size(), 666u );
+  BOOST_CHECK( std::all_of( sync.threads.begin(), sync.threads.end(),
+                            []( auto id ) { return id == std::this_thread::get_id(); } ) );
+}
+
+BOOST_AUTO_TEST_CASE( not_clonable ) {
+  auto     svc = incidentSvc();
+  Recorder async;
+  svc->addListener( &async, "C", 0, false, false, true );
+
+  svc->fireIncident( Incident( "first", "C" ) );
+  svc->fireIncident( NotClonable( "second", "C" ) );
+  {
+    // the incident that cannot be copied is delivered, after the queued ones, before fireIncident returns
+    auto lock = std::scoped_lock{ async.m_mutex };
+    BOOST_CHECK_EQUAL( async.seen.size(), 2u );
+  }
+  svc->fireIncident( Incident( "third", "C" ) );
+  svc->removeListener( &async );
+
+  const std::vector<std::string> expected{ "first:C", "second:C", "third:C" };
+  BOOST_CHECK_EQUAL_COLLECTIONS( async.seen.begin(), async.seen.end(), expected.begin(), expected.end() );
+  // all on the delivery thread
+  BOOST_CHECK( std::all_of( async.threads.begin(), async.threads.end(),
+                            []( auto id ) { return id != std::this_thread::get_id(); } ) );
+}
+
+BOOST_AUTO_TEST_CASE( concurrent_firing ) {
+  auto              svc = incidentSvc();
+  Counter           always;
+  std::atomic<bool> stop{ false };
+  svc->addListener( &always, "D" );
+
+  std::vector<std::thread> threads;
+  for ( int i = 0; i != 4; ++i ) {
+    threads.emplace_back( [&] {
+      while ( !stop ) svc->fireIncident( Incident( "thread", "D" ) );
+    } );
+  }
+  for ( int i = 0; i != 200; ++i ) {
+    // a single-shot listener gets one incident, even from several threads
+    Counter once;
+    svc->addListener( &once, "D", 0, false, true );
+    while ( !once.count ) std::this_thread::yield();
+    // after removeListener() the listener is not called any more, so it can be deleted
+    auto temporary = std::make_unique<Counter>();
+    svc->addListener( temporary.get(), "D" );
+    while ( !temporary->count ) std::this_thread::yield();
+    svc->removeListener( temporary.get(), "D" );
+    const int calls = temporary->count;
+    std::this_thread::yield();
+    BOOST_CHECK_EQUAL( temporary->count, calls );
+    BOOST_CHECK_EQUAL( once.count, 1 );
+    svc->removeListener( &once, "D" ); // already removed by the service
+  }
+  stop = true;
+  for ( auto& t : threads ) t.join();
+  svc->removeListener( &always );
+  BOOST_CHECK( always.count > 0 );
+}
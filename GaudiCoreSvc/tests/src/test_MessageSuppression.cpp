@@ -0,0 +1,133 @@
+/***********************************************************************************\
+* (c) Copyright 2022 CERN for the benefit of the LHCb and ATLAS collaborations      *
+*                                                                                   *
+* This software is distributed under the terms of the Apache version 2 licence,     *
+* copied verbatim in the file "LICENSE".                                            *
+*                                                                                   *
+* In applying this licence, CERN does not waive the privileges and immunities       *
+* granted to it by virtue of its status as an Intergovernmental Organization        *
+* or submit itself to any jurisdiction.                                             *
+\***********************************************************************************/
+#define BOOST_TEST_DYN_LINK
+#define BOOST_TEST_MODULE test_MessageSuppression
+#include <boost/test/unit_test.hpp>
+
+#include "ApplicationFixture.h"
+
+#include <Gaudi/Interfaces/IOptionsSvc.h>
+#include <Gaudi/LazyFormat.h>
+#include <GaudiKernel/Bootstrap.h>
+#include <GaudiKernel/IMessageSvc.h>
+#include <GaudiKernel/ISvcLocator.h>
+#include <GaudiKernel/Message.h>
+#include <GaudiKernel/MsgStream.h>
+#include <GaudiKernel/SmartIF.h>
+
+#include <algorithm>
+#include <filesystem>
+#include <fstream>
+#include <sstream>
+#include <string>
+#include <vector>
+
+namespace {
+  constexpr int limit = 3;
+
+  /// A new MessageSvc instance printing "<source> <text>" to @c out (which has to outlive the service),
+  /// with the message limits enabled.
+  SmartIF<IMessageSvc> messageSvc( const std::string& name, std::ostream& out,
+                                   const std::vector<std::pair<std::string, std::string>>& options = {} ) {
+    auto& opts = Gaudi::svcLocator()->getOptsSvc();
+    opts.set( name + ".OutputLevel", "3" );
+    opts.set( name + ".Format", "'%S %M'" );
+    opts.set( name + ".enableSuppression", "True" );
+    opts.set( name + ".defaultLimit", std::to_string( limit ) );
+    for ( const auto& [prop, value] : options ) opts.set( name + "." + prop, value );
+    auto svc = Gaudi::svcLocator()->service<IMessageSvc>( "MessageSvc/" + name );
+    if ( svc ) svc->setDefaultStream( &out );
+    return svc;
+  }
+
+  std::vector<std::string> lines( const std::string& text ) {
+    std::vector<std::string> result;
+    std::istringstream       in{ text };
+    for ( std::string line; std::getline( in, line ); ) result.push_back( line );
+    return result;
+  }
+
+  // type counting how many times it is formatted
+  struct Counted {
+    static inline int formatted = 0;
+  };
+} // namespace
+
+template <>
+struct fmt::formatter<Counted> : fmt::formatter<int> {
+  auto format( const Counted&, fmt::format_context& ctx ) const {
+    ++Counted::formatted;
+    return fmt::formatter<int>::format( 42, ctx );
+  }
+};
+
+BOOST_GLOBAL_FIXTURE( ApplicationFixture );
+
+BOOST_AUTO_TEST_CASE( suppressed_before_formatting ) {
+  static std::ostringstream early, late;
+  auto                      earlySvc = messageSvc( "Early", early );
+  auto                      lateSvc  = messageSvc( "Late", late );
+  BOOST_REQUIRE( earlySvc && lateSvc );
+  const int earlyCount = earlySvc->messageCount( MSG::INFO );
+
+  // through MsgStream, the messages over the limit are not formatted
+  constexpr int n = 10;
+  MsgStream     log( earlySvc.get(), "Limited" );
+  Counted::formatted = 0;
+  for ( int i = 0; i != n; ++i ) log << MSG::INFO << Gaudi::lazyFormat( "{}", Counted{} ) << endmsg;
+  BOOST_CHECK_EQUAL( Counted::formatted, limit );
+
+  // reported directly, the messages are suppressed by the service after formatting
+  for ( int i = 0; i != n; ++i ) lateSvc->reportMessage( Message{ "Limited", MSG::INFO, "42" } );
+
+  // same output and counts in both cases
+  BOOST_CHECK_EQUAL( early.str(), late.str() );
+  BOOST_CHECK_EQUAL( earlySvc->messageCount( MSG::INFO ) - earlyCount, n );
+  BOOST_CHECK_EQUAL( earlySvc->messageCount( MSG::INFO ), lateSvc->messageCount( MSG::INFO ) );
+
+  const auto printed = lines( early.str() );
+  BOOST_CHECK_EQUAL( std::count( printed.begin(), printed.end(), "Limited 42" ), limit - 1 );
+  const auto limitReached = std::count_if( printed.begin(), printed.end(), []( const std::string& line ) {
+    return line.find( "message limit (3) reached for Limited" ) != std::string::npos;
+  } );
+  BOOST_CHECK_EQUAL( limitReached, 1 );
+
+  // the limits are per source and per level
+  Counted::formatted = 0;
+  MsgStream other( earlySvc.get(), "Other" );
+  other << MSG::INFO << Gaudi::lazyFormat( "{}", Counted{} ) << endmsg;
+  log << MSG::WARNING << Gaudi::lazyFormat( "{}", Counted{} ) << endmsg;
+  BOOST_CHECK_EQUAL( Counted::formatted, 2 );
+}
+
+BOOST_AUTO_TEST_CASE( logged_streams_not_suppressed ) {
+  const auto logFile = std::filesystem::temp_directory_path() / "test_MessageSuppression.log";
+  const auto logged  = "{'Logged': '" + logFile.string() + "'}";
+
+  static std::ostringstream out;
+  auto                      svc = messageSvc( "Logging", out, { { "loggedStreams", logged } } );
+  BOOST_REQUIRE( svc );
+
+  // the logged streams receive all the messages, which are then formatted
+  constexpr int n = 10;
+  MsgStream     log( svc.get(), "Logged" );
+  Counted::formatted = 0;
+  for ( int i = 0; i != n; ++i ) log << MSG::INFO << Gaudi::lazyFormat( "{}", Counted{} ) << endmsg;
+  BOOST_CHECK_EQUAL( Counted::formatted, n );
+
+  std::ifstream file{ logFile };
+  int           loggedLines = 0;
+  for ( std::string line; std::getline( file, line ); ) ++loggedLines;
+  BOOST_CHECK_EQUAL( loggedLines, n );
+  // while the standard output is still limited
+  BOOST_CHECK_EQUAL( lines( out.str() ).size(), std::size_t( limit ) );
+  std::filesystem::remove( logFile );
+}
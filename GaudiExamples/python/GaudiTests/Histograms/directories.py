@@ -46,6 +46,20 @@ def config():
         os.remove(FILENAME)
 
 
+def config_direct():
+    """
+    Same as config, but with the ROOT sink converting the histograms directly
+    from their bins, in several threads.
+    """
+    import GaudiConfig2.Configurables as C
+
+    for c in config():
+        if isinstance(c, C.Gaudi.Histograming.Sink.Root):
+            c.DirectConversion = True
+            c.NumberOfThreads = 2
+        yield c
+
+
 def check(causes, result):
     result["root_output_file"] = FILENAME
 
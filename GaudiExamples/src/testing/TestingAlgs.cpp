@@ -21,8 +21,12 @@
 #include "GaudiKernel/Incident.h"
 #include "GaudiKernel/Memory.h"
 #include "GaudiKernel/Sleep.h"
+#include "GaudiKernel/ThreadLocalContext.h"
 
+#include <chrono>
 #include <iostream>
+#include <memory>
+#include <vector>
 
 #include <csignal>
 
@@ -312,6 +316,51 @@ namespace GaudiTesting {
       info() << "rss:  " << System::mappedMemory() << " kB" << endmsg;
     }
   };
+
+  /**
+   * Simple algorithm making Count heap allocations of Size bytes per event.
+   */
+  class AllocatingAlg : public GaudiAlgorithm {
+  public:
+    using GaudiAlgorithm::GaudiAlgorithm;
+    StatusCode initialize() override {
+      return GaudiAlgorithm::initialize().andThen( [&] { m_blocks.reserve( m_count ); } );
+    }
+    StatusCode execute() override {
+      for ( int i = 0; i < m_count; ++i ) m_blocks.emplace_back( new char[m_size] );
+      m_blocks.clear();
+      return StatusCode::SUCCESS;
+    }
+
+  private:
+    Gaudi::Property<int>                 m_count{ this, "Count", 10, "Number of allocations per event" };
+    Gaudi::Property<std::size_t>         m_size{ this, "Size", 1000, "Size of the allocations in bytes" };
+    std::vector<std::unique_ptr<char[]>> m_blocks;
+  };
+
+  /**
+   * Simple algorithm keeping the CPU busy (not sleeping) for BusyTime milliseconds per event, or SlowTime in the
+   * event SlowEvent.
+   */
+  class BusyAlg : public GaudiAlgorithm {
+  public:
+    using GaudiAlgorithm::GaudiAlgorithm;
+    StatusCode execute() override {
+      const bool      slow = static_cast<long long>( Gaudi::Hive::currentContextEvt() ) == m_slowEvent;
+      const auto      time = std::chrono::milliseconds( slow ? m_slowTime.value() : m_busyTime.value() );
+      const auto      end  = std::chrono::steady_clock::now() + time;
+      volatile double sum  = 0;
+      while ( std::chrono::steady_clock::now() < end ) {
+        for ( int i = 0; i < 1000; ++i ) sum = sum + i;
+      }
+      return StatusCode::SUCCESS;
+    }
+
+  private:
+    Gaudi::Property<int>       m_busyTime{ this, "BusyTime", 10, "Milliseconds of CPU time spent in each execution" };
+    Gaudi::Property<long long> m_slowEvent{ this, "SlowEvent", -1, "Event in which SlowTime is spent (-1 for none)" };
+    Gaudi::Property<int>       m_slowTime{ this, "SlowTime", 1000, "Milliseconds of CPU time spent in SlowEvent" };
+  };
 } // namespace GaudiTesting
 
 namespace GaudiTesting {
@@ -326,4 +375,6 @@ namespace GaudiTesting {
   DECLARE_COMPONENT( EvenEventsFilter )
   DECLARE_COMPONENT( ListTools )
   DECLARE_COMPONENT( PrintMemoryUsage )
+  DECLARE_COMPONENT( AllocatingAlg )
+  DECLARE_COMPONENT( BusyAlg )
 } // namespace GaudiTesting
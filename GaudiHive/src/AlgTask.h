@@ -25,6 +25,7 @@
 #include "GaudiKernel/ThreadLocalContext.h"
 #include <Gaudi/Algorithm.h>
 
+#include <chrono>
 #include <functional>
 
 namespace Gaudi {
@@ -75,6 +76,16 @@ public:
 
     // select the appropriate store
     this_algo->whiteboard()->selectStore( evtCtx.valid() ? evtCtx.slot() : 0 ).ignore();
+
+    // make the execution visible to the monitoring (see IScheduler::runningAlgorithms) and time it, only when
+    // requested (no bookkeeping otherwise)
+    const bool tracked  = m_scheduler->m_runningAlgorithmsTrackers.load( std::memory_order_relaxed ) > 0;
+    const auto callback = m_scheduler->m_executionCallback.load( std::memory_order_acquire );
+    auto       worker   = tracked ? &m_scheduler->workerState() : nullptr;
+
+    std::chrono::steady_clock::time_point start;
+    if ( worker || callback ) start = std::chrono::steady_clock::now();
+    if ( worker ) worker->started( ts.algIndex, evtCtx, start );
     try {
       RetCodeGuard rcg( appmgr, Gaudi::ReturnCode::UnhandledException );
 
@@ -97,6 +108,9 @@ public:
       eventfailed = true;
     }
 
+    if ( worker ) worker->finished();
+    if ( callback ) ( *callback )( ts.algIndex, std::chrono::steady_clock::now() - start );
+
     // A FAILURE in algorithm execution must be communicated to the framework
     m_aess->updateEventStatus( eventfailed, evtCtx );
 
@@ -1158,3 +1158,80 @@ void AvalancheSchedulerSvc::recordOccupancy( int samplePeriod, std::function<voi
 
   m_actionsQueue.push( std::move( action ) );
 }
+
+//---------------------------------------------------------------------------
+
+AvalancheSchedulerSvc::WorkerState& AvalancheSchedulerSvc::workerState() {
+  return m_workers.local( [] {
+    auto worker    = std::make_unique<WorkerState>();
+    worker->thread = pthread_self();
+    return worker;
+  } );
+}
+
+void AvalancheSchedulerSvc::WorkerState::started( unsigned int index, const EventContext& ctx,
+                                                  std::chrono::steady_clock::time_point t ) {
+  const auto seq = sequence.load( std::memory_order_relaxed );
+  sequence.store( seq + 1, std::memory_order_relaxed );
+  std::atomic_thread_fence( std::memory_order_release );
+  algIndex.store( index + 1, std::memory_order_relaxed );
+  slot.store( ctx.slot(), std::memory_order_relaxed );
+  subSlot.store( ctx.subSlot(), std::memory_order_relaxed );
+  evt.store( ctx.evt(), std::memory_order_relaxed );
+  start.store( t.time_since_epoch().count(), std::memory_order_relaxed );
+  sequence.store( seq + 2, std::memory_order_release );
+}
+
+void AvalancheSchedulerSvc::WorkerState::finished() {
+  const auto seq = sequence.load( std::memory_order_relaxed );
+  sequence.store( seq + 1, std::memory_order_relaxed );
+  std::atomic_thread_fence( std::memory_order_release );
+  algIndex.store( 0, std::memory_order_relaxed );
+  sequence.store( seq + 2, std::memory_order_release );
+}
+
+// Executions of algorithms currently in progress
+
+std::vector<IScheduler::RunningAlgorithm> AvalancheSchedulerSvc::runningAlgorithms() const {
+  std::vector<RunningAlgorithm> running;
+
+  m_workers.forEach( [&]( const WorkerState& worker ) {
+    RunningAlgorithm               r{};
+    unsigned int                   index = 0;
+    std::chrono::steady_clock::rep start{};
+    std::uint64_t                  seq = 0;
+    do {
+      seq       = worker.sequence.load( std::memory_order_acquire );
+      index     = worker.algIndex.load( std::memory_order_relaxed );
+      r.slot    = worker.slot.load( std::memory_order_relaxed );
+      r.subSlot = worker.subSlot.load( std::memory_order_relaxed );
+      r.evt     = worker.evt.load( std::memory_order_relaxed );
+      start     = worker.start.load( std::memory_order_relaxed );
+      std::atomic_thread_fence( std::memory_order_acquire );
+    } while ( ( seq & 1 ) || seq != worker.sequence.load( std::memory_order_relaxed ) );
+    if ( !index ) return;
+
+    r.index  = index - 1;
+    r.name   = m_algname_vect.at( r.index );
+    r.start  = std::chrono::steady_clock::time_point{ std::chrono::steady_clock::duration{ start } };
+    r.thread = worker.thread;
+    running.push_back( r );
+  } );
+  return running;
+}
+
+void AvalancheSchedulerSvc::trackRunningAlgorithms( bool track ) {
+  m_runningAlgorithmsTrackers.fetch_add( track ? 1 : -1, std::memory_order_relaxed );
+}
+
+// Call the callback at the end of each execution of an algorithm with its duration
+
+void AvalancheSchedulerSvc::recordExecutionTimes( ExecutionTimeCallback callback ) {
+  const ExecutionTimeCallback* current = nullptr;
+  if ( callback ) {
+    std::scoped_lock lock( m_executionCallbacksMutex );
+    current = m_executionCallbacks.emplace_back( std::make_unique<ExecutionTimeCallback>( std::move( callback ) ) )
+                  .get();
+  }
+  m_executionCallback.store( current, std::memory_order_release );
+}
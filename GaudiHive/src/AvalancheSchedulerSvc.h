@@ -17,6 +17,7 @@
 #include "PrecedenceSvc.h"
 
 // Framework include files
+#include "Gaudi/Concurrency/PerThread.h"
 #include "GaudiKernel/IAlgExecStateSvc.h"
 #include "GaudiKernel/IAlgResourcePool.h"
 #include "GaudiKernel/ICondSvc.h"
@@ -27,7 +28,10 @@
 #include "GaudiKernel/Service.h"
 
 // C++ include files
+#include <atomic>
 #include <functional>
+#include <memory>
+#include <mutex>
 #include <queue>
 #include <string>
 #include <string_view>
@@ -151,6 +155,13 @@ public:
   /// Each sample, apply the callback function to the result
   virtual void recordOccupancy( int samplePeriod, std::function<void( OccupancySnapshot )> callback ) override;
 
+  /// Executions of algorithms currently in progress
+  std::vector<RunningAlgorithm> runningAlgorithms() const override;
+  void                          trackRunningAlgorithms( bool track ) override;
+
+  /// Call the callback at the end of each execution of an algorithm with its duration
+  void recordExecutionTimes( ExecutionTimeCallback callback ) override;
+
 private:
   using AState = AlgsExecutionStates::State;
   using action = std::function<StatusCode()>;
@@ -162,6 +173,32 @@ private:
   std::chrono::system_clock::time_point      m_lastSnapshot     = std::chrono::system_clock::now();
   std::function<void( OccupancySnapshot )>   m_snapshotCallback;
 
+  /// Algorithm executed by a worker thread, published for runningAlgorithms()
+  /// Only the worker writes, the readers retry if the sequence number is odd or changed while they read.
+  struct WorkerState {
+    std::atomic<std::uint64_t>                  sequence{ 0 };
+    std::atomic<unsigned int>                   algIndex{ 0 }; ///< index of the algorithm + 1, 0 when idle
+    std::atomic<EventContext::ContextID_t>      slot{ 0 };
+    std::atomic<EventContext::ContextID_t>      subSlot{ 0 };
+    std::atomic<EventContext::ContextEvt_t>     evt{ 0 };
+    std::atomic<std::chrono::steady_clock::rep> start{ 0 };
+    std::thread::native_handle_type             thread{};
+
+    void started( unsigned int index, const EventContext& ctx, std::chrono::steady_clock::time_point t );
+    void finished();
+  };
+  /// State of the current worker thread (registered on first use)
+  WorkerState& workerState();
+
+  Gaudi::Concurrency::PerThread<WorkerState> m_workers;
+  /// Number of users of runningAlgorithms(), the tasks do not update their WorkerState if 0
+  std::atomic<int> m_runningAlgorithmsTrackers{ 0 };
+
+  /// Current execution time callback, and all the ones set so far (tasks may still be using them)
+  std::atomic<const ExecutionTimeCallback*>           m_executionCallback{ nullptr };
+  std::vector<std::unique_ptr<ExecutionTimeCallback>> m_executionCallbacks;
+  std::mutex                                          m_executionCallbacksMutex;
+
   Gaudi::Property<int> m_threadPoolSize{
       this, "ThreadPoolSize", -1,
       "Size of the global thread pool initialised by TBB; a value of -1 requests to use"
@@ -14,6 +14,8 @@
 //
 //====================================================================
 // Include files
+#include "Gaudi/Interfaces/IDataFaultHandler.h"
+#include "Gaudi/Monitoring/StoreMemoryMonitor.h"
 #include "GaudiKernel/ConcurrencyFlags.h"
 #include "GaudiKernel/DataObjID.h"
 #include "GaudiKernel/DataObject.h"
@@ -27,6 +29,7 @@
 #include "boost/callable_traits.hpp"
 #include "tbb/concurrent_queue.h"
 #include <mutex>
+#include <optional>
 #include <utility>
 
 // Interfaces
@@ -125,7 +128,8 @@ namespace {
  * @author Pere Mato
  * @version 1.0
  */
-class HiveWhiteBoard : public extends<Service, IDataProviderSvc, IDataManagerSvc, IHiveWhiteBoard> {
+class HiveWhiteBoard : public extends<Service, IDataProviderSvc, IDataManagerSvc, IHiveWhiteBoard,
+                                      Gaudi::Interfaces::IDataFaultSource> {
 protected:
   Gaudi::Property<CLID>                     m_rootCLID{ this, "RootCLID", 110 /*CLID_Event*/, "CLID of root entry" };
   Gaudi::Property<std::string>              m_rootName{ this, "RootName", "/Event", "name of root entry" };
@@ -136,6 +140,27 @@ protected:
   Gaudi::Property<bool>                     m_enableFaultHdlr{ this, "EnableFaultHandler", false,
                                            "enable incidents on data creation requests" };
   Gaudi::Property<std::vector<std::string>> m_inhibitPathes{ this, "InhibitPathes", {}, "inhibited leaves" };
+  Gaudi::Property<unsigned int>             m_memAccountingPeriod{
+      this, "MemoryAccountingPeriod", 0,
+      "Account for the memory of one registered object out of N (on average), by location and producer; "
+      "0 to disable" };
+  Gaudi::Property<double> m_memHistoMax{ this, "MemoryHistogramMax", 1024.,
+                                         "Upper edge of the memory accounting histograms [KiB]" };
+
+  /// Memory accounting of the registered objects (if enabled)
+  std::optional<Gaudi::Monitoring::StoreMemoryMonitor<HiveWhiteBoard>> m_memMonitor;
+
+  /// Record the memory used by a newly registered object, if requested.
+  StatusCode account( StatusCode sc, const DataObject* pObj ) {
+    if ( m_memMonitor && sc.isSuccess() && pObj && pObj->registry() && m_memMonitor->sample() ) {
+      std::string_view       path = pObj->registry()->identifier();
+      const std::string_view root = m_rootName.value();
+      if ( path.substr( 0, root.size() ) == root ) path.remove_prefix( root.size() );
+      if ( !path.empty() && path.front() == '/' ) path.remove_prefix( 1 );
+      m_memMonitor->record( path, pObj->memoryFootprint() );
+    }
+    return sc;
+  }
 
   /// Pointer to data loader service
   IConversionSvc* m_dataLoader = nullptr;
@@ -279,13 +304,22 @@ public:
   StatusCode preLoad() override {
     return fwd( [&]( IDataProviderSvc& p ) { return p.preLoad(); } );
   }
+  /// Set the handler called directly on data faults in all the partitions.
+  StatusCode setDataFaultHandler( Gaudi::Interfaces::IDataFaultHandler* handler ) override {
+    StatusCode sc = StatusCode::SUCCESS;
+    for_( m_partitions, [&]( Partition& p ) {
+      auto src = p.dataProvider.as<Gaudi::Interfaces::IDataFaultSource>();
+      if ( !src || src->setDataFaultHandler( handler ).isFailure() ) sc = StatusCode::FAILURE;
+    } );
+    return sc;
+  }
   /// Register object with the data store.
   StatusCode registerObject( std::string_view parent, std::string_view obj, DataObject* pObj ) override {
-    return fwd( [&]( IDataProviderSvc& p ) { return p.registerObject( parent, obj, pObj ); } );
+    return account( fwd( [&]( IDataProviderSvc& p ) { return p.registerObject( parent, obj, pObj ); } ), pObj );
   }
   /// Register object with the data store.
   StatusCode registerObject( DataObject* parent, std::string_view obj, DataObject* pObj ) override {
-    return fwd( [&]( IDataProviderSvc& p ) { return p.registerObject( parent, obj, pObj ); } );
+    return account( fwd( [&]( IDataProviderSvc& p ) { return p.registerObject( parent, obj, pObj ); } ), pObj );
   }
   /// Unregister object from the data store.
   StatusCode unregisterObject( std::string_view path ) override {
@@ -483,6 +517,10 @@ public:
       m_freeSlots.push( i );
     }
     selectStore( 0 ).ignore();
+    if ( m_memAccountingPeriod > 0 ) {
+      using Axis = Gaudi::Monitoring::StoreMemoryMonitor<HiveWhiteBoard>::Axis;
+      m_memMonitor.emplace( this, m_memAccountingPeriod, Axis{ 100, 0., m_memHistoMax, "KiB" } );
+    }
     return attachServices();
   }
 
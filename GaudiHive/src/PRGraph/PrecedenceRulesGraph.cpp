@@ -675,19 +675,27 @@ namespace concurrency {
 
     // Fill runtimes (as this could not be done on the fly during trace assembling)
     SmartIF<ITimelineSvc> timelineSvc = m_svcLocator->service<ITimelineSvc>( "TimelineSvc", false );
-    if ( !timelineSvc.isValid() ) {
-      warning() << "Failed to get the TimelineSvc, timing will not be added to "
+    if ( !timelineSvc.isValid() || !timelineSvc->isEnabled() ) {
+      warning() << "Failed to get the TimelineSvc (with RecordTimeline), timing will not be added to "
                 << "the task precedence trace dump" << endmsg;
     } else {
 
       std::vector<long long int> start_times;
+      std::size_t                missing = 0;
 
       for ( auto vp = vertices( m_precTrace ); vp.first != vp.second; ++vp.first ) {
         TimelineEvent te{};
         te.algorithm = m_precTrace[*vp.first].m_name;
         te.slot      = slot.eventContext->slot();
         te.event     = slot.eventContext->evt();
-        timelineSvc->getTimelineEvent( te );
+        // the TimelineSvc only keeps the most recent records in memory: the timing of the others is
+        // left to 0 in the dump (the complete timeline is in the TimelineSvc output files)
+        if ( !timelineSvc->getTimelineEvent( te ) || te.end < te.start ) {
+          m_precTrace[*vp.first].m_runtime = 0;
+          m_precTrace[*vp.first].m_start   = 0;
+          if ( te.algorithm != "ENTRY" ) ++missing;
+          continue;
+        }
 
         long int runtime{ std::chrono::duration_cast<std::chrono::microseconds>( te.end - te.start ).count() };
         m_precTrace[*vp.first].m_runtime = runtime;
@@ -698,6 +706,12 @@ namespace concurrency {
         if ( start != 0 ) start_times.push_back( start );
       }
 
+      if ( missing ) {
+        warning() << "No timing for " << missing << " algorithms in the task precedence trace of event "
+                  << slot.eventContext->evt()
+                  << ": their TimelineSvc records were dropped or overwritten (see BufferSize)" << endmsg;
+      }
+
       auto min = std::min_element( start_times.begin(), start_times.end() );
 
       for ( auto vp = vertices( m_precTrace ); vp.first != vp.second; ++vp.first ) {
@@ -282,9 +282,10 @@ namespace precedence {
         te.slot      = m_slot.eventContext->slot();
         te.event     = m_slot.eventContext->evt();
 
-        m_timelineSvc->getTimelineEvent( te );
-        startTime = std::to_string(
-            std::chrono::duration_cast<std::chrono::nanoseconds>( te.start.time_since_epoch() ).count() );
+        if ( m_timelineSvc->getTimelineEvent( te ) ) {
+          startTime = std::to_string(
+              std::chrono::duration_cast<std::chrono::nanoseconds>( te.start.time_since_epoch() ).count() );
+        }
       }
 
       return startTime;
@@ -321,9 +322,10 @@ namespace precedence {
         te.slot      = m_slot.eventContext->slot();
         te.event     = m_slot.eventContext->evt();
 
-        m_timelineSvc->getTimelineEvent( te );
-        endTime =
-            std::to_string( std::chrono::duration_cast<std::chrono::nanoseconds>( te.end.time_since_epoch() ).count() );
+        if ( m_timelineSvc->getTimelineEvent( te ) && te.end >= te.start ) {
+          endTime = std::to_string(
+              std::chrono::duration_cast<std::chrono::nanoseconds>( te.end.time_since_epoch() ).count() );
+        }
       }
 
       return endTime;
@@ -360,8 +362,9 @@ namespace precedence {
         te.slot      = m_slot.eventContext->slot();
         te.event     = m_slot.eventContext->evt();
 
-        m_timelineSvc->getTimelineEvent( te );
-        time = std::to_string( std::chrono::duration_cast<std::chrono::nanoseconds>( te.end - te.start ).count() );
+        if ( m_timelineSvc->getTimelineEvent( te ) && te.end >= te.start ) {
+          time = std::to_string( std::chrono::duration_cast<std::chrono::nanoseconds>( te.end - te.start ).count() );
+        }
       }
 
       return time;
@@ -9,10 +9,69 @@
 * or submit itself to any jurisdiction.                                             *
 \***********************************************************************************/
 #include "TimelineSvc.h"
+#include "GaudiKernel/EventContext.h"
 #include "GaudiKernel/MsgStream.h"
 #include "GaudiKernel/StatusCode.h"
 
-#include <fstream>
+#include <nlohmann/json.hpp>
+
+#include <algorithm>
+#include <cstdio>
+#include <iomanip>
+#include <limits>
+#include <map>
+
+namespace {
+  constexpr char          s_magic[8] = { 'G', 'A', 'U', 'D', 'I', 'T', 'L', 'N' };
+  constexpr std::uint32_t s_version  = 1;
+  enum BlockTag : std::uint32_t { NameTag = 1, RecordsTag = 2 };
+
+  template <typename T>
+  void write( std::ostream& out, const T& v ) {
+    out.write( reinterpret_cast<const char*>( &v ), sizeof( T ) );
+  }
+  template <typename T>
+  bool read( std::istream& in, T& v ) {
+    return bool( in.read( reinterpret_cast<char*>( &v ), sizeof( T ) ) );
+  }
+
+  void writeCSV( std::ostream& out, const TimelineRecord& r, const std::string& alg ) {
+    out << r.start << " " << r.end << " " << alg << " " << r.thread << " " << r.slot << " " << r.event << '\n';
+  }
+
+  /// Read a binary timeline file, calling onName( id, name ) and onRecord( record ) for its content.
+  template <typename OnName, typename OnRecord>
+  bool readTimeline( const std::string& fileName, OnName onName, OnRecord onRecord ) {
+    std::ifstream in( fileName, std::ifstream::binary );
+    char          magic[sizeof( s_magic )];
+    std::uint32_t version = 0;
+    if ( !in.read( magic, sizeof( magic ) ) || !std::equal( magic, magic + sizeof( magic ), s_magic ) ||
+         !read( in, version ) || version != s_version ) {
+      return false;
+    }
+    std::uint32_t tag = 0;
+    while ( read( in, tag ) ) {
+      std::uint32_t n = 0;
+      if ( tag == NameTag ) {
+        std::uint32_t id = 0;
+        if ( !read( in, id ) || !read( in, n ) ) return false;
+        std::string name( n, '\0' );
+        if ( !in.read( name.data(), n ) ) return false;
+        onName( id, std::move( name ) );
+      } else if ( tag == RecordsTag ) {
+        if ( !read( in, n ) ) return false;
+        TimelineRecord record;
+        for ( std::uint32_t i = 0; i < n; ++i ) {
+          if ( !read( in, record ) ) return false;
+          onRecord( record );
+        }
+      } else {
+        return false;
+      }
+    }
+    return true;
+  }
+} // namespace
 
 StatusCode TimelineSvc::initialize() {
   StatusCode sc = Service::initialize();
@@ -20,17 +79,33 @@ StatusCode TimelineSvc::initialize() {
 
   if ( msgLevel( MSG::DEBUG ) ) debug() << "initialize" << endmsg;
 
-  m_events.clear();
-  // the initial allocation of tbb::concurrent_vector determines the size of
-  // the first allocated array, useful to reduce fragmentation
-  m_events.reserve( 1024 );
+  if ( !m_isEnabled ) return StatusCode::SUCCESS;
+
+  // the binary file is needed also as temporary storage for the exports
+  m_binaryFileName = m_binaryFile;
+  if ( m_binaryFileName.empty() && ( m_dumpTimeline || !m_chromeTraceFile.empty() ) ) {
+    m_binaryFileName = m_timelineFile + ".bin";
+  }
+  if ( !m_binaryFileName.empty() ) {
+    m_binaryOut.open( m_binaryFileName, std::ofstream::binary | std::ofstream::trunc );
+    if ( !m_binaryOut.is_open() ) {
+      error() << "cannot open timeline file " << m_binaryFileName << endmsg;
+      return StatusCode::FAILURE;
+    }
+    m_binaryOut.write( s_magic, sizeof( s_magic ) );
+    write( m_binaryOut, s_version );
+    m_writtenNames = 0;
+  }
 
   if ( m_partial ) {
-    std::ofstream out( m_timelineFile + ".part", std::ofstream::trunc | std::ofstream::out );
-    out << "#start end algorithm thread slot event" << std::endl;
-    out.close();
+    m_partialOut.open( m_timelineFile + ".part", std::ofstream::trunc | std::ofstream::out );
+    m_partialOut << "#start end algorithm thread slot event" << std::endl;
   }
 
+  m_nRecords    = 0;
+  m_stopFlusher = false;
+  m_flusher     = std::thread{ [this]() { flusherLoop(); } };
+
   return StatusCode::SUCCESS;
 }
 
@@ -39,62 +114,230 @@ StatusCode TimelineSvc::reinitialize() {
   MsgStream log( msgSvc(), name() );
   log << MSG::DEBUG << "reinitialize" << endmsg;
 
-  m_events.clear();
-
   return StatusCode::SUCCESS;
 }
 
 StatusCode TimelineSvc::finalize() {
-  if ( m_dumpTimeline && m_events.size() > 0 ) {
-    MsgStream log( msgSvc(), name() );
+  if ( m_flusher.joinable() ) {
+    {
+      auto lock     = std::scoped_lock{ m_flusherMutex };
+      m_stopFlusher = true;
+    }
+    m_flusherCond.notify_one();
+    m_flusher.join();
+  }
 
-    log << MSG::INFO << "Outputting timeline with " << m_events.size() << " entries to file " << m_timelineFile.value()
-        << endmsg;
+  std::uint64_t dropped = 0;
+  m_buffers.forEach(
+      [&]( const ThreadBuffer& buffer ) { dropped += buffer.dropped.load( std::memory_order_relaxed ); } );
+  if ( dropped > 0 ) {
+    warning() << dropped << " timeline events were lost because of full buffers, consider increasing BufferSize"
+              << endmsg;
+  }
+
+  if ( m_binaryOut.is_open() ) {
+    m_binaryOut.close();
+
+    if ( m_dumpTimeline && m_nRecords > 0 ) {
+      MsgStream log( msgSvc(), name() );
 
-    outputTimeline();
+      log << MSG::INFO << "Outputting timeline with " << m_nRecords << " entries to file " << m_timelineFile.value()
+          << endmsg;
+
+      exportCSV( m_binaryFileName );
+    }
+    if ( !m_chromeTraceFile.empty() && m_nRecords > 0 ) {
+      info() << "Outputting timeline in Chrome Trace Event format to file " << m_chromeTraceFile.value() << endmsg;
+      exportChromeTrace( m_binaryFileName );
+    }
+    if ( m_binaryFile.empty() ) std::remove( m_binaryFileName.c_str() );
   }
+  if ( m_partialOut.is_open() ) m_partialOut.close();
 
-  return StatusCode::SUCCESS;
+  return Service::finalize();
 }
 
-ITimelineSvc::TimelineRecorder TimelineSvc::getRecorder( std::string alg, const EventContext& ctx ) {
-  auto&            newTimelineEvent = *m_events.emplace_back();
-  TimelineRecorder recorder{ newTimelineEvent, std::move( alg ), ctx };
-  if ( m_partial ) {
-    std::ofstream out( m_timelineFile + ".part", std::ofstream::app | std::ofstream::out );
-    out << std::chrono::duration_cast<std::chrono::nanoseconds>( newTimelineEvent.start.time_since_epoch() ).count()
-        << " "
-        << std::chrono::duration_cast<std::chrono::nanoseconds>( newTimelineEvent.end.time_since_epoch() ).count()
-        << " " << newTimelineEvent.algorithm << " " << newTimelineEvent.thread << " " << newTimelineEvent.slot << " "
-        << newTimelineEvent.event << std::endl;
+std::uint32_t TimelineSvc::algorithmId( const std::string& alg ) {
+  auto lock = std::scoped_lock{ m_algorithmsMutex };
+  auto it   = m_algorithmIds.find( alg );
+  if ( it == m_algorithmIds.end() ) {
+    it = m_algorithmIds.emplace( alg, static_cast<std::uint32_t>( m_algorithms.size() ) ).first;
+    m_algorithms.push_back( alg );
+  }
+  return it->second;
+}
 
-    out.close();
+ITimelineSvc::TimelineRecorder TimelineSvc::getRecorder( std::uint32_t alg, const EventContext& ctx ) {
+  auto& buffer = m_buffers.local( [this] {
+    std::size_t size = 1;
+    while ( size < m_bufferSize ) size <<= 1;
+    return std::make_unique<ThreadBuffer>( size, pthread_self() );
+  } );
+  const auto head   = buffer.head.load( std::memory_order_relaxed );
+  if ( head - buffer.tail.load( std::memory_order_acquire ) > buffer.mask ) {
+    // the flusher is late, or blocked by a long execution still in the buffer
+    buffer.dropped.fetch_add( 1, std::memory_order_relaxed );
+    return {};
   }
-  return recorder;
+  auto& slot = buffer.slots[head & buffer.mask];
+  // tell concurrent readers (getTimelineEvent) that the slot is being overwritten
+  slot.state.store( head << 2 | TimelineRecordSlot::Writing, std::memory_order_relaxed );
+  std::atomic_thread_fence( std::memory_order_release );
+  slot.record       = { 0, 0, buffer.thread, ctx.evt(), static_cast<std::uint32_t>( ctx.slot() ), alg };
+  slot.record.start = TimelineRecord::now();
+  slot.state.store( head << 2 | TimelineRecordSlot::Started, std::memory_order_release );
+  buffer.head.store( head + 1, std::memory_order_release );
+  return TimelineRecorder{ slot };
 }
 
 bool TimelineSvc::getTimelineEvent( TimelineEvent& e ) const {
-  for ( const auto& candidate : m_events ) {
-    if ( candidate.algorithm == e.algorithm && candidate.event == e.event ) {
-      e = candidate;
-      return true;
+  std::uint32_t alg = 0;
+  {
+    auto lock = std::scoped_lock{ m_algorithmsMutex };
+    auto it   = m_algorithmIds.find( e.algorithm );
+    if ( it == m_algorithmIds.end() ) return false;
+    alg = it->second;
+  }
+
+  bool found = false;
+  m_buffers.forEach( [&]( const ThreadBuffer& buffer ) {
+    if ( found ) return;
+    // look at all the records still in the buffer, flushed or not, starting from the most recent
+    const auto head  = buffer.head.load( std::memory_order_acquire );
+    const auto first = head > buffer.mask ? head - buffer.mask - 1 : 0;
+    for ( auto i = head; i-- > first; ) {
+      const auto& slot  = buffer.slots[i & buffer.mask];
+      const auto  state = slot.state.load( std::memory_order_acquire );
+      if ( state >> 2 != i || ( state & TimelineRecordSlot::StatusMask ) == TimelineRecordSlot::Writing ) continue;
+      const TimelineRecord record = slot.record;
+      std::atomic_thread_fence( std::memory_order_acquire );
+      // skip the record if the slot was reused while we were reading it
+      if ( slot.state.load( std::memory_order_relaxed ) >> 2 != i ) continue;
+      if ( record.algorithm != alg || record.event != e.event ) continue;
+
+      auto toTimePoint = []( std::int64_t t ) {
+        using namespace std::chrono;
+        return TimelineEvent::time_point{ duration_cast<TimelineEvent::Clock::duration>( nanoseconds{ t } ) };
+      };
+      e.thread = static_cast<pthread_t>( record.thread );
+      e.slot   = record.slot;
+      e.start  = toTimePoint( record.start );
+      e.end    = ( state & TimelineRecordSlot::StatusMask ) == TimelineRecordSlot::Done ? toTimePoint( record.end )
+                                                                                        : TimelineEvent::time_point{};
+      found = true;
+      return;
+    }
+  } );
+  return found;
+}
+
+void TimelineSvc::flush() {
+  if ( m_binaryOut.is_open() ) {
+    // algorithm names first, so that they are known when reading the records
+    auto lock = std::scoped_lock{ m_algorithmsMutex };
+    for ( ; m_writtenNames < m_algorithms.size(); ++m_writtenNames ) {
+      const auto& alg = m_algorithms[m_writtenNames];
+      write( m_binaryOut, NameTag );
+      write( m_binaryOut, static_cast<std::uint32_t>( m_writtenNames ) );
+      write( m_binaryOut, static_cast<std::uint32_t>( alg.size() ) );
+      m_binaryOut.write( alg.data(), alg.size() );
     }
   }
-  return false;
+
+  std::vector<ThreadBuffer*> buffers;
+  m_buffers.forEach( [&]( ThreadBuffer& buffer ) { buffers.push_back( &buffer ); } );
+
+  for ( auto buffer : buffers ) {
+    auto       tail = buffer->tail.load( std::memory_order_relaxed );
+    const auto head = buffer->head.load( std::memory_order_acquire );
+    m_flushBuffer.clear();
+    // stop at the first execution not completed (e.g. a sequencer), the ones nested in it wait for it
+    for ( ; tail != head; ++tail ) {
+      const auto& slot = buffer->slots[tail & buffer->mask];
+      if ( ( slot.state.load( std::memory_order_acquire ) & TimelineRecordSlot::StatusMask ) !=
+           TimelineRecordSlot::Done ) {
+        break;
+      }
+      m_flushBuffer.push_back( slot.record );
+    }
+    buffer->tail.store( tail, std::memory_order_release );
+    if ( m_flushBuffer.empty() ) continue;
+
+    m_nRecords += m_flushBuffer.size();
+    if ( m_binaryOut.is_open() ) {
+      write( m_binaryOut, RecordsTag );
+      write( m_binaryOut, static_cast<std::uint32_t>( m_flushBuffer.size() ) );
+      m_binaryOut.write( reinterpret_cast<const char*>( m_flushBuffer.data() ),
+                         m_flushBuffer.size() * sizeof( TimelineRecord ) );
+    }
+    if ( m_partialOut.is_open() ) {
+      auto lock = std::scoped_lock{ m_algorithmsMutex };
+      for ( const auto& record : m_flushBuffer ) writeCSV( m_partialOut, record, m_algorithms[record.algorithm] );
+    }
+  }
+  if ( m_binaryOut.is_open() ) m_binaryOut.flush();
+  if ( m_partialOut.is_open() ) m_partialOut.flush();
+}
+
+void TimelineSvc::flusherLoop() {
+  const auto       period = std::chrono::duration<double>( m_flushPeriod.value() );
+  std::unique_lock lock{ m_flusherMutex };
+  bool             stop = false;
+  while ( !stop ) {
+    stop = m_flusherCond.wait_for( lock, period, [this]() { return m_stopFlusher; } );
+    flush();
+  }
 }
 
-void TimelineSvc::outputTimeline() {
+void TimelineSvc::exportCSV( const std::string& binaryFile ) const {
   std::ofstream out( m_timelineFile, std::ofstream::out | std::ofstream::trunc );
 
   out << "#start end algorithm thread slot event" << std::endl;
 
-  for ( const auto& e : m_events ) {
-    out << std::chrono::duration_cast<std::chrono::nanoseconds>( e.start.time_since_epoch() ).count() << " "
-        << std::chrono::duration_cast<std::chrono::nanoseconds>( e.end.time_since_epoch() ).count() << " "
-        << e.algorithm << " " << e.thread << " " << e.slot << " " << e.event << std::endl;
-  }
+  std::vector<std::string> names;
+  readTimeline(
+      binaryFile,
+      [&names]( std::uint32_t id, std::string name ) {
+        if ( names.size() <= id ) names.resize( id + 1 );
+        names[id] = std::move( name );
+      },
+      [&]( const TimelineRecord& record ) { writeCSV( out, record, names[record.algorithm] ); } );
+}
+
+void TimelineSvc::exportChromeTrace( const std::string& binaryFile ) const {
+  // times are given in microseconds since the first execution
+  std::int64_t origin = std::numeric_limits<std::int64_t>::max();
+  readTimeline(
+      binaryFile, []( std::uint32_t, std::string ) {},
+      [&origin]( const TimelineRecord& record ) { origin = std::min( origin, record.start ); } );
+
+  std::ofstream out( m_chromeTraceFile.value(), std::ofstream::out | std::ofstream::trunc );
+  out << std::fixed << std::setprecision( 3 ) << "{\"displayTimeUnit\":\"ns\",\"traceEvents\":[";
+
+  std::vector<std::string>             names; // JSON encoded
+  std::map<std::uint64_t, std::size_t> threads;
+  const char*                          separator = "\n";
+  readTimeline(
+      binaryFile,
+      [&names]( std::uint32_t id, std::string name ) {
+        if ( names.size() <= id ) names.resize( id + 1 );
+        names[id] = nlohmann::json( name ).dump();
+      },
+      [&]( const TimelineRecord& record ) {
+        auto [it, newThread] = threads.emplace( record.thread, threads.size() );
+        if ( newThread ) {
+          out << separator << "{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":0,\"tid\":" << it->second
+              << ",\"args\":{\"name\":\"thread " << it->second << " (" << record.thread << ")\"}}";
+          separator = ",\n";
+        }
+        out << separator << "{\"name\":" << names[record.algorithm]
+            << ",\"cat\":\"algorithm\",\"ph\":\"X\",\"pid\":0,\"tid\":" << it->second
+            << ",\"ts\":" << ( record.start - origin ) / 1e3 << ",\"dur\":" << ( record.end - record.start ) / 1e3
+            << ",\"args\":{\"event\":" << record.event << ",\"slot\":" << record.slot << "}}";
+        separator = ",\n";
+      } );
 
-  out.close();
+  out << "\n]}" << std::endl;
 }
 
 DECLARE_COMPONENT( TimelineSvc )
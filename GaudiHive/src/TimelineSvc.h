@@ -12,13 +12,38 @@
 #ifndef GAUDIHIVE_TIMELINESVC_H
 #define GAUDIHIVE_TIMELINESVC_H
 
+#include "Gaudi/Concurrency/PerThread.h"
 #include "GaudiKernel/ITimelineSvc.h"
 #include "GaudiKernel/Service.h"
 
+#include <condition_variable>
+#include <cstdint>
+#include <fstream>
+#include <memory>
+#include <mutex>
 #include <string>
+#include <thread>
+#include <unordered_map>
+#include <vector>
 
-#include "tbb/concurrent_vector.h"
-
+/**
+ * Records the start and end times of the algorithm executions.
+ *
+ * Each thread writes fixed size records (TimelineRecord) to its own ring buffer, without
+ * locking. A background thread periodically moves the completed records to a compact binary
+ * file, so that the memory used is bounded by the size of the ring buffers. At finalize the
+ * binary file is exported to the CSV format (DumpTimeline) and/or to the Chrome Trace Event
+ * format (ChromeTraceFile), readable by chrome://tracing and Perfetto.
+ *
+ * The binary file starts with the 8 bytes "GAUDITLN" and the format version (uint32), followed by
+ * blocks made of a uint32 tag and:
+ *  - tag 1: definition of an algorithm name: id (uint32), size (uint32) and characters,
+ *  - tag 2: records: number (uint32) and TimelineRecord's.
+ * Numbers are stored with the native byte order.
+ *
+ * getTimelineEvent only sees the records still in the ring buffers (flushed or not): the older ones
+ * are only in the output files, and the ones dropped because of a full buffer are lost.
+ */
 class TimelineSvc : public extends<Service, ITimelineSvc> {
 public:
   using extends::extends;
@@ -27,20 +52,66 @@ public:
   StatusCode reinitialize() override;
   StatusCode finalize() override;
 
-  TimelineRecorder getRecorder( std::string alg, const EventContext& ctx ) override;
+  using ITimelineSvc::getRecorder;
+
+  std::uint32_t    algorithmId( const std::string& alg ) override;
+  TimelineRecorder getRecorder( std::uint32_t alg, const EventContext& ctx ) override;
   bool             getTimelineEvent( TimelineEvent& ) const override;
 
   bool isEnabled() const override { return m_isEnabled; }
 
 private:
-  void outputTimeline();
+  /// Ring buffer of the records of one thread.
+  struct ThreadBuffer {
+    ThreadBuffer( std::size_t size, std::uint64_t thread )
+        : slots{ std::make_unique<TimelineRecordSlot[]>( size ) }, mask{ size - 1 }, thread{ thread } {}
+
+    std::unique_ptr<TimelineRecordSlot[]> slots;
+    const std::size_t                     mask;
+    const std::uint64_t                   thread;
+    std::atomic<std::uint64_t>            head{ 0 };    ///< next slot to use (written by the owning thread)
+    std::atomic<std::uint64_t>            tail{ 0 };    ///< first slot not yet flushed (written by the flusher)
+    std::atomic<std::uint64_t>            dropped{ 0 }; ///< records lost because the buffer was full
+  };
+
+  /// Move the completed records of all threads to the output files.
+  void flush();
+  void flusherLoop();
+
+  void exportCSV( const std::string& binaryFile ) const;
+  void exportChromeTrace( const std::string& binaryFile ) const;
 
   Gaudi::Property<std::string> m_timelineFile{ this, "TimelineFile", "timeline.csv", "" };
   Gaudi::Property<bool>        m_isEnabled{ this, "RecordTimeline", false, "Enable recording of the timeline events" };
   Gaudi::Property<bool>        m_dumpTimeline{ this, "DumpTimeline", false, "Enable dumping of the timeline events" };
-  Gaudi::Property<bool>        m_partial{ this, "Partial", false, "" };
+  Gaudi::Property<bool>        m_partial{ this, "Partial", false,
+                                   "Write the timeline events to TimelineFile + '.part' while the job runs" };
+  Gaudi::Property<std::string> m_binaryFile{
+      this, "BinaryFile", "", "Binary file for the timeline events (if empty, a temporary file is used if needed)" };
+  Gaudi::Property<std::string> m_chromeTraceFile{
+      this, "ChromeTraceFile", "", "If not empty, export the timeline events in Chrome Trace Event format" };
+  Gaudi::Property<unsigned int> m_bufferSize{
+      this, "BufferSize", 1u << 16, "Size of the ring buffer of records of each thread (rounded up to a power of 2)" };
+  Gaudi::Property<double> m_flushPeriod{ this, "FlushPeriod", 0.1,
+                                         "Period in seconds of the transfer of the records to the output files" };
+
+  Gaudi::Concurrency::PerThread<ThreadBuffer> m_buffers;
+
+  std::vector<std::string>                       m_algorithms; ///< algorithm names, indexed by id
+  std::unordered_map<std::string, std::uint32_t> m_algorithmIds;
+  mutable std::mutex                             m_algorithmsMutex;
 
-  tbb::concurrent_vector<TimelineEvent> m_events;
+  // state of the flusher thread (m_flusherMutex also protects the output files)
+  std::thread                 m_flusher;
+  std::mutex                  m_flusherMutex;
+  std::condition_variable     m_flusherCond;
+  bool                        m_stopFlusher = false;
+  std::string                 m_binaryFileName;
+  std::ofstream               m_binaryOut;
+  std::ofstream               m_partialOut;
+  std::size_t                 m_writtenNames = 0;
+  std::uint64_t               m_nRecords     = 0;
+  std::vector<TimelineRecord> m_flushBuffer;
 };
 
 #endif
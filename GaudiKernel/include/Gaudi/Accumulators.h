@@ -11,6 +11,7 @@
 
 #pragma once
 
+#include <Gaudi/Accumulators/ShardedValue.h>
 #include <Gaudi/MonitoringHub.h>
 
 #include <chrono>
@@ -35,12 +36,16 @@ namespace Gaudi::Accumulators {
  *   - Accumulator : object accumulating some data in some way.
  *       examples : counters, sum of squares accumulator,
  *                  minimum accumulator (keeps minimum of all values)
- *   - Atomicity : the atomicity of an accumulator. Can be none or full.
+ *   - Atomicity : the atomicity of an accumulator. Can be none, full or sharded.
  *       "none" means that the accumulator is not thread safe and should
  *       only be used locally within a thread. "full" means that the
  *       accumulator is thread safe, but that you pay the price of atomics
  *       inside. Note that this price may be reduced by the usage of the
- *       Buffer class, see below.
+ *       Buffer class, see below. "sharded" means that the accumulator is
+ *       thread safe and that each thread updates its own copy of the value
+ *       without atomic operations, the copies being combined when the value
+ *       is read. It is meant for accumulators updated by many threads at high
+ *       rate, at the price of more expensive reads and of more memory.
  *   - InputTransform : a transformation to be applied to the input of an Accumulator.
  *       for example "elevation to power 2" for a sum of squares Accumulator,
  *       "identity" for a sum Accumulator or a minimum Accumulator,
@@ -233,7 +238,7 @@ namespace nlohmann {
 namespace Gaudi::Accumulators {
 
   /// Defines atomicity of the accumulators
-  enum class atomicity { none, full };
+  enum class atomicity { none, full, sharded };
 
   /// forward declaration of sqrt for custom types
   template <class T>
@@ -284,6 +289,22 @@ namespace Gaudi::Accumulators {
   template <typename Arithmetic, typename Result = double>
   using fp_result_type = std::conditional_t<std::is_integral_v<Arithmetic>, Result, Arithmetic>;
 
+  /**
+   * Extreme values of the type Arithmetic, used as initial values of Minimum and Maximum.
+   * std::numeric_limits is not specialized for std::chrono::duration (it would give 0)
+   */
+  template <typename Arithmetic>
+  struct Limits : std::numeric_limits<Arithmetic> {};
+  template <typename Rep, typename Period>
+  struct Limits<std::chrono::duration<Rep, Period>> {
+    static constexpr std::chrono::duration<Rep, Period> max() noexcept {
+      return std::chrono::duration<Rep, Period>::max();
+    }
+    static constexpr std::chrono::duration<Rep, Period> lowest() noexcept {
+      return std::chrono::duration<Rep, Period>::min();
+    }
+  };
+
   /**
    * Base type for all functors used as ValuesHandler. The base takes care of storing the value
    */
@@ -352,6 +373,22 @@ namespace Gaudi::Accumulators {
     };
   };
 
+  /**
+   * Adder specialization in the case of sharded atomicity
+   */
+  template <typename Arithmetic>
+  struct Adder<Arithmetic, atomicity::sharded> {
+    using OutputType   = Arithmetic;
+    using InternalType = details::ShardedValue<Arithmetic, details::zero<Arithmetic>, std::plus<>>;
+    static constexpr OutputType DefaultValue() { return Arithmetic{}; }
+    static OutputType           getValue( const InternalType& v ) noexcept { return v.value(); }
+    static Arithmetic           exchange( InternalType& v, Arithmetic newv ) noexcept { return v.exchange( newv ); }
+    static void                 merge( InternalType& a, Arithmetic b ) noexcept {
+      if ( DefaultValue() == b ) return; // avoid touching the shard if b is "0"
+      a.update( b );
+    };
+  };
+
   /**
    * An Extremum ValueHandler, to be reused for Minimum and Maximum
    * operator(a, b) means if (Compare(b,a)) a = b In case of full atomicity, compare_exchange_weak is used.
@@ -387,19 +424,32 @@ namespace Gaudi::Accumulators {
     };
   };
 
+  /**
+   * Extremum specialization in the case of sharded atomicity
+   */
+  template <typename Arithmetic, typename Compare, Arithmetic ( *Initial )()>
+  struct Extremum<Arithmetic, atomicity::sharded, Compare, Initial> {
+    using OutputType   = Arithmetic;
+    using InternalType = details::ShardedValue<Arithmetic, Initial, details::Pick<Compare>>;
+    static constexpr OutputType DefaultValue() { return Initial(); }
+    static OutputType           getValue( const InternalType& v ) noexcept { return v.value(); }
+    static Arithmetic           exchange( InternalType& v, Arithmetic newv ) noexcept { return v.exchange( newv ); }
+    static void                 merge( InternalType& a, Arithmetic b ) noexcept { a.update( b ); };
+  };
+
   /**
    * A Minimun ValueHandler
    * operator(a, b) means a = min(a, b) In case of full atomicity, compare_exchange_weak is used.
    */
   template <typename Arithmetic, atomicity Atomicity = atomicity::full>
-  using Minimum = Extremum<Arithmetic, Atomicity, std::less<Arithmetic>, std::numeric_limits<Arithmetic>::max>;
+  using Minimum = Extremum<Arithmetic, Atomicity, std::less<Arithmetic>, Limits<Arithmetic>::max>;
 
   /**
    * An Maximum ValueHandler
    * operator(a, b) means a = max(a, b) In case of full atomicity, compare_exchange_weak is used.
    */
   template <typename Arithmetic, atomicity Atomicity = atomicity::full>
-  using Maximum = Extremum<Arithmetic, Atomicity, std::greater<Arithmetic>, std::numeric_limits<Arithmetic>::lowest>;
+  using Maximum = Extremum<Arithmetic, Atomicity, std::greater<Arithmetic>, Limits<Arithmetic>::lowest>;
 
   /**
    * constant used to disambiguate construction of an empty Accumulator
@@ -416,7 +466,7 @@ namespace Gaudi::Accumulators {
    *   - InputType : the type of input data coming to this Accumulator
    *   - InnerType : the type of the accumulated value. May be different from InputType,
    *        e.g. for a pure counter where InputType is double and InnerType is unsigned long
-   *   - Atomicity : the desired atomicity : none or full
+   *   - Atomicity : the desired atomicity : none, full or sharded
    *   - InputTransform : a function to be applied to the values pushed in
    *        + default to identity
    *        + other typical functions : square for a sumn of squares, constant 1 for a count
@@ -425,7 +475,7 @@ namespace Gaudi::Accumulators {
    *        + one could think of sqrt for and RMS accumulator, InputTransform begin square
    *   - ValueHandler : the handler of the internal value, that is a functor providing :
    *        + the way to increment the internal value (e.g. +, min, max) as the operator()
-   *        + the type of the internal value (typically Arithmetic or std::atomic<Arithmetic>)
+   *        + the type of the internal value (typically Arithmetic, std::atomic<Arithmetic> or a sharded value)
    *        + the default value for the internal type
    */
   template <typename InputTypeT, typename InnerType, atomicity Atomicity = atomicity::full,
@@ -444,7 +494,7 @@ namespace Gaudi::Accumulators {
 #endif
     using InternalType          = InnerType;
     using JSONStringEntriesType = std::string;
-    GenericAccumulator operator+=( const InputType by ) {
+    GenericAccumulator& operator+=( const InputType by ) {
       ValueHandler::merge( m_value, InputTransform{}( by ) );
       return *this;
     }
@@ -885,6 +935,8 @@ namespace Gaudi::Accumulators {
     }
 
     inline static const std::string typeString{ "counter" };
+    /// non atomic counters cannot be read while updated, so they are not part of the monitoring snapshots
+    static constexpr bool concurrentReads = Atomicity != atomicity::none;
 
   protected:
     template <typename OWNER, typename SELF, typename... CARGS>
@@ -1125,6 +1177,7 @@ namespace Gaudi::Accumulators {
   class MsgCounter : public PrintableCounter, public details::MsgCounter::MsgAccumulator<Atomicity> {
   public:
     inline static const std::string typeString{ "counter:MsgCounter" };
+    static constexpr bool           concurrentReads = Atomicity != atomicity::none;
     template <typename OWNER>
     MsgCounter( OWNER* o, std::string const& ms, unsigned long nMax = 10 )
         : m_monitoringHub{ &o->serviceLocator()->monitoringHub() }, logger( o ), msg( ms ), max( nMax ) {
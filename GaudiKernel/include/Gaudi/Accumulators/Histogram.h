@@ -12,9 +12,13 @@
 
 #include <Gaudi/Accumulators.h>
 #include <Gaudi/MonitoringHub.h>
+#include <algorithm>
 #include <array>
+#include <cassert>
 #include <cmath>
 #include <fmt/format.h>
+#include <gsl/span>
+#include <memory>
 #include <nlohmann/json.hpp>
 #include <string>
 #include <type_traits>
@@ -93,7 +97,7 @@ namespace Gaudi::Accumulators {
     using Base::Base;
     using Base::operator+=;
     //// overload of operator+= to be able to only give weight and no value
-    WeightedCountAccumulator operator+=( const Arithmetic weight ) {
+    WeightedCountAccumulator& operator+=( const Arithmetic weight ) {
       *this += { Arithmetic{}, weight };
       return *this;
     }
@@ -180,6 +184,24 @@ namespace Gaudi::Accumulators {
       int idx = std::floor( ( value - minValue ) * ratio ) + 1;
       return idx < 0 ? 0 : ( (unsigned int)idx > nBins ? nBins + 1 : (unsigned int)idx );
     }
+
+    /**
+     * adds stride * index( values[i] ) to indices[i] for the n given values
+     *
+     * Same result as index(), but written without branches nor calls so that the
+     * compiler can vectorize it
+     */
+    void addIndices( const Arithmetic* values, std::size_t n, unsigned int stride, unsigned int* indices ) const {
+      const Arithmetic top = nBins;
+      for ( std::size_t i = 0; i < n; ++i ) {
+        Arithmetic t = ( values[i] - minValue ) * ratio;
+        t            = t > Arithmetic( -1 ) ? t : Arithmetic( -1 ); // also sends NaN to the underflow bin
+        t            = t < top ? t : top;
+        int fl       = static_cast<int>( t );
+        fl -= t < fl; // floor
+        indices[i] += ( fl + 1 ) * stride;
+      }
+    }
   };
 
   /// automatic conversion of the Axis type to json
@@ -201,7 +223,9 @@ namespace Gaudi::Accumulators {
     // The change on NIndex == 1 allow to have simpler syntax in that case, that is no tuple of one item
     using ValueType          = HistoInputType<Arithmetic, NIndex == 1 ? 1 : ND, NIndex>;
     using AxisArithmeticType = Arithmetic;
-    unsigned int computeIndex( const std::array<Axis<Arithmetic>, NIndex>& axis ) const {
+    /// number of values given on top of the coordinates, i.e. 1 for profile histograms
+    static constexpr unsigned int nExtraValues = ND - NIndex;
+    unsigned int                  computeIndex( const std::array<Axis<Arithmetic>, NIndex>& axis ) const {
       unsigned int index = 0;
       for ( unsigned int j = 0; j < NIndex; j++ ) {
         unsigned int dim = NIndex - j - 1;
@@ -229,6 +253,7 @@ namespace Gaudi::Accumulators {
   public:
     using ValueType          = HistoInputType;
     using AxisArithmeticType = Arithmetic;
+    static constexpr unsigned int nExtraValues = 0;
     HistoInputType( Arithmetic a ) : value( a ) {}
     unsigned int computeIndex( const std::array<Axis<Arithmetic>, 1>& axis ) const { return axis[0].index( value ); }
     Arithmetic&  operator[]( int ) { return value; }
@@ -250,7 +275,9 @@ namespace Gaudi::Accumulators {
     using ValueType          = HistoInputType<Arithmetic, NIndex == 1 ? 1 : ND, NIndex>;
     using AxisArithmeticType = Arithmetic;
     using std::pair<HistoInputType<Arithmetic, ND, NIndex>, Arithmetic>::pair;
-    unsigned int computeIndex( const std::array<Axis<Arithmetic>, NIndex>& axis ) const {
+    /// the weight comes on top of the values of the unweighted case
+    static constexpr unsigned int nExtraValues = HistoInputType<Arithmetic, ND, NIndex>::nExtraValues + 1;
+    unsigned int                  computeIndex( const std::array<Axis<Arithmetic>, NIndex>& axis ) const {
       return this->first.computeIndex( axis );
     }
     auto forInternalCounter() { return std::pair( this->first.forInternalCounter(), this->second ); }
@@ -260,9 +287,36 @@ namespace Gaudi::Accumulators {
     }
   };
 
+  namespace details {
+    /// computes the global bin indices of the entries [start, start + n) of the given ranges of values
+    template <typename Arithmetic, std::size_t NAxis, std::size_t NRanges>
+    void computeIndices( const std::array<Axis<Arithmetic>, NAxis>& axis,
+                         const std::array<gsl::span<const Arithmetic>, NRanges>& ranges, std::size_t start,
+                         std::size_t n, unsigned int* indices ) {
+      std::fill_n( indices, n, 0 );
+      unsigned int stride = 1;
+      for ( unsigned int d = 0; d < NAxis; ++d ) {
+        axis[d].addIndices( ranges[d].data() + start, n, stride, indices );
+        stride *= axis[d].nBins + 2;
+      }
+    }
+    /// adds entry i of the given ranges of values to a bin accumulator, using the
+    /// ranges following the NAxis coordinates as profiled values and/or weights
+    template <std::size_t NAxis, typename Accumulator, typename Arithmetic, std::size_t NRanges>
+    void addEntry( Accumulator& acc, const std::array<gsl::span<const Arithmetic>, NRanges>& ranges, std::size_t i ) {
+      if constexpr ( NRanges == NAxis ) {
+        acc += 1;
+      } else if constexpr ( NRanges == NAxis + 1 ) {
+        acc += ranges[NAxis][i];
+      } else {
+        acc += { ranges[NAxis][i], ranges[NAxis + 1][i] };
+      }
+    }
+  } // namespace details
+
   /**
    * Internal Accumulator class dealing with Histograming. Templates parameters are :
-   *  - Atomicity : none or full
+   *  - Atomicity : none, full or sharded
    *  - Arithmetic : the arithmetic type used for values filled into the histogram
    *  - ND : the number of dimensions of the histogram.
    *    Note that ND is given as an integral_constant as it needs to be a type for the internal template
@@ -318,6 +372,24 @@ namespace Gaudi::Accumulators {
     [[nodiscard]] auto operator[]( typename InputType::ValueType v ) {
       return Buffer<BaseAccumulatorT, Atomicity, Arithmetic>{ accumulator( v.computeIndex( m_axis ) ) };
     }
+    /**
+     * Fills a batch of entries, given as one range of values per dimension, followed, depending on
+     * the kind of histogram, by the ranges of profiled values and/or of weights. E.g.
+     * \code
+     * h1.fill( xs );            // Histogram<1>
+     * h2.fill( xs, ys );        // Histogram<2>
+     * w1.fill( xs, ws );        // WeightedHistogram<1>
+     * p1.fill( xs, vs );        // ProfileHistogram<1>
+     * wp2.fill( xs, ys, vs, ws ); // WeightedProfileHistogram<2>
+     * \endcode
+     * All ranges must have the same size. The bin indices are computed in blocks, the entries are
+     * accumulated in a local non atomic copy of the histogram, which is merged in one go at the end.
+     */
+    template <typename... Ranges>
+    void fill( const Ranges&... ranges ) {
+      static_assert( sizeof...( Ranges ) >= ND::value, "fill needs one range of values per dimension" );
+      fillImpl( std::array{ gsl::span<const AxisArithmeticType>( ranges )... } );
+    }
 
   protected:
     auto& axis() const { return m_axis; }
@@ -329,6 +401,65 @@ namespace Gaudi::Accumulators {
     auto  totNBins() const { return m_totNBins; }
 
   private:
+    template <std::size_t N>
+    void fillImpl( const std::array<gsl::span<const AxisArithmeticType>, N>& ranges ) {
+      using LocalAccumulator = BaseAccumulatorT<atomicity::none, Arithmetic>;
+      static_assert( N == ND::value + InputType::nExtraValues, "wrong number of ranges given to fill" );
+      const std::size_t n = ranges[0].size();
+      for ( const auto& r : ranges ) assert( r.size() == n );
+      if ( !n ) return;
+
+      // process the values by blocks, computing all the bin indices of a block in one go
+      constexpr std::size_t               BlockSize = 256;
+      std::array<unsigned int, BlockSize> indices;
+
+      // the local copy is kept by the thread for the next calls, so it is used only for histograms of moderate
+      // size (bounding the memory kept by each thread): the larger ones are filled directly
+      constexpr unsigned int MaxLocalBins = 16384;
+      if ( m_totNBins > MaxLocalBins ) {
+        for ( std::size_t start = 0; start < n; start += BlockSize ) {
+          const std::size_t m = std::min( BlockSize, n - start );
+          details::computeIndices( m_axis, ranges, start, m, indices.data() );
+          for ( std::size_t i = 0; i < m; ++i ) {
+            details::addEntry<ND::value>( accumulator( indices[i] ), ranges, start + i );
+          }
+        }
+        return;
+      }
+
+      // local histogram and list of the bins actually filled, kept across calls (and left empty)
+      // to avoid allocating and clearing them for each batch
+      struct Scratch {
+        std::unique_ptr<LocalAccumulator[]> local;
+        std::vector<char>                   filled;
+        std::vector<unsigned int>           touched;
+      };
+      static thread_local Scratch scratch;
+      if ( scratch.filled.size() < m_totNBins ) {
+        scratch.local.reset( new LocalAccumulator[m_totNBins] );
+        scratch.filled.assign( m_totNBins, 0 );
+      }
+      auto& local   = scratch.local;
+      auto& filled  = scratch.filled;
+      auto& touched = scratch.touched;
+
+      for ( std::size_t start = 0; start < n; start += BlockSize ) {
+        const std::size_t m = std::min( BlockSize, n - start );
+        details::computeIndices( m_axis, ranges, start, m, indices.data() );
+        for ( std::size_t i = 0; i < m; ++i ) {
+          details::addEntry<ND::value>( local[indices[i]], ranges, start + i );
+          if ( !filled[indices[i]] ) {
+            filled[indices[i]] = 1;
+            touched.push_back( indices[i] );
+          }
+        }
+      }
+      for ( auto index : touched ) {
+        accumulator( index ).mergeAndReset( std::move( local[index] ) );
+        filled[index] = 0;
+      }
+      touched.clear();
+    }
     BaseAccumulator& accumulator( unsigned int index ) const {
       assert( index < m_totNBins );
       return m_value[index];
@@ -402,6 +533,9 @@ namespace Gaudi::Accumulators {
    *    reading all of them back
    *  - profile histograms are also supported, operator+= takes one more
    *    value in the array of values in that case
+   *  - many entries can be filled at once with fill(), which takes one range
+   *    of values per dimension (plus the profiled values and/or the weights).
+   *    The shared bins are then updated once per bin rather than once per entry
    *
    * This base class is then aliases for the 4 standard cases of Histogram,
    * WeightedHistogram, ProfileHistogram and WeightedProfileHistogram
@@ -417,6 +551,7 @@ namespace Gaudi::Accumulators {
    *   wcounter{owner, "CounterName", "HistoTitle", {{nBins1, minVal1, maxVal1}, {nBins2, minVal2, maxVal2}}};
    * wcounter[{val1, val2}] += w;    // prefered syntax
    * wcounter += {{val1, val2}, w};  // original syntax inherited from counters
+   * wcounter.fill( vals1, vals2, ws ); // batch filling from spans or vectors
    * \endcode
    *
    * When serialized to json, this counter uses new types histogram:Histogram:<prec>, histogram:ProfileHistogram:<prec>,
@@ -486,6 +621,12 @@ namespace Gaudi::Accumulators {
                { "axis", this->axis() },
                { "bins", bins } };
     }
+    std::string const& title() const { return m_title; }
+    // read access to the content, e.g. for sinks converting the bins without going through JSON
+    using Parent::axis;
+    using Parent::binValue;
+    using Parent::nEntries;
+    using Parent::totNBins;
 
   private:
     std::string const m_title;
@@ -0,0 +1,136 @@
+/***********************************************************************************\
+* (c) Copyright 2022 CERN for the benefit of the LHCb and ATLAS collaborations      *
+*                                                                                   *
+* This software is distributed under the terms of the Apache version 2 licence,     *
+* copied verbatim in the file "LICENSE".                                            *
+*                                                                                   *
+* In applying this licence, CERN does not waive the privileges and immunities       *
+* granted to it by virtue of its status as an Intergovernmental Organization        *
+* or submit itself to any jurisdiction.                                             *
+\***********************************************************************************/
+#pragma once
+
+#include <GaudiKernel/Kernel.h>
+
+#include <atomic>
+#include <cstdint>
+#include <cstring>
+#include <type_traits>
+
+namespace Gaudi::Accumulators::details {
+
+  /**
+   * Registry of the per-thread shards used by the sharded accumulators.
+   *
+   * Each sharded value owns a slot, i.e. an index in the table of cells that every thread
+   * gets the first time it updates a sharded value. The tables are allocated by chunks of
+   * cache line aligned cells, so that two threads never write to the same cache line, and
+   * are recycled (with their content) when threads exit.
+   *
+   * Cells are 64 bits wide and hold the bit pattern of the actual value.
+   */
+  class GAUDI_API ShardRegistry {
+  public:
+    using Cell = std::atomic<std::uint64_t>;
+
+    /// Reserve a slot, setting all its cells to the given (neutral) value.
+    static std::uint32_t acquire( std::uint64_t neutral );
+    /// Give back a slot.
+    static void release( std::uint32_t slot );
+    /// The cell of the calling thread for a slot (allocated on demand).
+    static Cell& localCell( std::uint32_t slot );
+    /// Call `f( cell, ctx )` for the cells of all the threads for a slot.
+    static void visit( std::uint32_t slot, void ( *f )( Cell&, void* ), void* ctx );
+  };
+
+  /// Neutral element of the sum.
+  template <typename T>
+  constexpr T zero() {
+    return T{};
+  }
+
+  /// Binary operation keeping the value preferred by Compare.
+  template <typename Compare>
+  struct Pick {
+    template <typename T>
+    constexpr T operator()( T a, T b ) const {
+      return Compare{}( b, a ) ? b : a;
+    }
+  };
+
+  /**
+   * Storage of a value updated through the associative operation Op with neutral element Neutral,
+   * split in one shard per thread.
+   *
+   * Updates only touch the shard of the calling thread with plain (relaxed) loads and stores,
+   * while reading the value combines the shards of all threads. Reading is thus more expensive
+   * than for an atomic value, but updates never contend.
+   *
+   * Note that assignment and exchange are only exact when no other thread updates the value at
+   * the same time, which is the case where accumulators are usually reset or merged.
+   */
+  template <typename T, T ( *Neutral )(), typename Op>
+  class ShardedValue {
+    static_assert( std::is_trivially_copyable_v<T> && sizeof( T ) <= sizeof( std::uint64_t ),
+                   "sharded values must fit in 64 bits" );
+
+  public:
+    ShardedValue( T v = Neutral() ) : m_slot{ ShardRegistry::acquire( encode( Neutral() ) ) } { update( v ); }
+    ShardedValue( const ShardedValue& ) = delete;
+    ~ShardedValue() { ShardRegistry::release( m_slot ); }
+
+    ShardedValue& operator=( T v ) {
+      exchange( v );
+      return *this;
+    }
+
+    /// Combine b into the shard of the current thread.
+    void update( T b ) {
+      auto& c = ShardRegistry::localCell( m_slot );
+      c.store( encode( Op{}( decode( c.load( std::memory_order_relaxed ) ), b ) ), std::memory_order_relaxed );
+    }
+
+    /// Combined value of all the shards.
+    T value() const {
+      T acc = Neutral();
+      ShardRegistry::visit(
+          m_slot,
+          []( ShardRegistry::Cell& c, void* ctx ) {
+            auto& acc = *static_cast<T*>( ctx );
+            acc       = Op{}( acc, decode( c.load( std::memory_order_relaxed ) ) );
+          },
+          &acc );
+      return acc;
+    }
+
+    /// Reset all the shards, then set the value to v, returning the previous (combined) value.
+    T exchange( T v ) {
+      T acc = Neutral();
+      ShardRegistry::visit(
+          m_slot,
+          []( ShardRegistry::Cell& c, void* ctx ) {
+            auto& acc = *static_cast<T*>( ctx );
+            acc       = Op{}( acc, decode( c.exchange( encode( Neutral() ), std::memory_order_relaxed ) ) );
+          },
+          &acc );
+      update( v );
+      return acc;
+    }
+
+  private:
+    // T is trivially copyable (see the static_assert), so copying its bytes is fine even for class
+    // types like std::chrono::duration (the casts to void* tell the compiler so)
+    static std::uint64_t encode( T v ) {
+      std::uint64_t r = 0;
+      std::memcpy( &r, static_cast<const void*>( &v ), sizeof( T ) );
+      return r;
+    }
+    static T decode( std::uint64_t r ) {
+      T v;
+      std::memcpy( static_cast<void*>( &v ), &r, sizeof( T ) );
+      return v;
+    }
+
+    std::uint32_t m_slot;
+  };
+} // namespace Gaudi::Accumulators::details
@@ -0,0 +1,258 @@
+/***********************************************************************************\
+* (c) Copyright 2022 CERN for the benefit of the LHCb and ATLAS collaborations      *
+*                                                                                   *
+* This software is distributed under the terms of the Apache version 2 licence,     *
+* copied verbatim in the file "LICENSE".                                            *
+*                                                                                   *
+* In applying this licence, CERN does not waive the privileges and immunities       *
+* granted to it by virtue of its status as an Intergovernmental Organization        *
+* or submit itself to any jurisdiction.                                             *
+\***********************************************************************************/
+#pragma once
+
+#include <Gaudi/Accumulators/Histogram.h>
+
+#include <atomic>
+#include <functional>
+#include <memory>
+
+namespace Gaudi::Accumulators {
+
+  /**
+   * Internal Accumulator class dealing with sparse Histograming. It has the same template
+   * parameters and interface as HistogramingAccumulatorInternal, but the bins are stored
+   * in blocks of BlockSize bins allocated the first time one of their bins is filled.
+   * Empty blocks thus only cost a pointer.
+   *
+   * Once the fraction of allocated blocks passes a threshold (by default half of them, see
+   * setDensePromotionThreshold), all the missing blocks are allocated in one go, i.e. the
+   * histogram is promoted to a dense storage and stops allocating.
+   *
+   * Block allocation is lock free, so that the thread safety is the same as for the dense
+   * histograms.
+   */
+  template <atomicity Atomicity, typename InputType, typename Arithmetic, typename ND,
+            template <atomicity Ato, typename Arith> typename BaseAccumulatorT>
+  class SparseHistogramingAccumulatorInternal {
+    template <atomicity, typename, typename, typename, template <atomicity, typename> typename>
+    friend class SparseHistogramingAccumulatorInternal;
+
+  public:
+    using BaseAccumulator    = BaseAccumulatorT<Atomicity, Arithmetic>;
+    using AxisArithmeticType = typename InputType::AxisArithmeticType;
+    using AxisType           = Axis<AxisArithmeticType>;
+    /// number of bins in a block
+    static constexpr unsigned int BlockSize = 64;
+
+    template <std::size_t... Is>
+    SparseHistogramingAccumulatorInternal( details::GetTuple_t<AxisType, ND::value> axis,
+                                           std::index_sequence<Is...> )
+        : m_axis{ std::get<Is>( axis )... }
+        , m_totNBins{ InputType::computeTotNBins( m_axis ) }
+        , m_nBlocks{ ( m_totNBins + BlockSize - 1 ) / BlockSize }
+        , m_blocks( new std::atomic<BaseAccumulator*>[m_nBlocks]() ) {}
+    template <atomicity ato>
+    SparseHistogramingAccumulatorInternal(
+        construct_empty_t,
+        const SparseHistogramingAccumulatorInternal<ato, InputType, Arithmetic, ND, BaseAccumulatorT>& other )
+        : m_axis( other.m_axis )
+        , m_totNBins{ other.m_totNBins }
+        , m_nBlocks{ other.m_nBlocks }
+        , m_blocks( new std::atomic<BaseAccumulator*>[m_nBlocks]() )
+        , m_promotionThreshold{ other.m_promotionThreshold } {}
+    ~SparseHistogramingAccumulatorInternal() {
+      for ( unsigned int b = 0; b < m_nBlocks; ++b ) {
+        auto block = m_blocks[b].load( std::memory_order_relaxed );
+        if ( !inDenseStorage( block ) ) delete[] block;
+      }
+    }
+    [[deprecated( "Use `++h1[x]`, `++h2[{x,y}]`, etc. instead." )]] SparseHistogramingAccumulatorInternal&
+    operator+=( InputType v ) {
+      accumulator( v.computeIndex( m_axis ) ) += v.forInternalCounter();
+      return *this;
+    }
+    void reset() {
+      forEachAllocatedBin( []( unsigned int, BaseAccumulator& acc ) { acc.reset(); } );
+    }
+    template <atomicity ato>
+    void
+    mergeAndReset( SparseHistogramingAccumulatorInternal<ato, InputType, Arithmetic, ND, BaseAccumulatorT>&& other ) {
+      assert( m_totNBins == other.m_totNBins );
+      other.forEachAllocatedBin( [this]( unsigned int index, auto& acc ) {
+        accumulator( index ).mergeAndReset( std::move( acc ) );
+      } );
+    }
+    [[nodiscard]] auto operator[]( typename InputType::ValueType v ) {
+      return Buffer<BaseAccumulatorT, Atomicity, Arithmetic>{ accumulator( v.computeIndex( m_axis ) ) };
+    }
+    /**
+     * Fills a batch of entries, see HistogramingAccumulatorInternal::fill.
+     * In order not to use memory for the empty bins, the entries are directly added to the bins
+     * (the indices being still computed by blocks)
+     */
+    template <typename... Ranges>
+    void fill( const Ranges&... ranges ) {
+      static_assert( sizeof...( Ranges ) == ND::value + InputType::nExtraValues,
+                     "wrong number of ranges given to fill" );
+      const std::array  all{ gsl::span<const AxisArithmeticType>( ranges )... };
+      const std::size_t n = all[0].size();
+      for ( const auto& r : all ) assert( r.size() == n );
+      constexpr std::size_t           Batch = 256;
+      std::array<unsigned int, Batch> indices;
+      for ( std::size_t start = 0; start < n; start += Batch ) {
+        const std::size_t m = std::min( Batch, n - start );
+        details::computeIndices( m_axis, all, start, m, indices.data() );
+        for ( std::size_t i = 0; i < m; ++i ) {
+          details::addEntry<ND::value>( accumulator( indices[i] ), all, start + i );
+        }
+      }
+    }
+
+    /// fraction of allocated blocks above which the histogram switches to dense storage (1 to never switch)
+    void setDensePromotionThreshold( double fraction ) { m_promotionThreshold = fraction; }
+    /// number of bins currently allocated
+    unsigned int allocatedBins() const { return m_nAllocated.load( std::memory_order_relaxed ) * BlockSize; }
+    /// tell if all the bins are allocated
+    bool isDense() const { return m_nAllocated.load( std::memory_order_relaxed ) == m_nBlocks; }
+
+  protected:
+    auto& axis() const { return m_axis; }
+    auto  nBins( unsigned int i ) const { return m_axis[i].nBins; }
+    auto  minValue( unsigned int i ) const { return m_axis[i].minValue; }
+    auto  maxValue( unsigned int i ) const { return m_axis[i].maxValue; }
+    auto  binValue( unsigned int i ) const {
+      auto acc = find( i );
+      return acc ? acc->value() : emptyBin().value();
+    }
+    auto nEntries( unsigned int i ) const {
+      auto acc = find( i );
+      return acc ? acc->nEntries() : emptyBin().nEntries();
+    }
+    auto totNBins() const { return m_totNBins; }
+
+  private:
+    static const BaseAccumulatorT<atomicity::none, Arithmetic>& emptyBin() {
+      static const BaseAccumulatorT<atomicity::none, Arithmetic> empty{};
+      return empty;
+    }
+    /// bin accumulator for reading, nullptr if the bin was never filled
+    const BaseAccumulator* find( unsigned int index ) const {
+      assert( index < m_totNBins );
+      auto block = m_blocks[index / BlockSize].load( std::memory_order_acquire );
+      return block ? block + index % BlockSize : nullptr;
+    }
+    /// bin accumulator for writing, allocating its block if needed
+    BaseAccumulator& accumulator( unsigned int index ) {
+      assert( index < m_totNBins );
+      auto& slot  = m_blocks[index / BlockSize];
+      auto  block = slot.load( std::memory_order_acquire );
+      if ( !block ) block = allocateBlock( slot );
+      return block[index % BlockSize];
+    }
+    template <typename F>
+    void forEachAllocatedBin( F&& f ) {
+      for ( unsigned int b = 0; b < m_nBlocks; ++b ) {
+        auto block = m_blocks[b].load( std::memory_order_acquire );
+        if ( !block ) continue;
+        const unsigned int first = b * BlockSize;
+        for ( unsigned int i = 0; i < BlockSize && first + i < m_totNBins; ++i ) f( first + i, block[i] );
+      }
+    }
+    BaseAccumulator* allocateBlock( std::atomic<BaseAccumulator*>& slot ) {
+      BaseAccumulator* expected = nullptr;
+      auto             fresh    = new BaseAccumulator[BlockSize];
+      if ( !slot.compare_exchange_strong( expected, fresh, std::memory_order_acq_rel ) ) {
+        delete[] fresh; // another thread was faster
+        return expected;
+      }
+      if ( ++m_nAllocated > m_promotionThreshold * m_nBlocks ) promote();
+      return fresh;
+    }
+    /// allocate all the missing blocks in one go
+    void promote() {
+      if ( m_promoted.exchange( true ) ) return;
+      unsigned int missing = 0;
+      for ( unsigned int b = 0; b < m_nBlocks; ++b ) missing += !m_blocks[b].load( std::memory_order_relaxed );
+      if ( !missing ) return;
+      m_dense.reset( new BaseAccumulator[missing * BlockSize] );
+      m_denseSize = missing * BlockSize;
+      auto next   = m_dense.get();
+      for ( unsigned int b = 0; b < m_nBlocks && next != m_dense.get() + m_denseSize; ++b ) {
+        BaseAccumulator* expected = nullptr;
+        // blocks allocated concurrently leave a hole in the dense storage, which is harmless
+        if ( m_blocks[b].compare_exchange_strong( expected, next, std::memory_order_acq_rel ) ) ++m_nAllocated;
+        next += BlockSize;
+      }
+    }
+    bool inDenseStorage( const BaseAccumulator* block ) const {
+      return m_dense && !std::less<const BaseAccumulator*>{}( block, m_dense.get() ) &&
+             std::less<const BaseAccumulator*>{}( block, m_dense.get() + m_denseSize );
+    }
+
+    /// set of Axis of this Histogram
+    std::array<AxisType, ND::value> m_axis;
+    /// total number of bins in this histogram, under and overflow included
+    unsigned int m_totNBins;
+    /// number of blocks of bins
+    unsigned int m_nBlocks;
+    /// pointers to the blocks, nullptr for blocks not yet used
+    std::unique_ptr<std::atomic<BaseAccumulator*>[]> m_blocks;
+    /// storage of the blocks allocated at promotion time
+    std::unique_ptr<BaseAccumulator[]> m_dense;
+    unsigned int                       m_denseSize{ 0 };
+    std::atomic<unsigned int>          m_nAllocated{ 0 };
+    std::atomic<bool>                  m_promoted{ false };
+    double                             m_promotionThreshold{ 0.5 };
+  };
+
+  /// sparse version of HistogramingAccumulator
+  template <atomicity Atomicity, typename Arithmetic, typename ND>
+  using SparseHistogramingAccumulator =
+      SparseHistogramingAccumulatorInternal<Atomicity, HistoInputType<Arithmetic, ND::value>, unsigned long, ND,
+                                            IntegralAccumulator>;
+
+  /// sparse version of WeightedHistogramingAccumulator
+  template <atomicity Atomicity, typename Arithmetic, typename ND>
+  using SparseWeightedHistogramingAccumulator =
+      SparseHistogramingAccumulatorInternal<Atomicity, WeightedHistoInputType<Arithmetic, ND::value>, Arithmetic, ND,
+                                            WeightedCountAccumulator>;
+
+  /// sparse version of ProfileHistogramingAccumulator
+  template <atomicity Atomicity, typename Arithmetic, typename ND>
+  using SparseProfileHistogramingAccumulator =
+      SparseHistogramingAccumulatorInternal<Atomicity, HistoInputType<Arithmetic, ND::value + 1, ND::value>,
+                                            Arithmetic, ND, SigmaAccumulator>;
+
+  /// sparse version of WeightedProfileHistogramingAccumulator
+  template <atomicity Atomicity, typename Arithmetic, typename ND>
+  using SparseWeightedProfileHistogramingAccumulator =
+      SparseHistogramingAccumulatorInternal<Atomicity, WeightedHistoInputType<Arithmetic, ND::value + 1, ND::value>,
+                                            Arithmetic, ND, WeightedSigmaAccumulator>;
+
+  /**
+   * Histograms with sparse storage of the bins, to be used for finely binned histograms
+   * expected to have most of their bins empty. They are used exactly as the dense ones
+   * (Histogram, WeightedHistogram, ...), including within HistogramArray, and produce the
+   * same JSON output, so that they are handled transparently by the existing sinks.
+   */
+  template <unsigned int ND, atomicity Atomicity = atomicity::full, typename Arithmetic = double>
+  using SparseHistogram =
+      HistogramingCounterBase<ND, Atomicity, Arithmetic, naming::histogramString, SparseHistogramingAccumulator>;
+
+  /// sparse version of WeightedHistogram
+  template <unsigned int ND, atomicity Atomicity = atomicity::full, typename Arithmetic = double>
+  using SparseWeightedHistogram = HistogramingCounterBase<ND, Atomicity, Arithmetic, naming::weightedHistogramString,
+                                                          SparseWeightedHistogramingAccumulator>;
+
+  /// sparse version of ProfileHistogram
+  template <unsigned int ND, atomicity Atomicity = atomicity::full, typename Arithmetic = double>
+  using SparseProfileHistogram = HistogramingCounterBase<ND, Atomicity, Arithmetic, naming::profilehistogramString,
+                                                         SparseProfileHistogramingAccumulator>;
+
+  /// sparse version of WeightedProfileHistogram
+  template <unsigned int ND, atomicity Atomicity = atomicity::full, typename Arithmetic = double>
+  using SparseWeightedProfileHistogram =
+      HistogramingCounterBase<ND, Atomicity, Arithmetic, naming::weightedProfilehistogramString,
+                              SparseWeightedProfileHistogramingAccumulator>;
+
+} // namespace Gaudi::Accumulators
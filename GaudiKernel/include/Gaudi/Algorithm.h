@@ -20,6 +20,7 @@
 #include "GaudiKernel/ISvcLocator.h"
 #include "GaudiKernel/ITimelineSvc.h"
 
+#include <limits>
 #include <string>
 #include <vector>
 
@@ -103,6 +104,9 @@ namespace Gaudi {
         , m_version( std::move( version ) ) // incremented by AlgResourcePool
         , m_pSvcLocator( svcloc ) {}
 
+    /// Destructor
+    ~Algorithm() override;
+
     /** Reinitialization method invoked by the framework. This method is responsible
      *  for any reinitialization required by the framework itself.
      *  It will in turn invoke the reinitialize() method of the derived algorithm,
@@ -443,6 +447,9 @@ namespace Gaudi {
     std::string      m_version;   ///< Algorithm's version
     unsigned int     m_index = 0; ///< Algorithm's index
 
+    /// index of the Algorithm in the AlgExecStateSvc, known after initialization
+    std::size_t m_execStateIndex = std::numeric_limits<std::size_t>::max();
+
     // tools used by algorithm
     mutable std::vector<IAlgTool*>             m_tools;
     mutable std::vector<BaseToolHandle*>       m_toolHandles;
@@ -478,6 +485,14 @@ namespace Gaudi {
     std::unique_ptr<IDataHandleVisitor> m_updateDataHandles;
 
   private:
+    /// Statistics of the time spent in execute() (see property TimeExecute)
+    struct ExecTimer;
+    /// Deleter defined where ExecTimer is complete, so that the inline constructor does not need it
+    struct ExecTimerDeleter {
+      void operator()( ExecTimer* timer ) const;
+    };
+    std::unique_ptr<ExecTimer, ExecTimerDeleter> m_execTimer;
+
     // Properties
     Gaudi::Property<int> m_outputLevel{
         this, "OutputLevel", MSG::NIL,
@@ -501,6 +516,10 @@ namespace Gaudi {
     Gaudi::Property<bool> m_auditorStop{ this, "AuditStop", m_auditInit.value(), "trigger auditor on stop()" };
 
     Gaudi::Property<bool> m_doTimeline{ this, "Timeline", true, "send events to TimelineSvc" };
+    std::uint32_t         m_timelineId = 0; ///< identifier of the algorithm in the TimelineSvc records
+
+    Gaudi::Property<bool> m_timeExecute{ this, "TimeExecute", false,
+                                         "accumulate the time spent in execute() in the ExecuteTime counter" };
 
     Gaudi::Property<std::string> m_monitorSvcName{ this, "MonitorService", "MonitorSvc",
                                                    "name to use for Monitor Service" };
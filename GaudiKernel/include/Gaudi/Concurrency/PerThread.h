@@ -0,0 +1,90 @@
+/***********************************************************************************\
+* (c) Copyright 2022 CERN for the benefit of the LHCb and ATLAS collaborations      *
+*                                                                                   *
+* This software is distributed under the terms of the Apache version 2 licence,     *
+* copied verbatim in the file "LICENSE".                                            *
+*                                                                                   *
+* In applying this licence, CERN does not waive the privileges and immunities       *
+* granted to it by virtue of its status as an Intergovernmental Organization        *
+* or submit itself to any jurisdiction.                                             *
+\***********************************************************************************/
+#pragma once
+
+#include <atomic>
+#include <cstdint>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <vector>
+
+namespace Gaudi::Concurrency {
+  /**
+   * Objects of a component, one for each thread using it, e.g. buffers filled only by their
+   * thread and read or merged by another one.
+   *
+   * After the first call of a thread, local() finds the object of the thread without locking.
+   * The objects are owned by the PerThread instance (not by the threads), so that they can be
+   * visited, and are destroyed by clear() or with the instance: the threads get new objects on
+   * their next call.
+   */
+  template <typename T>
+  class PerThread {
+  public:
+    PerThread()                              = default;
+    PerThread( const PerThread& )            = delete;
+    PerThread& operator=( const PerThread& ) = delete;
+
+    /// Object of the calling thread, created by `make()` (returning a std::unique_ptr<T>) on the first call.
+    template <typename Make>
+    T& local( Make&& make ) {
+      T*& obj = cached( m_id.load( std::memory_order_acquire ) );
+      if ( !obj ) {
+        auto created = make();
+        auto lock    = std::scoped_lock{ m_mutex };
+        obj          = m_objects.emplace_back( std::move( created ) ).get();
+      }
+      return *obj;
+    }
+    /// Object of the calling thread, default constructed on the first call.
+    T& local() {
+      return local( [] { return std::make_unique<T>(); } );
+    }
+
+    /// Call `f( T& )` for the objects of all threads (no object can be added meanwhile).
+    template <typename F>
+    void forEach( F&& f ) const {
+      auto lock = std::scoped_lock{ m_mutex };
+      for ( const auto& obj : m_objects ) f( *obj );
+    }
+
+    /// Destroy the objects of all threads, which must not be using them.
+    void clear() {
+      auto lock = std::scoped_lock{ m_mutex };
+      // invalidate the pointers cached by the threads
+      m_id.store( ++s_instanceCount, std::memory_order_release );
+      m_objects.clear();
+    }
+
+  private:
+    /// Pointer to the object of the calling thread for the instance with the given id.
+    static T*& cached( std::uint64_t id ) {
+      // usually a thread uses only one instance of a component, so the last one is cached
+      // (the map is needed only in the rare case of several instances)
+      thread_local std::uint64_t               lastId = 0;
+      thread_local T**                         last   = nullptr;
+      thread_local std::map<std::uint64_t, T*> all;
+      if ( id != lastId ) {
+        last   = &all[id];
+        lastId = id;
+      }
+      return *last;
+    }
+
+    inline static std::atomic<std::uint64_t> s_instanceCount{ 0 };
+
+    /// unique identifier of the instance (ids are never reused)
+    std::atomic<std::uint64_t>      m_id{ ++s_instanceCount };
+    std::vector<std::unique_ptr<T>> m_objects;
+    mutable std::mutex              m_mutex;
+  };
+} // namespace Gaudi::Concurrency
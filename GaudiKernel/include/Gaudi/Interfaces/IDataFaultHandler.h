@@ -0,0 +1,38 @@
+/***********************************************************************************\
+* (c) Copyright 2022 CERN for the benefit of the LHCb and ATLAS collaborations      *
+*                                                                                   *
+* This software is distributed under the terms of the Apache version 2 licence,     *
+* copied verbatim in the file "LICENSE".                                            *
+*                                                                                   *
+* In applying this licence, CERN does not waive the privileges and immunities       *
+* granted to it by virtue of its status as an Intergovernmental Organization        *
+* or submit itself to any jurisdiction.                                             *
+\***********************************************************************************/
+#pragma once
+
+#include <GaudiKernel/IInterface.h>
+#include <GaudiKernel/StatusCode.h>
+#include <string>
+
+namespace Gaudi::Interfaces {
+  /// Interface of components able to create, on request, the objects missing in a data service.
+  struct IDataFaultHandler : extend_interfaces<IInterface> {
+    DeclareInterfaceID( IDataFaultHandler, 1, 0 );
+
+    /// Called by the data service when the object at the given (full) path is missing.
+    virtual void handleDataFault( const std::string& path ) = 0;
+  };
+
+  /** Interface of data services that can call an IDataFaultHandler directly on data faults.
+   *
+   *  The handler is invoked before (and instead of, if it provides the missing object)
+   *  the "DataFault" incident, saving the incident dispatch in the common case.
+   */
+  struct IDataFaultSource : extend_interfaces<IInterface> {
+    DeclareInterfaceID( IDataFaultSource, 1, 0 );
+
+    /// Set the handler to call on data faults (nullptr to remove it).
+    /// The data service does not take the ownership of the handler.
+    virtual StatusCode setDataFaultHandler( IDataFaultHandler* handler ) = 0;
+  };
+} // namespace Gaudi::Interfaces
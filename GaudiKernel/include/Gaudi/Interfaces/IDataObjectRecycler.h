@@ -0,0 +1,82 @@
+/***********************************************************************************\
+* (c) Copyright 2022 CERN for the benefit of the LHCb and ATLAS collaborations      *
+*                                                                                   *
+* This software is distributed under the terms of the Apache version 2 licence,     *
+* copied verbatim in the file "LICENSE".                                            *
+*                                                                                   *
+* In applying this licence, CERN does not waive the privileges and immunities       *
+* granted to it by virtue of its status as an Intergovernmental Organization        *
+* or submit itself to any jurisdiction.                                             *
+\***********************************************************************************/
+#pragma once
+
+#include <GaudiKernel/AnyDataWrapper.h>
+#include <GaudiKernel/DataObject.h>
+#include <GaudiKernel/IInterface.h>
+#include <GaudiKernel/detected.h>
+#include <memory>
+#include <type_traits>
+#include <typeinfo>
+
+namespace Gaudi::Interfaces {
+  /** Interface of event stores able to recycle DataObject instances across events.
+   *
+   *  Recycling of a type is enabled the first time a producer asks for an instance
+   *  of it: from then on, the objects of that type handed back to the store when
+   *  an event slot is cleared are reset (keeping their capacity) and kept in a
+   *  per-slot pool instead of being deleted.
+   */
+  struct IDataObjectRecycler : extend_interfaces<IInterface> {
+    DeclareInterfaceID( IDataObjectRecycler, 1, 0 );
+
+    /// Function bringing a recycled object back to its default (empty) state.
+    using Resetter = void ( * )( DataObject& );
+
+    /// Get a recycled instance of the requested type from the pool of the current slot,
+    /// enabling the recycling of the type if needed.
+    /// Returns an empty pointer if no instance is available.
+    virtual std::unique_ptr<DataObject> acquire( const std::type_info& type, Resetter reset ) = 0;
+  };
+} // namespace Gaudi::Interfaces
+
+namespace Gaudi::Recycling {
+  namespace details {
+    template <typename T>
+    using clear_t = decltype( std::declval<T&>().clear() );
+
+    /// Describe how a type can be recycled: by default it must be default
+    /// constructible and provide a clear() method.
+    template <typename T>
+    struct Traits {
+      static constexpr bool recyclable =
+          std::is_default_constructible_v<T> && Gaudi::cpp17::is_detected_v<clear_t, T>;
+      static std::unique_ptr<T> create() { return std::make_unique<T>(); }
+      static void               reset( T& obj ) { obj.clear(); }
+    };
+
+    /// AnyDataWrapper<T> is recyclable if the wrapped type is.
+    template <typename T>
+    struct Traits<AnyDataWrapper<T>> {
+      static constexpr bool recyclable =
+          std::is_default_constructible_v<T> && Gaudi::cpp17::is_detected_v<clear_t, T>;
+      static std::unique_ptr<AnyDataWrapper<T>> create() { return std::make_unique<AnyDataWrapper<T>>( T{} ); }
+      static void                               reset( AnyDataWrapper<T>& obj ) { obj.getData().clear(); }
+    };
+  } // namespace details
+
+  template <typename T>
+  inline constexpr bool is_recyclable_v = details::Traits<T>::recyclable;
+
+  /// Get an empty instance of T, recycled from the store if possible, otherwise newly allocated.
+  template <typename T>
+  std::unique_ptr<T> acquire( Interfaces::IDataObjectRecycler* recycler ) {
+    using Traits = details::Traits<T>;
+    if constexpr ( Traits::recyclable ) {
+      if ( recycler ) {
+        auto obj = recycler->acquire( typeid( T ), []( DataObject& o ) { Traits::reset( static_cast<T&>( o ) ); } );
+        if ( obj ) return std::unique_ptr<T>{ static_cast<T*>( obj.release() ) };
+      }
+    }
+    return Traits::create();
+  }
+} // namespace Gaudi::Recycling
@@ -0,0 +1,44 @@
+/***********************************************************************************\
+* (c) Copyright 2022 CERN for the benefit of the LHCb and ATLAS collaborations      *
+*                                                                                   *
+* This software is distributed under the terms of the Apache version 2 licence,     *
+* copied verbatim in the file "LICENSE".                                            *
+*                                                                                   *
+* In applying this licence, CERN does not waive the privileges and immunities       *
+* granted to it by virtue of its status as an Intergovernmental Organization        *
+* or submit itself to any jurisdiction.                                             *
+\***********************************************************************************/
+#pragma once
+
+#include <GaudiKernel/DataObject.h>
+#include <GaudiKernel/EventIDRange.h>
+#include <GaudiKernel/IInterface.h>
+#include <GaudiKernel/StatusCode.h>
+#include <memory>
+#include <string_view>
+
+namespace Gaudi::Interfaces {
+  /** Interface of event stores able to hold objects shared by all the event slots.
+   *
+   *  A shared object is registered once and then found, in every slot, at the given
+   *  location (unless an object with the same path was registered in the slot itself),
+   *  e.g. through a plain DataObjectReadHandle. It must not be modified once registered.
+   *
+   *  A slot keeps a reference to the shared objects it used until it is cleared, so
+   *  unregistering an object does not invalidate the events being processed.
+   */
+  struct ISharedDataStore : extend_interfaces<IInterface> {
+    DeclareInterfaceID( ISharedDataStore, 1, 0 );
+
+    /// Make an object visible in all the event slots.
+    virtual StatusCode registerShared( std::string_view path, std::shared_ptr<DataObject> obj ) = 0;
+
+    /// Make an object visible in the event slots processing events within the given IOV.
+    /// Several objects can be registered at the same location for different IOVs.
+    virtual StatusCode registerShared( std::string_view path, std::shared_ptr<DataObject> obj,
+                                       const EventIDRange& iov ) = 0;
+
+    /// Remove the shared object(s) registered at the given location.
+    virtual StatusCode unregisterShared( std::string_view path ) = 0;
+  };
+} // namespace Gaudi::Interfaces
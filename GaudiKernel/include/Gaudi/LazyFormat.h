@@ -0,0 +1,115 @@
+/***********************************************************************************\
+* (c) Copyright 2022 CERN for the benefit of the LHCb and ATLAS collaborations      *
+*                                                                                   *
+* This software is distributed under the terms of the Apache version 2 licence,     *
+* copied verbatim in the file "LICENSE".                                            *
+*                                                                                   *
+* In applying this licence, CERN does not waive the privileges and immunities       *
+* granted to it by virtue of its status as an Intergovernmental Organization        *
+* or submit itself to any jurisdiction.                                             *
+\***********************************************************************************/
+#pragma once
+
+#include <GaudiKernel/MsgStream.h>
+
+#include <fmt/format.h>
+
+#include <iterator>
+#include <new>
+#include <string>
+#include <string_view>
+#include <tuple>
+#include <type_traits>
+#include <utility>
+
+namespace Gaudi {
+  /**
+   * Message text made of a format string and the captured arguments, formatted with fmt only
+   * when it is sent to an active MsgStream, i.e. after the checks of the output level and of
+   * the message limits.
+   *
+   * The arguments are captured by reference, so the object has to be used in the statement
+   * where it is created:
+   * @code
+   * warning() << Gaudi::lazyFormat( "track {} has chi2/ndof {:.2f}", key, chi2 ) << endmsg;
+   * @endcode
+   */
+  template <typename... Args>
+  class LazyFormat {
+  public:
+    LazyFormat( fmt::format_string<const Args&...> format, const Args&... args )
+        : m_format{ format }, m_args{ args... } {}
+
+    /// Format the text to the output iterator.
+    template <typename OutputIt>
+    OutputIt formatTo( OutputIt out ) const {
+      return std::apply( [&]( const auto&... args ) { return fmt::format_to( out, m_format, args... ); }, m_args );
+    }
+
+  private:
+    fmt::format_string<const Args&...> m_format;
+    std::tuple<const Args&...>         m_args;
+  };
+
+  /// Create a LazyFormat (the format string is checked at compile time).
+  template <typename... Args>
+  LazyFormat<Args...> lazyFormat( fmt::format_string<const Args&...> format, const Args&... args ) {
+    return { format, args... };
+  }
+
+  namespace details {
+    /// Type used to copy an argument of a DeferredFormat: strings are always copied to std::string.
+    template <typename T>
+    using deferred_arg_t = std::conditional_t<std::is_convertible_v<const std::decay_t<T>&, std::string_view>,
+                                              std::string, std::decay_t<T>>;
+  } // namespace details
+
+  /**
+   * Message text made of a format string and copies of the arguments, which can be formatted
+   * later and in another thread (see reportDeferred()).
+   */
+  template <typename... Args>
+  class DeferredFormat final : public DeferredText {
+  public:
+    template <typename... A>
+    DeferredFormat( fmt::format_string<const Args&...> format, A&&... args )
+        : m_format{ format }, m_args{ std::forward<A>( args )... } {}
+
+    void formatTo( std::string& out ) const override {
+      std::apply( [&]( const auto&... args ) { fmt::format_to( std::back_inserter( out ), m_format, args... ); },
+                  m_args );
+    }
+    std::size_t   size() const override { return sizeof( DeferredFormat ); }
+    std::size_t   alignment() const override { return alignof( DeferredFormat ); }
+    DeferredText* moveTo( void* storage ) override { return new ( storage ) DeferredFormat( std::move( *this ) ); }
+
+  private:
+    fmt::format_string<const Args&...> m_format;
+    std::tuple<Args...>                m_args;
+  };
+
+  /**
+   * Report a message to an active MsgStream, with the text formatted from a copy of the arguments
+   * by the message service when it prints it: with AsyncMessageSvc the formatting is done by the
+   * printer thread instead of the reporting one. Nothing is copied if the stream is not active.
+   * @code
+   * Gaudi::reportDeferred( warning(), "track {} has chi2/ndof {:.2f}", key, chi2 );
+   * @endcode
+   */
+  template <typename... Args>
+  MsgStream& reportDeferred( MsgStream&                                                 s,
+                             fmt::format_string<const details::deferred_arg_t<Args>&...> format, Args&&... args ) {
+    if ( !s.isActive() ) return s;
+    DeferredFormat<details::deferred_arg_t<Args>...> text{ format, std::forward<Args>( args )... };
+    return s.doOutput( text );
+  }
+} // namespace Gaudi
+
+template <typename... Args>
+MsgStream& operator<<( MsgStream& s, const Gaudi::LazyFormat<Args...>& text ) {
+  try {
+    // this may throw, and we cannot afford it if the stream is used in a catch block
+    if ( s.isActive() ) text.formatTo( std::ostreambuf_iterator<char>( s.stream() ) );
+  } catch ( ... ) {}
+  return s;
+}
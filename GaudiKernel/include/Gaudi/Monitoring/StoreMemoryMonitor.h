@@ -0,0 +1,90 @@
+/***********************************************************************************\
+* (c) Copyright 2022 CERN for the benefit of the LHCb and ATLAS collaborations      *
+*                                                                                   *
+* This software is distributed under the terms of the Apache version 2 licence,     *
+* copied verbatim in the file "LICENSE".                                            *
+*                                                                                   *
+* In applying this licence, CERN does not waive the privileges and immunities       *
+* granted to it by virtue of its status as an Intergovernmental Organization        *
+* or submit itself to any jurisdiction.                                             *
+\***********************************************************************************/
+#pragma once
+
+#include <Gaudi/Accumulators/Histogram.h>
+#include <GaudiKernel/IAlgorithm.h>
+#include <GaudiKernel/ThreadLocalContext.h>
+
+#include <cstdint>
+#include <map>
+#include <mutex>
+#include <shared_mutex>
+#include <string>
+#include <string_view>
+
+namespace Gaudi::Monitoring {
+  /** Sampled accounting of the memory used by the objects registered in an event store.
+   *
+   *  The size of each accounted object, as reported by DataObject::memoryFootprint(), is filled,
+   *  in KiB, in two histograms: one for the location of the object and one for the algorithm that
+   *  produced it (i.e. the one being executed by the registering thread). Objects reporting no size
+   *  are not accounted for, and the bookkeeping of the store itself is not included, so that all
+   *  the stores give the same numbers for the same objects.
+   *
+   *  The histograms are published through the monitoring hub as "MemoryByPath/<location>" and
+   *  "MemoryByAlgorithm/<algorithm>". As the locations are only known when the objects are
+   *  registered, the histograms are created on demand by the event threads: their creation is
+   *  serialized by the monitor and their registration by the hub, so that it is safe while other
+   *  threads fill histograms, create other ones or take snapshots of the hub.
+   *
+   *  To keep the overhead low, only one object out of `period` (on average) is accounted for.
+   */
+  template <typename OWNER>
+  class StoreMemoryMonitor {
+  public:
+    using Histogram = Gaudi::Accumulators::Histogram<1, Gaudi::Accumulators::atomicity::full, double>;
+    using Axis      = Gaudi::Accumulators::Axis<double>;
+
+    StoreMemoryMonitor( OWNER* owner, unsigned int period, Axis axis )
+        : m_owner{ owner }, m_period{ period }, m_axis{ std::move( axis ) } {}
+
+    /// Tell if the object being registered has to be accounted for.
+    bool sample() const {
+      if ( m_period <= 1 ) return m_period == 1;
+      // cheap per-thread xorshift generator, so that we do not always pick the same locations
+      static thread_local std::uint32_t state = 2463534242u;
+      state ^= state << 13;
+      state ^= state >> 17;
+      state ^= state << 5;
+      return state % m_period == 0;
+    }
+
+    /// Account for `bytes` registered at `path` by the current algorithm.
+    void record( std::string_view path, std::size_t bytes ) {
+      if ( !bytes ) return; // nothing known about the object
+      const double kib = bytes / 1024.;
+      const auto   alg = Gaudi::Hive::currentAlgorithm();
+      ++histogram( m_byPath, "MemoryByPath/", path )[kib];
+      ++histogram( m_byAlgorithm, "MemoryByAlgorithm/", alg ? std::string_view{ alg->name() } : "<none>" )[kib];
+    }
+
+  private:
+    using Histograms = std::map<std::string, Histogram, std::less<>>;
+
+    Histogram& histogram( Histograms& histos, std::string_view prefix, std::string_view key ) {
+      {
+        std::shared_lock lock{ m_mutex };
+        if ( auto i = histos.find( key ); i != histos.end() ) return i->second;
+      }
+      std::scoped_lock lock{ m_mutex };
+      auto             name = std::string{ prefix }.append( key );
+      return histos.try_emplace( std::string{ key }, m_owner, name, name, m_axis ).first->second;
+    }
+
+    OWNER*            m_owner;
+    unsigned int      m_period;
+    Axis              m_axis;
+    std::shared_mutex m_mutex;
+    Histograms        m_byPath;
+    Histograms        m_byAlgorithm;
+  };
+} // namespace Gaudi::Monitoring
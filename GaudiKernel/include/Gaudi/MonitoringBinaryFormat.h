@@ -0,0 +1,99 @@
+/***********************************************************************************\
+* (c) Copyright 2022 CERN for the benefit of the LHCb and ATLAS collaborations      *
+*                                                                                   *
+* This software is distributed under the terms of the Apache version 2 licence,     *
+* copied verbatim in the file "LICENSE".                                            *
+*                                                                                   *
+* In applying this licence, CERN does not waive the privileges and immunities       *
+* granted to it by virtue of its status as an Intergovernmental Organization        *
+* or submit itself to any jurisdiction.                                             *
+\***********************************************************************************/
+#pragma once
+
+#include <Gaudi/MonitoringHub.h>
+
+#include <cstdint>
+#include <istream>
+#include <optional>
+#include <stdexcept>
+#include <ostream>
+#include <string_view>
+#include <vector>
+
+/**
+ * Compact binary format for the Monitoring::Hub entities, written one by one as a stream.
+ *
+ * A file starts with the 8 characters "GAUDIMON" followed by the format version, then contains
+ * one record per entity. A record is the size of its payload followed by the payload itself,
+ * the CBOR encoding (RFC 8949) of the dictionary { "name", "component", "entity" } that JSONSink
+ * writes for the same entity. All integers of the framing are 32 bits little endian.
+ */
+namespace Gaudi::Monitoring::BinaryFormat {
+
+  inline constexpr std::string_view magic{ "GAUDIMON" };
+  inline constexpr std::uint32_t    version{ 1 };
+
+  namespace details {
+    inline void writeUInt32( std::ostream& os, std::uint32_t v ) {
+      const char bytes[4] = { char( v & 0xff ), char( ( v >> 8 ) & 0xff ), char( ( v >> 16 ) & 0xff ),
+                              char( ( v >> 24 ) & 0xff ) };
+      os.write( bytes, 4 );
+    }
+    inline std::optional<std::uint32_t> readUInt32( std::istream& is ) {
+      unsigned char bytes[4];
+      if ( !is.read( reinterpret_cast<char*>( bytes ), 4 ) ) return std::nullopt;
+      return std::uint32_t( bytes[0] ) | std::uint32_t( bytes[1] ) << 8 | std::uint32_t( bytes[2] ) << 16 |
+             std::uint32_t( bytes[3] ) << 24;
+    }
+  } // namespace details
+
+  /// Writes the header, then one record per call to write, reusing the same buffer for all of them.
+  class Writer {
+  public:
+    Writer( std::ostream& os ) : m_os{ os } {
+      m_os.write( magic.data(), magic.size() );
+      details::writeUInt32( m_os, version );
+    }
+    void write( Hub::Entity const& ent ) {
+      write( nlohmann::json{ { "name", ent.name }, { "component", ent.component }, { "entity", ent.toJSON() } } );
+    }
+    void write( nlohmann::json const& record ) {
+      m_buffer.clear();
+      nlohmann::json::to_cbor( record, m_buffer );
+      details::writeUInt32( m_os, m_buffer.size() );
+      m_os.write( reinterpret_cast<const char*>( m_buffer.data() ), m_buffer.size() );
+    }
+
+  private:
+    std::ostream&             m_os;
+    std::vector<std::uint8_t> m_buffer;
+  };
+
+  /// Checks the header, then gives back the records one by one, as JSON.
+  class Reader {
+  public:
+    Reader( std::istream& is ) : m_is{ is } {
+      char header[magic.size()];
+      if ( !m_is.read( header, magic.size() ) || std::string_view( header, magic.size() ) != magic ) {
+        throw std::runtime_error( "BinaryFormat::Reader: not a Gaudi monitoring file" );
+      }
+      if ( auto v = details::readUInt32( m_is ); !v || *v != version ) {
+        throw std::runtime_error( "BinaryFormat::Reader: unsupported format version" );
+      }
+    }
+    /// next record, or nothing at the end of the stream
+    std::optional<nlohmann::json> next() {
+      auto size = details::readUInt32( m_is );
+      if ( !size ) return std::nullopt;
+      m_buffer.resize( *size );
+      if ( !m_is.read( reinterpret_cast<char*>( m_buffer.data() ), *size ) ) {
+        throw std::runtime_error( "BinaryFormat::Reader: truncated record" );
+      }
+      return nlohmann::json::from_cbor( m_buffer );
+    }
+
+  private:
+    std::istream&             m_is;
+    std::vector<std::uint8_t> m_buffer;
+  };
+} // namespace Gaudi::Monitoring::BinaryFormat
@@ -12,12 +12,15 @@
 
 #include "GaudiKernel/detected.h"
 
+#include <cstdint>
 #include <deque>
 #include <functional>
+#include <mutex>
 #include <nlohmann/json.hpp>
 #include <string>
 #include <typeindex>
 #include <typeinfo>
+#include <unordered_map>
 
 namespace Gaudi::Monitoring {
 
@@ -35,6 +38,18 @@ namespace Gaudi::Monitoring {
     using has_from_json_ = decltype( T::fromJSON( nlohmann::json{} ) );
     template <typename T>
     inline constexpr bool has_from_json_v = Gaudi::cpp17::is_detected_v<has_from_json_, T>;
+    template <typename T>
+    using has_concurrent_reads_ = decltype( T::concurrentReads );
+
+    /// tell if T declares (with a `static constexpr bool concurrentReads`) that it can be serialized while updated
+    template <typename T>
+    constexpr bool supportsConcurrentReads() {
+      if constexpr ( Gaudi::cpp17::is_detected_v<has_concurrent_reads_, T> ) {
+        return T::concurrentReads;
+      } else {
+        return false;
+      }
+    }
 
     using MergeAndReset_t = void ( * )( void*, void* );
 
@@ -70,6 +85,10 @@ namespace Gaudi::Monitoring {
   ///
   /// The Gaudi::Monitoring::Hub delegates the actual reports to services implementing the Gaudi::Monitoring::Hub::Sink
   /// interface.
+  ///
+  /// Besides the final report that sinks usually produce at stop, the Hub can publish periodic snapshots
+  /// (see publishSnapshot), in which only the entities that changed since the previous snapshot are sent
+  /// to the sinks. All the methods of the Hub can be called from any thread.
   struct Hub {
     using json = nlohmann::json;
 
@@ -85,6 +104,9 @@ namespace Gaudi::Monitoring {
      * The type in json should match the type member of the Entity. It is used by Sink instances
      * to decide if they have to handle a given entity or not.
      * It can also be used to know which fields to expect in the json dictionnary
+     *
+     * Objects whose toJSON can be called while they are being updated from other threads declare it with
+     * a `static constexpr bool concurrentReads = true;` member. Only those appear in the snapshots.
      */
     class Entity {
     public:
@@ -100,7 +122,8 @@ namespace Gaudi::Monitoring {
           , m_reset{ []( void* ptr ) { reinterpret_cast<T*>( ptr )->reset(); } }
           , m_mergeAndReset{ details::makeMergeAndResetFor<T>() }
           , m_getJSON{ []( const void* ptr ) { return reinterpret_cast<const T*>( ptr )->toJSON(); } }
-          , m_mergeAndResetFromJSON{ details::makeMergeAndResetFromJSONFor<T>() } {}
+          , m_mergeAndResetFromJSON{ details::makeMergeAndResetFromJSONFor<T>() }
+          , m_concurrentReads{ details::supportsConcurrentReads<T>() } {}
       /// name of the component owning the Entity
       std::string component;
       /// name of the entity
@@ -129,6 +152,15 @@ namespace Gaudi::Monitoring {
       void mergeAndReset( nlohmann::json const& j ) {
         if ( canMergeFromJSON() ) ( *m_mergeAndResetFromJSON )( m_ptr, j );
       }
+      /// tell if the Entity data can be converted to JSON while being updated from other threads
+      bool canReadConcurrently() const { return m_concurrentReads; }
+      /// address of the actual data, identifying the Entity
+      const void* id() const { return m_ptr; }
+      /// access to the actual data, if its type is exactly T (nullptr otherwise)
+      template <typename T>
+      const T* dataAs() const {
+        return typeIndex() == std::type_index( typeid( T ) ) ? static_cast<const T*>( m_ptr ) : nullptr;
+      }
       /// operator== for comparison with raw pointer
       bool operator==( void* ent ) { return m_ptr == ent; }
       /// operator== for comparison with an entity
@@ -150,13 +182,23 @@ namespace Gaudi::Monitoring {
       json ( *m_getJSON )( const void* );
       /// function calling merge and reset on internal data from JSON input
       details::MergeAndResetFromJSON_t m_mergeAndResetFromJSON{ nullptr };
+      /// whether toJSON can be called concurrently with updates of the internal data
+      bool m_concurrentReads{ false };
     };
 
-    /// Interface reporting services must implement.
+    /** Interface reporting services must implement.
+     *
+     * All calls are serialized by the Hub, so sinks do not need to protect their own state
+     * against concurrent calls, but they must not call back into the Hub from them.
+     */
     struct Sink {
       virtual void registerEntity( Entity ent )      = 0;
       virtual void removeEntity( Entity const& ent ) = 0;
-      virtual ~Sink()                                = default;
+      /// called during a snapshot for each entity that changed since the previous one, with its current value
+      virtual void onSnapshot( std::uint64_t /* snapshot */, Entity const& /* ent */, json const& /* value */ ) {}
+      /// called at the end of each snapshot, even when no entity changed
+      virtual void onSnapshotEnd( std::uint64_t /* snapshot */ ) {}
+      virtual ~Sink() = default;
     };
 
     template <typename T>
@@ -164,30 +206,70 @@ namespace Gaudi::Monitoring {
       registerEntity( { std::move( c ), std::move( n ), std::move( t ), ent } );
     }
     void registerEntity( Entity ent ) {
+      std::scoped_lock lock{ m_mutex };
       std::for_each( begin( m_sinks ), end( m_sinks ), [ent]( auto sink ) { sink->registerEntity( ent ); } );
       m_entities.emplace_back( std::move( ent ) );
     }
     template <typename T>
     void removeEntity( T& ent ) {
-      auto it = std::find( begin( m_entities ), end( m_entities ), &ent );
+      std::scoped_lock lock{ m_mutex };
+      auto             it = std::find( begin( m_entities ), end( m_entities ), &ent );
       if ( it != m_entities.end() ) {
         std::for_each( begin( m_sinks ), end( m_sinks ), [&it]( auto sink ) { sink->removeEntity( *it ); } );
+        m_lastSnapshot.erase( it->id() );
         m_entities.erase( it );
       }
     }
 
     void addSink( Sink* sink ) {
+      std::scoped_lock lock{ m_mutex };
       std::for_each( begin( m_entities ), end( m_entities ),
                      [sink]( Entity ent ) { sink->registerEntity( std::move( ent ) ); } );
       m_sinks.push_back( sink );
     }
     void removeSink( Sink* sink ) {
-      auto it = std::find( begin( m_sinks ), end( m_sinks ), sink );
+      std::scoped_lock lock{ m_mutex };
+      auto             it = std::find( begin( m_sinks ), end( m_sinks ), sink );
       if ( it != m_sinks.end() ) m_sinks.erase( it );
     }
 
+    /** Publish a snapshot of the registered entities to the sinks.
+     *
+     * Every entity is serialized to JSON and passed to Sink::onSnapshot only if its content differs
+     * from the one it had in the previous snapshot (compared through a hash of the JSON). The values
+     * are read while the entities are being updated, so only the entities that support concurrent
+     * reads (see Entity::canReadConcurrently, e.g. atomic and sharded accumulators) are part of the
+     * snapshots, the others only appear in the final reports. Event threads are never blocked, except
+     * if they register or remove an entity while the snapshot is being taken.
+     *
+     * Meant to be called periodically from a dedicated thread, returns the number of changed entities.
+     */
+    std::size_t publishSnapshot() {
+      std::scoped_lock lock{ m_mutex };
+      const auto       snapshot = ++m_snapshotCount;
+      std::size_t      changed  = 0;
+      for ( auto& ent : m_entities ) {
+        if ( !ent.canReadConcurrently() ) continue;
+        auto value          = ent.toJSON();
+        auto h              = std::hash<json>{}( value );
+        auto [it, inserted] = m_lastSnapshot.try_emplace( ent.id(), h );
+        if ( !inserted ) {
+          if ( it->second == h ) continue;
+          it->second = h;
+        }
+        ++changed;
+        for ( auto sink : m_sinks ) sink->onSnapshot( snapshot, ent, value );
+      }
+      for ( auto sink : m_sinks ) sink->onSnapshotEnd( snapshot );
+      return changed;
+    }
+
   private:
+    std::mutex         m_mutex;
     std::deque<Sink*>  m_sinks;
     std::deque<Entity> m_entities;
+    /// hash of the JSON of each entity in the last snapshot
+    std::unordered_map<const void*, std::size_t> m_lastSnapshot;
+    std::uint64_t                                m_snapshotCount{ 0 };
   };
 } // namespace Gaudi::Monitoring
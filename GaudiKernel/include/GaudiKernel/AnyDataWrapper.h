@@ -10,6 +10,7 @@
 \***********************************************************************************/
 #pragma once
 #include "GaudiKernel/DataObject.h"
+#include "GaudiKernel/detected.h"
 #include <cstddef>
 #include <iterator>
 #include <optional>
@@ -23,6 +24,21 @@ namespace details {
     static_assert( sizeof...( Args ) == 0, "No extra args please" );
     return std::nullopt;
   }
+
+  template <typename T>
+  using capacity_t = decltype( std::declval<const T&>().capacity() );
+  template <typename T>
+  using value_type_t = typename T::value_type;
+
+  /// Estimate of the memory owned by a container (only contiguous storage is taken into account).
+  template <typename T>
+  constexpr std::size_t ownedMemory( const T& data ) noexcept {
+    if constexpr ( Gaudi::cpp17::is_detected_v<capacity_t, T> && Gaudi::cpp17::is_detected_v<value_type_t, T> ) {
+      return data.capacity() * sizeof( typename T::value_type );
+    } else {
+      return 0;
+    }
+  }
 } // namespace details
 
 // ugly hack to circumvent the usage of std::any
@@ -49,6 +65,8 @@ public:
     using details::size;
     return size( getData() );
   }
+
+  std::size_t memoryFootprint() const override { return sizeof( *this ) + details::ownedMemory( getData() ); }
 };
 
 template <typename ViewType, typename OwnedType>
@@ -63,4 +81,6 @@ public:
   AnyDataWithViewWrapper( AnyDataWithViewWrapper const& ) = delete;
   AnyDataWithViewWrapper& operator=( AnyDataWithViewWrapper&& ) = delete;
   AnyDataWithViewWrapper& operator=( AnyDataWithViewWrapper const& ) = delete;
+
+  std::size_t memoryFootprint() const override { return sizeof( *this ) + details::ownedMemory( m_owned ); }
 };
@@ -99,6 +99,33 @@ public:
     if ( svc ) { m_chrono = svc->chronoStart( tag ); }
   }
   // =========================================================================
+  /** Constructor from Chrono Service and the chrono handle
+   *
+   *  @code
+   *
+   *  IChronoSvc* svc = ... ;
+   *  const auto handle = svc->chronoHandle ( "some unique tag here" ) ;
+   *
+   *  { // start the scope
+   *    Chrono chrono ( svc , handle ) ;
+   *
+   *    for ( long i = 0 ; i < 10000000 ; ++i )
+   *     {
+   *        .. put some CPU-intensive computations here
+   *     }
+   *
+   *  } // end of the scope, destroy chrono
+   *
+   *  @endcode
+   *
+   *  @param svc    pointer to Chrono Service
+   *  @param handle the chrono handle
+   *  @see IChronoSvc::chronoHandle
+   */
+  Chrono( IChronoSvc* svc, IChronoSvc::ChronoHandle handle ) {
+    if ( svc ) { m_chrono = svc->chronoStart( handle ); }
+  }
+  // =========================================================================
   /** Constructor from Chrono Object/Entity
    *
    *  @code
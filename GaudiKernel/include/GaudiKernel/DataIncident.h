@@ -13,6 +13,8 @@
 
 // Include files
 #include "GaudiKernel/Incident.h"
+#include <type_traits>
+#include <typeinfo>
 
 /**
  * @class DataIncident DataIncident.h GaudiKernel/DataIncident.h
@@ -39,6 +41,13 @@ public:
 
   /// Accesssor to the tag value (CONST)
   const T& tag() const { return m_tag; }
+
+  std::unique_ptr<Incident> clone() const override {
+    if constexpr ( std::is_copy_constructible_v<T> ) {
+      if ( typeid( *this ) == typeid( ContextIncident ) ) return std::make_unique<ContextIncident>( *this );
+    }
+    return nullptr;
+  }
 };
 
 /// Specific incident type used by the data-on-demand-service
@@ -74,6 +74,10 @@ public:
 
   /// Provide empty placeholder for internal object reconfiguration callback
   virtual StatusCode update();
+  /// Number of bytes used by the object, including the memory it owns (0 if unknown).
+  /// Used by the event stores to account for the memory of the registered objects: only the types
+  /// overriding it (AnyDataWrapper, KeyedContainer, ObjectVector, ...) are accounted for.
+  virtual std::size_t memoryFootprint() const { return 0; }
 
   /**@name inline code of class DataObject    */
   /// Set pointer to Registry
@@ -128,6 +128,16 @@ public:
    */
   T* getOrCreate() const;
 
+  /**
+   * Get an empty object to be filled and put in the store, recycled from a
+   * previous event if the event store supports it, newly allocated otherwise
+   *
+   * The object must be filled in place: assigning another instance to it
+   * replaces the buffers kept from the previous event. (Functional algorithms
+   * return new instances, so their outputs are not recycled.)
+   */
+  std::unique_ptr<T> acquire() const { return Gaudi::Recycling::acquire<T>( m_recycler.get() ); }
+
   /**
    * Register object in transient store
    */
@@ -293,17 +303,26 @@ public:
     return data ? &data->getData() : nullptr;
   }
 
+  /**
+   * Get an empty wrapper to be filled in place and put in the store, recycled
+   * from a previous event if the event store supports it (see the same method
+   * of DataObjectHandle<T>)
+   */
+  std::unique_ptr<AnyDataWrapper<T>> acquire() const {
+    return Gaudi::Recycling::acquire<AnyDataWrapper<T>>( m_recycler.get() );
+  }
+
   /**
    * Register object in transient store
    */
-  const T* put( T&& obj ) const {
+  const T* put( std::unique_ptr<AnyDataWrapper<T>> objectp ) const {
     assert( m_init );
-    auto objectp = std::make_unique<AnyDataWrapper<T>>( std::move( obj ) );
     if ( auto sc = m_EDS->registerObject( objKey(), objectp.get() ); sc.isFailure() ) {
       throw GaudiException( "Error in put of " + objKey(), "DataObjectHandle<AnyDataWrapper<T>>::put", sc );
     }
     return &objectp.release()->getData();
   }
+  const T* put( T&& obj ) const { return put( std::make_unique<AnyDataWrapper<T>>( std::move( obj ) ) ); }
 
   /**
    * Size of boxed item, if boxed item has a 'size' method
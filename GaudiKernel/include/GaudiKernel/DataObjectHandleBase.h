@@ -13,6 +13,7 @@
 
 #include <mutex>
 
+#include "Gaudi/Interfaces/IDataObjectRecycler.h"
 #include "GaudiKernel/DataHandle.h"
 #include "GaudiKernel/IDataProviderSvc.h"
 #include "GaudiKernel/IMessageSvc.h"
@@ -69,6 +70,8 @@ protected:
 protected:
   SmartIF<IDataProviderSvc> m_EDS;
   SmartIF<IMessageSvc>      m_MS;
+  /// Recycling interface of the event store, if it provides one
+  SmartIF<Gaudi::Interfaces::IDataObjectRecycler> m_recycler;
 
   bool m_init     = false;
   bool m_optional = false;
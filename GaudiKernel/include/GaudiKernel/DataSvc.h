@@ -12,6 +12,7 @@
 #define GAUDIKERNEL_DATASVC_H
 
 // Include files
+#include "Gaudi/Interfaces/IDataFaultHandler.h"
 #include "GaudiKernel/DataStoreItem.h"
 #include "GaudiKernel/IConversionSvc.h"
 #include "GaudiKernel/IDataManagerSvc.h"
@@ -49,11 +50,15 @@ namespace DataSvcHelpers {
  * @author Sebastien Ponce
  * @version 1.0
  */
-class GAUDI_API DataSvc : public extends<Service, IDataProviderSvc, IDataManagerSvc> {
+class GAUDI_API DataSvc
+    : public extends<Service, IDataProviderSvc, IDataManagerSvc, Gaudi::Interfaces::IDataFaultSource> {
 
   /// Pointer to data loader service
   SmartIF<IConversionSvc> m_dataLoader = nullptr;
 
+  /// Handler called directly on data faults (not owned)
+  Gaudi::Interfaces::IDataFaultHandler* m_faultHandler = nullptr;
+
 protected:
   /// Pointer to incident service
   SmartIF<IIncidentSvc> m_incidentSvc = nullptr;
@@ -166,6 +171,9 @@ public:
    */
   StatusCode setDataLoader( IConversionSvc* svc, IDataProviderSvc* dpsvc = nullptr ) override;
 
+  /// IDataFaultSource: set the handler called directly on data faults
+  StatusCode setDataFaultHandler( Gaudi::Interfaces::IDataFaultHandler* handler ) override;
+
   /// Add an item to the preload list
   StatusCode addPreLoadItem( const DataStoreItem& item ) override;
 
@@ -296,5 +304,7 @@ private:
   StatusCode  i_retrieveEntry( DataSvcHelpers::RegistryEntry* parentObj, std::string_view path,
                                DataSvcHelpers::RegistryEntry*& pEntry );
   DataObject* i_handleDataFault( IRegistry* pReg, std::string_view path = std::string_view{} );
+  /// Give the fault handler (if any), then the incident listeners, a chance to create the missing object
+  IRegistry* i_dispatchDataFault( const std::string& path );
 };
 #endif // GAUDIKERNEL_DATASVC_H
@@ -20,6 +20,7 @@
 #include "GaudiKernel/Incident.h"
 
 #include <string>
+#include <typeinfo>
 
 /** @class FileIncident
  *  @brief This class is the FileIncident.
@@ -33,6 +34,10 @@ public:
   const std::string& fileName() const { return m_fileName; }
   const std::string& fileGuid() const { return m_fileGuid; }
 
+  std::unique_ptr<Incident> clone() const override {
+    return typeid( *this ) == typeid( FileIncident ) ? std::make_unique<FileIncident>( *this ) : nullptr;
+  }
+
 private:
   std::string m_fileName;
   std::string m_fileGuid;
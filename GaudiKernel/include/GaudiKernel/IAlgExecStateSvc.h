@@ -15,6 +15,7 @@
 #include "GaudiKernel/IInterface.h"
 #include "GaudiKernel/StatusCode.h"
 #include "GaudiKernel/StringKey.h"
+#include <cstddef>
 #include <map>
 #include <sstream>
 #include <string>
@@ -80,7 +81,7 @@ namespace EventStatus {
 class GAUDI_API IAlgExecStateSvc : virtual public IInterface {
 public:
   /// InterfaceID
-  DeclareInterfaceID( IAlgExecStateSvc, 1, 0 );
+  DeclareInterfaceID( IAlgExecStateSvc, 1, 1 );
 
   typedef std::map<Gaudi::StringKey, AlgExecState> AlgStateMap_t;
 
@@ -91,6 +92,12 @@ public:
   }
   virtual AlgExecState& algExecState( IAlgorithm* iAlg, const EventContext& ctx ) = 0;
 
+  // get the index of a known Algorithm, assigned when it is added, to access its state without
+  // looking up its name
+  virtual std::size_t algIndex( const Gaudi::StringKey& algName ) const = 0;
+  // get the Algorithm Execution State for the Algorithm of given index and EventContext
+  virtual AlgExecState& algExecState( std::size_t algIndex, const EventContext& ctx ) = 0;
+
   // get all the Algorithm Execution States for a given EventContext
   virtual const AlgStateMap_t& algExecStates( const EventContext& ctx ) const = 0;
 
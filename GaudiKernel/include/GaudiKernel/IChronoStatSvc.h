@@ -43,7 +43,7 @@
 class GAUDI_API IChronoStatSvc : virtual public extend_interfaces<IService, IChronoSvc, IStatSvc> {
 public:
   /// InterfaceID
-  DeclareInterfaceID( IChronoStatSvc, 6, 0 );
+  DeclareInterfaceID( IChronoStatSvc, 7, 0 );
 };
 // ============================================================================
 // The END
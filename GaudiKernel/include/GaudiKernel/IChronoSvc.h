@@ -15,6 +15,7 @@
 // ============================================================================
 // STD&STL
 // ============================================================================
+#include <cstddef>
 #include <string>
 // ============================================================================
 // GaudiKernel
@@ -41,12 +42,14 @@ class ChronoEntity;
 class GAUDI_API IChronoSvc : virtual public IInterface {
 public:
   /// InterfaceID
-  DeclareInterfaceID( IChronoSvc, 3, 0 );
+  DeclareInterfaceID( IChronoSvc, 4, 0 );
   // ==========================================================================
   /// the actual type of identifier for Chrono objects
   typedef std::string ChronoTag;
   /// Type of the delta-time
   typedef double ChronoTime;
+  /// Identifier of a chrono for the handle based methods, see chronoHandle()
+  enum class ChronoHandle : std::size_t {};
   // ==========================================================================
 public:
   // ==========================================================================
@@ -94,6 +97,42 @@ public:
    */
   virtual const ChronoEntity* chrono( const ChronoTag& t ) const = 0;
   // ==========================================================================
+  /** resolve a chrono tag (name) into a handle, to be used instead of the tag
+   *  in the time critical code
+   *
+   *  Chronos accessed by handle are accumulated separately by each thread,
+   *  without any locking, and are merged with the chronos accessed by tag
+   *  only when the final report is produced.
+   *
+   *  @code
+   *
+   *  // initialize()
+   *  m_handle = chronoSvc()->chronoHandle( "some unique tag here" ) ;
+   *
+   *  // execute()
+   *  chronoSvc()->chronoStart( m_handle ) ;
+   *  ...
+   *  chronoSvc()->chronoStop( m_handle ) ;
+   *
+   *  @endcode
+   *
+   *  @param t chrono tag (name)
+   *  @return chrono handle, valid for the lifetime of the service
+   */
+  virtual ChronoHandle chronoHandle( const ChronoTag& t ) = 0;
+  // ==========================================================================
+  /**    start   chrono of the current thread, identified by its handle
+   *     @param h chrono handle
+   *     @return chrono object (specific to the current thread)
+   */
+  virtual ChronoEntity* chronoStart( ChronoHandle h ) = 0;
+  // ==========================================================================
+  /**    stop    chrono of the current thread, identified by its handle
+   *     @param h chrono handle
+   *     @return chrono object (specific to the current thread)
+   */
+  virtual const ChronoEntity* chronoStop( ChronoHandle h ) = 0;
+  // ==========================================================================
 };
 // ============================================================================
 // The END
@@ -15,6 +15,7 @@
 #include "GaudiKernel/EventContextHash.h"
 #include "GaudiKernel/IInterface.h"
 #include "GaudiKernel/Incident.h"
+#include <cstdint>
 #include <memory>
 #include <string>
 #include <vector>
@@ -33,15 +34,22 @@ class IIncidentListener;
 class GAUDI_API IIncidentSvc : virtual public IInterface {
 public:
   /// InterfaceID
-  DeclareInterfaceID( IIncidentSvc, 2, 0 );
+  DeclareInterfaceID( IIncidentSvc, 3, 0 );
+
+  /// Integer identifier of an incident type, see incidentTypeHandle()
+  typedef std::uint32_t IncidentTypeHandle;
 
   /** Add listener
       @param lis Listener address
       @param type Incident type
       @param priority  Priority in handling incident
+      @param rethrow Rethrow the exceptions thrown by the listener (ignored for asynchronous listeners)
+      @param singleShot Remove the listener after the first incident
+      @param async Deliver the incidents in a background thread, in the order they are fired,
+                   instead of in the thread that fires them
   */
   virtual void addListener( IIncidentListener* lis, const std::string& type = "", long priority = 0,
-                            bool rethrow = false, bool singleShot = false ) = 0;
+                            bool rethrow = false, bool singleShot = false, bool async = false ) = 0;
   /** Remove listener
       @param lis Listener address
       @param type Incident type
@@ -56,12 +64,25 @@ public:
   */
   virtual void fireIncident( const Incident& incident ) = 0;
 
+  /** Get the handle of an incident type, to fire frequent incidents without looking up their type.
+      The handle is valid for the lifetime of the service.
+      @param type Incident type
+  */
+  virtual IncidentTypeHandle incidentTypeHandle( const std::string& type ) = 0;
+
+  /** Fire an Incident of the type identified by a handle
+      @param Incident being fired
+      @param type Handle of the type of the incident (not checked against incident.type())
+  */
+  virtual void fireIncident( const Incident& incident, IncidentTypeHandle type ) = 0;
+
   /** Listener properties */
   struct Listener final {
     IIncidentListener* iListener{ nullptr };
     long               priority{ 0 };
     bool               rethrow{ false };
     bool               singleShot{ false };
+    bool               async{ false };
   };
 
   /** List of incidents and their listeners */
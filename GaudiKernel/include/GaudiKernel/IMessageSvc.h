@@ -13,8 +13,10 @@
 
 // Include files
 #include "GaudiKernel/IInterface.h"
+#include <cstddef>
 #include <iostream>
 #include <string>
+#include <string_view>
 
 // Forward declarations
 class StatusCode;
@@ -167,4 +169,46 @@ public:
   virtual void incrInactiveCount( MSG::Level level, std::string_view src ) = 0;
 };
 
+class GAUDI_API IMessageLimiter : virtual public IInterface {
+public:
+  /// InterfaceID
+  DeclareInterfaceID( IMessageLimiter, 1, 0 );
+
+  /** Check if a message would be suppressed by the message limits of the service.
+   *  Used by MsgStream before the message is formatted: if the result is true, the
+   *  message is counted as reported and the caller must not report it.
+   */
+  virtual bool suppressMessage( MSG::Level level, std::string_view src ) = 0;
+};
+
+namespace Gaudi {
+  /** Text of a message formatted only when it is printed, possibly by another thread
+   *  (see Gaudi::reportDeferred in Gaudi/LazyFormat.h).
+   */
+  class GAUDI_API DeferredText {
+  public:
+    virtual ~DeferredText() = default;
+    /// Append the formatted text to the string.
+    virtual void formatTo( std::string& out ) const = 0;
+    /// Size of the object, i.e. of the storage needed by moveTo().
+    virtual std::size_t size() const = 0;
+    /// Alignment of the storage needed by moveTo().
+    virtual std::size_t alignment() const = 0;
+    /// Move the object to the given storage. The caller has to destroy the returned object.
+    virtual DeferredText* moveTo( void* storage ) = 0;
+  };
+} // namespace Gaudi
+
+class GAUDI_API IDeferredMessageSvc : virtual public IInterface {
+public:
+  /// InterfaceID
+  DeclareInterfaceID( IDeferredMessageSvc, 1, 0 );
+
+  /** Report a message whose text is formatted by the service when it is printed.
+   *  The output level and the limits have already been checked by the caller (MsgStream).
+   *  The service takes over the content of @c text with DeferredText::moveTo().
+   */
+  virtual void reportDeferred( std::string_view source, int type, Gaudi::DeferredText& text ) = 0;
+};
+
 #endif // GAUDIKERNEL_IMESSAGESVC_H
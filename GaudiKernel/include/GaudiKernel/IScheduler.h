@@ -19,6 +19,8 @@
 #include <chrono>
 #include <functional>
 #include <memory>
+#include <string_view>
+#include <thread>
 #include <vector>
 
 /**@class IScheduler IScheduler.h GaudiKernel/IScheduler.h
@@ -32,7 +34,7 @@
 class GAUDI_API IScheduler : virtual public IInterface {
 public:
   /// InterfaceID
-  DeclareInterfaceID( IScheduler, 1, 0 );
+  DeclareInterfaceID( IScheduler, 1, 1 );
 
   /// Make an event available to the scheduler
   virtual StatusCode pushNewEvent( EventContext* eventContext ) = 0;
@@ -64,5 +66,27 @@ public:
     std::vector<std::vector<int>>         states;
   };
   virtual void recordOccupancy( int samplePeriod, std::function<void( OccupancySnapshot )> callback ) = 0;
+
+  /// Execution of an algorithm in progress
+  struct RunningAlgorithm {
+    unsigned int                          index; ///< index of the algorithm in the scheduler
+    std::string_view                      name;  ///< name of the algorithm (owned by the scheduler)
+    EventContext::ContextID_t             slot;
+    EventContext::ContextID_t             subSlot;
+    EventContext::ContextEvt_t            evt;
+    std::chrono::steady_clock::time_point start;
+    std::thread::native_handle_type       thread; ///< thread executing the algorithm
+  };
+  /// Executions of algorithms currently in progress (empty if the scheduler does not track them)
+  virtual std::vector<RunningAlgorithm> runningAlgorithms() const { return {}; }
+  /// Start (true) or stop (false) tracking the executions for runningAlgorithms(), off by default
+  /// Each call with true must be balanced by a call with false, tracking stops with the last one.
+  virtual void trackRunningAlgorithms( bool /* track */ ) {}
+
+  /// Duration of the executions of the algorithms
+  /// The callback is called at the end of each execution, by the thread that executed the algorithm,
+  /// with the index of the algorithm (see RunningAlgorithm) and the duration; an empty function deactivates it
+  typedef std::function<void( unsigned int, std::chrono::steady_clock::duration )> ExecutionTimeCallback;
+  virtual void recordExecutionTimes( ExecutionTimeCallback /* callback */ ) {}
 };
 #endif
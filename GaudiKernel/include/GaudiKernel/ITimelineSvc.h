@@ -16,7 +16,9 @@
 #include <pthread.h>
 #include <string>
 
+#include <atomic>
 #include <chrono>
+#include <cstdint>
 
 class EventContext;
 
@@ -34,38 +36,79 @@ struct TimelineEvent final {
   time_point end;
 };
 
+/// Fixed size record of the execution of an algorithm, as stored by the timeline service.
+struct TimelineRecord final {
+  std::int64_t  start;     ///< nanoseconds since the epoch of TimelineEvent::Clock
+  std::int64_t  end;       ///< nanoseconds since the epoch of TimelineEvent::Clock
+  std::uint64_t thread;    ///< pthread id of the executing thread
+  std::uint64_t event;     ///< event number
+  std::uint32_t slot;      ///< event slot
+  std::uint32_t algorithm; ///< algorithm id, see ITimelineSvc::algorithmId()
+
+  static std::int64_t now() {
+    return std::chrono::duration_cast<std::chrono::nanoseconds>( TimelineEvent::Clock::now().time_since_epoch() )
+        .count();
+  }
+};
+
+/**
+ * Storage of a TimelineRecord being written by a thread and read by others.
+ *
+ * The state combines a sequence number, identifying the record currently in the slot,
+ * with the status of that record (low two bits).
+ */
+struct TimelineRecordSlot final {
+  enum Status : std::uint64_t { Writing = 0, Started = 1, Done = 2, StatusMask = 3 };
+
+  TimelineRecord             record{};
+  std::atomic<std::uint64_t> state{ Writing };
+};
+
 class GAUDI_API ITimelineSvc : virtual public IService {
 
 public:
   /// InterfaceID
-  DeclareInterfaceID( ITimelineSvc, 2, 0 );
+  DeclareInterfaceID( ITimelineSvc, 3, 0 );
 
   /// RAII helper to record timeline events
   class TimelineRecorder final {
   public:
-    using Clock = TimelineEvent::Clock;
-
     TimelineRecorder() = default;
-    TimelineRecorder( TimelineEvent& record, std::string alg, const EventContext& ctx );
+    /// Complete the (started) record in the slot when going out of scope
+    explicit TimelineRecorder( TimelineRecordSlot& slot ) : m_slot{ &slot } {}
 
     TimelineRecorder( const TimelineRecorder& ) = delete;
-    TimelineRecorder( TimelineRecorder&& other ) : m_record{ other.m_record } { other.m_record = nullptr; }
+    TimelineRecorder( TimelineRecorder&& other ) : m_slot{ other.m_slot } { other.m_slot = nullptr; }
 
     TimelineRecorder& operator=( TimelineRecorder&& other ) {
-      std::swap( m_record, other.m_record );
+      std::swap( m_slot, other.m_slot );
       return *this;
     }
 
     ~TimelineRecorder() {
-      if ( m_record ) m_record->end = Clock::now();
+      if ( m_slot ) {
+        m_slot->record.end = TimelineRecord::now();
+        m_slot->state.store( ( m_slot->state.load( std::memory_order_relaxed ) & ~TimelineRecordSlot::StatusMask ) |
+                                 TimelineRecordSlot::Done,
+                             std::memory_order_release );
+      }
     }
 
   private:
-    TimelineEvent* m_record = nullptr;
+    TimelineRecordSlot* m_slot = nullptr;
   };
 
-  virtual TimelineRecorder getRecorder( std::string alg, const EventContext& ctx ) = 0;
-  // Augment a partially pre-filled TimelineEvent object with matching info
+  /// Identifier of an algorithm in the timeline records, to be resolved once and passed to getRecorder()
+  virtual std::uint32_t algorithmId( const std::string& alg ) = 0;
+
+  virtual TimelineRecorder getRecorder( std::uint32_t alg, const EventContext& ctx ) = 0;
+  TimelineRecorder         getRecorder( const std::string& alg, const EventContext& ctx ) {
+    return getRecorder( algorithmId( alg ), ctx );
+  }
+
+  /// Augment a partially pre-filled TimelineEvent object (algorithm and event) with matching info.
+  /// Only the records still in memory are known: returns false if the record was dropped (full buffer)
+  /// or already replaced by newer ones. The end is left to the epoch if the execution is not completed.
   virtual bool getTimelineEvent( TimelineEvent& ) const = 0;
   virtual bool isEnabled() const                        = 0;
 };
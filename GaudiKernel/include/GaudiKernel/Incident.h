@@ -14,6 +14,7 @@
 // Include files
 #include "GaudiKernel/EventContext.h"
 #include "GaudiKernel/Kernel.h"
+#include <memory>
 #include <string>
 
 /** @class Incident Incident.h GaudiKernel/Incident.h
@@ -59,6 +60,13 @@ public:
    */
   EventContext context() const { return m_ctx; }
 
+  /** Copy of the incident, used for the asynchronous delivery to listeners
+   *
+   *  @return the copy, or nullptr for derived classes that do not override it
+   *          (they cannot be copied without slicing)
+   */
+  virtual std::unique_ptr<Incident> clone() const;
+
 private:
   std::string  m_source; ///< Incident source
   std::string  m_type;   ///< incident type
@@ -289,6 +289,11 @@ public:
   void reserve( size_type value ) { m_cont.reserve( value ); }
   /// Clear the entire content and erase the objects from the container
   void clear() { erase( begin(), end() ); }
+  /// Memory used by the container and the contained objects (not counting the key map and what the objects own)
+  std::size_t memoryFootprint() const override {
+    return sizeof( *this ) + m_sequential.capacity() * sizeof( contained_type* ) +
+           m_sequential.size() * sizeof( contained_type );
+  }
   /** Retrieve the full content of the object container by reference.
    *  Returned is the random access container if in sequntial direct
    *  access mode. Otherwise the sequential access container is returned
@@ -101,6 +101,8 @@ public:
   Link*       link( std::string_view path );
   /// Add link by object reference and path
   long addLink( const std::string& path, const DataObject* pObject );
+  /// Remove all links
+  void clearLinks();
 
   struct Sentinel {};
   Sentinel end() const { return {}; }
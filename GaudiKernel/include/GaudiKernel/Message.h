@@ -60,6 +60,16 @@ public:
   EventContext::ContextID_t  getEventSlot() const { return m_ecSlot; }
   EventContext::ContextEvt_t getEventNumber() const { return m_ecEvt; }
   EventIDBase                getEventID() const { return m_ecEvtId; }
+  pthread_t                  getThread() const { return m_ecThrd; }
+
+  /// Set the event identifiers and the thread of a message reported on behalf of another thread.
+  void setEventInfo( EventContext::ContextID_t slot, EventContext::ContextEvt_t evt, const EventIDBase& evtId,
+                     pthread_t thread ) {
+    m_ecSlot  = slot;
+    m_ecEvt   = evt;
+    m_ecEvtId = evtId;
+    m_ecThrd  = thread;
+  }
   //@}
 
   /// Get the format string.
@@ -59,6 +59,10 @@ protected:
   /// Pointer to service counting messages prepared but not printed because of
   /// wrong level.
   IInactiveMessageCounter* m_inactCounter = nullptr;
+  /// Pointer to service applying message limits, checked before the message is formatted.
+  IMessageLimiter* m_limiter = nullptr;
+  /// Pointer to service able to format the messages itself, if any.
+  IDeferredMessageSvc* m_deferred = nullptr;
   /// Flag to state if the inactive messages has to be counted.
   static bool m_countInactive;
 
@@ -74,18 +78,26 @@ public:
       , m_level( msg.m_level )
       , m_currLevel( msg.m_currLevel )
       , m_useColors( msg.m_useColors )
-      , m_inactCounter( msg.m_inactCounter ) {
+      , m_inactCounter( msg.m_inactCounter )
+      , m_limiter( msg.m_limiter )
+      , m_deferred( msg.m_deferred ) {
     try { // ignore exception if we cannot copy the string
       m_source = msg.m_source;
     } catch ( ... ) {}
   }
   /// Standard destructor
   GAUDI_API virtual ~MsgStream() = default;
-  /// Initialize report of new message: activate if print level is sufficient.
+  /// Initialize report of new message: activate if print level is sufficient
+  /// and the message is not suppressed by the limits of the message service.
   MsgStream& report( int lvl ) {
     lvl = ( lvl >= MSG::NUM_LEVELS ) ? MSG::ALWAYS : ( lvl < MSG::NIL ) ? MSG::NIL : lvl;
     if ( ( m_currLevel = MSG::Level( lvl ) ) >= level() ) {
-      activate();
+      // a suppressed message is counted by the service and never formatted
+      if ( m_limiter && m_limiter->suppressMessage( m_currLevel, m_source ) ) {
+        deactivate();
+      } else {
+        activate();
+      }
     } else {
       deactivate();
 #ifndef NDEBUG
@@ -98,12 +110,19 @@ public:
   }
   /// Output method
   virtual GAUDI_API MsgStream& doOutput();
+  /// Output method for a message made of the text streamed so far followed by @c text.
+  /// If nothing was streamed, the formatting of @c text is left to the message service when possible.
+  GAUDI_API MsgStream& doOutput( Gaudi::DeferredText& text );
   /// Access string buffer
   const std::string& buffer() const { return m_buffer; }
   /// Access string MsgStream
   std::ostringstream& stream() { return m_stream; }
   /// Update @c IMessageSvc pointer
-  void setMsgSvc( IMessageSvc* svc ) { m_service = svc; }
+  void setMsgSvc( IMessageSvc* svc ) {
+    m_service = svc;
+    m_limiter  = svc ? Gaudi::Cast<IMessageLimiter>( svc ) : nullptr;
+    m_deferred = svc ? Gaudi::Cast<IDeferredMessageSvc>( svc ) : nullptr;
+  }
   /// Update outputlevel
   void setLevel( int level ) {
     level   = ( level >= MSG::NUM_LEVELS ) ? MSG::ALWAYS : ( level < MSG::NIL ) ? MSG::NIL : level;
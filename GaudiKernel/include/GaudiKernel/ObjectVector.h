@@ -133,6 +133,11 @@ public:
   /// It is always greater than or equal to size()
   typename ObjectVector<TYPE>::size_type capacity() const { return m_vector.capacity(); }
 
+  /// Memory used by the container and the contained objects (not counting what the objects own)
+  std::size_t memoryFootprint() const override {
+    return sizeof( *this ) + m_vector.capacity() * sizeof( TYPE* ) + m_vector.size() * sizeof( TYPE );
+  }
+
   /** Reserve place for "value" objects in the container.
       If "value" is less than or equal to capacity(), this call has no effect,
       otherwise, it is a request for allocation of additional memory.
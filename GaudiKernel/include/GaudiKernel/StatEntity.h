@@ -23,6 +23,7 @@ class StatEntity : public Gaudi::Accumulators::PrintableCounter,
                                                               Gaudi::Accumulators::BinomialAccumulator> {
 public:
   inline static const std::string typeString{ "statentity" };
+  static constexpr bool           concurrentReads = true;
   using AccParent         = Gaudi::Accumulators::AccumulatorSet<double, Gaudi::Accumulators::atomicity::full, double,
                                                         Gaudi::Accumulators::StatAccumulator,
                                                         Gaudi::Accumulators::BinomialAccumulator>;
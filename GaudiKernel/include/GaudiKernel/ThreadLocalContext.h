@@ -16,6 +16,7 @@
 #include "GaudiKernel/Kernel.h"
 
 class EventContext;
+class IAlgorithm;
 
 namespace Gaudi {
   namespace Hive {
@@ -36,6 +37,15 @@ namespace Gaudi {
     GAUDI_API void setCurrentContextId( const EventContext* ctx );
     GAUDI_API void setCurrentContext( const EventContext* ctx );
     GAUDI_API void setCurrentContext( const EventContext& ctx );
+
+    /// Return the algorithm being executed by the current thread.
+    /// The returned pointer is valid only within the sysExecute method of
+    /// algorithms (nullptr otherwise).
+    GAUDI_API IAlgorithm* currentAlgorithm();
+
+    /// Used by the framework to change the algorithm being executed by the
+    /// current thread, returning the previous one.
+    GAUDI_API IAlgorithm* setCurrentAlgorithm( IAlgorithm* alg );
   } // namespace Hive
 } // namespace Gaudi
 
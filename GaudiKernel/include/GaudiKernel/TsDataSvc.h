@@ -19,10 +19,38 @@
 #include "GaudiKernel/Service.h"
 
 // System libraries
+#include <atomic>
 #include <mutex>
+#include <shared_mutex>
+#include <thread>
+
+namespace Gaudi::Details {
+  /** Reader/writer mutex protecting the TsDataSvc store.
+   *
+   *  The exclusive lock is re-entrant for the owning thread (the store calls itself
+   *  while loading objects or handling data faults) and a shared lock requested by
+   *  that thread is granted immediately. Shared locks are re-entrant as well.
+   *  The shared lock cannot be upgraded: requesting the exclusive lock while holding
+   *  a shared one throws a GaudiException, so shared sections must not call code that
+   *  may modify the store.
+   */
+  class GAUDI_API TsDataSvcMutex {
+  public:
+    void lock();
+    void unlock();
+    void lock_shared();
+    void unlock_shared();
+
+  private:
+    std::shared_mutex            m_mutex;
+    std::atomic<std::thread::id> m_owner{};
+    /// exclusive re-entrance depth (only accessed by the owner)
+    std::size_t m_depth = 0;
+  };
+} // namespace Gaudi::Details
 
 namespace {
-  typedef std::recursive_mutex tsDataSvcMutex;
+  typedef Gaudi::Details::TsDataSvcMutex tsDataSvcMutex;
 } // namespace
 
 // Forward declarations
@@ -54,8 +82,12 @@ namespace DataSvcHelpers {
  * This solution cannot solve the problem of having different conditions set
  * available simultaneously but it is the simplest solution to allow multiple
  * algorithms running concurrently to access detector components.
- * In first approximation, since for the data we have the whiteboard, we protect
- * only the retrieval of objects.
+ * Lookups (retrieveObject, findObject, objectParent, objectLeaves) take a shared
+ * lock, while modifications of the store (registration, loading of objects, links)
+ * and traversals, whose agents may load objects, take an exclusive one.
+ * retrieveObject first tries to resolve already loaded objects under the shared
+ * lock and falls back to the exclusive path only if something has to be loaded
+ * or created on demand.
  *
  * @author Markus Frank
  * @author Sebastien Ponce
@@ -300,6 +332,12 @@ protected:
    */
   DataObject* handleDataFault( IRegistry* pReg, std::string_view path = {} );
 
+  /** Look for an already loaded object without side effects (no loading, no data
+   *  fault handling). Must be called with at least a shared lock held.
+   * @return the object or nullptr if the slow path is required
+   */
+  DataObject* i_findLoaded( DataSvcHelpers::RegistryEntry* pNode, std::string_view path );
+
   /// Mutex to protect access to the store
   tsDataSvcMutex m_accessMutex;
 };
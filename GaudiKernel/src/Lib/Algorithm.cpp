@@ -8,7 +8,12 @@
 * granted to it by virtue of its status as an Intergovernmental Organization        *
 * or submit itself to any jurisdiction.                                             *
 \***********************************************************************************/
+#include <Gaudi/Accumulators.h>
 #include <Gaudi/Algorithm.h>
+#include <Gaudi/Chrono/Counters.h> // arithmetic of std::chrono::duration for the counters
+#ifdef __x86_64__
+#  include <Gaudi/Timers/RdtscClock.h>
+#endif // __x86_64__
 
 #include <algorithm>
 #include <numeric>
@@ -39,6 +44,7 @@
 #include "GaudiKernel/ServiceLocatorHelper.h"
 #include "GaudiKernel/Stat.h"
 #include "GaudiKernel/StringKey.h"
+#include "GaudiKernel/ThreadLocalContext.h"
 #include "GaudiKernel/ToolHandle.h"
 
 namespace Gaudi {
@@ -52,8 +58,66 @@ namespace Gaudi {
       }
       return audit.value();
     }
+
+    /// Helper to record the algorithm being executed by the current thread
+    /// (restoring the previous one, e.g. for algorithms executed by sequencers).
+    class CurrentAlgorithmGuard {
+    public:
+      CurrentAlgorithmGuard( IAlgorithm* alg ) : m_previous{ Gaudi::Hive::setCurrentAlgorithm( alg ) } {}
+      ~CurrentAlgorithmGuard() { Gaudi::Hive::setCurrentAlgorithm( m_previous ); }
+      CurrentAlgorithmGuard( const CurrentAlgorithmGuard& ) = delete;
+      CurrentAlgorithmGuard& operator=( const CurrentAlgorithmGuard& ) = delete;
+
+    private:
+      IAlgorithm* m_previous;
+    };
   } // namespace Details
 
+  /**
+   * Statistics of the time spent in execute(), published as the "ExecuteTime" counter.
+   *
+   * Measurements use the RDTSC clock (where available) and go to a sharded counter, i.e.
+   * to cells private to the executing thread, so that timing costs a few ns per call and
+   * concurrent executions of a reentrant algorithm never contend.
+   */
+  struct Algorithm::ExecTimer {
+#ifdef __x86_64__
+    using Clock = Gaudi::Timers::RdtscClock<std::chrono::microseconds>;
+#else
+    using Clock = std::chrono::high_resolution_clock;
+#endif // __x86_64__
+
+    /// Times its scope, if a timer is given.
+    class Scope {
+    public:
+      Scope( ExecTimer* timer ) : m_timer{ timer } {
+        if ( m_timer ) m_t0 = Clock::now();
+      }
+      ~Scope() {
+        if ( m_timer ) m_timer->m_stats += std::chrono::duration_cast<std::chrono::microseconds>( Clock::now() - m_t0 );
+      }
+      Scope( const Scope& ) = delete;
+      Scope& operator=( const Scope& ) = delete;
+
+    private:
+      ExecTimer*        m_timer;
+      Clock::time_point m_t0;
+    };
+
+    ExecTimer( Algorithm* owner ) : m_stats{ owner, "ExecuteTime" } {
+#ifdef __x86_64__
+      // calibrate now rather than during the first event
+      Clock::calibrate();
+#endif // __x86_64__
+    }
+
+    Gaudi::Accumulators::SigmaCounter<std::chrono::microseconds, Gaudi::Accumulators::atomicity::sharded> m_stats;
+  };
+
+  Algorithm::~Algorithm() = default;
+
+  void Algorithm::ExecTimerDeleter::operator()( ExecTimer* timer ) const { delete timer; }
+
   // IAlgorithm implementation
   StatusCode Algorithm::sysInitialize() {
 
@@ -86,6 +150,10 @@ namespace Gaudi {
 
     // check whether timeline should be done
     m_doTimeline = timelineSvc()->isEnabled();
+    if ( m_doTimeline ) m_timelineId = timelineSvc()->algorithmId( name() );
+
+    // set up the timing of execute(), if requested
+    if ( m_timeExecute && !m_execTimer ) m_execTimer.reset( new ExecTimer( this ) );
 
     StatusCode sc;
     // Invoke initialize() method of the derived class inside a try/catch clause
@@ -121,6 +189,7 @@ namespace Gaudi {
     }
 
     algExecStateSvc()->addAlg( this );
+    m_execStateIndex = algExecStateSvc()->algIndex( nameKey() );
 
     //
     //// build list of data dependencies
@@ -354,6 +423,7 @@ namespace Gaudi {
 
     // lock the context service
     Gaudi::Utils::AlgContext cnt( this, registerContext() ? contextSvc().get() : nullptr, ctx );
+    Details::CurrentAlgorithmGuard currentAlg( this );
 
     Gaudi::Guards::AuditorGuard guard( this,
                                        // check if we want to audit the initialize
@@ -361,7 +431,8 @@ namespace Gaudi {
 
     try {
       ITimelineSvc::TimelineRecorder timelineRecoder;
-      if ( m_doTimeline ) { timelineRecoder = timelineSvc()->getRecorder( name(), ctx ); }
+      if ( m_doTimeline ) { timelineRecoder = timelineSvc()->getRecorder( m_timelineId, ctx ); }
+      ExecTimer::Scope timeit{ m_execTimer.get() };
 
       status = execute( ctx );
 
@@ -552,6 +623,9 @@ namespace Gaudi {
   bool Algorithm::isEnabled() const { return m_isEnabled; }
 
   AlgExecState& Algorithm::execState( const EventContext& ctx ) const {
+    if ( m_execStateIndex != std::numeric_limits<std::size_t>::max() ) {
+      return algExecStateSvc()->algExecState( m_execStateIndex, ctx );
+    }
     return algExecStateSvc()->algExecState( const_cast<IAlgorithm*>( (const IAlgorithm*)this ), ctx );
   }
 
@@ -27,6 +27,7 @@ DataObjectHandleBase::DataObjectHandleBase( DataObjectHandleBase&& other )
     : Gaudi::DataHandle( other )
     , m_EDS( std::move( other.m_EDS ) )
     , m_MS( std::move( other.m_MS ) )
+    , m_recycler( std::move( other.m_recycler ) )
     , m_init( other.m_init )
     , m_optional( other.m_optional )
     , m_searchDone( other.m_searchDone.load() ) {
@@ -41,6 +42,7 @@ DataObjectHandleBase& DataObjectHandleBase::operator=( const DataObjectHandleBas
   Gaudi::DataHandle::operator=( other );
   m_EDS                      = other.m_EDS;
   m_MS                       = other.m_MS;
+  m_recycler                 = other.m_recycler;
   m_init                     = other.m_init;
   m_optional                 = other.m_optional;
   m_searchDone               = other.m_searchDone.load();
@@ -126,6 +128,7 @@ bool DataObjectHandleBase::init() {
       throw GaudiException( "owner is neither AlgTool nor Gaudi::Algorithm", "Invalid Cast", StatusCode::FAILURE );
     }
   }
+  if ( m_EDS ) m_recycler = m_EDS.as<Gaudi::Interfaces::IDataObjectRecycler>();
   m_init = true;
   return true;
 }
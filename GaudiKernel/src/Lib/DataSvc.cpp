@@ -439,6 +439,10 @@ DataObject* DataSvc::i_handleDataFault( IRegistry* pReg, std::string_view path )
   if ( m_enableFaultHdlr ) {
     IRegistry* pLeaf = nullptr;
     if ( pReg && path.empty() ) {
+      if ( m_faultHandler ) {
+        m_faultHandler->handleDataFault( pReg->identifier() );
+        if ( pReg->object() ) return pReg->object();
+      }
       DataIncident incident( name(), m_faultName, pReg->identifier() );
       m_incidentSvc->fireIncident( incident );
       return pReg->object();
@@ -447,22 +451,34 @@ DataObject* DataSvc::i_handleDataFault( IRegistry* pReg, std::string_view path )
       std::string p = pReg->identifier();
       if ( path.front() != SEPARATOR ) p += SEPARATOR;
       p.append( path.data(), path.size() );
-      DataIncident incident( name(), m_faultName, p );
-      m_incidentSvc->fireIncident( incident );
-      pLeaf = m_root->findLeaf( p );
+      pLeaf = i_dispatchDataFault( p );
     } else {
       std::string p = m_root->identifier();
       if ( path.front() != SEPARATOR ) p += SEPARATOR;
       p.append( path.data(), path.size() );
-      DataIncident incident( name(), m_faultName, p );
-      m_incidentSvc->fireIncident( incident );
-      pLeaf = m_root->findLeaf( p );
+      pLeaf = i_dispatchDataFault( p );
     }
     if ( pLeaf ) { return pLeaf->object(); }
   }
   return nullptr;
 }
 
+IRegistry* DataSvc::i_dispatchDataFault( const std::string& path ) {
+  if ( m_faultHandler ) {
+    // direct call, no need to go through the incident service if the handler did the job
+    m_faultHandler->handleDataFault( path );
+    if ( auto pLeaf = m_root->findLeaf( path ); pLeaf && pLeaf->object() ) return pLeaf;
+  }
+  DataIncident incident( name(), m_faultName, path );
+  m_incidentSvc->fireIncident( incident );
+  return m_root->findLeaf( path );
+}
+
+StatusCode DataSvc::setDataFaultHandler( Gaudi::Interfaces::IDataFaultHandler* handler ) {
+  m_faultHandler = handler;
+  return StatusCode::SUCCESS;
+}
+
 /** Invoke Persistency service to create transient object from its
  *  persistent representation
  */
@@ -857,6 +873,7 @@ StatusCode DataSvc::finalize() {
   resetPreLoad().ignore();
   clearStore().ignore();
   m_incidentSvc.reset();
+  m_faultHandler = nullptr;
   return Service::finalize();
 }
 
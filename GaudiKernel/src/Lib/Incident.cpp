@@ -11,7 +11,12 @@
 #define _inc_types_impl_
 #include "GaudiKernel/Incident.h"
 #include "GaudiKernel/ThreadLocalContext.h"
+#include <typeinfo>
 
 Incident::Incident( const std::string& source, const std::string& type ) : m_source( source ), m_type( type ) {
   m_ctx = Gaudi::Hive::currentContext();
 }
+
+std::unique_ptr<Incident> Incident::clone() const {
+  return typeid( *this ) == typeid( Incident ) ? std::make_unique<Incident>( *this ) : nullptr;
+}
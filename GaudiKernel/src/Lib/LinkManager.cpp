@@ -30,6 +30,12 @@ LinkManager::~LinkManager() {
   for ( auto& i : m_linkVector ) delete i;
 }
 
+/// Remove all links
+void LinkManager::clearLinks() {
+  for ( auto& i : m_linkVector ) delete i;
+  m_linkVector.clear();
+}
+
 /// Access to the object's address from the link
 IOpaqueAddress* LinkManager::Link::address() {
   if ( m_pObject ) {
@@ -50,6 +50,8 @@ MsgStream::MsgStream( IMessageSvc* svc, int ) : m_service( svc ) {
   setLevel( svc ? svc->outputLevel() : MSG::INFO );
   m_currLevel = m_level;
   m_useColors = ( svc ? svc->useColor() : false );
+  m_limiter   = svc ? Gaudi::Cast<IMessageLimiter>( svc ) : nullptr;
+  m_deferred  = svc ? Gaudi::Cast<IDeferredMessageSvc>( svc ) : nullptr;
 #ifndef NDEBUG
   m_inactCounter = svc ? Gaudi::Cast<IInactiveMessageCounter>( svc ) : 0;
 #endif
@@ -59,6 +61,8 @@ MsgStream::MsgStream( IMessageSvc* svc, std::string source, int ) : m_service( s
   setLevel( svc ? svc->outputLevel( m_source ) : MSG::INFO );
   m_currLevel = m_level;
   m_useColors = ( svc && svc->useColor() );
+  m_limiter   = svc ? Gaudi::Cast<IMessageLimiter>( svc ) : nullptr;
+  m_deferred  = svc ? Gaudi::Cast<IDeferredMessageSvc>( svc ) : nullptr;
 #ifndef NDEBUG
   m_inactCounter = svc ? Gaudi::Cast<IInactiveMessageCounter>( svc ) : 0;
 #endif
@@ -81,6 +85,21 @@ MsgStream& MsgStream::doOutput() {
   return *this;
 }
 
+MsgStream& MsgStream::doOutput( Gaudi::DeferredText& text ) {
+  try {
+    if ( isActive() && m_deferred && m_stream.tellp() == 0 ) {
+      m_deferred->reportDeferred( m_source, m_currLevel, text );
+      return *this;
+    }
+    if ( isActive() ) {
+      std::string str;
+      text.formatTo( str );
+      m_stream << str;
+    }
+  } catch ( ... ) {}
+  return doOutput();
+}
+
 void MsgStream::setColor( MSG::Color col ) {
 #ifndef _WIN32
   if ( m_useColors ) {
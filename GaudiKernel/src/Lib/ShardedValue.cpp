@@ -0,0 +1,124 @@
+/***********************************************************************************\
+* (c) Copyright 2022 CERN for the benefit of the LHCb and ATLAS collaborations      *
+*                                                                                   *
+* This software is distributed under the terms of the Apache version 2 licence,     *
+* copied verbatim in the file "LICENSE".                                            *
+*                                                                                   *
+* In applying this licence, CERN does not waive the privileges and immunities       *
+* granted to it by virtue of its status as an Intergovernmental Organization        *
+* or submit itself to any jurisdiction.                                             *
+\***********************************************************************************/
+#include <Gaudi/Accumulators/ShardedValue.h>
+
+#include <memory>
+#include <mutex>
+#include <vector>
+
+using Gaudi::Accumulators::details::ShardRegistry;
+
+namespace {
+  constexpr std::uint32_t ChunkBits = 9;
+  constexpr std::uint32_t ChunkSize = 1u << ChunkBits; // 4 KiB of cells
+  constexpr std::uint32_t ChunkMask = ChunkSize - 1;
+
+  struct alignas( 64 ) Chunk {
+    ShardRegistry::Cell cells[ChunkSize];
+  };
+
+  /// Cells of one thread. Only the owning thread adds chunks, always holding the registry lock.
+  struct Table {
+    std::vector<std::unique_ptr<Chunk>> chunks;
+  };
+
+  struct Registry {
+    std::mutex                          mutex;
+    std::vector<std::unique_ptr<Table>> tables;     // all tables ever created
+    std::vector<Table*>                 freeTables; // tables of threads that exited
+    std::vector<std::uint64_t>          neutral;    // neutral value of each slot
+    std::vector<std::uint32_t>          freeSlots;
+
+    Table* acquireTable() {
+      std::scoped_lock lock{ mutex };
+      if ( !freeTables.empty() ) {
+        auto t = freeTables.back();
+        freeTables.pop_back();
+        return t;
+      }
+      return tables.emplace_back( std::make_unique<Table>() ).get();
+    }
+    void releaseTable( Table* t ) {
+      std::scoped_lock lock{ mutex };
+      freeTables.push_back( t );
+    }
+    Chunk& addChunk( Table& t, std::uint32_t idx ) {
+      std::scoped_lock lock{ mutex };
+      if ( t.chunks.size() <= idx ) t.chunks.resize( idx + 1 );
+      auto chunk = std::make_unique<Chunk>();
+      // slots not yet acquired get their value when they are
+      const std::uint32_t first = idx << ChunkBits;
+      for ( std::uint32_t i = 0; i < ChunkSize && first + i < neutral.size(); ++i ) {
+        chunk->cells[i].store( neutral[first + i], std::memory_order_relaxed );
+      }
+      return *( t.chunks[idx] = std::move( chunk ) );
+    }
+  };
+
+  /// Never destroyed, so that counters living in static objects and thread exits
+  /// do not depend on the destruction order.
+  Registry& registry() {
+    static auto r = new Registry;
+    return *r;
+  }
+
+  /// Gives the table of the current thread back to the registry when the thread exits.
+  struct LocalTable {
+    Table* table = registry().acquireTable();
+    ~LocalTable() { registry().releaseTable( table ); }
+  };
+  thread_local LocalTable s_local;
+} // namespace
+
+std::uint32_t ShardRegistry::acquire( std::uint64_t neutral ) {
+  auto&            r = registry();
+  std::scoped_lock lock{ r.mutex };
+  std::uint32_t    slot;
+  if ( !r.freeSlots.empty() ) {
+    slot = r.freeSlots.back();
+    r.freeSlots.pop_back();
+  } else {
+    slot = r.neutral.size();
+    r.neutral.push_back( neutral );
+  }
+  r.neutral[slot] = neutral;
+  const auto idx  = slot >> ChunkBits;
+  for ( auto& t : r.tables ) {
+    if ( idx < t->chunks.size() && t->chunks[idx] ) {
+      t->chunks[idx]->cells[slot & ChunkMask].store( neutral, std::memory_order_relaxed );
+    }
+  }
+  return slot;
+}
+
+void ShardRegistry::release( std::uint32_t slot ) {
+  auto&            r = registry();
+  std::scoped_lock lock{ r.mutex };
+  r.freeSlots.push_back( slot );
+}
+
+ShardRegistry::Cell& ShardRegistry::localCell( std::uint32_t slot ) {
+  auto&      t   = *s_local.table;
+  const auto idx = slot >> ChunkBits;
+  // only this thread modifies its table, so it can be read without locking
+  Chunk* chunk = idx < t.chunks.size() ? t.chunks[idx].get() : nullptr;
+  if ( !chunk ) chunk = &registry().addChunk( t, idx );
+  return chunk->cells[slot & ChunkMask];
+}
+
+void ShardRegistry::visit( std::uint32_t slot, void ( *f )( Cell&, void* ), void* ctx ) {
+  auto&            r = registry();
+  std::scoped_lock lock{ r.mutex };
+  const auto       idx = slot >> ChunkBits;
+  for ( auto& t : r.tables ) {
+    if ( idx < t->chunks.size() && t->chunks[idx] ) f( t->chunks[idx]->cells[slot & ChunkMask], ctx );
+  }
+}
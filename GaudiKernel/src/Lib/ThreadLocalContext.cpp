@@ -14,6 +14,8 @@
 #include "Rtypes.h"
 #include "ThreadLocalStorage.h"
 
+#include <utility>
+
 namespace {
   // MacOS X's clang doesn't provide thread_local. So we need to use ROOT's
   // thread-local implementation to operate on this platform.
@@ -21,6 +23,8 @@ namespace {
     TTHREAD_TLS_DECL( EventContext, localContext );
     return localContext;
   }
+
+  TTHREAD_TLS( IAlgorithm* ) s_curAlg = nullptr;
 } // namespace
 
 namespace Gaudi {
@@ -41,5 +45,9 @@ namespace Gaudi {
     void setCurrentContext( const EventContext* ctx ) { s_curCtx() = *ctx; }
 
     void setCurrentContext( const EventContext& ctx ) { s_curCtx() = ctx; }
+
+    IAlgorithm* currentAlgorithm() { return s_curAlg; }
+
+    IAlgorithm* setCurrentAlgorithm( IAlgorithm* alg ) { return std::exchange( s_curAlg, alg ); }
   } // namespace Hive
 } // namespace Gaudi
@@ -47,13 +47,36 @@
 #include <cassert>
 #include <cstdlib>
 #include <mutex>
+#include <shared_mutex>
 #include <sstream>
 #include <vector>
 
-// Macro to lock a scope
+// Macros to lock a scope
 #define STD_LOCK_GUARD_MACRO std::scoped_lock lock{ m_accessMutex };
+#define STD_SHARED_LOCK_MACRO std::shared_lock lock{ m_accessMutex };
 
 namespace {
+  /// Shared lock depth held by the current thread on each TsDataSvcMutex instance.
+  thread_local std::vector<std::pair<const void*, std::size_t>> s_sharedDepths;
+
+  std::size_t& sharedDepth( const void* mutex ) {
+    auto i = std::find_if( begin( s_sharedDepths ), end( s_sharedDepths ),
+                           [mutex]( const auto& e ) { return e.first == mutex; } );
+    return ( i != end( s_sharedDepths ) ? *i : s_sharedDepths.emplace_back( mutex, 0 ) ).second;
+  }
+
+  std::size_t currentSharedDepth( const void* mutex ) {
+    auto i = std::find_if( begin( s_sharedDepths ), end( s_sharedDepths ),
+                           [mutex]( const auto& e ) { return e.first == mutex; } );
+    return i != end( s_sharedDepths ) ? i->second : 0;
+  }
+
+  void dropSharedDepth( const void* mutex ) {
+    s_sharedDepths.erase( std::remove_if( begin( s_sharedDepths ), end( s_sharedDepths ),
+                                          [mutex]( const auto& e ) { return e.first == mutex; } ),
+                          end( s_sharedDepths ) );
+  }
+
   std::string operator+( char c, std::string_view sr ) {
     std::string s{ c };
     s.append( sr.data(), sr.size() );
@@ -82,10 +105,54 @@ typedef DataSvcHelpers::RegistryEntry RegEntry;
 #define DEBMSG ON_DEBUG debug()
 #define VERMSG ON_VERBOSE verbose()
 
+void Gaudi::Details::TsDataSvcMutex::lock() {
+  const auto self = std::this_thread::get_id();
+  if ( m_owner.load( std::memory_order_relaxed ) == self ) {
+    ++m_depth;
+    return;
+  }
+  // a shared lock cannot be upgraded in place, and releasing it would let other writers
+  // invalidate the entries the caller is still using
+  if ( currentSharedDepth( this ) ) {
+    throw GaudiException( "exclusive lock requested while holding a shared one", "TsDataSvcMutex",
+                          StatusCode::FAILURE );
+  }
+  m_mutex.lock();
+  m_owner.store( self, std::memory_order_relaxed );
+  m_depth = 1;
+}
+
+void Gaudi::Details::TsDataSvcMutex::unlock() {
+  assert( m_owner.load( std::memory_order_relaxed ) == std::this_thread::get_id() );
+  if ( --m_depth ) return;
+  m_owner.store( std::thread::id{}, std::memory_order_relaxed );
+  m_mutex.unlock();
+}
+
+void Gaudi::Details::TsDataSvcMutex::lock_shared() {
+  if ( m_owner.load( std::memory_order_relaxed ) == std::this_thread::get_id() ) {
+    ++m_depth;
+    return;
+  }
+  if ( sharedDepth( this )++ == 0 ) m_mutex.lock_shared();
+}
+
+void Gaudi::Details::TsDataSvcMutex::unlock_shared() {
+  if ( m_owner.load( std::memory_order_relaxed ) == std::this_thread::get_id() ) {
+    unlock();
+    return;
+  }
+  if ( --sharedDepth( this ) == 0 ) {
+    dropSharedDepth( this );
+    m_mutex.unlock_shared();
+  }
+}
+
 /** IDataManagerSvc: Remove all data objects below the sub tree
  *  identified by its full path name.
  */
 StatusCode TsDataSvc::clearSubTree( std::string_view sub_tree_path ) {
+  STD_LOCK_GUARD_MACRO
   DataObject* pObject = nullptr;
   StatusCode  status  = findObject( sub_tree_path, pObject );
   if ( !status.isSuccess() ) return status;
@@ -101,6 +168,7 @@ StatusCode TsDataSvc::clearSubTree( std::string_view sub_tree_path ) {
  *  identified by the object.
  */
 StatusCode TsDataSvc::clearSubTree( DataObject* pObject ) {
+  STD_LOCK_GUARD_MACRO
   if ( !checkRoot() ) return Status::INVALID_ROOT;
   RegEntry* entry = CAST_REGENTRY( RegEntry*, pObject->registry() );
   if ( !entry ) return Status::INVALID_OBJECT;
@@ -112,6 +180,7 @@ StatusCode TsDataSvc::clearSubTree( DataObject* pObject ) {
 
 /// IDataManagerSvc: Remove all data objects in the data store.
 StatusCode TsDataSvc::clearStore() {
+  STD_LOCK_GUARD_MACRO
   if ( !checkRoot() ) return Status::INVALID_ROOT;
   m_root.reset();
   return StatusCode::SUCCESS;
@@ -128,6 +197,7 @@ StatusCode TsDataSvc::traverseSubTree( std::string_view sub_tree_path, IDataStor
 
 /// IDataManagerSvc: Analyse by traversing all data objects below the sub tree
 StatusCode TsDataSvc::traverseSubTree( DataObject* pObject, IDataStoreAgent* pAgent ) {
+  // the agent may load objects or modify the store
   STD_LOCK_GUARD_MACRO
   if ( !checkRoot() ) return Status::INVALID_ROOT;
   RegEntry* entry = CAST_REGENTRY( RegEntry*, pObject->registry() );
@@ -137,6 +207,7 @@ StatusCode TsDataSvc::traverseSubTree( DataObject* pObject, IDataStoreAgent* pAg
 
 /// IDataManagerSvc: Analyse by traversing all data objects in the data store.
 StatusCode TsDataSvc::traverseTree( IDataStoreAgent* pAgent ) {
+  // the agent may load objects or modify the store
   STD_LOCK_GUARD_MACRO
   if ( !checkRoot() ) return Status::INVALID_ROOT;
   return m_root->traverseTree( pAgent );
@@ -158,6 +229,7 @@ StatusCode TsDataSvc::setRoot( std::string root_path, DataObject* pRootObj ) {
  */
 StatusCode TsDataSvc::i_setRoot( std::string root_path, DataObject* pRootObj ) {
   if ( pRootObj ) {
+    STD_LOCK_GUARD_MACRO
     m_root = std::make_unique<RegEntry>( std::move( root_path ) );
     m_root->makeHard( pRootObj );
     m_root->setDataSvc( this );
@@ -182,6 +254,7 @@ StatusCode TsDataSvc::setRoot( std::string root_path, IOpaqueAddress* pRootAddr
  */
 StatusCode TsDataSvc::i_setRoot( std::string root_path, IOpaqueAddress* pRootAddr ) {
   if ( pRootAddr ) {
+    STD_LOCK_GUARD_MACRO
     m_root = std::make_unique<RegEntry>( std::move( root_path ) );
     m_root->makeHard( pRootAddr );
     m_root->setDataSvc( this );
@@ -206,7 +279,7 @@ StatusCode TsDataSvc::objectParent( const DataObject* pObject, IRegistry*& refpP
 }
 /// IDataManagerSvc: Explore the object store: retrieve the object's parent
 StatusCode TsDataSvc::objectParent( const IRegistry* pRegistry, IRegistry*& refpParent ) {
-  STD_LOCK_GUARD_MACRO
+  STD_SHARED_LOCK_MACRO
   if ( !checkRoot() ) return Status::INVALID_ROOT;
   const RegEntry* node_entry = CAST_REGENTRY( const RegEntry*, pRegistry );
   if ( !node_entry ) return Status::INVALID_OBJECT;
@@ -227,7 +300,7 @@ StatusCode TsDataSvc::objectLeaves( const IRegistry* pRegistry, std::vector<IReg
   if ( !pRegistry ) return Status::INVALID_OBJECT;
   const RegEntry* node_entry = CAST_REGENTRY( const RegEntry*, pRegistry );
   if ( !node_entry ) return Status::INVALID_OBJECT;
-  STD_LOCK_GUARD_MACRO
+  STD_SHARED_LOCK_MACRO
   leaves.insert( leaves.end(), node_entry->leaves().begin(), node_entry->leaves().end() );
   // leaves = node_entry->leaves();
   return StatusCode::SUCCESS;
@@ -241,6 +314,7 @@ StatusCode TsDataSvc::registerAddress( std::string_view fullPath, IOpaqueAddress
 
 ///  IDataManagerSvc: Register object address with the data store.
 StatusCode TsDataSvc::registerAddress( IRegistry* parentObj, std::string_view objPath, IOpaqueAddress* pAddress ) {
+  STD_LOCK_GUARD_MACRO
   if ( !checkRoot() ) return Status::INVALID_ROOT;
   if ( objPath.empty() ) return Status::INVALID_OBJ_PATH;
   if ( !parentObj ) {
@@ -282,6 +356,7 @@ StatusCode TsDataSvc::unregisterAddress( std::string_view fullPath ) {
 
 ///  IDataManagerSvc: Unregister object address from the data store.
 StatusCode TsDataSvc::unregisterAddress( IRegistry* pParent, std::string_view objPath ) {
+  STD_LOCK_GUARD_MACRO
   if ( !checkRoot() ) return Status::INVALID_ROOT;
 
   if ( objPath.empty() ) return Status::INVALID_OBJ_PATH;
@@ -311,6 +386,7 @@ StatusCode TsDataSvc::unregisterAddress( IRegistry* pParent, std::string_view ob
 
 /// Register object with the data store.
 StatusCode TsDataSvc::registerObject( std::string_view parentPath, std::string_view objPath, DataObject* pObject ) {
+  STD_LOCK_GUARD_MACRO
   DataObject* pO     = nullptr;
   StatusCode  status = retrieveObject( parentPath, pO );
   if ( !status.isSuccess() && m_forceLeaves ) {
@@ -323,6 +399,7 @@ StatusCode TsDataSvc::registerObject( std::string_view parentPath, std::string_v
 
 /// Register object with the data store.
 StatusCode TsDataSvc::registerObject( DataObject* parentObj, std::string_view objPath, DataObject* pObject ) {
+  STD_LOCK_GUARD_MACRO
   if ( !checkRoot() ) return Status::INVALID_ROOT;
   if ( !parentObj ) {
     if ( !objPath.empty() ) {
@@ -391,6 +468,7 @@ StatusCode TsDataSvc::registerObject( DataObject* parentObj, std::string_view ob
 
 /// Unregister object from the data store.
 StatusCode TsDataSvc::unregisterObject( std::string_view fullPath ) {
+  STD_LOCK_GUARD_MACRO
   DataObject* pObject = nullptr;
   StatusCode  status  = findObject( fullPath, pObject );
   if ( status.isFailure() ) return status;
@@ -406,6 +484,7 @@ StatusCode TsDataSvc::unregisterObject( std::string_view fullPath ) {
 
 /// Unregister object from the data store.
 StatusCode TsDataSvc::unregisterObject( DataObject* pObject ) {
+  STD_LOCK_GUARD_MACRO
   if ( !checkRoot() ) return Status::INVALID_ROOT;
   RegEntry* entry = m_root->findLeaf( pObject );
   if ( !entry ) return Status::INVALID_OBJECT;
@@ -419,6 +498,7 @@ StatusCode TsDataSvc::unregisterObject( DataObject* pObject ) {
 
 /// Unregister object from the data store.
 StatusCode TsDataSvc::unregisterObject( DataObject* pParentObj, std::string_view objectPath ) {
+  STD_LOCK_GUARD_MACRO
   if ( !checkRoot() ) return Status::INVALID_ROOT;
   try {
     RegEntry* parent = CAST_REGENTRY( RegEntry*, pParentObj->registry() );
@@ -620,10 +700,41 @@ StatusCode TsDataSvc::retrieveEntry( RegEntry* parentObj, std::string_view path,
   return status;
 }
 
+/// Look for an already loaded object, following the same path resolution as retrieveEntry
+DataObject* TsDataSvc::i_findLoaded( RegEntry* pNode, std::string_view path ) {
+  if ( !checkRoot() ) return nullptr;
+  if ( !pNode ) {
+    if ( path.empty() || path == m_rootName ) return m_root->object();
+    pNode = m_root.get();
+    if ( path.front() == SEPARATOR ) {
+      auto sep = find( path, SEPARATOR, 1 );
+      if ( sep == std::string_view::npos ) return nullptr;
+      path = path.substr( sep );
+    }
+  }
+  while ( pNode && pNode->object() ) {
+    if ( path.empty() ) return pNode->object();
+    auto      sep   = find( path, SEPARATOR, 1 );
+    RegEntry* entry = pNode->findLeaf( path.substr( 0, sep ) );
+    if ( !entry || !entry->object() ) return nullptr;
+    if ( sep == std::string_view::npos ) return entry->object();
+    if ( entry->isSoft() ) entry = CAST_REGENTRY( RegEntry*, entry->object()->registry() );
+    pNode = entry;
+    path  = path.substr( sep );
+  }
+  return nullptr;
+}
+
 /// Retrieve object identified by its directory from the data store.
 StatusCode TsDataSvc::retrieveObject( IRegistry* pRegistry, std::string_view path, DataObject*& pObject ) {
   pObject           = nullptr;
   RegEntry * result = nullptr, *parent = CAST_REGENTRY( RegEntry*, pRegistry );
+  {
+    // fast path: the object is already there, a shared lock is enough
+    STD_SHARED_LOCK_MACRO
+    pObject = i_findLoaded( parent, path );
+    if ( pObject ) return StatusCode::SUCCESS;
+  }
   StatusCode status = retrieveEntry( parent, path, result );
   if ( status.isSuccess() ) pObject = result->object();
   return status;
@@ -631,7 +742,7 @@ StatusCode TsDataSvc::retrieveObject( IRegistry* pRegistry, std::string_view pat
 
 /// Retrieve object identified by its directory from the data store.
 StatusCode TsDataSvc::findObject( IRegistry* pRegistry, std::string_view path, DataObject*& pObject ) {
-  STD_LOCK_GUARD_MACRO
+  STD_SHARED_LOCK_MACRO
   pObject               = nullptr;
   IRegistry* pReg       = ( pRegistry ? pRegistry : m_root.get() );
   RegEntry*  root_entry = CAST_REGENTRY( RegEntry*, pReg );
@@ -646,7 +757,7 @@ StatusCode TsDataSvc::findObject( IRegistry* pRegistry, std::string_view path, D
 /// Find object identified by its full path in the data store.
 StatusCode TsDataSvc::findObject( std::string_view path, DataObject*& pObject ) {
   pObject = nullptr;
-  STD_LOCK_GUARD_MACRO
+  STD_SHARED_LOCK_MACRO
   if ( !checkRoot() ) return Status::INVALID_ROOT;
   if ( path.empty() || path == m_rootName ) {
     pObject = m_root->object();
@@ -758,6 +869,7 @@ StatusCode TsDataSvc::unlinkObject( std::string_view fullPath ) {
 
 /// Remove a link to another object.
 StatusCode TsDataSvc::unlinkObject( DataObject* from, std::string_view objPath ) {
+  STD_LOCK_GUARD_MACRO
   if ( !checkRoot() ) return Status::INVALID_ROOT;
   return unlinkObject( m_root->findLeaf( from ), objPath );
 }
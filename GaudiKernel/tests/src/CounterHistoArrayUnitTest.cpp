@@ -11,6 +11,7 @@
 #define BOOST_TEST_DYN_LINK
 #define BOOST_TEST_MODULE test_CounterHistos
 #include <Gaudi/Accumulators/HistogramArray.h>
+#include <Gaudi/Accumulators/SparseHistogram.h>
 
 #include <boost/test/unit_test.hpp>
 
@@ -61,6 +62,17 @@ BOOST_AUTO_TEST_CASE( test_counter_histos, *boost::unit_test::tolerance( 1e-14 )
     for ( unsigned int i = 0; i < 7; i++ ) BOOST_TEST( histo2dw[i].toJSON().at( "bins" )[( 1 + 21 + 1 ) + 1] == 0.75 );
   }
 
+  {
+    // testing an array of 3 2D, sparse histograms
+    Gaudi::Accumulators::HistogramArray<Gaudi::Accumulators::SparseHistogram<2>, 3> histo2ds{
+        &algo, "Sparse{}", "Sparse {}", { 1000, 0, 1000, "X" }, { 1000, 0, 1000, "Y" } };
+    for ( unsigned int i = 0; i < 3; i++ ) ++histo2ds[i][{ 10.5, 20.5 }];
+    for ( unsigned int i = 0; i < 3; i++ ) {
+      BOOST_TEST( histo2ds[i].toJSON().at( "bins" )[21 * 1002 + 11] == 1 );
+      BOOST_TEST( histo2ds[i].allocatedBins() == 64 );
+    }
+  }
+
   {
     Gaudi::Accumulators::HistogramArray<Gaudi::Accumulators::Histogram<1>, 5> histo1d{
         &algo,
@@ -11,6 +11,7 @@
 #define BOOST_TEST_DYN_LINK
 #define BOOST_TEST_MODULE test_CounterHistos
 #include <Gaudi/Accumulators/Histogram.h>
+#include <Gaudi/Accumulators/SparseHistogram.h>
 
 #include "LogHistogram.h"
 
@@ -18,6 +19,8 @@
 
 #include <deque>
 #include <iostream>
+#include <thread>
+#include <vector>
 
 // Mock code for the test
 struct MonitoringHub : Gaudi::Monitoring::Hub {};
@@ -106,6 +109,143 @@ BOOST_AUTO_TEST_CASE( test_counter_histos, *boost::unit_test::tolerance( 1e-14 )
   }
 }
 
+BOOST_AUTO_TEST_CASE( test_sharded_histos, *boost::unit_test::tolerance( 1e-14 ) ) {
+  using namespace Gaudi::Accumulators;
+  Algo                                     algo;
+  Histogram<1, atomicity::sharded>         histo{ &algo, "ShardedH1D", "A sharded 1D histogram", { 10, 0, 10 } };
+  ProfileHistogram<1u, atomicity::sharded> prof{ &algo, "ShardedP1D", "A sharded 1D profile", { 10, 0, 10 } };
+  {
+    std::vector<std::thread> threads;
+    for ( int t = 0; t < 4; ++t ) {
+      threads.emplace_back( [&] {
+        for ( int i = 0; i < 100; ++i ) {
+          ++histo[i % 10 + 0.5];
+          prof[i % 10 + 0.5] += 2.;
+        }
+      } );
+    }
+    for ( auto& t : threads ) t.join();
+  }
+  auto j = histo.toJSON();
+  BOOST_TEST( j.at( "nEntries" ).get<unsigned long>() == 400 );
+  auto bins = j.at( "bins" ).get<std::vector<unsigned long>>();
+  for ( std::size_t i = 1; i <= 10; ++i ) BOOST_TEST( bins[i] == 40 );
+  BOOST_TEST( bins[0] == 0 );
+  BOOST_TEST( bins[11] == 0 );
+
+  auto  pbins = prof.toJSON().at( "bins" ).get<std::vector<std::tuple<std::tuple<unsigned int, double>, double>>>();
+  auto& [tmp, sumw2] = pbins[1];
+  auto& [nent, sumw] = tmp;
+  BOOST_TEST( nent == 40 );
+  BOOST_TEST( sumw == 80. );
+  BOOST_TEST( sumw2 == 160. );
+
+  histo.reset();
+  BOOST_TEST( histo.toJSON().at( "nEntries" ).get<unsigned long>() == 0 );
+}
+
+BOOST_AUTO_TEST_CASE( test_batch_fill, *boost::unit_test::tolerance( 1e-12 ) ) {
+  using namespace Gaudi::Accumulators;
+  Algo algo;
+  // values covering underflow, overflow and the bin edges
+  std::vector<double> xs, ys, zs, ws;
+  for ( int i = 0; i < 1000; ++i ) {
+    xs.push_back( -12 + 0.025 * i );
+    ys.push_back( 11 - 0.05 * ( i % 450 ) );
+    zs.push_back( ( i % 21 ) - 10.5 );
+    ws.push_back( 0.5 + i % 3 );
+  }
+  const auto n = xs.size();
+
+  Histogram<1> h1s{ &algo, "H1S", "", { 21, -10.5, 10.5 } }, h1b{ &algo, "H1B", "", { 21, -10.5, 10.5 } };
+  for ( std::size_t i = 0; i < n; ++i ) ++h1s[xs[i]];
+  h1b.fill( xs );
+  BOOST_TEST( h1b.toJSON() == h1s.toJSON() );
+
+  Histogram<2> h2s{ &algo, "H2S", "", { { 21, -10.5, 10.5 }, { 10, -5, 5 } } },
+      h2b{ &algo, "H2B", "", { { 21, -10.5, 10.5 }, { 10, -5, 5 } } };
+  for ( std::size_t i = 0; i < n; ++i ) ++h2s[{ xs[i], ys[i] }];
+  h2b.fill( xs, ys );
+  BOOST_TEST( h2b.toJSON() == h2s.toJSON() );
+
+  Histogram<3> h3s{ &algo, "H3S", "", { { 21, -10.5, 10.5 }, { 10, -5, 5 }, { 7, -7, 7 } } },
+      h3b{ &algo, "H3B", "", { { 21, -10.5, 10.5 }, { 10, -5, 5 }, { 7, -7, 7 } } };
+  for ( std::size_t i = 0; i < n; ++i ) ++h3s[{ xs[i], ys[i], zs[i] }];
+  h3b.fill( gsl::span<const double>( xs ), ys, zs );
+  BOOST_TEST( h3b.toJSON() == h3s.toJSON() );
+
+  WeightedHistogram<2> w2s{ &algo, "W2S", "", { { 21, -10.5, 10.5 }, { 10, -5, 5 } } },
+      w2b{ &algo, "W2B", "", { { 21, -10.5, 10.5 }, { 10, -5, 5 } } };
+  for ( std::size_t i = 0; i < n; ++i ) w2s[{ xs[i], ys[i] }] += ws[i];
+  w2b.fill( xs, ys, ws );
+  BOOST_TEST( w2b.toJSON() == w2s.toJSON() );
+
+  ProfileHistogram<1> p1s{ &algo, "P1S", "", { 21, -10.5, 10.5 } }, p1b{ &algo, "P1B", "", { 21, -10.5, 10.5 } };
+  for ( std::size_t i = 0; i < n; ++i ) p1s[xs[i]] += ys[i];
+  p1b.fill( xs, ys );
+  BOOST_TEST( p1b.toJSON() == p1s.toJSON() );
+
+  WeightedProfileHistogram<2> wp2s{ &algo, "WP2S", "", { { 21, -10.5, 10.5 }, { 10, -5, 5 } } },
+      wp2b{ &algo, "WP2B", "", { { 21, -10.5, 10.5 }, { 10, -5, 5 } } };
+  for ( std::size_t i = 0; i < n; ++i ) wp2s[{ xs[i], ys[i] }] += { zs[i], ws[i] };
+  wp2b.fill( xs, ys, zs, ws );
+  BOOST_TEST( wp2b.toJSON() == wp2s.toJSON() );
+
+  // large histograms are filled without local copy
+  Histogram<2> l2s{ &algo, "L2S", "", { { 200, -12, 13 }, { 200, -5, 12 } } },
+      l2b{ &algo, "L2B", "", { { 200, -12, 13 }, { 200, -5, 12 } } };
+  for ( std::size_t i = 0; i < n; ++i ) ++l2s[{ xs[i], ys[i] }];
+  l2b.fill( xs, ys );
+  BOOST_TEST( l2b.toJSON() == l2s.toJSON() );
+
+  // batch filling adds to the existing content
+  h1b.fill( xs );
+  BOOST_TEST( h1b.toJSON().at( "nEntries" ).get<unsigned long>() == 2 * n );
+}
+
+BOOST_AUTO_TEST_CASE( test_sparse_histos, *boost::unit_test::tolerance( 1e-12 ) ) {
+  using namespace Gaudi::Accumulators;
+  Algo                algo;
+  std::vector<double> xs, ys, vs;
+  for ( int i = 0; i < 200; ++i ) {
+    xs.push_back( -120 + 1.3 * i );
+    ys.push_back( 50 - 0.7 * ( i % 30 ) );
+    vs.push_back( 0.5 * ( i % 7 ) );
+  }
+
+  Histogram<2>       dense{ &algo, "Dense", "", { { 200, -100, 100 }, { 200, -100, 100 } } };
+  SparseHistogram<2> sparse{ &algo, "Sparse", "", { { 200, -100, 100 }, { 200, -100, 100 } } };
+  sparse.setDensePromotionThreshold( 1 );
+  for ( std::size_t i = 0; i < xs.size(); ++i ) ++dense[{ xs[i], ys[i] }];
+  for ( std::size_t i = 0; i < xs.size(); ++i ) ++sparse[{ xs[i], ys[i] }];
+  BOOST_TEST( sparse.toJSON() == dense.toJSON() );
+  BOOST_TEST( !sparse.isDense() );
+  BOOST_TEST( sparse.allocatedBins() < 202 * 202 / 5 );
+  sparse.fill( xs, ys );
+  dense.fill( xs, ys );
+  BOOST_TEST( sparse.toJSON() == dense.toJSON() );
+  sparse.reset();
+  BOOST_TEST( sparse.toJSON().at( "nEntries" ).get<unsigned long>() == 0 );
+
+  ProfileHistogram<1>       pdense{ &algo, "PDense", "", { 100, -100, 100 } };
+  SparseProfileHistogram<1> psparse{ &algo, "PSparse", "", { 100, -100, 100 } };
+  for ( std::size_t i = 0; i < xs.size(); ++i ) {
+    pdense[xs[i]] += vs[i];
+    psparse[xs[i]] += vs[i];
+  }
+  BOOST_TEST( psparse.toJSON() == pdense.toJSON() );
+
+  // promotion to dense storage
+  SparseWeightedHistogram<1> wsparse{ &algo, "WSparse", "", { 1000, 0, 1000 } };
+  wsparse.setDensePromotionThreshold( 0.25 );
+  for ( int i = 0; i < 1000; i += 64 ) wsparse[i] += 2.;
+  BOOST_TEST( wsparse.isDense() );
+  BOOST_TEST( wsparse.toJSON().at( "nEntries" ).get<unsigned long>() == 32 );
+  for ( int i = 0; i < 1000; ++i ) wsparse[i] += 1.;
+  BOOST_TEST( wsparse.toJSON().at( "bins" )[1].get<double>() == 3. );
+  BOOST_TEST( wsparse.toJSON().at( "bins" )[2].get<double>() == 1. );
+}
+
 enum class TestEnum { A, B, C, D };
 
 namespace Gaudi::Accumulators {
@@ -17,6 +17,8 @@
 #include "GaudiKernel/StatEntity.h"
 
 #include <chrono>
+#include <thread>
+#include <vector>
 
 using namespace Gaudi::Accumulators;
 
@@ -237,7 +239,7 @@ BOOST_AUTO_TEST_CASE( test_Counters_duration ) {
   c += Unit( 3 );
   c += std::chrono::seconds( 1 ); // mixing with larger units is OK
 
-  BOOST_TEST( c.toString() == "#=3       Sum=1008ms      Mean=     336ms +- 470ms      Min/Max=       0ms/1000ms    " );
+  BOOST_TEST( c.toString() == "#=3       Sum=1008ms      Mean=     336ms +- 470ms      Min/Max=       3ms/1000ms    " );
 
   // Check compilation of all stat methods:
   BOOST_TEST( is_Unit_v<decltype( c.mean() )>, "mean return type should be Unit" );
@@ -249,3 +251,60 @@ BOOST_AUTO_TEST_CASE( test_Counters_duration ) {
   BOOST_TEST( is_Unit_v<decltype( c.min() )>, "min return type should be Unit" );
   BOOST_TEST( is_Unit_v<decltype( c.max() )>, "max return type should be Unit" );
 }
+
+BOOST_AUTO_TEST_CASE( test_sharded_counters, *utf::tolerance( 1e-14 ) ) {
+  Counter<atomicity::sharded>                 c;
+  StatCounter<double, atomicity::sharded>     stat;
+  BinomialCounter<double, atomicity::sharded> bin;
+  {
+    std::vector<std::thread> threads;
+    for ( int t = 0; t < 4; ++t ) {
+      threads.emplace_back( [&, t] {
+        for ( int i = 0; i < 1000; ++i ) {
+          ++c;
+          stat += t * 1000 + i;
+          bin += ( i % 4 == 0 );
+        }
+      } );
+    }
+    for ( auto& t : threads ) t.join();
+  }
+  // values of the threads that exited are kept
+  BOOST_TEST( c.nEntries() == 4000 );
+  BOOST_TEST( stat.nEntries() == 4000 );
+  BOOST_TEST( stat.sum() == 3999. * 4000. / 2 );
+  BOOST_TEST( stat.min() == 0 );
+  BOOST_TEST( stat.max() == 3999 );
+  BOOST_TEST( bin.nEntries() == 4000 );
+  BOOST_TEST( bin.nTrueEntries() == 1000 );
+
+  {
+    auto buf = c.buffer();
+    ++buf;
+  }
+  BOOST_TEST( c.nEntries() == 4001 );
+  BOOST_TEST( c.toJSON().at( "nEntries" ).get<unsigned long>() == 4001 );
+
+  Counter<atomicity::full> merged;
+  merged.mergeAndReset( std::move( c ) );
+  BOOST_TEST( merged.nEntries() == 4001 );
+  BOOST_TEST( c.nEntries() == 0 );
+
+  stat.reset();
+  BOOST_TEST( stat.nEntries() == 0 );
+  BOOST_TEST( stat.max() == std::numeric_limits<double>::lowest() );
+  stat += -1;
+  BOOST_TEST( stat.min() == -1 );
+  BOOST_TEST( stat.max() == -1 );
+}
+
+BOOST_AUTO_TEST_CASE( test_sharded_durations ) {
+  using std::chrono::microseconds;
+  StatCounter<microseconds, atomicity::sharded> t;
+  t += microseconds{ 5 };
+  t += microseconds{ 7 };
+  BOOST_TEST( t.nEntries() == 2 );
+  BOOST_TEST( t.sum().count() == 12 );
+  BOOST_TEST( t.min().count() == 5 );
+  BOOST_TEST( t.max().count() == 7 );
+}
@@ -11,10 +11,14 @@
 #define BOOST_TEST_DYN_LINK
 #define BOOST_TEST_MODULE test_GenericSink
 
+#include "Gaudi/MonitoringBinaryFormat.h"
 #include "Gaudi/MonitoringHub.h"
 
 #include <boost/test/unit_test.hpp>
 
+#include <mutex>
+#include <sstream>
+
 // Mock code for the test
 struct MonitoringHub : Gaudi::Monitoring::Hub {};
 struct ServiceLocator {
@@ -46,6 +50,33 @@ struct Store {
   nlohmann::json toJSON() const { return m_data; }
 };
 
+// Same as Store, but protected by a mutex so that it can be read while updated from other threads
+struct LockedStore {
+  static constexpr bool   concurrentReads = true;
+  mutable std::mutex      m_mutex;
+  std::string             m_data;
+  Gaudi::Monitoring::Hub* m_monitoringHub{ nullptr };
+
+  template <typename OWNER>
+  LockedStore( OWNER* o, std::string const& name, const std::string storeType )
+      : m_monitoringHub( &o->serviceLocator()->monitoringHub() ) {
+    m_monitoringHub->registerEntity( o->name(), name, storeType, *this );
+  }
+  ~LockedStore() { m_monitoringHub->removeEntity( *this ); }
+  void reset() {
+    std::scoped_lock lock{ m_mutex };
+    m_data = "";
+  }
+  void storeData( std::string const& data ) {
+    std::scoped_lock lock{ m_mutex };
+    m_data += data;
+  }
+  nlohmann::json toJSON() const {
+    std::scoped_lock lock{ m_mutex };
+    return m_data;
+  }
+};
+
 // dummy  Sink for the purpose of testing Hub and Sink with non mergeable items
 struct NonMergeableSink : public Gaudi::Monitoring::Hub::Sink {
   virtual void registerEntity( Gaudi::Monitoring::Hub::Entity ent ) override { m_entities.push_back( ent ); }
@@ -74,3 +105,78 @@ BOOST_AUTO_TEST_CASE( test_entity_no_merge_reset, *boost::unit_test::tolerance(
   for ( auto& ent : entities ) { output += ent.toJSON().get<std::string>(); }
   BOOST_TEST( output == "Hello World !" );
 }
+
+// dummy Sink recording the snapshots
+struct SnapshotSink : NonMergeableSink {
+  void onSnapshot( std::uint64_t snapshot, Gaudi::Monitoring::Hub::Entity const& ent,
+                   nlohmann::json const& value ) override {
+    m_changes.push_back( std::to_string( snapshot ) + ":" + ent.name + "=" + value.get<std::string>() );
+  }
+  void                     onSnapshotEnd( std::uint64_t ) override { ++m_nSnapshots; }
+  std::vector<std::string> m_changes;
+  std::size_t              m_nSnapshots{ 0 };
+};
+
+BOOST_AUTO_TEST_CASE( test_snapshot_deltas ) {
+  Algo         algo;
+  SnapshotSink sink;
+  auto&        hub = algo.serviceLocator()->monitoringHub();
+  hub.addSink( &sink );
+
+  // entities that cannot be read concurrently are never part of the snapshots
+  Store unsafe( &algo, "Unsafe", "store:test" );
+  unsafe.storeData( "x" );
+
+  LockedStore store1( &algo, "TestStore1", "store:test" );
+  store1.storeData( "a" );
+  {
+    LockedStore store2( &algo, "TestStore2", "store:test" );
+    // first snapshot contains all entities
+    BOOST_TEST( hub.publishSnapshot() == 2u );
+    // nothing changed
+    BOOST_TEST( hub.publishSnapshot() == 0u );
+    store2.storeData( "b" );
+    BOOST_TEST( hub.publishSnapshot() == 1u );
+  }
+  // removed entities do not appear anymore
+  store1.storeData( "c" );
+  unsafe.storeData( "y" );
+  BOOST_TEST( hub.publishSnapshot() == 1u );
+
+  BOOST_TEST( sink.m_nSnapshots == 4u );
+  const auto expected =
+      std::vector<std::string>{ "1:TestStore1=a", "1:TestStore2=", "3:TestStore2=b", "4:TestStore1=ac" };
+  BOOST_TEST( sink.m_changes == expected, boost::test_tools::per_element() );
+}
+
+BOOST_AUTO_TEST_CASE( test_binary_format ) {
+  using namespace Gaudi::Monitoring::BinaryFormat;
+  Algo             algo;
+  NonMergeableSink sink;
+  algo.serviceLocator()->monitoringHub().addSink( &sink );
+
+  Store store1( &algo, "TestStore1", "store:test" );
+  Store store2( &algo, "TestStore2", "store:test" );
+  store1.storeData( "Hello" );
+
+  std::stringstream buffer;
+  {
+    Writer writer( buffer );
+    for ( auto& ent : sink.m_entities ) writer.write( ent );
+    writer.write( nlohmann::json{ { "number", -1.5 }, { "list", { 1, 2, 3 } } } );
+  }
+
+  Reader reader( buffer );
+  for ( auto& ent : sink.m_entities ) {
+    auto record = reader.next();
+    BOOST_REQUIRE( record.has_value() );
+    BOOST_TEST( record->at( "name" ).get<std::string>() == ent.name );
+    BOOST_TEST( record->at( "component" ).get<std::string>() == ent.component );
+    BOOST_TEST( record->at( "entity" ) == ent.toJSON() );
+  }
+  BOOST_TEST( reader.next().value() == ( nlohmann::json{ { "number", -1.5 }, { "list", { 1, 2, 3 } } } ) );
+  BOOST_TEST( !reader.next().has_value() );
+
+  std::stringstream garbage( "not a monitoring file" );
+  BOOST_CHECK_THROW( Reader{ garbage }, std::runtime_error );
+}
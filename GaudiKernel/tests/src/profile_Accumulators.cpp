@@ -0,0 +1,107 @@
+/***********************************************************************************\
+* (c) Copyright 2022 CERN for the benefit of the LHCb and ATLAS collaborations      *
+*                                                                                   *
+* This software is distributed under the terms of the Apache version 2 licence,     *
+* copied verbatim in the file "LICENSE".                                            *
+*                                                                                   *
+* In applying this licence, CERN does not waive the privileges and immunities       *
+* granted to it by virtue of its status as an Intergovernmental Organization        *
+* or submit itself to any jurisdiction.                                             *
+\***********************************************************************************/
+// Contention benchmark of the accumulators: all threads update the same counter or
+// histogram, comparing the atomic (full) and the sharded implementations.
+//
+// usage: profile_Accumulators [n_threads] [n_updates_per_thread]
+#include <Gaudi/Accumulators.h>
+#include <Gaudi/Accumulators/Histogram.h>
+
+#include <chrono>
+#include <cstdlib>
+#include <iostream>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace {
+  // minimal owner for the histograms
+  struct ServiceLocator {
+    Gaudi::Monitoring::Hub& monitoringHub() { return m_monitHub; }
+    Gaudi::Monitoring::Hub  m_monitHub{};
+  };
+  struct Owner {
+    ServiceLocator* serviceLocator() { return &m_serviceLocator; }
+    std::string     name() { return "Owner"; }
+    ServiceLocator  m_serviceLocator{};
+  };
+
+  /// run `update( i )` n_updates times in each of n threads, for n = 1, 2, 4, ... n_threads
+  template <typename F>
+  void run( const std::string& label, std::size_t n_threads, std::size_t n_updates, F update ) {
+    for ( std::size_t n = 1; n <= n_threads; n *= 2 ) {
+      std::vector<std::thread> threads;
+      threads.reserve( n );
+      auto start = std::chrono::high_resolution_clock::now();
+      for ( std::size_t t = 0; t != n; ++t ) {
+        threads.emplace_back( [&] {
+          for ( std::size_t i = 0; i != n_updates; ++i ) update( i );
+        } );
+      }
+      for ( auto& t : threads ) t.join();
+      auto end = std::chrono::high_resolution_clock::now();
+
+      std::chrono::duration<double> elapsed = end - start;
+      std::cout << label << ", " << n << " threads: " << elapsed.count() * 1e9 / n_updates << " ns/update/thread"
+                << std::endl;
+    }
+  }
+} // namespace
+
+int main( int argc, char* argv[] ) {
+  using namespace Gaudi::Accumulators;
+  const std::size_t n_threads = argc > 1 ? std::atol( argv[1] ) : std::thread::hardware_concurrency();
+  const std::size_t n_updates = argc > 2 ? std::atol( argv[2] ) : 10000000;
+
+  Owner        owner;
+  Axis<double> axis{ 100, 0, 100 };
+
+  {
+    Counter<atomicity::full> c;
+    run( "Counter<full>", n_threads, n_updates, [&]( std::size_t ) { ++c; } );
+  }
+  {
+    Counter<atomicity::sharded> c;
+    run( "Counter<sharded>", n_threads, n_updates, [&]( std::size_t ) { ++c; } );
+  }
+  {
+    AveragingCounter<double, atomicity::full> c;
+    run( "AveragingCounter<full>", n_threads, n_updates, [&]( std::size_t i ) { c += i; } );
+  }
+  {
+    AveragingCounter<double, atomicity::sharded> c;
+    run( "AveragingCounter<sharded>", n_threads, n_updates, [&]( std::size_t i ) { c += i; } );
+  }
+  {
+    StatCounter<double, atomicity::full> c;
+    run( "StatCounter<full>", n_threads, n_updates, [&]( std::size_t i ) { c += i; } );
+  }
+  {
+    StatCounter<double, atomicity::sharded> c;
+    run( "StatCounter<sharded>", n_threads, n_updates, [&]( std::size_t i ) { c += i; } );
+  }
+  {
+    Histogram<1, atomicity::full> h{ &owner, "H1Full", "", axis };
+    run( "Histogram<full>", n_threads, n_updates, [&]( std::size_t i ) { ++h[i % 100]; } );
+  }
+  {
+    Histogram<1, atomicity::sharded> h{ &owner, "H1Sharded", "", axis };
+    run( "Histogram<sharded>", n_threads, n_updates, [&]( std::size_t i ) { ++h[i % 100]; } );
+  }
+  {
+    ProfileHistogram<1, atomicity::full> h{ &owner, "P1Full", "", axis };
+    run( "ProfileHistogram<full>", n_threads, n_updates, [&]( std::size_t i ) { h[i % 100] += i; } );
+  }
+  {
+    ProfileHistogram<1, atomicity::sharded> h{ &owner, "P1Sharded", "", axis };
+    run( "ProfileHistogram<sharded>", n_threads, n_updates, [&]( std::size_t i ) { h[i % 100] += i; } );
+  }
+}
@@ -0,0 +1,114 @@
+/***********************************************************************************\
+* (c) Copyright 2022 CERN for the benefit of the LHCb and ATLAS collaborations      *
+*                                                                                   *
+* This software is distributed under the terms of the Apache version 2 licence,     *
+* copied verbatim in the file "LICENSE".                                            *
+*                                                                                   *
+* In applying this licence, CERN does not waive the privileges and immunities       *
+* granted to it by virtue of its status as an Intergovernmental Organization        *
+* or submit itself to any jurisdiction.                                             *
+\***********************************************************************************/
+// Compare filling histograms entry by entry (operator[]) with the batch fill() method.
+//
+// usage: profile_HistogramFill [n_values_per_batch] [n_batches]
+#include <Gaudi/Accumulators/Histogram.h>
+
+#include <chrono>
+#include <cstdlib>
+#include <iostream>
+#include <random>
+#include <string>
+#include <vector>
+
+namespace {
+  // minimal owner for the histograms
+  struct ServiceLocator {
+    Gaudi::Monitoring::Hub& monitoringHub() { return m_monitHub; }
+    Gaudi::Monitoring::Hub  m_monitHub{};
+  };
+  struct Owner {
+    ServiceLocator* serviceLocator() { return &m_serviceLocator; }
+    std::string     name() { return "Owner"; }
+    ServiceLocator  m_serviceLocator{};
+  };
+
+  template <typename F>
+  void time( const std::string& label, std::size_t n_batches, std::size_t n_values, F f ) {
+    auto start = std::chrono::high_resolution_clock::now();
+    for ( std::size_t b = 0; b != n_batches; ++b ) f();
+    auto end = std::chrono::high_resolution_clock::now();
+
+    std::chrono::duration<double> elapsed = end - start;
+    std::cout << label << ": " << elapsed.count() * 1e9 / ( n_batches * n_values ) << " ns/entry" << std::endl;
+  }
+} // namespace
+
+int main( int argc, char* argv[] ) {
+  using namespace Gaudi::Accumulators;
+  const std::size_t n_values  = argc > 1 ? std::atol( argv[1] ) : 2000;
+  const std::size_t n_batches = argc > 2 ? std::atol( argv[2] ) : 5000;
+
+  std::mt19937                     rng( 42 );
+  std::normal_distribution<double> gauss( 0, 40 );
+  std::vector<double>              xs( n_values ), ys( n_values ), zs( n_values ), ws( n_values );
+  for ( std::size_t i = 0; i != n_values; ++i ) {
+    xs[i] = gauss( rng );
+    ys[i] = gauss( rng );
+    zs[i] = gauss( rng );
+    ws[i] = 1 + gauss( rng ) / 100;
+  }
+
+  Owner        owner;
+  Axis<double> axis{ 100, -100, 100 };
+
+  {
+    Histogram<1> h{ &owner, "H1Scalar", "", axis };
+    time( "Histogram<1> scalar", n_batches, n_values, [&] {
+      for ( auto x : xs ) ++h[x];
+    } );
+  }
+  {
+    Histogram<1> h{ &owner, "H1Batch", "", axis };
+    time( "Histogram<1> batch ", n_batches, n_values, [&] { h.fill( xs ); } );
+  }
+  {
+    WeightedHistogram<1> h{ &owner, "W1Scalar", "", axis };
+    time( "WeightedHistogram<1> scalar", n_batches, n_values, [&] {
+      for ( std::size_t i = 0; i != n_values; ++i ) h[xs[i]] += ws[i];
+    } );
+  }
+  {
+    WeightedHistogram<1> h{ &owner, "W1Batch", "", axis };
+    time( "WeightedHistogram<1> batch ", n_batches, n_values, [&] { h.fill( xs, ws ); } );
+  }
+  {
+    Histogram<2> h{ &owner, "H2Scalar", "", axis, axis };
+    time( "Histogram<2> scalar", n_batches, n_values, [&] {
+      for ( std::size_t i = 0; i != n_values; ++i ) ++h[{ xs[i], ys[i] }];
+    } );
+  }
+  {
+    Histogram<2> h{ &owner, "H2Batch", "", axis, axis };
+    time( "Histogram<2> batch ", n_batches, n_values, [&] { h.fill( xs, ys ); } );
+  }
+  {
+    Histogram<3> h{ &owner, "H3Scalar", "", { 20, -100, 100 }, { 20, -100, 100 }, { 20, -100, 100 } };
+    time( "Histogram<3> scalar", n_batches, n_values, [&] {
+      for ( std::size_t i = 0; i != n_values; ++i ) ++h[{ xs[i], ys[i], zs[i] }];
+    } );
+  }
+  {
+    Histogram<3> h{ &owner, "H3Batch", "", { 20, -100, 100 }, { 20, -100, 100 }, { 20, -100, 100 } };
+    time( "Histogram<3> batch ", n_batches, n_values, [&] { h.fill( xs, ys, zs ); } );
+  }
+  {
+    ProfileHistogram<1> h{ &owner, "P1Scalar", "", axis };
+    time( "ProfileHistogram<1> scalar", n_batches, n_values, [&] {
+      for ( std::size_t i = 0; i != n_values; ++i ) h[xs[i]] += ys[i];
+    } );
+  }
+  {
+    ProfileHistogram<1> h{ &owner, "P1Batch", "", axis };
+    time( "ProfileHistogram<1> batch ", n_batches, n_values, [&] { h.fill( xs, ys ); } );
+  }
+}
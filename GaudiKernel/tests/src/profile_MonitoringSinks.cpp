@@ -0,0 +1,104 @@
+/***********************************************************************************\
+* (c) Copyright 2022 CERN for the benefit of the LHCb and ATLAS collaborations      *
+*                                                                                   *
+* This software is distributed under the terms of the Apache version 2 licence,     *
+* copied verbatim in the file "LICENSE".                                            *
+*                                                                                   *
+* In applying this licence, CERN does not waive the privileges and immunities       *
+* granted to it by virtue of its status as an Intergovernmental Organization        *
+* or submit itself to any jurisdiction.                                             *
+\***********************************************************************************/
+// Time and peak memory needed to write many counters and histograms at the end of a job, either
+// as a single JSON document (as JSONSink does) or streamed in the binary format (as BinarySink does).
+// Run once per format, as the peak memory of the process is reported.
+//
+// usage: profile_MonitoringSinks json|binary [n_counters] [n_histograms] [output_file]
+#include <Gaudi/Accumulators.h>
+#include <Gaudi/Accumulators/Histogram.h>
+#include <Gaudi/MonitoringBinaryFormat.h>
+
+#include <sys/resource.h>
+
+#include <chrono>
+#include <cstdlib>
+#include <deque>
+#include <fstream>
+#include <iostream>
+#include <memory>
+#include <string>
+#include <vector>
+
+namespace {
+  // minimal owner for the accumulators
+  struct ServiceLocator {
+    Gaudi::Monitoring::Hub& monitoringHub() { return m_monitHub; }
+    Gaudi::Monitoring::Hub  m_monitHub{};
+  };
+  struct Owner {
+    ServiceLocator* serviceLocator() { return &m_serviceLocator; }
+    std::string     name() { return "Owner"; }
+    ServiceLocator  m_serviceLocator{};
+  };
+
+  // sink collecting all entities
+  struct CollectingSink : Gaudi::Monitoring::Hub::Sink {
+    void registerEntity( Gaudi::Monitoring::Hub::Entity ent ) override { entities.push_back( std::move( ent ) ); }
+    void removeEntity( Gaudi::Monitoring::Hub::Entity const& ) override {}
+    std::deque<Gaudi::Monitoring::Hub::Entity> entities;
+  };
+
+  double peakMemoryMB() {
+    rusage usage;
+    getrusage( RUSAGE_SELF, &usage );
+    return usage.ru_maxrss / 1024.;
+  }
+} // namespace
+
+int main( int argc, char* argv[] ) {
+  using namespace Gaudi::Accumulators;
+  if ( argc < 2 ) {
+    std::cerr << "usage: " << argv[0] << " json|binary [n_counters] [n_histograms] [output_file]" << std::endl;
+    return 1;
+  }
+  const std::string format       = argv[1];
+  const std::size_t n_counters   = argc > 2 ? std::atol( argv[2] ) : 50000;
+  const std::size_t n_histograms = argc > 3 ? std::atol( argv[3] ) : 10000;
+  const std::string fileName     = argc > 4 ? argv[4] : "profile_MonitoringSinks." + format;
+
+  Owner          owner;
+  CollectingSink sink;
+  owner.serviceLocator()->monitoringHub().addSink( &sink );
+
+  std::vector<std::unique_ptr<StatCounter<>>> counters;
+  std::vector<std::unique_ptr<Histogram<1>>>  histos;
+  for ( std::size_t i = 0; i != n_counters; ++i ) {
+    counters.push_back( std::make_unique<StatCounter<>>( &owner, "Counter" + std::to_string( i ) ) );
+    *counters.back() += i;
+  }
+  for ( std::size_t i = 0; i != n_histograms; ++i ) {
+    histos.push_back( std::make_unique<Histogram<1>>( &owner, "Histo" + std::to_string( i ), "A histogram",
+                                                      Axis<double>{ 100, 0, 100 } ) );
+    for ( int j = 0; j != 100; ++j ) ++( *histos.back() )[j];
+  }
+  const double memoryBefore = peakMemoryMB();
+
+  auto start = std::chrono::high_resolution_clock::now();
+  if ( format == "json" ) {
+    nlohmann::json output;
+    for ( auto& ent : sink.entities ) {
+      output.emplace_back(
+          nlohmann::json{ { "name", ent.name }, { "component", ent.component }, { "entity", ent.toJSON() } } );
+    }
+    std::ofstream os( fileName, std::ios::out );
+    os << output.dump( 4 );
+  } else {
+    std::ofstream                           os( fileName, std::ios::out | std::ios::binary );
+    Gaudi::Monitoring::BinaryFormat::Writer writer( os );
+    for ( auto& ent : sink.entities ) writer.write( ent );
+  }
+  auto end = std::chrono::high_resolution_clock::now();
+
+  std::chrono::duration<double> elapsed = end - start;
+  std::cout << format << ": " << sink.entities.size() << " entities written in " << elapsed.count()
+            << " s, peak memory increase " << peakMemoryMB() - memoryBefore << " MB" << std::endl;
+}
@@ -0,0 +1,114 @@
+/***********************************************************************************\
+* (c) Copyright 2022 CERN for the benefit of the LHCb and ATLAS collaborations      *
+*                                                                                   *
+* This software is distributed under the terms of the Apache version 2 licence,     *
+* copied verbatim in the file "LICENSE".                                            *
+*                                                                                   *
+* In applying this licence, CERN does not waive the privileges and immunities       *
+* granted to it by virtue of its status as an Intergovernmental Organization        *
+* or submit itself to any jurisdiction.                                             *
+\***********************************************************************************/
+// Cost of the periodic Monitoring::Hub snapshots on the threads updating the accumulators:
+// the same updates are timed without snapshots and with a thread publishing snapshots
+// every snapshot_period_us microseconds.
+//
+// usage: profile_MonitoringSnapshot [n_threads] [n_updates_per_thread] [snapshot_period_us]
+#include <Gaudi/Accumulators.h>
+#include <Gaudi/Accumulators/Histogram.h>
+
+#include <atomic>
+#include <chrono>
+#include <cstdlib>
+#include <iostream>
+#include <memory>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace {
+  // minimal owner for the accumulators
+  struct ServiceLocator {
+    Gaudi::Monitoring::Hub& monitoringHub() { return m_monitHub; }
+    Gaudi::Monitoring::Hub  m_monitHub{};
+  };
+  struct Owner {
+    ServiceLocator* serviceLocator() { return &m_serviceLocator; }
+    std::string     name() { return "Owner"; }
+    ServiceLocator  m_serviceLocator{};
+  };
+
+  // sink receiving the snapshots, only counting the changed entities
+  struct CountingSink : Gaudi::Monitoring::Hub::Sink {
+    void registerEntity( Gaudi::Monitoring::Hub::Entity ) override {}
+    void removeEntity( Gaudi::Monitoring::Hub::Entity const& ) override {}
+    void onSnapshot( std::uint64_t, Gaudi::Monitoring::Hub::Entity const&, nlohmann::json const& ) override {
+      ++nChanged;
+    }
+    std::size_t nChanged{ 0 };
+  };
+
+  /// time n_updates calls to update( i ) in each of n_threads threads, while publishing snapshots if period > 0
+  template <typename F>
+  void run( const std::string& label, Gaudi::Monitoring::Hub& hub, std::size_t n_threads, std::size_t n_updates,
+            std::chrono::microseconds period, F update ) {
+    std::atomic<bool> done{ false };
+    std::size_t       nSnapshots = 0;
+    std::thread       snapshots;
+    if ( period.count() > 0 ) {
+      snapshots = std::thread{ [&] {
+        while ( !done ) {
+          std::this_thread::sleep_for( period );
+          hub.publishSnapshot();
+          ++nSnapshots;
+        }
+      } };
+    }
+    std::vector<std::thread> threads;
+    threads.reserve( n_threads );
+    auto start = std::chrono::high_resolution_clock::now();
+    for ( std::size_t t = 0; t != n_threads; ++t ) {
+      threads.emplace_back( [&] {
+        for ( std::size_t i = 0; i != n_updates; ++i ) update( i );
+      } );
+    }
+    for ( auto& t : threads ) t.join();
+    auto end = std::chrono::high_resolution_clock::now();
+    done     = true;
+    if ( snapshots.joinable() ) snapshots.join();
+
+    std::chrono::duration<double> elapsed = end - start;
+    std::cout << label << ( period.count() > 0 ? ", with snapshots: " : ", no snapshots:   " )
+              << elapsed.count() * 1e9 / n_updates << " ns/update/thread";
+    if ( nSnapshots ) std::cout << " (" << nSnapshots << " snapshots)";
+    std::cout << std::endl;
+  }
+} // namespace
+
+int main( int argc, char* argv[] ) {
+  using namespace Gaudi::Accumulators;
+  const std::size_t n_threads = argc > 1 ? std::atol( argv[1] ) : std::thread::hardware_concurrency();
+  const std::size_t n_updates = argc > 2 ? std::atol( argv[2] ) : 10000000;
+  const auto        period    = std::chrono::microseconds{ argc > 3 ? std::atol( argv[3] ) : 1000 };
+
+  Owner        owner;
+  auto&        hub = owner.serviceLocator()->monitoringHub();
+  CountingSink sink;
+  hub.addSink( &sink );
+
+  // a realistic number of entities to serialize in each snapshot
+  using Histo = Histogram<1, atomicity::full>;
+  Axis<double>                            axis{ 100, 0, 100 };
+  std::vector<std::unique_ptr<Counter<>>> counters;
+  std::vector<std::unique_ptr<Histo>>     histos;
+  for ( int i = 0; i != 1000; ++i ) {
+    counters.push_back( std::make_unique<Counter<>>( &owner, "C" + std::to_string( i ) ) );
+    if ( i % 10 == 0 ) histos.push_back( std::make_unique<Histo>( &owner, "H" + std::to_string( i ), "", axis ) );
+  }
+
+  for ( auto p : { std::chrono::microseconds{ 0 }, period } ) {
+    run( "Counter<full>", hub, n_threads, n_updates, p, [&]( std::size_t i ) { ++*counters[i % counters.size()]; } );
+    run( "Histogram<full>", hub, n_threads, n_updates, p,
+         [&]( std::size_t i ) { ++( *histos[i % histos.size()] )[i % 100]; } );
+  }
+  std::cout << "changed entities sent to the sink: " << sink.nChanged << std::endl;
+}
@@ -0,0 +1,95 @@
+/***********************************************************************************\
+* (c) Copyright 2022 CERN for the benefit of the LHCb and ATLAS collaborations      *
+*                                                                                   *
+* This software is distributed under the terms of the Apache version 2 licence,     *
+* copied verbatim in the file "LICENSE".                                            *
+*                                                                                   *
+* In applying this licence, CERN does not waive the privileges and immunities       *
+* granted to it by virtue of its status as an Intergovernmental Organization        *
+* or submit itself to any jurisdiction.                                             *
+\***********************************************************************************/
+// Multi-threaded read benchmark of TsDataSvc on a detector description sized tree.
+//
+// usage: profile_TsDataSvc [n_threads] [n_lookups_per_thread] [fan_out] [depth]
+#include <GaudiKernel/Bootstrap.h>
+#include <GaudiKernel/DataObject.h>
+#include <GaudiKernel/IAppMgrUI.h>
+#include <GaudiKernel/IProperty.h>
+#include <GaudiKernel/ISvcLocator.h>
+#include <GaudiKernel/SmartIF.h>
+#include <GaudiKernel/System.h>
+#include <GaudiKernel/TsDataSvc.h>
+
+#include <chrono>
+#include <cstdlib>
+#include <iostream>
+#include <random>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace {
+  /// recursively fill the store with fan_out^depth leaves, recording the paths
+  void fill( TsDataSvc& svc, const std::string& parent, std::size_t fan_out, std::size_t depth,
+             std::vector<std::string>& paths ) {
+    if ( !depth ) return;
+    for ( std::size_t i = 0; i != fan_out; ++i ) {
+      std::string path = parent + "/Node" + std::to_string( i );
+      svc.registerObject( path, new DataObject() ).ignore();
+      paths.push_back( path );
+      fill( svc, path, fan_out, depth - 1, paths );
+    }
+  }
+} // namespace
+
+int main( int argc, char* argv[] ) {
+  const std::size_t n_threads = argc > 1 ? std::atol( argv[1] ) : std::thread::hardware_concurrency();
+  const std::size_t n_lookups = argc > 2 ? std::atol( argv[2] ) : 1000000;
+  const std::size_t fan_out   = argc > 3 ? std::atol( argv[3] ) : 8;
+  const std::size_t depth     = argc > 4 ? std::atol( argv[4] ) : 5;
+
+  // minimal bootstrap, so that the service can find its ISvcLocator
+  {
+    System::ImageHandle handle;
+    System::loadDynamicLib( "libGaudiCoreSvc.so", &handle );
+  }
+  auto               app = Gaudi::createApplicationMgr();
+  SmartIF<IProperty> appProp{ app };
+  appProp->setProperty( "JobOptionsType", "NONE" ).ignore();
+  appProp->setPropertyRepr( "AppName", "''" ).ignore();
+  appProp->setProperty( "OutputLevel", 6 ).ignore();
+  app->configure().ignore();
+
+  SmartIF<TsDataSvc> svc{ new TsDataSvc( "DetectorDataSvc", Gaudi::svcLocator() ) };
+  svc->setProperty( "RootName", "/dd" ).ignore();
+  svc->setRoot( "/dd", new DataObject() ).ignore();
+
+  std::vector<std::string> paths;
+  fill( *svc, "/dd", fan_out, depth, paths );
+  std::cout << "registered " << paths.size() << " objects" << std::endl;
+
+  auto reader = [&]( std::size_t seed ) {
+    std::mt19937                               rng( seed );
+    std::uniform_int_distribution<std::size_t> pick( 0, paths.size() - 1 );
+    DataObject*                                obj = nullptr;
+    for ( std::size_t i = 0; i != n_lookups; ++i ) {
+      if ( !svc->retrieveObject( paths[pick( rng )], obj ) || !obj ) std::abort();
+    }
+  };
+
+  for ( std::size_t n = 1; n <= n_threads; n *= 2 ) {
+    std::vector<std::thread> threads;
+    threads.reserve( n );
+    auto start = std::chrono::high_resolution_clock::now();
+    for ( std::size_t t = 0; t != n; ++t ) threads.emplace_back( reader, t );
+    for ( auto& t : threads ) t.join();
+    auto end = std::chrono::high_resolution_clock::now();
+
+    std::chrono::duration<double> elapsed = end - start;
+    std::cout << n << " threads: " << n * n_lookups << " lookups in " << elapsed.count() << " s ("
+              << elapsed.count() * 1e9 / n_lookups << " ns/lookup/thread, "
+              << n * n_lookups / elapsed.count() << " lookups/s)" << std::endl;
+  }
+
+  svc->clearStore().ignore();
+}
@@ -0,0 +1,68 @@
+/***********************************************************************************\
+* (c) Copyright 2022 CERN for the benefit of the LHCb and ATLAS collaborations      *
+*                                                                                   *
+* This software is distributed under the terms of the Apache version 2 licence,     *
+* copied verbatim in the file "LICENSE".                                            *
+*                                                                                   *
+* In applying this licence, CERN does not waive the privileges and immunities       *
+* granted to it by virtue of its status as an Intergovernmental Organization        *
+* or submit itself to any jurisdiction.                                             *
+\***********************************************************************************/
+#define BOOST_TEST_DYN_LINK
+#define BOOST_TEST_MODULE test_DataObjectRecycling
+#include <Gaudi/Interfaces/IDataObjectRecycler.h>
+#include <GaudiKernel/implements.h>
+#include <boost/test/unit_test.hpp>
+#include <vector>
+
+namespace {
+  /// minimal single-type recycler, mimicking what an event store does at event clear
+  struct TestRecycler : implements<Gaudi::Interfaces::IDataObjectRecycler> {
+    std::unique_ptr<DataObject> acquire( const std::type_info&, Resetter reset ) override {
+      m_reset = reset;
+      return std::move( m_free );
+    }
+    void recycle( std::unique_ptr<DataObject> obj ) {
+      m_reset( *obj );
+      m_free = std::move( obj );
+    }
+    Resetter                    m_reset = nullptr;
+    std::unique_ptr<DataObject> m_free;
+  };
+
+  using Wrapper = AnyDataWrapper<std::vector<int>>;
+} // namespace
+
+BOOST_AUTO_TEST_CASE( traits ) {
+  static_assert( Gaudi::Recycling::is_recyclable_v<Wrapper> );
+  static_assert( !Gaudi::Recycling::is_recyclable_v<AnyDataWrapper<int>> );
+  static_assert( !Gaudi::Recycling::is_recyclable_v<DataObject> );
+}
+
+BOOST_AUTO_TEST_CASE( no_recycler ) {
+  auto obj = Gaudi::Recycling::acquire<Wrapper>( nullptr );
+  BOOST_REQUIRE( obj );
+  BOOST_CHECK( obj->getData().empty() );
+}
+
+BOOST_AUTO_TEST_CASE( recycle ) {
+  TestRecycler recycler;
+
+  auto obj = Gaudi::Recycling::acquire<Wrapper>( &recycler );
+  BOOST_REQUIRE( obj );
+  BOOST_REQUIRE( recycler.m_reset );
+  obj->getData().assign( 1000, 42 );
+  const auto  capacity = obj->getData().capacity();
+  const auto* ptr      = obj.get();
+
+  recycler.recycle( std::move( obj ) );
+
+  auto again = Gaudi::Recycling::acquire<Wrapper>( &recycler );
+  BOOST_CHECK( again.get() == ptr );
+  BOOST_CHECK( again->getData().empty() );
+  BOOST_CHECK( again->getData().capacity() == capacity );
+
+  // pool is now empty: a new instance is allocated
+  auto other = Gaudi::Recycling::acquire<Wrapper>( &recycler );
+  BOOST_CHECK( other.get() != ptr );
+}
@@ -0,0 +1,76 @@
+/***********************************************************************************\
+* (c) Copyright 2022 CERN for the benefit of the LHCb and ATLAS collaborations      *
+*                                                                                   *
+* This software is distributed under the terms of the Apache version 2 licence,     *
+* copied verbatim in the file "LICENSE".                                            *
+*                                                                                   *
+* In applying this licence, CERN does not waive the privileges and immunities       *
+* granted to it by virtue of its status as an Intergovernmental Organization        *
+* or submit itself to any jurisdiction.                                             *
+\***********************************************************************************/
+#define BOOST_TEST_DYN_LINK
+#define BOOST_TEST_MODULE test_LazyFormat
+#include <boost/test/unit_test.hpp>
+
+#include <Gaudi/LazyFormat.h>
+
+#include <string>
+
+namespace {
+  // type counting how many times it is formatted
+  struct Counted {
+    static inline int formatted = 0;
+  };
+} // namespace
+
+template <>
+struct fmt::formatter<Counted> : fmt::formatter<int> {
+  auto format( const Counted&, fmt::format_context& ctx ) const {
+    ++Counted::formatted;
+    return fmt::formatter<int>::format( 42, ctx );
+  }
+};
+
+BOOST_AUTO_TEST_CASE( active_stream ) {
+  MsgStream         log( nullptr, "Source" ); // prints INFO and above to std::cout
+  const std::string s = "text";
+  log << MSG::INFO << "<" << Gaudi::lazyFormat( "{} {} {:.2f} {}", 1, s, 0.125, Counted{} ) << ">";
+  BOOST_CHECK_EQUAL( log.stream().str(), "<1 text 0.12 42>" );
+  log << endmsg;
+}
+
+BOOST_AUTO_TEST_CASE( inactive_stream ) {
+  MsgStream log( nullptr, "Source" );
+  Counted::formatted = 0;
+  log << MSG::DEBUG << Gaudi::lazyFormat( "{}", Counted{} ) << endmsg;
+  BOOST_CHECK_EQUAL( Counted::formatted, 0 );
+  log << MSG::WARNING << Gaudi::lazyFormat( "{}", Counted{} ) << endmsg;
+  BOOST_CHECK_EQUAL( Counted::formatted, 1 );
+}
+
+BOOST_AUTO_TEST_CASE( deferred_format ) {
+  std::string s    = "text";
+  const char* cstr = "c-string";
+  auto        text = Gaudi::DeferredFormat<int, std::string, std::string>{ "{} {} {}", 1, s, cstr };
+  s                = "changed"; // the arguments are copies
+
+  alignas( std::max_align_t ) char storage[sizeof( text )];
+  BOOST_REQUIRE_LE( text.size(), sizeof( storage ) );
+  BOOST_REQUIRE_LE( text.alignment(), alignof( std::max_align_t ) );
+  Gaudi::DeferredText* moved = text.moveTo( storage );
+
+  std::string out = "<";
+  moved->formatTo( out );
+  BOOST_CHECK_EQUAL( out, "<1 text c-string" );
+  moved->~DeferredText();
+}
+
+BOOST_AUTO_TEST_CASE( report_deferred ) {
+  MsgStream log( nullptr, "Source" ); // no service able to defer: formatted by the stream
+  Counted::formatted = 0;
+  Gaudi::reportDeferred( log << MSG::DEBUG, "{}", Counted{} );
+  BOOST_CHECK_EQUAL( Counted::formatted, 0 );
+  Gaudi::reportDeferred( log << MSG::WARNING, "{} {}", Counted{}, std::string_view{ "view" } );
+  BOOST_CHECK_EQUAL( Counted::formatted, 1 );
+  BOOST_CHECK_EQUAL( log.stream().str(), "" ); // the message was reported
+}
@@ -0,0 +1,97 @@
+/***********************************************************************************\
+* (c) Copyright 2022 CERN for the benefit of the LHCb and ATLAS collaborations      *
+*                                                                                   *
+* This software is distributed under the terms of the Apache version 2 licence,     *
+* copied verbatim in the file "LICENSE".                                            *
+*                                                                                   *
+* In applying this licence, CERN does not waive the privileges and immunities       *
+* granted to it by virtue of its status as an Intergovernmental Organization        *
+* or submit itself to any jurisdiction.                                             *
+\***********************************************************************************/
+#define BOOST_TEST_DYN_LINK
+#define BOOST_TEST_MODULE test_PerThread
+#include <boost/test/unit_test.hpp>
+
+#include <Gaudi/Concurrency/PerThread.h>
+
+#include <memory>
+#include <set>
+#include <thread>
+#include <vector>
+
+using Gaudi::Concurrency::PerThread;
+
+namespace {
+  struct Local {
+    std::thread::id owner = std::this_thread::get_id();
+    int             count = 0;
+  };
+
+  std::set<std::thread::id> owners( const PerThread<Local>& objects ) {
+    std::set<std::thread::id> result;
+    objects.forEach( [&]( const Local& obj ) { result.insert( obj.owner ); } );
+    return result;
+  }
+} // namespace
+
+BOOST_AUTO_TEST_CASE( one_object_per_thread ) {
+  PerThread<Local> objects;
+  auto&            mine = objects.local();
+  BOOST_CHECK_EQUAL( &objects.local(), &mine );
+
+  constexpr int            nThreads = 4, nCalls = 1000;
+  std::vector<std::thread> threads;
+  for ( int t = 0; t != nThreads; ++t ) {
+    threads.emplace_back( [&] {
+      for ( int i = 0; i != nCalls; ++i ) ++objects.local().count;
+    } );
+  }
+  for ( auto& t : threads ) t.join();
+
+  // the objects outlive their threads
+  int total = 0, n = 0;
+  objects.forEach( [&]( const Local& obj ) {
+    total += obj.count;
+    ++n;
+  } );
+  BOOST_CHECK_EQUAL( n, nThreads + 1 );
+  BOOST_CHECK_EQUAL( total, nThreads * nCalls );
+  BOOST_CHECK_EQUAL( owners( objects ).size(), std::size_t( nThreads + 1 ) );
+}
+
+BOOST_AUTO_TEST_CASE( several_instances ) {
+  PerThread<Local> a, b;
+  // alternate, so that the cache of the last instance used is replaced at each call
+  for ( int i = 0; i != 3; ++i ) {
+    ++a.local().count;
+    b.local().count += 10;
+  }
+  BOOST_CHECK( &a.local() != &b.local() );
+  BOOST_CHECK_EQUAL( a.local().count, 3 );
+  BOOST_CHECK_EQUAL( b.local().count, 30 );
+
+  // an instance created at the address of a destroyed one does not find its objects
+  auto c = std::make_unique<PerThread<Local>>();
+  ++c->local().count;
+  c.reset();
+  c = std::make_unique<PerThread<Local>>();
+  BOOST_CHECK_EQUAL( c->local().count, 0 );
+}
+
+BOOST_AUTO_TEST_CASE( clear ) {
+  PerThread<Local> objects;
+  int              made = 0;
+  auto             make = [&] {
+    ++made;
+    return std::make_unique<Local>();
+  };
+  objects.local( make ).count = 5;
+  objects.local( make );
+  BOOST_CHECK_EQUAL( made, 1 );
+
+  objects.clear();
+  BOOST_CHECK( owners( objects ).empty() );
+  // a new object, created on the next call
+  BOOST_CHECK_EQUAL( objects.local( make ).count, 0 );
+  BOOST_CHECK_EQUAL( made, 2 );
+}
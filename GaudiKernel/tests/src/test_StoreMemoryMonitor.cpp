@@ -0,0 +1,145 @@
+/***********************************************************************************\
+* (c) Copyright 2022 CERN for the benefit of the LHCb and ATLAS collaborations      *
+*                                                                                   *
+* This software is distributed under the terms of the Apache version 2 licence,     *
+* copied verbatim in the file "LICENSE".                                            *
+*                                                                                   *
+* In applying this licence, CERN does not waive the privileges and immunities       *
+* granted to it by virtue of its status as an Intergovernmental Organization        *
+* or submit itself to any jurisdiction.                                             *
+\***********************************************************************************/
+#define BOOST_TEST_DYN_LINK
+#define BOOST_TEST_MODULE test_StoreMemoryMonitor
+#include <Gaudi/Monitoring/StoreMemoryMonitor.h>
+#include <GaudiKernel/AnyDataWrapper.h>
+#include <GaudiKernel/ContainedObject.h>
+#include <GaudiKernel/DataObject.h>
+#include <GaudiKernel/KeyedContainer.h>
+#include <GaudiKernel/KeyedObject.h>
+#include <GaudiKernel/ObjectVector.h>
+
+#include <boost/test/unit_test.hpp>
+
+#include <algorithm>
+#include <atomic>
+#include <deque>
+#include <string>
+#include <thread>
+#include <vector>
+
+// Mock code for the test
+struct MonitoringHub : Gaudi::Monitoring::Hub {};
+struct ServiceLocator {
+  MonitoringHub& monitoringHub() { return m_monitHub; }
+  MonitoringHub  m_monitHub{};
+};
+struct Algo {
+  ServiceLocator* serviceLocator() { return &m_serviceLocator; }
+  std::string     name() { return ""; }
+  ServiceLocator  m_serviceLocator{};
+};
+struct HistSink : public Gaudi::Monitoring::Hub::Sink {
+  void registerEntity( Gaudi::Monitoring::Hub::Entity ent ) override { m_entities.push_back( ent ); }
+  void removeEntity( Gaudi::Monitoring::Hub::Entity const& ent ) override {
+    auto it = std::find( begin( m_entities ), end( m_entities ), ent );
+    if ( it != m_entities.end() ) m_entities.erase( it );
+  }
+  const Gaudi::Monitoring::Hub::Entity* find( std::string const& name ) const {
+    auto it = std::find_if( begin( m_entities ), end( m_entities ), [&]( auto& e ) { return e.name == name; } );
+    return it != m_entities.end() ? &*it : nullptr;
+  }
+  std::deque<Gaudi::Monitoring::Hub::Entity> m_entities;
+};
+
+namespace {
+  struct Hit : ContainedObject {
+    double x, y, z;
+  };
+  struct Track : KeyedObject<int> {
+    double params[5];
+  };
+} // namespace
+
+BOOST_AUTO_TEST_CASE( footprints ) {
+  // types that do not know their size are not accounted for
+  BOOST_CHECK_EQUAL( DataObject{}.memoryFootprint(), 0u );
+
+  AnyDataWrapper<std::vector<double>> wrapper{ std::vector<double>( 100 ) };
+  BOOST_CHECK_EQUAL( wrapper.memoryFootprint(), sizeof( wrapper ) + wrapper.getData().capacity() * sizeof( double ) );
+
+  ObjectVector<Hit> hits;
+  for ( int i = 0; i != 10; ++i ) hits.push_back( new Hit );
+  BOOST_CHECK_EQUAL( hits.memoryFootprint(), sizeof( hits ) + hits.capacity() * sizeof( Hit* ) + 10 * sizeof( Hit ) );
+
+  KeyedContainer<Track> tracks;
+  for ( int i = 0; i != 10; ++i ) tracks.insert( new Track );
+  BOOST_CHECK( tracks.memoryFootprint() >= sizeof( tracks ) + 10 * ( sizeof( Track* ) + sizeof( Track ) ) );
+  tracks.clear();
+  BOOST_CHECK( tracks.memoryFootprint() < sizeof( tracks ) + 10 * ( sizeof( Track* ) + sizeof( Track ) ) );
+}
+
+BOOST_AUTO_TEST_CASE( record ) {
+  Algo     algo;
+  HistSink sink;
+  algo.serviceLocator()->monitoringHub().addSink( &sink );
+
+  Gaudi::Monitoring::StoreMemoryMonitor<Algo> monitor{ &algo, 1, { 10, 0., 10., "KiB" } };
+  BOOST_CHECK( monitor.sample() ); // period 1: every object
+
+  monitor.record( "Unknown", 0 ); // no size reported: ignored
+  BOOST_CHECK( !sink.find( "MemoryByPath/Unknown" ) );
+
+  monitor.record( "Hits", 2048 );
+  monitor.record( "Hits", 100 * 1024 );
+  auto byPath = sink.find( "MemoryByPath/Hits" );
+  BOOST_REQUIRE( byPath );
+  auto j = byPath->toJSON();
+  BOOST_CHECK_EQUAL( j.at( "nEntries" ).get<int>(), 2 );
+  auto bins = j.at( "bins" ).get<std::vector<int>>(); // with underflow and overflow
+  BOOST_CHECK_EQUAL( bins.at( 3 ), 1 );                // 2 KiB
+  BOOST_CHECK_EQUAL( bins.at( 11 ), 1 );               // 100 KiB
+
+  // no algorithm being executed by this thread
+  auto byAlg = sink.find( "MemoryByAlgorithm/<none>" );
+  BOOST_REQUIRE( byAlg );
+  BOOST_CHECK_EQUAL( byAlg->toJSON().at( "nEntries" ).get<int>(), 2 );
+}
+
+BOOST_AUTO_TEST_CASE( record_from_several_threads ) {
+  Algo     algo;
+  HistSink sink;
+  auto&    hub = algo.serviceLocator()->monitoringHub();
+  hub.addSink( &sink );
+
+  Gaudi::Monitoring::StoreMemoryMonitor<Algo> monitor{ &algo, 1, { 10, 0., 10., "KiB" } };
+
+  // the histograms are created by the threads filling them, while the hub takes snapshots
+  constexpr int            nThreads = 4, nPaths = 50, nRecords = 10;
+  std::atomic<bool>        done{ false };
+  std::vector<std::thread> threads;
+
+  std::thread snapshots{ [&] {
+    while ( !done ) hub.publishSnapshot();
+  } };
+  for ( int t = 0; t != nThreads; ++t ) {
+    threads.emplace_back( [&] {
+      for ( int i = 0; i != nRecords; ++i ) {
+        for ( int p = 0; p != nPaths; ++p ) monitor.record( "Path" + std::to_string( p ), 1024 );
+      }
+    } );
+  }
+  for ( auto& t : threads ) t.join();
+  done = true;
+  snapshots.join();
+
+  // one histogram per path, and one for the (absent) algorithm
+  BOOST_CHECK_EQUAL( sink.m_entities.size(), nPaths + 1u );
+  for ( int p = 0; p != nPaths; ++p ) {
+    auto byPath = sink.find( "MemoryByPath/Path" + std::to_string( p ) );
+    BOOST_REQUIRE( byPath );
+    BOOST_CHECK_EQUAL( byPath->toJSON().at( "nEntries" ).get<int>(), nThreads * nRecords );
+  }
+  auto byAlg = sink.find( "MemoryByAlgorithm/<none>" );
+  BOOST_REQUIRE( byAlg );
+  BOOST_CHECK_EQUAL( byAlg->toJSON().at( "nEntries" ).get<int>(), nThreads * nRecords * nPaths );
+}
@@ -0,0 +1,89 @@
+/***********************************************************************************\
+* (c) Copyright 2022 CERN for the benefit of the LHCb and ATLAS collaborations      *
+*                                                                                   *
+* This software is distributed under the terms of the Apache version 2 licence,     *
+* copied verbatim in the file "LICENSE".                                            *
+*                                                                                   *
+* In applying this licence, CERN does not waive the privileges and immunities       *
+* granted to it by virtue of its status as an Intergovernmental Organization        *
+* or submit itself to any jurisdiction.                                             *
+\***********************************************************************************/
+#define BOOST_TEST_DYN_LINK
+#define BOOST_TEST_MODULE test_TsDataSvcMutex
+#include <boost/test/unit_test.hpp>
+
+#include <GaudiKernel/GaudiException.h>
+#include <GaudiKernel/TsDataSvc.h>
+
+#include <atomic>
+#include <chrono>
+#include <mutex>
+#include <shared_mutex>
+#include <thread>
+
+using Gaudi::Details::TsDataSvcMutex;
+using namespace std::chrono_literals;
+
+namespace {
+  /// Run f in another thread and wait for it (a deadlock makes the test time out).
+  template <typename F>
+  void inOtherThread( F f ) {
+    std::thread{ f }.join();
+  }
+} // namespace
+
+BOOST_AUTO_TEST_CASE( exclusive_reentrance ) {
+  TsDataSvcMutex m;
+  {
+    std::scoped_lock outer{ m };
+    std::scoped_lock inner{ m };
+    std::shared_lock shared{ m }; // granted to the owner of the exclusive lock
+  }
+  // everything released
+  inOtherThread( [&] { std::scoped_lock l{ m }; } );
+}
+
+BOOST_AUTO_TEST_CASE( shared_reentrance ) {
+  TsDataSvcMutex m;
+  m.lock_shared();
+  m.lock_shared();
+  // other readers are not blocked
+  inOtherThread( [&] { std::shared_lock l{ m }; } );
+  m.unlock_shared();
+
+  // writers are blocked until the last shared lock of the thread is released
+  std::atomic<bool> writerDone{ false };
+  std::thread       writer{ [&] {
+    std::scoped_lock l{ m };
+    writerDone = true;
+  } };
+  std::this_thread::sleep_for( 50ms );
+  BOOST_CHECK( !writerDone );
+  m.unlock_shared();
+  writer.join();
+  BOOST_CHECK( writerDone );
+}
+
+BOOST_AUTO_TEST_CASE( shared_to_exclusive ) {
+  TsDataSvcMutex m;
+  {
+    std::shared_lock shared{ m };
+    BOOST_CHECK_THROW( std::scoped_lock{ m }, GaudiException );
+    // the shared lock is still held
+    std::atomic<bool> writerDone{ false };
+    std::thread       writer{ [&] {
+      std::scoped_lock l{ m };
+      writerDone = true;
+    } };
+    std::this_thread::sleep_for( 50ms );
+    BOOST_CHECK( !writerDone );
+    shared.unlock();
+    writer.join();
+    BOOST_CHECK( writerDone );
+  }
+  // and the thread can take the exclusive lock once the shared one is released
+  {
+    std::scoped_lock l{ m };
+  }
+  inOtherThread( [&] { std::scoped_lock l{ m }; } );
+}
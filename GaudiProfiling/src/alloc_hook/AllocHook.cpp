@@ -0,0 +1,78 @@
+/***********************************************************************************\
+* (c) Copyright 2022 CERN for the benefit of the LHCb and ATLAS collaborations      *
+*                                                                                   *
+* This software is distributed under the terms of the Apache version 2 licence,     *
+* copied verbatim in the file "LICENSE".                                            *
+*                                                                                   *
+* In applying this licence, CERN does not waive the privileges and immunities       *
+* granted to it by virtue of its status as an Intergovernmental Organization        *
+* or submit itself to any jurisdiction.                                             *
+\***********************************************************************************/
+#include "AllocHook.h"
+
+#include <atomic>
+#include <cerrno>
+
+// glibc implementations of the allocation functions
+extern "C" {
+void* __libc_malloc( std::size_t size );
+void* __libc_calloc( std::size_t n, std::size_t size );
+void* __libc_realloc( void* ptr, std::size_t size );
+void* __libc_memalign( std::size_t alignment, std::size_t size );
+}
+
+namespace {
+  std::atomic<GaudiAllocHookCallback> s_callback{ nullptr };
+
+  /// true while the callback runs on the thread, to ignore its own allocations
+  /// (initial-exec, so that accessing it does not allocate)
+  thread_local bool s_inCallback __attribute__( ( tls_model( "initial-exec" ) ) ) = false;
+
+  inline void notify( std::size_t size ) {
+    auto callback = s_callback.load( std::memory_order_acquire );
+    if ( callback && !s_inCallback ) {
+      s_inCallback = true;
+      callback( size );
+      s_inCallback = false;
+    }
+  }
+} // namespace
+
+extern "C" {
+void gaudi_alloc_hook_set( GaudiAllocHookCallback callback ) { s_callback.store( callback, std::memory_order_release ); }
+
+void* malloc( std::size_t size ) {
+  notify( size );
+  return __libc_malloc( size );
+}
+
+void* calloc( std::size_t n, std::size_t size ) {
+  notify( n * size );
+  return __libc_calloc( n, size );
+}
+
+void* realloc( void* ptr, std::size_t size ) {
+  notify( size );
+  return __libc_realloc( ptr, size );
+}
+
+void* memalign( std::size_t alignment, std::size_t size ) {
+  notify( size );
+  return __libc_memalign( alignment, size );
+}
+
+void* aligned_alloc( std::size_t alignment, std::size_t size ) {
+  notify( size );
+  return __libc_memalign( alignment, size );
+}
+
+int posix_memalign( void** ptr, std::size_t alignment, std::size_t size ) {
+  // same checks as glibc
+  if ( alignment % sizeof( void* ) != 0 || ( alignment & ( alignment - 1 ) ) != 0 || alignment == 0 ) return EINVAL;
+  notify( size );
+  void* p = __libc_memalign( alignment, size );
+  if ( !p ) return ENOMEM;
+  *ptr = p;
+  return 0;
+}
+}
@@ -0,0 +1,35 @@
+/***********************************************************************************\
+* (c) Copyright 2022 CERN for the benefit of the LHCb and ATLAS collaborations      *
+*                                                                                   *
+* This software is distributed under the terms of the Apache version 2 licence,     *
+* copied verbatim in the file "LICENSE".                                            *
+*                                                                                   *
+* In applying this licence, CERN does not waive the privileges and immunities       *
+* granted to it by virtue of its status as an Intergovernmental Organization        *
+* or submit itself to any jurisdiction.                                             *
+\***********************************************************************************/
+#pragma once
+/** @file AllocHook.h
+ *
+ *  Interface of the allocation hook library (libGaudiAllocHook.so).
+ *
+ *  The library, to be preloaded with LD_PRELOAD, interposes the allocation functions of the C
+ *  library (malloc, calloc, realloc, aligned_alloc, posix_memalign, memalign), hence also the
+ *  default operator new, and calls the installed callback for each allocation, on the allocating
+ *  thread, before forwarding the call to glibc.  Allocations made from the callback itself are not
+ *  reported.
+ *
+ *  As the library is optional, clients look up the function with dlsym( RTLD_DEFAULT, ... ).
+ */
+#include <cstddef>
+
+extern "C" {
+/// Function called for each allocation of `size` bytes.
+typedef void ( *GaudiAllocHookCallback )( std::size_t size );
+
+/// Install the callback (nullptr to remove it).
+void gaudi_alloc_hook_set( GaudiAllocHookCallback callback );
+}
+
+/// Name of the function to install the callback, to use with dlsym.
+#define GAUDI_ALLOC_HOOK_SET_NAME "gaudi_alloc_hook_set"
@@ -0,0 +1,312 @@
+/***********************************************************************************\
+* (c) Copyright 2022 CERN for the benefit of the LHCb and ATLAS collaborations      *
+*                                                                                   *
+* This software is distributed under the terms of the Apache version 2 licence,     *
+* copied verbatim in the file "LICENSE".                                            *
+*                                                                                   *
+* In applying this licence, CERN does not waive the privileges and immunities       *
+* granted to it by virtue of its status as an Intergovernmental Organization        *
+* or submit itself to any jurisdiction.                                             *
+\***********************************************************************************/
+#include "AllocHook.h"
+
+#include <Gaudi/Concurrency/PerThread.h>
+#include <GaudiKernel/Auditor.h>
+#include <GaudiKernel/INamedInterface.h>
+#include <GaudiKernel/MsgStream.h>
+#include <GaudiKernel/System.h>
+
+#include <dlfcn.h>
+
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <cmath>
+#include <cstdint>
+#include <iomanip>
+#include <map>
+#include <memory>
+#include <sstream>
+#include <string>
+#include <string_view>
+#include <vector>
+
+/** Auditor measuring the heap allocations (number, bytes and sizes) made by each algorithm during
+ *  its execution, and optionally the call sites responsible for them.
+ *
+ *  The allocations are intercepted by the library libGaudiAllocHook.so, which must be preloaded
+ *  (LD_PRELOAD=libGaudiAllocHook.so gaudirun.py ...): without it the auditor only prints a warning.
+ *
+ *  Each allocation is attributed to the innermost algorithm being executed on the thread (counts
+ *  are exclusive: the allocations of the members of a sequencer are not counted for the
+ *  sequencer).  All the bookkeeping is done in per-thread tables, merged at finalize.
+ *
+ *  If SamplingPeriod is not 0, only a sample of the allocations is looked at, on average one per
+ *  SamplingPeriod bytes allocated, and the totals are estimated from them.  For the sampled
+ *  allocations the call stack is recorded (CallSiteDepth frames) to report the call sites
+ *  responsible for most of the allocated bytes.
+ */
+class AllocationAuditor : public Auditor {
+public:
+  using Auditor::Auditor;
+
+  StatusCode initialize() override;
+  StatusCode finalize() override;
+
+  using Auditor::before; // avoid hiding base-class methods
+  void before( StandardEventType evt, INamedInterface* caller ) override;
+  using Auditor::after; // avoid hiding base-class methods
+  void after( StandardEventType evt, INamedInterface* caller, const StatusCode& sc ) override;
+
+private:
+  /// size classes of the histogram of allocation sizes: [0, 1], (1, 2], (2, 4] ... (2^(n-2), inf)
+  static constexpr std::size_t s_nSizeClasses = 32;
+
+  /// Allocation statistics of an algorithm in a thread (estimated values if sampling).
+  struct AllocStats {
+    std::uint64_t                      executions = 0;
+    double                             count      = 0;
+    double                             bytes      = 0;
+    std::array<double, s_nSizeClasses> sizes{};
+
+    void        add( std::size_t size, double weight );
+    AllocStats& operator+=( const AllocStats& other );
+  };
+  /// Allocations from a call site.
+  struct SiteStats {
+    double count = 0;
+    double bytes = 0;
+  };
+  using CallStack = std::vector<void*>;
+
+  /// Per-thread bookkeeping.
+  struct ThreadState {
+    /// statistics per algorithm
+    std::map<std::string, AllocStats, std::less<>> algs;
+    /// algorithms being executed (innermost last)
+    std::vector<AllocStats*> stack;
+    /// statistics of the sampled call sites
+    std::map<CallStack, SiteStats> sites;
+    /// bytes still to be allocated before the next sample
+    double untilSample = 0;
+    /// state of the random generator of the sampling
+    std::uint64_t random = 0x9e3779b97f4a7c15;
+  };
+
+  /// The callback installed in the allocation hook.
+  static void onAllocation( std::size_t size );
+  /// Bookkeeping of an allocation on the current thread.
+  void record( ThreadState& state, std::size_t size );
+  /// Number of bytes until the next sample (exponentially distributed, for unbiased estimates).
+  double nextSample( ThreadState& state ) const;
+  /// State of the current thread, created the first time it is needed.
+  ThreadState& threadState();
+
+  Gaudi::Property<std::size_t> m_samplingPeriod{
+      this, "SamplingPeriod", 0,
+      "if not 0, look only at one allocation every SamplingPeriod bytes on average (and record its call site)" };
+  Gaudi::Property<int>         m_callSiteDepth{ this, "CallSiteDepth", 8, "number of stack frames of the call sites" };
+  Gaudi::Property<std::size_t> m_nTop{ this, "NTop", 20, "number of algorithms and call sites in the reports" };
+
+  /// the hook installation function, if the hook library is loaded
+  void ( *m_setHook )( GaudiAllocHookCallback ) = nullptr;
+
+  /// states of all the threads, merged at finalize
+  Gaudi::Concurrency::PerThread<ThreadState> m_threads;
+
+  /// the instance receiving the allocations (only one can be active at a time)
+  inline static std::atomic<AllocationAuditor*> s_active{ nullptr };
+  /// state of the current thread for the active instance, nullptr if no algorithm is running
+  inline static thread_local ThreadState* t_running = nullptr;
+};
+
+DECLARE_COMPONENT( AllocationAuditor )
+
+void AllocationAuditor::AllocStats::add( std::size_t size, double weight ) {
+  count += weight;
+  bytes += weight * size;
+  const std::size_t sizeClass = size > 1 ? 64 - __builtin_clzll( size - 1 ) : 0;
+  sizes[std::min( sizeClass, s_nSizeClasses - 1 )] += weight;
+}
+
+AllocationAuditor::AllocStats& AllocationAuditor::AllocStats::operator+=( const AllocStats& other ) {
+  executions += other.executions;
+  count += other.count;
+  bytes += other.bytes;
+  for ( std::size_t i = 0; i < s_nSizeClasses; ++i ) sizes[i] += other.sizes[i];
+  return *this;
+}
+
+StatusCode AllocationAuditor::initialize() {
+  return Auditor::initialize().andThen( [&]() -> StatusCode {
+    m_setHook = reinterpret_cast<decltype( m_setHook )>( dlsym( RTLD_DEFAULT, GAUDI_ALLOC_HOOK_SET_NAME ) );
+    if ( !m_setHook ) {
+      warning() << "libGaudiAllocHook.so is not preloaded: the allocations will not be recorded" << endmsg;
+      return StatusCode::SUCCESS;
+    }
+    AllocationAuditor* expected = nullptr;
+    if ( !s_active.compare_exchange_strong( expected, this ) ) {
+      error() << "only one instance of AllocationAuditor can be active" << endmsg;
+      return StatusCode::FAILURE;
+    }
+    m_setHook( &AllocationAuditor::onAllocation );
+    return StatusCode::SUCCESS;
+  } );
+}
+
+StatusCode AllocationAuditor::finalize() {
+  if ( s_active.load() != this ) return Auditor::finalize();
+  m_setHook( nullptr );
+  s_active = nullptr;
+
+  // merge the statistics of all the threads
+  std::map<std::string_view, AllocStats> algs;
+  std::map<CallStack, SiteStats>         sites;
+  m_threads.forEach( [&]( const ThreadState& state ) {
+    for ( const auto& [alg, stats] : state.algs ) algs[alg] += stats;
+    for ( const auto& [stack, stats] : state.sites ) {
+      auto& total = sites[stack];
+      total.count += stats.count;
+      total.bytes += stats.bytes;
+    }
+  } );
+
+  std::vector<std::pair<std::string_view, const AllocStats*>> sortedAlgs;
+  for ( const auto& [alg, stats] : algs ) sortedAlgs.emplace_back( alg, &stats );
+  std::stable_sort( sortedAlgs.begin(), sortedAlgs.end(),
+                    []( const auto& a, const auto& b ) { return a.second->bytes > b.second->bytes; } );
+  if ( sortedAlgs.size() > m_nTop ) sortedAlgs.resize( m_nTop );
+
+  if ( !sortedAlgs.empty() ) {
+    std::size_t width = 9;
+    for ( const auto& alg : sortedAlgs ) width = std::max( width, alg.first.size() );
+    // coarser size classes for the printout
+    constexpr std::array<std::size_t, 6>      limits{ 16, 64, 256, 1024, 4096, 65536 };
+    constexpr std::array<std::string_view, 7> labels{ "<=16", "<=64", "<=256", "<=1k", "<=4k", "<=64k", ">64k" };
+
+    std::ostringstream out;
+    out << std::left << std::setw( width ) << "Algorithm" << std::right << std::setw( 11 ) << "Calls"
+        << std::setw( 12 ) << "Allocs/call" << std::setw( 12 ) << "Bytes/call" << std::setw( 14 ) << "Total bytes";
+    for ( const auto label : labels ) out << std::setw( 7 ) << label;
+    for ( const auto& [alg, stats] : sortedAlgs ) {
+      const double calls = std::max<double>( stats->executions, 1 );
+      out << '\n'
+          << std::left << std::setw( width ) << alg << std::right << std::setw( 11 ) << stats->executions
+          << std::fixed << std::setprecision( 1 ) << std::setw( 12 ) << stats->count / calls << std::setw( 12 )
+          << stats->bytes / calls << std::setprecision( 0 ) << std::setw( 14 ) << stats->bytes;
+      std::size_t sizeClass = 0;
+      for ( std::size_t i = 0; i < labels.size(); ++i ) {
+        double n = 0;
+        for ( ; sizeClass < s_nSizeClasses && ( i == limits.size() || ( 1ull << sizeClass ) <= limits[i] );
+              ++sizeClass ) {
+          n += stats->sizes[sizeClass];
+        }
+        out << std::setw( 7 ) << ( stats->count > 0 ? 100 * n / stats->count : 0. );
+      }
+    }
+    info() << "Heap allocations per algorithm, with the distribution of sizes in %"
+           << ( m_samplingPeriod > 0 ? " (estimated from sampled allocations)" : "" ) << ":\n"
+           << out.str() << endmsg;
+  }
+
+  std::vector<std::pair<const CallStack*, SiteStats>> sortedSites;
+  for ( const auto& [stack, stats] : sites ) sortedSites.emplace_back( &stack, stats );
+  std::stable_sort( sortedSites.begin(), sortedSites.end(),
+                    []( const auto& a, const auto& b ) { return a.second.bytes > b.second.bytes; } );
+  if ( sortedSites.size() > m_nTop ) sortedSites.resize( m_nTop );
+
+  if ( !sortedSites.empty() ) {
+    std::ostringstream out;
+    out << std::fixed << std::setprecision( 0 );
+    for ( const auto& [stack, stats] : sortedSites ) {
+      out << "\n-- " << stats.bytes << " bytes in " << stats.count << " allocations from:";
+      bool inAllocator = true;
+      for ( void* frame : *stack ) {
+        void*       addr = nullptr;
+        std::string fnc, lib;
+        if ( !System::getStackLevel( frame, addr, fnc, lib ) ) {
+          fnc = "??";
+          lib = "??";
+        }
+        // skip the frames of the allocation functions
+        if ( inAllocator && ( fnc.rfind( "operator new", 0 ) == 0 || fnc == "malloc" || fnc == "calloc" ||
+                              fnc == "realloc" || fnc == "aligned_alloc" || fnc == "posix_memalign" ) ) {
+          continue;
+        }
+        inAllocator = false;
+        out << "\n     " << fnc << "  [" << lib.substr( lib.rfind( '/' ) + 1 ) << "]";
+      }
+    }
+    info() << "Top call sites of the sampled allocations:" << out.str() << endmsg;
+  }
+
+  return Auditor::finalize();
+}
+
+AllocationAuditor::ThreadState& AllocationAuditor::threadState() {
+  return m_threads.local( [this] {
+    auto state = std::make_unique<ThreadState>();
+    // different random sequences in different threads
+    state->random ^= reinterpret_cast<std::uintptr_t>( state.get() );
+    state->untilSample = nextSample( *state );
+    return state;
+  } );
+}
+
+double AllocationAuditor::nextSample( ThreadState& state ) const {
+  // xorshift64* generator
+  state.random ^= state.random >> 12;
+  state.random ^= state.random << 25;
+  state.random ^= state.random >> 27;
+  const double uniform = ( ( state.random * 0x2545f4914f6cdd1dull ) >> 11 ) * 0x1.0p-53;
+  return -std::log1p( -uniform ) * m_samplingPeriod;
+}
+
+void AllocationAuditor::before( StandardEventType evt, INamedInterface* caller ) {
+  if ( evt != IAuditor::Execute || s_active.load( std::memory_order_relaxed ) != this ) return;
+  auto& state = threadState();
+  auto  it    = state.algs.find( caller->name() );
+  if ( it == state.algs.end() ) it = state.algs.emplace( caller->name(), AllocStats{} ).first;
+  ++it->second.executions;
+  state.stack.push_back( &it->second );
+  t_running = &state;
+}
+
+void AllocationAuditor::after( StandardEventType evt, INamedInterface*, const StatusCode& ) {
+  if ( evt != IAuditor::Execute || s_active.load( std::memory_order_relaxed ) != this ) return;
+  auto& state = threadState();
+  if ( !state.stack.empty() ) state.stack.pop_back();
+  if ( state.stack.empty() ) t_running = nullptr;
+}
+
+void AllocationAuditor::onAllocation( std::size_t size ) {
+  if ( auto state = t_running ) {
+    if ( auto self = s_active.load( std::memory_order_relaxed ) ) self->record( *state, size );
+  }
+}
+
+void AllocationAuditor::record( ThreadState& state, std::size_t size ) {
+  if ( m_samplingPeriod.value() == 0 ) {
+    state.stack.back()->add( size, 1 );
+    return;
+  }
+  state.untilSample -= size;
+  if ( state.untilSample > 0 ) return;
+  state.untilSample = nextSample( state );
+
+  // the allocation had a probability 1 - exp( -size / period ) to be sampled
+  const double weight = 1 / -std::expm1( -double( size ) / m_samplingPeriod );
+  state.stack.back()->add( size, weight );
+
+  if ( m_callSiteDepth > 0 ) {
+    // skip this function, onAllocation and the hook
+    constexpr int skip = 3;
+    void*         frames[skip + 64];
+    const int     depth = System::backTrace( frames, skip + std::min( m_callSiteDepth.value(), 64 ) );
+    if ( depth > skip ) {
+      auto& site = state.sites[CallStack( frames + skip, frames + depth )];
+      site.count += weight;
+      site.bytes += weight * size;
+    }
+  }
+}
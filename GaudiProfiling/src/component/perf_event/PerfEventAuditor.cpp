@@ -0,0 +1,272 @@
+/***********************************************************************************\
+* (c) Copyright 2022 CERN for the benefit of the LHCb and ATLAS collaborations      *
+*                                                                                   *
+* This software is distributed under the terms of the Apache version 2 licence,     *
+* copied verbatim in the file "LICENSE".                                            *
+*                                                                                   *
+* In applying this licence, CERN does not waive the privileges and immunities       *
+* granted to it by virtue of its status as an Intergovernmental Organization        *
+* or submit itself to any jurisdiction.                                             *
+\***********************************************************************************/
+#include <Gaudi/Accumulators.h>
+#include <Gaudi/Concurrency/PerThread.h>
+#include <GaudiKernel/Auditor.h>
+#include <GaudiKernel/INamedInterface.h>
+#include <GaudiKernel/MsgStream.h>
+
+#include <linux/perf_event.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+
+#include <algorithm>
+#include <atomic>
+#include <cerrno>
+#include <cstdint>
+#include <cstring>
+#include <deque>
+#include <iomanip>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <shared_mutex>
+#include <sstream>
+#include <string>
+#include <string_view>
+#include <vector>
+
+namespace {
+  /// Names of the generic events of perf_event_open (type and config), as used by the perf tool.
+  const std::map<std::string_view, std::pair<std::uint32_t, std::uint64_t>> s_genericEvents{
+      { "cycles", { PERF_TYPE_HARDWARE, PERF_COUNT_HW_CPU_CYCLES } },
+      { "instructions", { PERF_TYPE_HARDWARE, PERF_COUNT_HW_INSTRUCTIONS } },
+      { "cache-references", { PERF_TYPE_HARDWARE, PERF_COUNT_HW_CACHE_REFERENCES } },
+      { "cache-misses", { PERF_TYPE_HARDWARE, PERF_COUNT_HW_CACHE_MISSES } },
+      { "branch-instructions", { PERF_TYPE_HARDWARE, PERF_COUNT_HW_BRANCH_INSTRUCTIONS } },
+      { "branch-misses", { PERF_TYPE_HARDWARE, PERF_COUNT_HW_BRANCH_MISSES } },
+      { "bus-cycles", { PERF_TYPE_HARDWARE, PERF_COUNT_HW_BUS_CYCLES } },
+      { "stalled-cycles-frontend", { PERF_TYPE_HARDWARE, PERF_COUNT_HW_STALLED_CYCLES_FRONTEND } },
+      { "stalled-cycles-backend", { PERF_TYPE_HARDWARE, PERF_COUNT_HW_STALLED_CYCLES_BACKEND } },
+      { "ref-cycles", { PERF_TYPE_HARDWARE, PERF_COUNT_HW_REF_CPU_CYCLES } },
+      { "task-clock", { PERF_TYPE_SOFTWARE, PERF_COUNT_SW_TASK_CLOCK } },
+      { "page-faults", { PERF_TYPE_SOFTWARE, PERF_COUNT_SW_PAGE_FAULTS } },
+      { "context-switches", { PERF_TYPE_SOFTWARE, PERF_COUNT_SW_CONTEXT_SWITCHES } },
+      { "cpu-migrations", { PERF_TYPE_SOFTWARE, PERF_COUNT_SW_CPU_MIGRATIONS } } };
+
+  /// No wrapper for perf_event_open is provided by glibc.
+  int perf_event_open( perf_event_attr* attr, pid_t pid, int cpu, int group_fd, unsigned long flags ) {
+    return static_cast<int>( syscall( SYS_perf_event_open, attr, pid, cpu, group_fd, flags ) );
+  }
+} // namespace
+
+/** Auditor measuring hardware performance counters (cycles, instructions, cache and branch misses...)
+ *  for each algorithm execution, using directly the Linux perf_event_open interface.
+ *
+ *  Each thread opens (on its first audited execution) its own group of counters, restricted to
+ *  itself, so the counts are correctly attributed to the algorithms in multi-threaded jobs.  The
+ *  counts are inclusive (a sequencer includes its members) and are scaled when the kernel has to
+ *  multiplex the counters.  The results are accumulated in one counter per algorithm and event,
+ *  published via the monitoring hub, and summarized in a table at finalize.
+ *
+ *  The events are the generic events known to `perf list` (e.g. "cycles", "instructions",
+ *  "page-faults") or raw events in the form "r<hex code>".
+ *
+ *  Note that the counters are not accessible if /proc/sys/kernel/perf_event_paranoid is too
+ *  restrictive (> 2, or > 1 if ExcludeKernel is False), in which case the auditor only prints a
+ *  warning.
+ */
+class PerfEventAuditor : public Auditor {
+public:
+  using Auditor::Auditor;
+
+  StatusCode initialize() override;
+  StatusCode finalize() override;
+
+  using Auditor::before; // avoid hiding base-class methods
+  void before( StandardEventType evt, INamedInterface* caller ) override;
+  using Auditor::after; // avoid hiding base-class methods
+  void after( StandardEventType evt, INamedInterface* caller, const StatusCode& sc ) override;
+
+private:
+  using Counter = Gaudi::Accumulators::AveragingCounter<double, Gaudi::Accumulators::atomicity::sharded>;
+
+  /// Group of counters of one thread, with the counts at the start of the executions in progress.
+  struct ThreadGroup {
+    ~ThreadGroup() {
+      for ( int fd : fds ) close( fd );
+    }
+    /// file descriptors of the events (the first one is the group leader), empty if not available
+    std::vector<int> fds;
+    /// stack of the values read at the start of the executions (see readGroup)
+    std::vector<std::uint64_t> starts;
+    /// values read at the end of an execution
+    std::vector<std::uint64_t> current;
+  };
+
+  /// Group of counters of the current thread, opened the first time it is needed.
+  ThreadGroup& threadGroup();
+  /// Read all the counters of the group in `values`: number of events, time enabled, time running, event counts.
+  bool readGroup( const ThreadGroup& group, std::uint64_t* values ) const;
+  /// Counters of an algorithm (one per event), created the first time it is needed.
+  std::deque<Counter>& algCounters( const std::string& alg );
+
+  Gaudi::Property<std::vector<std::string>> m_events{
+      this,
+      "Events",
+      { "cycles", "instructions", "cache-misses", "branch-misses" },
+      "perf events to count: generic event names (see 'perf list') or raw events as 'r<hex code>'" };
+  Gaudi::Property<bool> m_excludeKernel{ this, "ExcludeKernel", true, "do not count the events in kernel mode" };
+
+  /// type and config of the perf events
+  std::vector<std::pair<std::uint32_t, std::uint64_t>> m_eventConfigs;
+
+  /// counters per algorithm
+  std::map<std::string, std::unique_ptr<std::deque<Counter>>, std::less<>> m_algCounters;
+  std::shared_mutex                                                        m_algCountersMutex;
+
+  /// to print the warning about inaccessible counters only once
+  std::atomic_flag m_openFailureReported = ATOMIC_FLAG_INIT;
+
+  /// groups of counters of the threads, closed at finalize
+  Gaudi::Concurrency::PerThread<ThreadGroup> m_groups;
+};
+
+DECLARE_COMPONENT( PerfEventAuditor )
+
+StatusCode PerfEventAuditor::initialize() {
+  return Auditor::initialize().andThen( [&]() -> StatusCode {
+    m_eventConfigs.clear();
+    for ( const auto& event : m_events ) {
+      if ( auto it = s_genericEvents.find( event ); it != s_genericEvents.end() ) {
+        m_eventConfigs.push_back( it->second );
+      } else if ( event.size() > 1 && event[0] == 'r' &&
+                  event.find_first_not_of( "0123456789abcdefABCDEF", 1 ) == std::string::npos ) {
+        m_eventConfigs.emplace_back( PERF_TYPE_RAW, std::stoull( event.substr( 1 ), nullptr, 16 ) );
+      } else {
+        error() << "unknown perf event '" << event << "'" << endmsg;
+        return StatusCode::FAILURE;
+      }
+    }
+    if ( m_eventConfigs.empty() ) {
+      error() << "no perf event requested" << endmsg;
+      return StatusCode::FAILURE;
+    }
+    return StatusCode::SUCCESS;
+  } );
+}
+
+StatusCode PerfEventAuditor::finalize() {
+  std::vector<std::pair<const std::string*, const std::deque<Counter>*>> algs;
+  {
+    auto lock = std::shared_lock{ m_algCountersMutex };
+    for ( const auto& [alg, counters] : m_algCounters ) algs.emplace_back( &alg, counters.get() );
+  }
+  if ( !algs.empty() ) {
+    // most expensive algorithms first (the first event is usually "cycles")
+    std::stable_sort( algs.begin(), algs.end(), []( const auto& a, const auto& b ) {
+      return a.second->front().sum() > b.second->front().sum();
+    } );
+
+    const auto& events = m_events.value();
+    const auto  cycles = std::find( events.begin(), events.end(), "cycles" ) - events.begin();
+    const auto  instrs = std::find( events.begin(), events.end(), "instructions" ) - events.begin();
+    const bool  hasIPC = cycles < std::ssize( events ) && instrs < std::ssize( events );
+
+    std::size_t width = 9;
+    for ( const auto& alg : algs ) width = std::max( width, alg.first->size() );
+    std::ostringstream out;
+    out << std::left << std::setw( width ) << "Algorithm" << std::right << ' ' << std::setw( 10 ) << "Calls";
+    for ( const auto& event : events ) out << ' ' << std::setw( std::max<std::size_t>( event.size(), 14 ) ) << event;
+    if ( hasIPC ) out << ' ' << std::setw( 6 ) << "IPC";
+    for ( const auto& [alg, counters] : algs ) {
+      out << '\n' << std::left << std::setw( width ) << *alg << std::right << ' ' << std::setw( 10 )
+          << counters->front().nEntries() << std::fixed << std::setprecision( 0 );
+      for ( std::size_t i = 0; i < counters->size(); ++i ) {
+        out << ' ' << std::setw( std::max<std::size_t>( events[i].size(), 14 ) ) << ( *counters )[i].mean();
+      }
+      if ( hasIPC ) {
+        const double c = ( *counters )[cycles].sum();
+        out << ' ' << std::setw( 6 ) << std::setprecision( 2 ) << ( c > 0 ? ( *counters )[instrs].sum() / c : 0. );
+      }
+    }
+    info() << "Mean hardware counts per algorithm execution (inclusive):\n" << out.str() << endmsg;
+  }
+  m_groups.clear(); // the threads may live longer than the auditor
+  return Auditor::finalize();
+}
+
+PerfEventAuditor::ThreadGroup& PerfEventAuditor::threadGroup() {
+  return m_groups.local( [this] {
+    auto group = std::make_unique<ThreadGroup>();
+    for ( const auto& [type, config] : m_eventConfigs ) {
+      perf_event_attr attr{};
+      attr.size           = sizeof( attr );
+      attr.type           = type;
+      attr.config         = config;
+      attr.exclude_kernel = m_excludeKernel;
+      attr.exclude_hv     = 1;
+      attr.read_format    = PERF_FORMAT_GROUP | PERF_FORMAT_TOTAL_TIME_ENABLED | PERF_FORMAT_TOTAL_TIME_RUNNING;
+      // only the current thread, on any CPU
+      const int fd = perf_event_open( &attr, 0, -1, group->fds.empty() ? -1 : group->fds.front(), 0 );
+      if ( fd < 0 ) {
+        if ( !m_openFailureReported.test_and_set() ) {
+          warning() << "cannot open the perf events (" << std::strerror( errno )
+                    << "), check /proc/sys/kernel/perf_event_paranoid: the hardware counters will not be available"
+                    << endmsg;
+        }
+        for ( int f : group->fds ) close( f );
+        group->fds.clear();
+        break;
+      }
+      group->fds.push_back( fd );
+    }
+    group->current.resize( m_eventConfigs.size() + 3 );
+    return group;
+  } );
+}
+
+bool PerfEventAuditor::readGroup( const ThreadGroup& group, std::uint64_t* values ) const {
+  if ( group.fds.empty() ) return false;
+  const auto size = static_cast<ssize_t>( ( m_eventConfigs.size() + 3 ) * sizeof( std::uint64_t ) );
+  return ::read( group.fds.front(), values, size ) == size;
+}
+
+std::deque<PerfEventAuditor::Counter>& PerfEventAuditor::algCounters( const std::string& alg ) {
+  {
+    auto lock = std::shared_lock{ m_algCountersMutex };
+    if ( auto it = m_algCounters.find( alg ); it != m_algCounters.end() ) return *it->second;
+  }
+  auto  lock     = std::unique_lock{ m_algCountersMutex };
+  auto& counters = m_algCounters[alg];
+  if ( !counters ) {
+    counters = std::make_unique<std::deque<Counter>>();
+    for ( const auto& event : m_events.value() ) counters->emplace_back( this, alg + "/" + event );
+  }
+  return *counters;
+}
+
+void PerfEventAuditor::before( StandardEventType evt, INamedInterface* ) {
+  if ( evt != IAuditor::Execute ) return;
+  auto&      group = threadGroup();
+  const auto n     = m_eventConfigs.size() + 3;
+  group.starts.resize( group.starts.size() + n );
+  auto start = group.starts.data() + group.starts.size() - n;
+  // the number of events (first value) is left to 0 if the counters cannot be read
+  if ( !readGroup( group, start ) ) start[0] = 0;
+}
+
+void PerfEventAuditor::after( StandardEventType evt, INamedInterface* caller, const StatusCode& ) {
+  if ( evt != IAuditor::Execute ) return;
+  auto&      group = threadGroup();
+  const auto n     = m_eventConfigs.size() + 3;
+  if ( group.starts.size() < n ) return; // unbalanced before/after
+  auto&      end   = group.current;
+  const bool valid = readGroup( group, end.data() );
+  const auto start = group.starts.data() + group.starts.size() - n;
+  // time enabled and running differ if the kernel had to multiplex the counters
+  if ( valid && start[0] != 0 && end[2] > start[2] ) {
+    const double scale    = double( end[1] - start[1] ) / double( end[2] - start[2] );
+    auto&        counters = algCounters( caller->name() );
+    for ( std::size_t i = 0; i < counters.size(); ++i ) counters[i] += scale * double( end[i + 3] - start[i + 3] );
+  }
+  group.starts.resize( group.starts.size() - n );
+}
@@ -0,0 +1,366 @@
+/***********************************************************************************\
+* (c) Copyright 2022 CERN for the benefit of the LHCb and ATLAS collaborations      *
+*                                                                                   *
+* This software is distributed under the terms of the Apache version 2 licence,     *
+* copied verbatim in the file "LICENSE".                                            *
+*                                                                                   *
+* In applying this licence, CERN does not waive the privileges and immunities       *
+* granted to it by virtue of its status as an Intergovernmental Organization        *
+* or submit itself to any jurisdiction.                                             *
+\***********************************************************************************/
+#include <Gaudi/Concurrency/PerThread.h>
+#include <GaudiKernel/Auditor.h>
+#include <GaudiKernel/INamedInterface.h>
+#include <GaudiKernel/MsgStream.h>
+#include <GaudiKernel/System.h>
+#include <GaudiKernel/ThreadLocalContext.h>
+
+#include <signal.h>
+#include <sys/syscall.h>
+#include <time.h>
+#include <unistd.h>
+
+#include <algorithm>
+#include <atomic>
+#include <cerrno>
+#include <cstdint>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <iomanip>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <sstream>
+#include <string>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+/** Statistical profiler attributing the samples to the algorithms being executed.
+ *
+ *  Each thread executing algorithms gets (at its first audited execution) a timer on its own CPU
+ *  time, sending SIGPROF every 1/Frequency seconds of CPU.  The signal handler records the call
+ *  stack of the thread, the innermost algorithm being executed and its event slot in a lock-free
+ *  ring buffer of the thread, which is drained by the thread itself after the executions, so
+ *  that the profiler does not need any external library and is not confused by the threads.
+ *
+ *  At finalize the aggregated stacks are written in the "folded" format of FlameGraph
+ *  (https://github.com/brendangregg/FlameGraph): one file per algorithm in OutputDirectory, and
+ *  all.folded with the algorithm name as root frame, and a summary of the samples per algorithm
+ *  and per slot is printed.
+ */
+class SamplingProfiler : public Auditor {
+public:
+  using Auditor::Auditor;
+
+  StatusCode initialize() override;
+  StatusCode finalize() override;
+
+  using Auditor::before; // avoid hiding base-class methods
+  void before( StandardEventType evt, INamedInterface* caller ) override;
+  using Auditor::after; // avoid hiding base-class methods
+  void after( StandardEventType evt, INamedInterface* caller, const StatusCode& sc ) override;
+
+private:
+  static constexpr int s_maxDepth = 64;
+  /// frames of System::backTrace, of the signal handler and of the signal trampoline
+  static constexpr int s_skipFrames = 3;
+
+  /// A sample, written by the signal handler.
+  struct Sample {
+    std::uint32_t alg; ///< id of the algorithm + 1, 0 if none
+    std::uint32_t slot;
+    int           depth;
+    void*         frames[s_maxDepth + s_skipFrames];
+  };
+  using CallStack = std::vector<void*>;
+
+  /// Sampling state of a thread.
+  struct ThreadSampler {
+    ThreadSampler( std::size_t size ) : samples{ std::make_unique<Sample[]>( size ) }, mask{ size - 1 } {}
+
+    /// ring buffer of the samples (written by the signal handler, read by drain)
+    std::unique_ptr<Sample[]>  samples;
+    const std::size_t          mask;
+    std::atomic<std::uint64_t> head{ 0 }, tail{ 0 }, dropped{ 0 };
+
+    /// algorithm (id + 1) and slot being executed, read by the signal handler
+    std::atomic<std::uint32_t> current{ 0 }, slot{ 0 };
+    /// outer algorithms and slots, to restore current and slot
+    std::vector<std::pair<std::uint32_t, std::uint32_t>> stack;
+    /// cache of the algorithm ids
+    std::unordered_map<const INamedInterface*, std::uint32_t> ids;
+
+    /// samples per (algorithm, call stack from the root)
+    std::map<std::pair<std::uint32_t, CallStack>, std::uint64_t> folded;
+    /// samples per slot
+    std::map<std::uint32_t, std::uint64_t> perSlot;
+
+    /// CPU time timer of the thread
+    timer_t timer{};
+    bool    hasTimer = false;
+  };
+
+  /// The SIGPROF handler.
+  static void onSignal( int, siginfo_t*, void* );
+  /// Move the samples in the ring buffer to the aggregated stacks.
+  void drain( ThreadSampler& sampler );
+  /// Sampler of the current thread, created (with its timer) the first time it is needed.
+  ThreadSampler& threadSampler();
+  /// Identifier of an algorithm name (+ 1).
+  std::uint32_t algorithmId( const std::string& name );
+
+  Gaudi::Property<double>       m_frequency{ this, "Frequency", 100, "samples per second of CPU time of each thread" };
+  Gaudi::Property<int>          m_depth{ this, "StackDepth", 48, "maximum number of frames of the samples (<= 64)" };
+  Gaudi::Property<unsigned int> m_bufferSize{ this, "BufferSize", 1024,
+                                              "size of the ring buffer of samples of each thread (power of 2)" };
+  Gaudi::Property<std::string>  m_outputDir{ this, "OutputDirectory", "sampling_profile",
+                                            "directory for the folded stacks files" };
+
+  Gaudi::Concurrency::PerThread<ThreadSampler> m_samplers;
+
+  std::vector<std::string>                       m_algorithms;
+  std::unordered_map<std::string, std::uint32_t> m_algorithmIds;
+  std::mutex                                     m_algorithmsMutex;
+
+  struct sigaction m_oldAction {};
+  int              m_frames = 0;
+
+  /// the instance receiving the signals (only one can be active at a time)
+  inline static std::atomic<SamplingProfiler*> s_active{ nullptr };
+  /// sampler of the current thread for the active instance, read by the signal handler
+  inline static thread_local ThreadSampler* t_sampler = nullptr;
+};
+
+DECLARE_COMPONENT( SamplingProfiler )
+
+StatusCode SamplingProfiler::initialize() {
+  return Auditor::initialize().andThen( [&]() -> StatusCode {
+    if ( m_frequency <= 0 ) {
+      error() << "invalid Frequency " << m_frequency.value() << endmsg;
+      return StatusCode::FAILURE;
+    }
+    SamplingProfiler* expected = nullptr;
+    if ( !s_active.compare_exchange_strong( expected, this ) ) {
+      error() << "only one instance of SamplingProfiler can be active" << endmsg;
+      return StatusCode::FAILURE;
+    }
+    m_frames = std::clamp( m_depth.value(), 1, s_maxDepth ) + s_skipFrames;
+
+    // the first call of backtrace may allocate (loading libgcc_s), it must not happen in the handler
+    void* frames[4];
+    System::backTrace( frames, 4 );
+
+    struct sigaction action {};
+    action.sa_sigaction = &SamplingProfiler::onSignal;
+    action.sa_flags     = SA_SIGINFO | SA_RESTART;
+    sigemptyset( &action.sa_mask );
+    if ( sigaction( SIGPROF, &action, &m_oldAction ) != 0 ) {
+      s_active = nullptr;
+      error() << "cannot install the SIGPROF handler: " << std::strerror( errno ) << endmsg;
+      return StatusCode::FAILURE;
+    }
+    return StatusCode::SUCCESS;
+  } );
+}
+
+StatusCode SamplingProfiler::finalize() {
+  if ( s_active.load() != this ) return Auditor::finalize();
+
+  m_samplers.forEach( []( ThreadSampler& sampler ) {
+    if ( sampler.hasTimer ) timer_delete( sampler.timer );
+    sampler.hasTimer = false;
+  } );
+  // a signal could still be pending: ignore it rather than getting the default action (termination)
+  if ( m_oldAction.sa_handler == SIG_DFL ) m_oldAction.sa_handler = SIG_IGN;
+  sigaction( SIGPROF, &m_oldAction, nullptr );
+  s_active = nullptr;
+  std::uint64_t dropped = 0;
+  m_samplers.forEach( [&]( ThreadSampler& sampler ) {
+    drain( sampler );
+    dropped += sampler.dropped.load();
+  } );
+  if ( dropped > 0 ) warning() << dropped << " samples lost, consider increasing BufferSize" << endmsg;
+
+  // merge the samples of all the threads
+  std::map<std::pair<std::uint32_t, CallStack>, std::uint64_t> folded;
+  std::map<std::uint32_t, std::uint64_t>                       perAlg, perSlot;
+  std::uint64_t                                                total = 0;
+  m_samplers.forEach( [&]( const ThreadSampler& sampler ) {
+    for ( const auto& [key, n] : sampler.folded ) {
+      folded[key] += n;
+      perAlg[key.first] += n;
+      total += n;
+    }
+    for ( const auto& [slot, n] : sampler.perSlot ) perSlot[slot] += n;
+  } );
+  if ( total == 0 ) {
+    info() << "no sample recorded" << endmsg;
+    return Auditor::finalize();
+  }
+
+  auto algName = [this]( std::uint32_t id ) -> std::string {
+    return id == 0 ? "[no algorithm]" : m_algorithms[id - 1];
+  };
+
+  // write the folded stacks
+  std::map<void*, std::string> symbols;
+  auto                         symbol = [&symbols]( void* addr ) -> const std::string& {
+    auto& name = symbols[addr];
+    if ( name.empty() ) {
+      void*       base = nullptr;
+      std::string fnc, lib;
+      if ( !System::getStackLevel( addr, base, fnc, lib ) ) {
+        name = "[unknown]";
+      } else {
+        name = fnc == "local" ? "[" + lib.substr( lib.rfind( '/' ) + 1 ) + "]" : fnc;
+        std::replace( name.begin(), name.end(), ';', ':' );
+      }
+    }
+    return name;
+  };
+  std::error_code ec;
+  std::filesystem::create_directories( m_outputDir.value(), ec );
+  std::ofstream                       all( std::filesystem::path{ m_outputDir.value() } / "all.folded" );
+  std::map<std::uint32_t, std::ofstream> files;
+  for ( const auto& [key, n] : folded ) {
+    const auto& [alg, stack] = key;
+    std::string line;
+    for ( auto frame = stack.rbegin(); frame != stack.rend(); ++frame ) {
+      if ( !line.empty() ) line += ';';
+      line += symbol( *frame );
+    }
+    all << algName( alg ) << ';' << line << ' ' << n << '\n';
+    if ( alg != 0 ) {
+      auto& file = files[alg];
+      if ( !file.is_open() ) {
+        auto fileName = algName( alg );
+        std::replace( fileName.begin(), fileName.end(), '/', '_' );
+        file.open( std::filesystem::path{ m_outputDir.value() } / ( fileName + ".folded" ) );
+      }
+      file << line << ' ' << n << '\n';
+    }
+  }
+  if ( !all ) warning() << "cannot write the folded stacks in " << m_outputDir.value() << endmsg;
+
+  // summary
+  std::vector<std::pair<std::uint64_t, std::uint32_t>> sorted;
+  for ( const auto& [alg, n] : perAlg ) sorted.emplace_back( n, alg );
+  std::stable_sort( sorted.begin(), sorted.end(), []( const auto& a, const auto& b ) { return a.first > b.first; } );
+  std::size_t width = 9;
+  for ( const auto& entry : sorted ) width = std::max( width, algName( entry.second ).size() );
+  std::ostringstream out;
+  out << std::left << std::setw( width ) << "Algorithm" << std::right << std::setw( 10 ) << "Samples" << std::setw( 9 )
+      << "%" << std::fixed << std::setprecision( 2 );
+  for ( const auto& [n, alg] : sorted ) {
+    out << '\n'
+        << std::left << std::setw( width ) << algName( alg ) << std::right << std::setw( 10 ) << n << std::setw( 9 )
+        << 100. * n / total;
+  }
+  out << "\nSamples per slot:";
+  for ( const auto& [slot, n] : perSlot ) out << ' ' << slot << ':' << n;
+  info() << "Folded stacks of " << total << " samples written to " << m_outputDir.value() << "\n"
+         << out.str() << endmsg;
+
+  return Auditor::finalize();
+}
+
+std::uint32_t SamplingProfiler::algorithmId( const std::string& name ) {
+  auto lock = std::scoped_lock{ m_algorithmsMutex };
+  auto it   = m_algorithmIds.find( name );
+  if ( it == m_algorithmIds.end() ) {
+    m_algorithms.push_back( name );
+    it = m_algorithmIds.emplace( name, static_cast<std::uint32_t>( m_algorithms.size() ) ).first;
+  }
+  return it->second;
+}
+
+SamplingProfiler::ThreadSampler& SamplingProfiler::threadSampler() {
+  bool  created = false;
+  auto& sampler = m_samplers.local( [&] {
+    created          = true;
+    std::size_t size = 1;
+    while ( size < m_bufferSize ) size <<= 1;
+    return std::make_unique<ThreadSampler>( size );
+  } );
+  if ( created ) {
+    // only now the signal handler can find the sampler
+    t_sampler = &sampler;
+
+    sigevent event{};
+    event.sigev_notify    = SIGEV_THREAD_ID;
+    event.sigev_signo     = SIGPROF;
+    event._sigev_un._tid  = static_cast<pid_t>( syscall( SYS_gettid ) ); // sigev_notify_thread_id
+    if ( timer_create( CLOCK_THREAD_CPUTIME_ID, &event, &sampler.timer ) == 0 ) {
+      const auto period = static_cast<long>( 1e9 / m_frequency );
+      itimerspec spec{};
+      spec.it_interval.tv_sec  = period / 1000000000;
+      spec.it_interval.tv_nsec = period % 1000000000;
+      spec.it_value            = spec.it_interval;
+      timer_settime( sampler.timer, 0, &spec, nullptr );
+      sampler.hasTimer = true;
+    } else {
+      warning() << "cannot create the sampling timer of the thread: " << std::strerror( errno ) << endmsg;
+    }
+  }
+  return sampler;
+}
+
+void SamplingProfiler::onSignal( int, siginfo_t*, void* ) {
+  const int savedErrno = errno;
+  auto      self       = s_active.load( std::memory_order_relaxed );
+  if ( auto sampler = t_sampler; sampler && self ) {
+    const auto head = sampler->head.load( std::memory_order_relaxed );
+    if ( head - sampler->tail.load( std::memory_order_acquire ) > sampler->mask ) {
+      sampler->dropped.store( sampler->dropped.load( std::memory_order_relaxed ) + 1, std::memory_order_relaxed );
+    } else {
+      auto& sample = sampler->samples[head & sampler->mask];
+      sample.alg   = sampler->current.load( std::memory_order_relaxed );
+      sample.slot  = sampler->slot.load( std::memory_order_relaxed );
+      sample.depth = System::backTrace( sample.frames, self->m_frames );
+      sampler->head.store( head + 1, std::memory_order_release );
+    }
+  }
+  errno = savedErrno;
+}
+
+void SamplingProfiler::drain( ThreadSampler& sampler ) {
+  auto       tail = sampler.tail.load( std::memory_order_relaxed );
+  const auto head = sampler.head.load( std::memory_order_acquire );
+  for ( ; tail != head; ++tail ) {
+    const auto& sample = sampler.samples[tail & sampler.mask];
+    if ( sample.depth > s_skipFrames ) {
+      ++sampler.folded[{ sample.alg, CallStack( sample.frames + s_skipFrames, sample.frames + sample.depth ) }];
+      if ( sample.alg != 0 ) ++sampler.perSlot[sample.slot];
+    }
+  }
+  sampler.tail.store( tail, std::memory_order_release );
+}
+
+void SamplingProfiler::before( StandardEventType evt, INamedInterface* caller ) {
+  if ( evt != IAuditor::Execute || s_active.load( std::memory_order_relaxed ) != this ) return;
+  auto& sampler = threadSampler();
+  sampler.stack.emplace_back( sampler.current.load( std::memory_order_relaxed ),
+                              sampler.slot.load( std::memory_order_relaxed ) );
+  sampler.slot.store( static_cast<std::uint32_t>( Gaudi::Hive::currentContextId() ), std::memory_order_relaxed );
+  auto& id = sampler.ids[caller];
+  if ( id == 0 ) id = algorithmId( caller->name() );
+  sampler.current.store( id, std::memory_order_relaxed );
+}
+
+void SamplingProfiler::after( StandardEventType evt, INamedInterface*, const StatusCode& ) {
+  if ( evt != IAuditor::Execute || s_active.load( std::memory_order_relaxed ) != this ) return;
+  auto& sampler = threadSampler();
+  if ( sampler.stack.empty() ) return;
+  const auto [previous, slot] = sampler.stack.back();
+  sampler.stack.pop_back();
+  sampler.current.store( previous, std::memory_order_relaxed );
+  sampler.slot.store( slot, std::memory_order_relaxed );
+  // drain the ring buffer when half full, out of the algorithms
+  if ( sampler.stack.empty() &&
+       2 * ( sampler.head.load( std::memory_order_relaxed ) - sampler.tail.load( std::memory_order_relaxed ) ) >
+           sampler.mask ) {
+    drain( sampler );
+  }
+}
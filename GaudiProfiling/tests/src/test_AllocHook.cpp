@@ -0,0 +1,116 @@
+/***********************************************************************************\
+* (c) Copyright 2022 CERN for the benefit of the LHCb and ATLAS collaborations      *
+*                                                                                   *
+* This software is distributed under the terms of the Apache version 2 licence,     *
+* copied verbatim in the file "LICENSE".                                            *
+*                                                                                   *
+* In applying this licence, CERN does not waive the privileges and immunities       *
+* granted to it by virtue of its status as an Intergovernmental Organization        *
+* or submit itself to any jurisdiction.                                             *
+\***********************************************************************************/
+#define BOOST_TEST_DYN_LINK
+#define BOOST_TEST_MODULE test_AllocHook
+#include <boost/test/unit_test.hpp>
+
+#include "AllocHook.h"
+
+#include <dlfcn.h>
+
+#include <algorithm>
+#include <cerrno>
+#include <cstdlib>
+#include <memory>
+#include <thread>
+#include <vector>
+
+// the test is linked against libGaudiAllocHook.so, which comes before the C library in the
+// lookup order, so its allocation functions are used as with LD_PRELOAD
+namespace {
+  thread_local std::vector<std::size_t>* t_sizes = nullptr;
+
+  void recordSize( std::size_t size ) {
+    if ( t_sizes ) t_sizes->push_back( size ); // may allocate: must not be reported
+  }
+
+  /// Install the callback for the lifetime of the object, recording the sizes allocated by the thread.
+  struct Recorder {
+    std::vector<std::size_t> sizes;
+    Recorder() {
+      sizes.reserve( 16 );
+      t_sizes = &sizes;
+      gaudi_alloc_hook_set( &recordSize );
+    }
+    ~Recorder() {
+      gaudi_alloc_hook_set( nullptr );
+      t_sizes = nullptr;
+    }
+  };
+
+  // prevent the compiler from removing allocations whose result is not used
+  void* volatile s_sink = nullptr;
+} // namespace
+
+BOOST_AUTO_TEST_CASE( lookup ) {
+  // the way the auditor finds the hook
+  BOOST_CHECK( dlsym( RTLD_DEFAULT, GAUDI_ALLOC_HOOK_SET_NAME ) == reinterpret_cast<void*>( &gaudi_alloc_hook_set ) );
+}
+
+BOOST_AUTO_TEST_CASE( allocation_functions ) {
+  Recorder rec;
+
+  void* p = std::malloc( 100 );
+  s_sink  = p;
+  p       = std::realloc( p, 300 );
+  s_sink  = p;
+  std::free( p );
+  p      = std::calloc( 4, 50 );
+  s_sink = p;
+  std::free( p );
+  p      = std::aligned_alloc( 64, 128 );
+  s_sink = p;
+  std::free( p );
+  const int valid = posix_memalign( &p, 64, 1000 );
+  s_sink          = p;
+  std::free( p );
+  const int invalid = posix_memalign( &p, 3, 1000 );      // invalid alignment: nothing allocated
+  auto      q       = std::make_unique<char[]>( 5000 ); // operator new uses malloc
+  s_sink            = q.get();
+
+  // the 16 capacity reserved for the sizes is exceeded: the reallocations of the vector, made
+  // from the callback, are not recorded
+  for ( int i = 0; i < 20; ++i ) {
+    p      = std::malloc( 10 );
+    s_sink = p;
+    std::free( p );
+  }
+
+  gaudi_alloc_hook_set( nullptr ); // the checks may allocate
+
+  BOOST_CHECK_EQUAL( valid, 0 );
+  BOOST_CHECK_EQUAL( invalid, EINVAL );
+  const std::vector<std::size_t> expected = { 100, 300, 200, 128, 1000, 5000 };
+  BOOST_REQUIRE_EQUAL( rec.sizes.size(), expected.size() + 20 );
+  BOOST_CHECK_EQUAL_COLLECTIONS( rec.sizes.begin(), rec.sizes.begin() + expected.size(), expected.begin(),
+                                 expected.end() );
+}
+
+BOOST_AUTO_TEST_CASE( threads_and_removal ) {
+  Recorder rec;
+  // the callback is global, but called on the allocating thread
+  std::thread t{ [] {
+    void* p = std::malloc( 77 );
+    s_sink  = p;
+    std::free( p );
+  } };
+  t.join();
+  const bool fromThread = std::find( rec.sizes.begin(), rec.sizes.end(), 77 ) != rec.sizes.end();
+
+  gaudi_alloc_hook_set( nullptr );
+  void* p = std::malloc( 33 );
+  s_sink  = p;
+  std::free( p );
+  const bool afterRemoval = std::find( rec.sizes.begin(), rec.sizes.end(), 33 ) != rec.sizes.end();
+
+  BOOST_CHECK( !fromThread );
+  BOOST_CHECK( !afterRemoval );
+}
@@ -19,12 +19,22 @@
 #include "StalledEventMonitor.h"
 
 #include "GaudiKernel/IIncidentSvc.h"
+#include "GaudiKernel/Incident.h"
 #include "GaudiKernel/Memory.h"
+#include "GaudiKernel/System.h"
 #include "GaudiKernel/WatchdogThread.h"
 
 #include "TSystem.h"
 
+#include <algorithm>
+#include <bit>
+#include <cerrno>
+#include <cmath>
 #include <csignal>
+#include <cstring>
+#include <iomanip>
+#include <pthread.h>
+#include <sstream>
 
 namespace {
   /// Specialized watchdog to monitor the event loop and spot possible infinite loops.
@@ -86,8 +96,80 @@ namespace {
         log << MSG::INFO << "The last event took ~" << m_counter * getTimeout().total_seconds() << "s" << endmsg;
     }
   };
+
+  /// Stack of a thread, captured by the thread itself in the SIGURG handler on request.
+  struct StackCapture {
+    static constexpr int maxDepth = 64;
+    /// frames of System::backTrace, of the signal handler and of the signal trampoline
+    static constexpr int skipFrames = 3;
+    enum State : int { Idle, Requested, Writing, Done };
+
+    std::atomic<int> state{ Idle };
+    int              depth = 0;
+    void*            frames[maxDepth];
+  } s_stack;
+
+  void onStackSignal( int ) {
+    int expected = StackCapture::Requested;
+    if ( !s_stack.state.compare_exchange_strong( expected, StackCapture::Writing ) ) return;
+    s_stack.depth = System::backTrace( s_stack.frames, StackCapture::maxDepth );
+    s_stack.state.store( StackCapture::Done, std::memory_order_release );
+  }
+
+  std::string toString( std::thread::native_handle_type thread ) {
+    std::ostringstream os;
+    os << "0x" << std::hex << thread;
+    return os.str();
+  }
+
+  double toSeconds( std::chrono::steady_clock::duration d ) { return std::chrono::duration<double>( d ).count(); }
 } // namespace
 
+void StalledEventMonitor::RuntimeHistogram::add( std::chrono::steady_clock::duration d ) {
+  const auto us = static_cast<std::uint64_t>(
+      std::max( std::chrono::duration_cast<std::chrono::microseconds>( d ).count(), std::int64_t{ 0 } ) );
+  std::size_t bin = us;
+  if ( us >= 4 ) {
+    // 4 bins per octave: the position of the highest bit and the next two bits
+    const std::size_t e = std::bit_width( us ) - 1;
+    bin                 = std::min( 4 * ( e - 1 ) + ( ( us >> ( e - 2 ) ) & 3 ), nBins - 1 );
+  }
+  bins[bin].fetch_add( 1, std::memory_order_relaxed );
+}
+
+std::chrono::duration<double> StalledEventMonitor::RuntimeHistogram::percentile( double p,
+                                                                                  std::uint64_t& entries ) const {
+  std::array<std::uint32_t, nBins> counts;
+  entries = 0;
+  for ( std::size_t i = 0; i != nBins; ++i ) entries += counts[i] = bins[i].load( std::memory_order_relaxed );
+  const auto  target = static_cast<std::uint64_t>( std::ceil( p / 100. * entries ) );
+  std::size_t bin    = 0;
+  for ( std::uint64_t sum = 0; bin != nBins - 1 && ( sum += counts[bin] ) < target; ) ++bin;
+  // upper edge of the bin
+  const std::uint64_t us = bin < 4 ? bin + 1 : ( 5 + bin % 4 ) << ( bin / 4 - 1 );
+  return std::chrono::microseconds( us );
+}
+
+StalledEventMonitor::RuntimeHistogram* StalledEventMonitor::runtimeHistogram( unsigned int index, bool create ) {
+  const std::size_t chunk = index / s_histogramsPerChunk;
+  if ( chunk >= s_maxChunks ) return nullptr;
+  auto* histograms = m_runtimes[chunk].load( std::memory_order_acquire );
+  if ( !histograms ) {
+    if ( !create ) return nullptr;
+    auto* fresh = new RuntimeHistogram[s_histogramsPerChunk];
+    if ( m_runtimes[chunk].compare_exchange_strong( histograms, fresh, std::memory_order_acq_rel ) ) {
+      histograms = fresh;
+    } else {
+      delete[] fresh; // another thread was faster
+    }
+  }
+  return histograms + index % s_histogramsPerChunk;
+}
+
+StalledEventMonitor::~StalledEventMonitor() {
+  for ( auto& histograms : m_runtimes ) delete[] histograms.exchange( nullptr );
+}
+
 // Initialization of the service.
 StatusCode StalledEventMonitor::initialize() {
   StatusCode sc = base_class::initialize();
@@ -98,7 +180,8 @@ StatusCode StalledEventMonitor::initialize() {
     m_watchdog = std::make_unique<EventWatchdog>( msgSvc(), "EventWatchdog",
                                                   boost::posix_time::seconds( m_eventTimeout.value() ), m_stackTrace,
                                                   m_maxTimeoutCount );
-
+  }
+  if ( m_eventTimeout || m_algorithmTimeout > 0 || m_runtimeFactor > 0 ) {
     // register to the incident service
     static const std::string serviceName = "IncidentSvc";
     m_incidentSvc                        = serviceLocator()->service( serviceName );
@@ -108,6 +191,7 @@ StatusCode StalledEventMonitor::initialize() {
     }
     debug() << "Register to the IncidentSvc" << endmsg;
     m_incidentSvc->addListener( this, IncidentType::BeginEvent );
+    m_incidentSvc->addListener( this, IncidentType::EndEvent );
   } else {
     warning() << "StalledEventMonitor/" << name() << " instantiated with 0 time-out: no monitoring performed" << endmsg;
   }
@@ -117,18 +201,221 @@ StatusCode StalledEventMonitor::initialize() {
 
 // Start the monitoring.
 StatusCode StalledEventMonitor::start() {
-  if ( m_watchdog ) m_watchdog->start();
+  if ( !m_incidentSvc ) return StatusCode::SUCCESS;
+
+  // in multi-threaded jobs, monitor the slots and the algorithms (the scheduler is initialized by now)
+  m_scheduler = serviceLocator()->service( m_schedulerName, false );
+  if ( !m_scheduler ) {
+    if ( m_watchdog ) {
+      m_watchdog->start();
+    } else {
+      warning() << "StalledEventMonitor/" << name() << " instantiated with 0 time-out: no monitoring performed"
+                << endmsg;
+    }
+    return StatusCode::SUCCESS;
+  }
+
+  if ( m_checkPeriod <= 0 ) {
+    error() << "invalid CheckPeriod " << m_checkPeriod.value() << endmsg;
+    return StatusCode::FAILURE;
+  }
+  if ( m_stackTrace ) {
+    // the first call of backtrace may allocate (loading libgcc_s), it must not happen in the handler
+    void* frames[4];
+    System::backTrace( frames, 4 );
+
+    struct sigaction action {};
+    action.sa_handler = &onStackSignal;
+    action.sa_flags   = SA_RESTART;
+    sigemptyset( &action.sa_mask );
+    if ( sigaction( SIGURG, &action, &m_oldAction ) != 0 ) {
+      error() << "cannot install the SIGURG handler: " << std::strerror( errno ) << endmsg;
+      return StatusCode::FAILURE;
+    }
+  }
+  if ( m_runtimeFactor > 0 ) {
+    m_scheduler->recordExecutionTimes( [this]( unsigned int index, std::chrono::steady_clock::duration d ) {
+      if ( auto histogram = runtimeHistogram( index, true ) ) histogram->add( d );
+    } );
+  }
+  m_scheduler->trackRunningAlgorithms( true );
+  m_stopMonitor   = false;
+  m_monitorThread = std::thread{ &StalledEventMonitor::monitorLoop, this };
   return StatusCode::SUCCESS;
 }
 
-// Notify the watchdog that a new event has been started
-void StalledEventMonitor::handle( const Incident& /* incident */ ) {
-  if ( m_watchdog ) m_watchdog->ping();
+// Notify the watchdog that a new event has been started, or keep track of the events per slot
+void StalledEventMonitor::handle( const Incident& incident ) {
+  if ( !m_scheduler ) {
+    if ( m_watchdog && incident.type() == IncidentType::BeginEvent ) m_watchdog->ping();
+    return;
+  }
+
+  const auto& ctx = incident.context();
+  if ( !ctx.valid() ) return;
+  std::scoped_lock lock( m_slotsMutex );
+  if ( ctx.slot() >= m_slots.size() ) m_slots.resize( ctx.slot() + 1 );
+  auto& slot = m_slots[ctx.slot()];
+  if ( incident.type() == IncidentType::BeginEvent ) {
+    slot = { ctx.evt(), std::chrono::steady_clock::now(), true, 0 };
+  } else {
+    if ( slot.active && slot.timeouts ) {
+      info() << "Event " << slot.evt << " in slot " << ctx.slot() << " took " << std::fixed << std::setprecision( 1 )
+             << toSeconds( std::chrono::steady_clock::now() - slot.start ) << "s" << endmsg;
+    }
+    slot.active = false;
+  }
+}
+
+void StalledEventMonitor::monitorLoop() {
+  const auto period =
+      std::chrono::duration_cast<std::chrono::steady_clock::duration>( std::chrono::duration<double>( m_checkPeriod ) );
+  std::unique_lock lock( m_monitorMutex );
+  while ( !m_monitorWakeUp.wait_for( lock, period, [this]() { return m_stopMonitor; } ) ) {
+    lock.unlock();
+    check();
+    lock.lock();
+  }
 }
 
-// Start the monitoring.
+void StalledEventMonitor::check() {
+  const auto now     = std::chrono::steady_clock::now();
+  const auto running = m_scheduler->runningAlgorithms();
+
+  // algorithms running for too long
+  std::set<std::pair<std::thread::native_handle_type, std::chrono::steady_clock::time_point>> current;
+  for ( const auto& alg : running ) {
+    const auto key = std::make_pair( alg.thread, alg.start );
+    current.insert( key );
+    if ( m_reported.count( key ) ) continue; // each execution is reported once
+
+    const double       elapsed = toSeconds( now - alg.start );
+    std::ostringstream reason;
+    reason << std::fixed << std::setprecision( 1 );
+    if ( m_algorithmTimeout > 0 && elapsed > m_algorithmTimeout ) {
+      reason << "more than AlgorithmTimeout (" << m_algorithmTimeout.value() << "s)";
+    } else if ( auto histogram = m_runtimeFactor > 0 ? runtimeHistogram( alg.index, false ) : nullptr ) {
+      std::uint64_t entries   = 0;
+      const auto    reference = histogram->percentile( m_runtimePercentile, entries ).count();
+      if ( entries < m_minExecutions || elapsed <= m_runtimeFactor * reference ) continue;
+      reason << m_runtimePercentile.value() << "% of its " << entries << " executions took less than "
+             << std::setprecision( 3 ) << reference << "s";
+    } else {
+      continue;
+    }
+    m_reported.insert( key );
+
+    warning() << "Algorithm " << alg.name << " running for " << std::fixed << std::setprecision( 1 ) << elapsed
+              << "s in slot " << alg.slot << " (event " << alg.evt << ") on thread " << toString( alg.thread ) << ": "
+              << reason.str() << endmsg;
+    if ( m_stackTrace ) printStack( alg.thread );
+  }
+  // forget the executions that ended
+  for ( auto it = m_reported.begin(); it != m_reported.end(); ) {
+    it = current.count( *it ) ? std::next( it ) : m_reported.erase( it );
+  }
+
+  if ( !m_eventTimeout ) return;
+
+  // events taking too long
+  bool                                         abort = false;
+  std::vector<std::thread::native_handle_type> stacks;
+  {
+    std::scoped_lock lock( m_slotsMutex );
+    for ( std::size_t i = 0; i != m_slots.size(); ++i ) {
+      auto& slot = m_slots[i];
+      if ( !slot.active || now - slot.start < std::chrono::seconds( m_eventTimeout * ( slot.timeouts + 1 ) ) ) {
+        continue;
+      }
+      ++slot.timeouts;
+
+      warning() << "Event " << slot.evt << " in slot " << i << " running for more than "
+                << m_eventTimeout * slot.timeouts << "s" << endmsg;
+      auto& log = info();
+      log << std::fixed << std::setprecision( 1 ) << "Algorithms running in slot " << i << ":";
+      bool any = false;
+      for ( const auto& alg : running ) {
+        if ( alg.slot != i || alg.evt != slot.evt ) continue;
+        log << "\n  " << alg.name << " for " << toSeconds( now - alg.start ) << "s on thread "
+            << toString( alg.thread );
+        any = true;
+      }
+      if ( !any ) log << " none";
+      log << endmsg;
+      info() << "Current memory usage is virtual size = " << System::virtualMemory() / 1024.
+             << " MB, resident set size = " << System::pagedMemory() / 1024. << " MB" << endmsg;
+
+      if ( m_maxTimeoutCount > 0 && slot.timeouts >= static_cast<unsigned int>( m_maxTimeoutCount ) ) {
+        for ( const auto& alg : running ) {
+          if ( alg.slot == i && alg.evt == slot.evt ) stacks.push_back( alg.thread );
+        }
+        abort = true;
+      }
+    }
+  }
+  if ( abort ) {
+    if ( m_stackTrace ) {
+      for ( auto thread : stacks ) printStack( thread );
+    }
+    fatal() << "too much time on a single event: aborting process" << endmsg;
+    std::raise( SIGQUIT );
+  }
+}
+
+void StalledEventMonitor::printStack( std::thread::native_handle_type thread ) {
+  s_stack.state = StackCapture::Requested;
+  if ( pthread_kill( thread, SIGURG ) != 0 ) {
+    s_stack.state = StackCapture::Idle;
+    warning() << "cannot signal thread " << toString( thread ) << endmsg;
+    return;
+  }
+  // the thread may be blocked with the signal masked: do not wait for more than a second
+  for ( int i = 0; i != 1000 && s_stack.state.load( std::memory_order_acquire ) != StackCapture::Done; ++i ) {
+    std::this_thread::sleep_for( std::chrono::milliseconds( 1 ) );
+  }
+  int expected = StackCapture::Requested;
+  if ( s_stack.state.compare_exchange_strong( expected, StackCapture::Idle ) ) {
+    warning() << "no stack trace received from thread " << toString( thread ) << endmsg;
+    return;
+  }
+  while ( s_stack.state.load( std::memory_order_acquire ) != StackCapture::Done ) std::this_thread::yield();
+
+  auto& log = info();
+  log << "Stack trace of thread " << toString( thread ) << ":";
+  std::string fnc, lib;
+  for ( int i = StackCapture::skipFrames; i < s_stack.depth; ++i ) {
+    void* addr = nullptr;
+    if ( System::getStackLevel( s_stack.frames[i], addr, fnc, lib ) ) {
+      log << "\n#" << std::setw( 3 ) << std::left << i - StackCapture::skipFrames + 1 << std::right << std::hex
+          << addr << std::dec << " " << fnc << "  [" << lib << "]";
+    }
+  }
+  log << endmsg;
+  s_stack.state = StackCapture::Idle;
+}
+
+// Stop the monitoring.
 StatusCode StalledEventMonitor::stop() {
-  if ( m_watchdog ) m_watchdog->stop();
+  if ( m_scheduler ) {
+    {
+      std::scoped_lock lock( m_monitorMutex );
+      m_stopMonitor = true;
+    }
+    m_monitorWakeUp.notify_one();
+    if ( m_monitorThread.joinable() ) m_monitorThread.join();
+    m_scheduler->trackRunningAlgorithms( false );
+    if ( m_runtimeFactor > 0 ) m_scheduler->recordExecutionTimes( {} );
+    if ( m_stackTrace ) {
+      // a signal could still be pending: ignore it rather than getting the default action
+      if ( m_oldAction.sa_handler == SIG_DFL ) m_oldAction.sa_handler = SIG_IGN;
+      sigaction( SIGURG, &m_oldAction, nullptr );
+    }
+    m_scheduler.reset();
+    m_reported.clear();
+    m_slots.clear();
+  } else if ( m_watchdog ) {
+    m_watchdog->stop();
+  }
   return StatusCode::SUCCESS;
 }
 
@@ -137,8 +424,11 @@ StatusCode StalledEventMonitor::finalize() {
   // destroy the watchdog thread (if any)
   m_watchdog.reset();
   // unregistering from the IncidentSvc
-  m_incidentSvc->removeListener( this, IncidentType::BeginEvent );
-  m_incidentSvc.reset();
+  if ( m_incidentSvc ) {
+    m_incidentSvc->removeListener( this, IncidentType::BeginEvent );
+    m_incidentSvc->removeListener( this, IncidentType::EndEvent );
+    m_incidentSvc.reset();
+  }
   return base_class::finalize();
 }
 
@@ -20,8 +20,21 @@
 
 // Include files
 #include "GaudiKernel/IIncidentListener.h"
+#include "GaudiKernel/IScheduler.h"
 #include "GaudiKernel/Service.h"
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <csignal>
+#include <cstdint>
 #include <memory>
+#include <mutex>
+#include <set>
+#include <string>
+#include <thread>
+#include <utility>
+#include <vector>
 
 // Forward declarations
 class WatchdogThread;
@@ -31,6 +44,13 @@ class IIncidentSvc;
  *  Service that monitor the time taken by processing of single events using a
  *  separate thread.
  *
+ *  In multi-threaded jobs (when the scheduler service exists) the events are followed per slot,
+ *  from their BeginEvent to their EndEvent incident, and the reports list the algorithms running
+ *  in the slot. Each algorithm execution is also checked on its own: it is reported when it lasts
+ *  more than AlgorithmTimeout, or more than RuntimeFactor times the RuntimePercentile percentile
+ *  of the previous executions of the algorithm. With StackTrace, the stack of the thread running
+ *  a reported algorithm is printed (it is captured by the thread itself, in a SIGURG handler).
+ *
  *  @see WatchdogThread
  *
  *  @author Marco Clemencic
@@ -57,6 +77,9 @@ public:
   /// Finalization of the service.
   StatusCode finalize() override;
 
+  /// Destructor.
+  ~StalledEventMonitor() override;
+
 private:
   Gaudi::Property<unsigned int> m_eventTimeout{
       this, "EventTimeout", 600, "Number of seconds allowed to process a single event (0 to disable the check)." };
@@ -64,11 +87,76 @@ private:
                                           "Number timeouts before aborting the execution (0 means never abort)." };
   Gaudi::Property<bool> m_stackTrace{ this, "StackTrace", false, "Whether to print the stack-trace on timeout." };
 
+  Gaudi::Property<std::string> m_schedulerName{
+      this, "Scheduler", "AvalancheSchedulerSvc",
+      "Scheduler providing the running algorithms (the events are monitored per slot if it exists)." };
+  Gaudi::Property<double> m_checkPeriod{ this, "CheckPeriod", 1.,
+                                         "Seconds between two checks of the slots and of the running algorithms." };
+  Gaudi::Property<double> m_algorithmTimeout{
+      this, "AlgorithmTimeout", 0., "Seconds an algorithm execution may take before being reported (0 to disable)." };
+  Gaudi::Property<double> m_runtimePercentile{ this, "RuntimePercentile", 99.,
+                                               "Percentile of the execution times used as reference." };
+  Gaudi::Property<double> m_runtimeFactor{ this, "RuntimeFactor", 10.,
+                                           "Report the algorithm executions longer than RuntimeFactor times their "
+                                           "reference execution time (0 to disable)." };
+  Gaudi::Property<unsigned int> m_minExecutions{
+      this, "MinExecutions", 100, "Executions of an algorithm needed before using its reference execution time." };
+
   /// Pointer to the watchdog thread that checks for the event timeout.
   std::unique_ptr<WatchdogThread> m_watchdog;
 
   /// Pointer to the incident service.
   SmartIF<IIncidentSvc> m_incidentSvc;
+
+  // --- per slot monitoring (multi-threaded jobs) ---
+
+  /// Main loop of the monitoring thread.
+  void monitorLoop();
+  /// Check the slots and the running algorithms.
+  void check();
+  /// Print the stack of a thread executing an algorithm.
+  void printStack( std::thread::native_handle_type thread );
+
+  /// The scheduler, if it exists (set in start()).
+  SmartIF<IScheduler> m_scheduler;
+
+  std::thread             m_monitorThread;
+  std::mutex              m_monitorMutex;
+  std::condition_variable m_monitorWakeUp;
+  bool                    m_stopMonitor = false;
+
+  /// Event being processed in a slot.
+  struct SlotState {
+    EventContext::ContextEvt_t            evt = 0;
+    std::chrono::steady_clock::time_point start;
+    bool                                  active   = false;
+    unsigned int                          timeouts = 0; ///< number of EventTimeout periods reported
+  };
+  std::mutex             m_slotsMutex;
+  std::vector<SlotState> m_slots;
+
+  /// Algorithm executions already reported, by thread and start time.
+  std::set<std::pair<std::thread::native_handle_type, std::chrono::steady_clock::time_point>> m_reported;
+
+  /// Distribution of the execution times of an algorithm, in bins of a quarter of octave of microseconds.
+  struct RuntimeHistogram {
+    static constexpr std::size_t                  nBins = 160;
+    std::array<std::atomic<std::uint32_t>, nBins> bins{};
+
+    void add( std::chrono::steady_clock::duration d );
+    /// Upper bound of the given percentile of the durations, also returning the number of entries.
+    std::chrono::duration<double> percentile( double p, std::uint64_t& entries ) const;
+  };
+  /// The histograms are indexed by the scheduler index of the algorithms, and allocated in chunks
+  /// (by the first execution of an algorithm of the chunk), so that they never move.
+  static constexpr std::size_t                            s_histogramsPerChunk = 64;
+  static constexpr std::size_t                            s_maxChunks          = 1024;
+  std::array<std::atomic<RuntimeHistogram*>, s_maxChunks> m_runtimes{};
+  /// Histogram of an algorithm, nullptr if it does not exist and create is false.
+  RuntimeHistogram* runtimeHistogram( unsigned int index, bool create );
+
+  /// SIGURG handler in place before the one capturing the stacks.
+  struct sigaction m_oldAction {};
 };
 
 #endif // STALLEDEVENTMONITOR_H_